@@ -10,6 +10,9 @@
 #include "taco/ir/ir.h"
 
 namespace taco {
+namespace util {
+class ThreadPool;
+}
 namespace ir {
 
 class Module {
@@ -21,7 +24,14 @@ public:
     setJITTmpdir();
   }
 
-  /// Compile the source into a library, returning its full path
+  /// Compile the source into a library, returning its full path.  If the
+  /// TACO_CACHE_DIR environment variable names a directory, compiled libraries
+  /// are stored there keyed by a hash of their source, compiler (including its
+  /// `--version` output) and flags, and later compilations of the same source
+  /// load the cached library instead of invoking the compiler, and return its
+  /// path in the cache.  TACO_CACHE_SIZE bounds the size of the cache in
+  /// megabytes (default 1024); least recently used libraries are evicted.
+  /// Different modules may be compiled concurrently on different threads.
   std::string compile();
   
   /// Compile the module into a source file located at the specified location
@@ -41,9 +51,14 @@ public:
   /// Get a function pointer to a compiled function. This returns a void*
   /// pointer, which the caller is required to cast to the correct function type
   /// before calling. If there's no function of this name then a nullptr is
-  /// returned.
+  /// returned. The pointers to the module's functions and their shims are
+  /// resolved once when the library is loaded.
   void* getFuncPtr(std::string name);
 
+  /// Call a raw function through a pointer obtained from `getFuncPtr`, which
+  /// avoids looking the function up by name on every call.
+  static int callFuncPtr(void* funcPtr, void** args);
+
   /// Call a raw function in this module and return the result
   int callFuncPackedRaw(std::string name, void** args);
   
@@ -72,6 +87,7 @@ private:
   std::string tmpdir;
   void* lib_handle;
   std::vector<Stmt> funcs;
+  std::map<std::string, void*> funcPtrs;
   
   // true iff the module was created from user-provided source
   bool moduleFromUserSource;
@@ -80,8 +96,15 @@ private:
   
   void setJITLibname();
   void setJITTmpdir();
+  void loadFuncPtrs();
 };
 
+/// Returns the pool of worker threads used to compile modules asynchronously.
+/// Its size, and thus the number of external compiler processes that run at
+/// once, is given by the TACO_COMPILE_THREADS environment variable and
+/// defaults to the number of hardware threads.
+util::ThreadPool& getCompilePool();
+
 } // namespace ir
 } // namespace taco
 #endif
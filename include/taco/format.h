@@ -62,13 +62,73 @@ public:
   /// Gets the type of the idx array for level i
   Datatype getCoordinateTypeIdx(size_t level) const;
 
+  /// Gets the type of the positions of level i, which is the widest position
+  /// array type of level i and the levels above it
+  Datatype getPositionType(size_t level) const;
+
   /// Sets the types of the coordinate arrays for each level
   void setLevelArrayTypes(std::vector<std::vector<Datatype>> levelArrayTypes);
 
+  /// Returns true if the format stores dense blocks of components.
+  bool isBlocked() const;
+
+  /// Gets the block size of every mode of a blocked format, or an empty vector
+  /// if the format is not blocked.
+  const std::vector<int>& getBlockSizes() const;
+
+  /// Sets the block size of every mode.  The levels of a blocked format store
+  /// the coordinates of the blocks, and every position of its last level
+  /// stores a dense row-major block of components.
+  void setBlockSizes(std::vector<int> blockSizes);
+
+  /// Returns true if the format is a sliced ELLPACK format.
+  bool isSliced() const;
+
+  /// Gets the number of rows in every slice of a sliced ELLPACK format, or 0
+  /// if every slice has all rows (ELLPACK).
+  int getSliceHeight() const;
+
+  /// Gets the number of consecutive rows that a sliced ELLPACK format sorts by
+  /// their number of components before slicing them.
+  int getSortWindow() const;
+
+  /// Makes a {Sliced,Singleton} format a sliced ELLPACK (SELL-C-sigma) format
+  /// with the given slice height C and sort window sigma.  The rows are sorted
+  /// by their number of components within windows of sigma rows and cut into
+  /// slices of C rows, which store the components of their rows column-major
+  /// and padded to the length of their longest row.
+  void setSlicing(int sliceHeight, int sortWindow);
+
+  /// Returns true if the format is a diagonal (DIA) format.
+  bool isDiagonal() const;
+
+  /// Returns true if the format is a pattern format, which stores only the
+  /// coordinates of the components of a tensor and no values.
+  bool isPattern() const;
+
+  /// Makes the format a pattern format.  Every component stored by a pattern
+  /// format is one, so tensors stored in it allocate no value array and
+  /// kernels that read them use the constant in place of loaded values.
+  void setPattern(bool pattern=true);
+
+  /// Returns true if the format stores the values of complex tensors split
+  /// into their real and imaginary parts.
+  bool isSplitComplex() const;
+
+  /// Makes the format store the values of complex tensors split into the real
+  /// parts of all components followed by their imaginary parts, so that
+  /// kernels compute them with real arithmetic over the two parts.
+  void setSplitComplex(bool splitComplex=true);
+
 private:
   std::vector<ModeFormatPack> modeFormatPacks;
   std::vector<int> modeOrdering;
   std::vector<std::vector<Datatype>> levelArrayTypes;
+  std::vector<int> blockSizes;
+  int sliceHeight = -1;
+  int sortWindow = 1;
+  bool pattern = false;
+  bool splitComplex = false;
 };
 
 bool operator==(const Format&, const Format&);
@@ -85,10 +145,24 @@ public:
   /// Aliases for predefined mode formats
   static ModeFormat dense;       /// e.g., first mode in CSR
   static ModeFormat compressed;  /// e.g., second mode in CSR
+  static ModeFormat singleton;   /// e.g., second mode in COO
+  static ModeFormat hashed;      /// e.g., second mode in hashed CSR
+  static ModeFormat sliced;      /// e.g., first mode in ELLPACK
+  static ModeFormat diagonal;    /// e.g., first mode in DIA
+  static ModeFormat offset;      /// e.g., second mode in DIA
+  static ModeFormat bitmap;      /// e.g., second mode in bitmap CSR
+  static ModeFormat permuted;    /// e.g., rows of a vector multiplied by SELL
 
   static ModeFormat sparse;      /// alias for compressed
   static ModeFormat Dense;       /// alias for dense
   static ModeFormat Compressed;  /// alias for compressed
+  static ModeFormat Singleton;   /// alias for singleton
+  static ModeFormat Hashed;      /// alias for hashed
+  static ModeFormat Sliced;      /// alias for sliced
+  static ModeFormat Diagonal;    /// alias for diagonal
+  static ModeFormat Offset;      /// alias for offset
+  static ModeFormat Bitmap;      /// alias for bitmap
+  static ModeFormat Permuted;    /// alias for permuted
   static ModeFormat Sparse;      /// alias for compressed
 
   /// Properties of a mode format
@@ -128,6 +202,7 @@ public:
   bool hasLocate() const;
   bool hasInsert() const;
   bool hasAppend() const;
+  bool hasWordIter() const;
 
   /// Returns true if mode format is defined, false otherwise. An undefined mode
   /// type can be used to indicate a mode whose format is not (yet) known.
@@ -169,17 +244,86 @@ std::ostream& operator<<(std::ostream&, const ModeFormatPack&);
 extern const ModeFormat Dense;
 extern const ModeFormat Compressed;
 extern const ModeFormat Sparse;
+extern const ModeFormat Singleton;
+extern const ModeFormat Hashed;
+extern const ModeFormat Sliced;
+extern const ModeFormat Diagonal;
+extern const ModeFormat Offset;
+extern const ModeFormat Bitmap;
+extern const ModeFormat Permuted;
 
 extern const ModeFormat dense;
 extern const ModeFormat compressed;
 extern const ModeFormat sparse;
+extern const ModeFormat singleton;
+extern const ModeFormat hashed;
+extern const ModeFormat sliced;
+extern const ModeFormat diagonal;
+extern const ModeFormat offset;
+extern const ModeFormat bitmap;
+extern const ModeFormat permuted;
 
 extern const Format CSR;
 extern const Format CSC;
 extern const Format DCSR;
 extern const Format DCSC;
+
+/// Sorted coordinate format of the given order: a non-unique compressed level
+/// followed by singleton levels.
+Format COO(int order);
+
+/// Blocked CSR format, which stores the dense blockRows x blockCols blocks of a
+/// matrix that have nonzeros as a CSR matrix of blocks.
+Format BCSR(int blockRows, int blockCols);
+
+/// ELLPACK format, which stores the components of every row of a matrix
+/// column-major and padded to the length of its longest row, so that kernels
+/// process all rows in lockstep.
+Format ELL();
+
+/// Sliced ELLPACK (SELL-C-sigma) format, which sorts the rows of a matrix by
+/// their number of components within windows of sortWindow rows and stores
+/// slices of sliceHeight rows as ELLPACK matrices.
+Format SELL(int sliceHeight, int sortWindow=1);
+
+/// Diagonal format, which stores the offsets of the diagonals of a matrix that
+/// have nonzeros and the components of every such diagonal in a dense array,
+/// so that kernels compute the columns of components instead of loading them.
+Format DIA();
 /// @}
 
+/// Returns the format of the tensor of blocks stored by a blocked format.  Its
+/// modes are the block coordinates of the modes of the blocked format followed
+/// by their coordinates within blocks, and its levels are the levels of the
+/// blocked format followed by one dense level for the coordinates within
+/// blocks of every mode.
+Format getBlockTensorFormat(const Format& format);
+
+/// Returns the dimensions of the tensor of blocks stored by a blocked format.
+std::vector<int> getBlockTensorDimensions(const std::vector<int>& dimensions,
+                                          const Format& format);
+
+/// Returns the format of the tensor of slots stored by a sliced ELLPACK format.
+/// Its modes are the slices, the slots of slices, the rows within slices and
+/// the columns, stored in a dense, a sliced, a dense and a singleton level.
+Format getSliceTensorFormat(const Format& format);
+
+/// Returns the dimensions of the tensor of slots stored by a sliced ELLPACK
+/// format, whose slots are bounded by the number of columns.
+std::vector<int> getSliceTensorDimensions(const std::vector<int>& dimensions,
+                                          const Format& format);
+
+/// Returns the format of the tensor of diagonals stored by a diagonal format.
+/// Its modes are the diagonals, the rows and the columns, stored in a dense, a
+/// diagonal and an offset level.
+Format getDiagonalTensorFormat(const Format& format);
+
+/// Returns the dimensions of the tensor of diagonals stored by a diagonal
+/// format, whose number of diagonals is bounded by the number of diagonals of
+/// the matrix.
+std::vector<int> getDiagonalTensorDimensions(const std::vector<int>& dimensions,
+                                             const Format& format);
+
 /// True if all modes are dense.
 bool isDense(const Format&);
 
@@ -460,22 +460,69 @@ public:
 };
 
 
+/// How the iterations of a forall statement are distributed over threads.
+enum class ParallelStrategy {
+  /// The iterations are evaluated in order by one thread.
+  NotParallel,
+
+  /// The iterations are divided evenly between the threads up front.
+  Static,
+
+  /// The threads grab chunks of iterations as they finish earlier ones, which
+  /// balances the load when the work per iteration varies (e.g. the rows of
+  /// a sparse matrix).
+  Dynamic
+};
+
+/// Print a parallel strategy.
+std::ostream& operator<<(std::ostream&, const ParallelStrategy&);
+
+
+/// How a parallel forall combines the contributions of its iterations to the
+/// results that are not indexed by its index variable (reductions).
+enum class ReductionStrategy {
+  /// Scalar results and small tensor results are reduced from partial results
+  /// private to chunks of iterations, while larger tensor results are updated
+  /// atomically.  Atomic updates happen in a different order on every run, so
+  /// the rounding of floating-point results may differ between runs.
+  Fast,
+
+  /// All results are reduced from private partial results that are combined
+  /// in a fixed order, so the results are the same on every run and for any
+  /// number of threads.  This costs memory for the partial results of large
+  /// tensor results.
+  Deterministic
+};
+
+/// Print a reduction strategy.
+std::ostream& operator<<(std::ostream&, const ReductionStrategy&);
+
+
 /// A forall statement binds an index variable to values and evaluates the
-/// sub-statement for each of these values.
+/// sub-statement for each of these values.  The values may be evaluated in
+/// parallel if the forall has a parallel strategy (see `Parallelize`), in which
+/// case reductions over the index variable are combined with the forall's
+/// reduction strategy.
 class Forall : public IndexStmt {
 public:
   Forall() = default;
   Forall(const ForallNode*);
-  Forall(IndexVar indexVar, IndexStmt stmt);
+  Forall(IndexVar indexVar, IndexStmt stmt,
+         ParallelStrategy strategy=ParallelStrategy::NotParallel,
+         ReductionStrategy reduction=ReductionStrategy::Fast);
 
   IndexVar getIndexVar() const;
   IndexStmt getStmt() const;
+  ParallelStrategy getParallelStrategy() const;
+  ReductionStrategy getReductionStrategy() const;
 
   typedef ForallNode Node;
 };
 
 /// Create a forall index statement.
-Forall forall(IndexVar i, IndexStmt expr);
+Forall forall(IndexVar i, IndexStmt expr,
+              ParallelStrategy strategy=ParallelStrategy::NotParallel,
+              ReductionStrategy reduction=ReductionStrategy::Fast);
 
 
 /// A where statment has a producer statement that binds a tensor variable in
@@ -171,8 +171,11 @@ struct AssignmentNode : public IndexStmtNode {
 };
 
 struct ForallNode : public IndexStmtNode {
-  ForallNode(IndexVar indexVar, IndexStmt stmt)
-      : indexVar(indexVar), stmt(stmt) {}
+  ForallNode(IndexVar indexVar, IndexStmt stmt,
+             ParallelStrategy strategy=ParallelStrategy::NotParallel,
+             ReductionStrategy reduction=ReductionStrategy::Fast)
+      : indexVar(indexVar), stmt(stmt), strategy(strategy),
+        reduction(reduction) {}
 
   void accept(IndexStmtVisitorStrict* v) const {
     v->visit(this);
@@ -180,6 +183,8 @@ struct ForallNode : public IndexStmtNode {
 
   IndexVar indexVar;
   IndexStmt stmt;
+  ParallelStrategy strategy;
+  ReductionStrategy reduction;
 };
 
 struct WhereNode : public IndexStmtNode {
@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <memory>
+#include <future>
 
 namespace taco {
 
@@ -54,6 +55,13 @@ public:
   }
   /// @}
 
+  /// Execute the kernel to compute the component values of the results on
+  /// arguments that are already packed as `taco_tensor_t*` (see
+  /// `TensorStorage::operator taco_tensor_t*`), results first. This calls the
+  /// compiled function directly without allocating, so it is suited for
+  /// invoking the same kernel many times on small tensors.
+  bool computePacked(void** args) const;
+
   /// Check whether the kernel is defined.
   bool defined();
 
@@ -72,5 +80,12 @@ private:
 /// Compile a concrete index notation statement to a runnable kernel.
 Kernel compile(IndexStmt stmt);
 
+/// Compile a concrete index notation statement to a runnable kernel without
+/// waiting for the C compiler. The statement is lowered on the calling thread
+/// and compiled by a bounded pool of worker threads (see
+/// `ir::getCompilePool`). The returned future holds the kernel once it has
+/// been compiled.
+std::shared_future<Kernel> compileAsync(IndexStmt stmt);
+
 }
 #endif
@@ -11,10 +11,13 @@ class TensorVar;
 class IndexVar;
 class IndexExpr;
 class IndexStmt;
+enum class ParallelStrategy;
+enum class ReductionStrategy;
 
 class TransformationInterface;
 class Reorder;
 class Precompute;
+class Parallelize;
 
 /// A transformation is an optimization that transforms a statement in the
 /// concrete index notation into a new statement that computes the same result
@@ -24,6 +27,7 @@ class Transformation {
 public:
   Transformation(Reorder);
   Transformation(Precompute);
+  Transformation(Parallelize);
 
   IndexStmt apply(IndexStmt stmt, std::string* reason=nullptr) const;
 
@@ -94,5 +98,40 @@ private:
 /// Print a precompute command.
 std::ostream& operator<<(std::ostream&, const Precompute&);
 
+
+/// The parallelize optimization marks the forall of `i` to be evaluated by
+/// multiple threads with the given strategy.  The loop must not race on its
+/// results, so every result written in the loop must either be indexed by `i`
+/// or be reduced into (`+=`), the loop must not contain temporaries, and the
+/// result levels written by the loop must support insertion (this last
+/// condition is checked when lowering, as it depends on the result formats).
+/// Reductions over `i` are combined with the given reduction strategy.  Loops
+/// that merge several sparse operands are emitted as while loops and remain
+/// serial.
+class Parallelize : public TransformationInterface {
+public:
+  Parallelize(IndexVar i, ParallelStrategy strategy);
+  Parallelize(IndexVar i, ParallelStrategy strategy,
+              ReductionStrategy reduction);
+
+  IndexVar geti() const;
+  ParallelStrategy getStrategy() const;
+  ReductionStrategy getReductionStrategy() const;
+
+  /// Apply the parallelize optimization to a concrete index statement.
+  /// Returns an undefined statement and a reason if the loop over `i` could
+  /// race on its results.
+  IndexStmt apply(IndexStmt stmt, std::string* reason=nullptr) const;
+
+  void print(std::ostream& os) const;
+
+private:
+  struct Content;
+  std::shared_ptr<Content> content;
+};
+
+/// Print a parallelize command.
+std::ostream& operator<<(std::ostream&, const Parallelize&);
+
 }
 #endif
@@ -2,6 +2,7 @@
 #define TACO_IR_H
 
 #include <vector>
+#include <atomic>
 #include <typeinfo>
 
 #include "taco/type.h"
@@ -22,6 +23,8 @@ enum class IRNodeType {
   Var,
   Neg,
   Sqrt,
+  Popcount,
+  Ctz,
   Add,
   Sub,
   Mul,
@@ -31,6 +34,7 @@ enum class IRNodeType {
   Max,
   BitAnd,
   BitOr,
+  Shl,
   Not,
   Eq,
   Neq,
@@ -54,6 +58,7 @@ enum class IRNodeType {
   VarDecl,
   VarAssign,
   Allocate,
+  Free,
   Comment,
   BlankLine,
   Print,
@@ -82,12 +87,14 @@ struct IRNode : private util::Uncopyable {
    */
   virtual IRNodeType type_info() const = 0;
 
-  mutable long ref = 0;
+  /// The reference count is atomic, because kernels are compiled on worker
+  /// threads while other threads share their IR through the compile cache
+  mutable std::atomic<long> ref{0};
   friend void acquire(const IRNode* node) {
-    ++(node->ref);
+    node->ref.fetch_add(1, std::memory_order_relaxed);
   }
   friend void release(const IRNode* node) {
-    if (--(node->ref) == 0) {
+    if (node->ref.fetch_sub(1, std::memory_order_acq_rel) == 1) {
       delete node;
     }
   }
@@ -268,6 +275,26 @@ public:
   static const IRNodeType _type_info = IRNodeType::Sqrt;
 };
 
+/** The number of set bits of a 64-bit unsigned integer */
+struct Popcount : public ExprNode<Popcount> {
+public:
+  Expr a;
+
+  static Expr make(Expr a);
+
+  static const IRNodeType _type_info = IRNodeType::Popcount;
+};
+
+/** The number of trailing zero bits of a nonzero 64-bit unsigned integer */
+struct Ctz : public ExprNode<Ctz> {
+public:
+  Expr a;
+
+  static Expr make(Expr a);
+
+  static const IRNodeType _type_info = IRNodeType::Ctz;
+};
+
 /** Addition. */
 struct Add : public ExprNode<Add> {
 public:
@@ -375,6 +402,17 @@ public:
   static const IRNodeType _type_info = IRNodeType::BitOr;
 };
 
+/** Left shift: a << b */
+struct Shl : public ExprNode<Shl> {
+public:
+  Expr a;
+  Expr b;
+
+  static Expr make(Expr a, Expr b);
+
+  static const IRNodeType _type_info = IRNodeType::Shl;
+};
+
 /** Equality: a==b. */
 struct Eq : public ExprNode<Eq> {
 public:
@@ -525,8 +563,9 @@ public:
   Expr arr;
   Expr loc;
   Expr data;
+  bool use_atomics;
 
-  static Stmt make(Expr arr, Expr loc, Expr data);
+  static Stmt make(Expr arr, Expr loc, Expr data, bool use_atomics=false);
 
   static const IRNodeType _type_info = IRNodeType::Store;
 };
@@ -659,6 +698,16 @@ public:
   static const IRNodeType _type_info = IRNodeType::Allocate;
 };
 
+/** A Free node that frees the memory of a Var allocated with Allocate */
+struct Free : public StmtNode<Free> {
+public:
+  Expr var;
+
+  static Stmt make(Expr var);
+
+  static const IRNodeType _type_info = IRNodeType::Free;
+};
+
 /** A comment */
 struct Comment : public StmtNode<Comment> {
 public:
@@ -705,6 +754,10 @@ public:
   static Expr make(Expr tensor, TensorProperty property, int mode=0);
   static Expr make(Expr tensor, TensorProperty property, int mode,
                    int index, std::string name);
+
+  /// Get an index array whose elements are of the given type.
+  static Expr make(Expr tensor, TensorProperty property, int mode,
+                   int index, std::string name, Datatype type);
   
   static const IRNodeType _type_info = IRNodeType::GetProperty;
 };
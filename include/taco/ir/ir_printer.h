@@ -26,6 +26,8 @@ protected:
   virtual void visit(const Var*);
   virtual void visit(const Neg*);
   virtual void visit(const Sqrt*);
+  virtual void visit(const Popcount*);
+  virtual void visit(const Ctz*);
   virtual void visit(const Add*);
   virtual void visit(const Sub*);
   virtual void visit(const Mul*);
@@ -35,6 +37,7 @@ protected:
   virtual void visit(const Max*);
   virtual void visit(const BitAnd*);
   virtual void visit(const BitOr*);
+  virtual void visit(const Shl*);
   virtual void visit(const Eq*);
   virtual void visit(const Neq*);
   virtual void visit(const Gt*);
@@ -57,6 +60,7 @@ protected:
   virtual void visit(const VarDecl*);
   virtual void visit(const Assign*);
   virtual void visit(const Allocate*);
+  virtual void visit(const Free*);
   virtual void visit(const Comment*);
   virtual void visit(const BlankLine*);
   virtual void visit(const Print*);
@@ -78,6 +82,7 @@ protected:
     REM = 5,
     ADD = 6,
     SUB = 6,
+    SHL = 7,
     EQ = 10,
     GT = 9,
     LT = 9,
@@ -27,6 +27,8 @@ protected:
   virtual void visit(const Var* op);
   virtual void visit(const Neg* op);
   virtual void visit(const Sqrt* op);
+  virtual void visit(const Popcount* op);
+  virtual void visit(const Ctz* op);
   virtual void visit(const Add* op);
   virtual void visit(const Sub* op);
   virtual void visit(const Mul* op);
@@ -36,6 +38,7 @@ protected:
   virtual void visit(const Max* op);
   virtual void visit(const BitAnd* op);
   virtual void visit(const BitOr* op);
+  virtual void visit(const Shl* op);
   virtual void visit(const Eq* op);
   virtual void visit(const Neq* op);
   virtual void visit(const Gt* op);
@@ -58,6 +61,7 @@ protected:
   virtual void visit(const VarDecl* op);
   virtual void visit(const Assign* op);
   virtual void visit(const Allocate* op);
+  virtual void visit(const Free* op);
   virtual void visit(const Comment* op);
   virtual void visit(const BlankLine* op);
   virtual void visit(const Print* op);
@@ -7,6 +7,8 @@ struct Literal;
 struct Var;
 struct Neg;
 struct Sqrt;
+struct Popcount;
+struct Ctz;
 struct Add;
 struct Sub;
 struct Mul;
@@ -16,6 +18,7 @@ struct Min;
 struct Max;
 struct BitAnd;
 struct BitOr;
+struct Shl;
 struct Eq;
 struct Neq;
 struct Gt;
@@ -38,6 +41,7 @@ struct Function;
 struct VarDecl;
 struct Assign;
 struct Allocate;
+struct Free;
 struct Comment;
 struct BlankLine;
 struct Print;
@@ -51,6 +55,8 @@ public:
   virtual void visit(const Var*) = 0;
   virtual void visit(const Neg*) = 0;
   virtual void visit(const Sqrt*) = 0;
+  virtual void visit(const Popcount*) = 0;
+  virtual void visit(const Ctz*) = 0;
   virtual void visit(const Add*) = 0;
   virtual void visit(const Sub*) = 0;
   virtual void visit(const Mul*) = 0;
@@ -60,6 +66,7 @@ public:
   virtual void visit(const Max*) = 0;
   virtual void visit(const BitAnd*) = 0;
   virtual void visit(const BitOr*) = 0;
+  virtual void visit(const Shl*) = 0;
   virtual void visit(const Eq*) = 0;
   virtual void visit(const Neq*) = 0;
   virtual void visit(const Gt*) = 0;
@@ -82,6 +89,7 @@ public:
   virtual void visit(const VarDecl*) = 0;
   virtual void visit(const Assign*) = 0;
   virtual void visit(const Allocate*) = 0;
+  virtual void visit(const Free*) = 0;
   virtual void visit(const Comment*) = 0;
   virtual void visit(const BlankLine*) = 0;
   virtual void visit(const Print*) = 0;
@@ -98,6 +106,8 @@ public:
   virtual void visit(const Var* op);
   virtual void visit(const Neg* op);
   virtual void visit(const Sqrt* op);
+  virtual void visit(const Popcount* op);
+  virtual void visit(const Ctz* op);
   virtual void visit(const Add* op);
   virtual void visit(const Sub* op);
   virtual void visit(const Mul* op);
@@ -107,6 +117,7 @@ public:
   virtual void visit(const Max* op);
   virtual void visit(const BitAnd* op);
   virtual void visit(const BitOr* op);
+  virtual void visit(const Shl* op);
   virtual void visit(const Eq* op);
   virtual void visit(const Neq* op);
   virtual void visit(const Gt* op);
@@ -129,6 +140,7 @@ public:
   virtual void visit(const VarDecl* op);
   virtual void visit(const Assign* op);
   virtual void visit(const Allocate* op);
+  virtual void visit(const Free* op);
   virtual void visit(const Comment* op);
   virtual void visit(const BlankLine* op);
   virtual void visit(const Print* op);
@@ -32,15 +32,18 @@ public:
   /// Construct an undefind iterator.
   Iterator();
 
-  /// Construct a dimension iterator.
-  Iterator(IndexVar indexVar);
+  /// Construct a dimension iterator whose coordinate variable has type
+  /// coordType.
+  Iterator(IndexVar indexVar, Datatype coordType=Int());
 
   /// Construct a root iterator.
   Iterator(ir::Expr tensorVar);
 
-  /// Construct a non-root iterator.
+  /// Construct a non-root iterator whose position variables have type posType
+  /// and whose coordinate variable has type coordType.
   Iterator(IndexVar indexVar, ir::Expr tensor, Mode mode, Iterator parent,
-           std::string name);
+           std::string name, Datatype posType=Int(),
+           Datatype coordType=Int());
 
   /// Get the parent of this iterator in its iterator list.
   const Iterator& getParent() const;
@@ -65,6 +68,7 @@ public:
   bool hasLocate() const;
   bool hasInsert() const;
   bool hasAppend() const;
+  bool hasWordIter() const;
 
 
   /// Returns the tensor this iterator is iterating over.
@@ -111,8 +115,15 @@ public:
   /// Return code for level functions that implement coordinate position  
   /// iteration.
   ModeFunction posBounds() const;
+  ModeFunction posBounds(const ir::Expr& parentPos) const;
   ModeFunction posAccess(const std::vector<ir::Expr>& coords) const;
+  ModeFunction posAccess(const ir::Expr& pos,
+                         const std::vector<ir::Expr>& coords) const;
   
+  /// Return code for level functions that implement word iteration.
+  ModeFunction wordBounds() const;
+  ModeFunction wordAccess(const ir::Expr& word) const;
+
   /// Returns code for level function that implements locate capability.
   ModeFunction locate(const std::vector<ir::Expr>& coords) const;
 
@@ -120,6 +131,7 @@ public:
   ir::Stmt getInsertCoord(const ir::Expr& p,
                           const std::vector<ir::Expr>& i) const;
   ir::Expr getSize() const;
+  ir::Expr getNumPositions(const ir::Expr& szPrev) const;
   ir::Stmt getInsertInitCoords(const ir::Expr& pBegin, 
                                const ir::Expr& pEnd) const;
   ir::Stmt getInsertInitLevel(const ir::Expr& szPrev, const ir::Expr& sz) const;
@@ -135,6 +147,7 @@ public:
   ir::Stmt getAppendInitLevel(const ir::Expr& szPrev, const ir::Expr& sz) const;
   ir::Stmt getAppendFinalizeLevel(const ir::Expr& szPrev, 
       const ir::Expr& sz) const;
+  ir::Stmt getAppendReserveCoords(const ir::Expr& sz) const;
 
   /// Returns true if the iterator is defined, false otherwise.
   bool defined() const;
@@ -147,7 +160,8 @@ public:
   /// Construct an iterator from an tensor path.
   /// @deprecated
   Iterator(const old::TensorPath& path, std::string coordVarName,
-           const ir::Expr& tensor, Mode mode, Iterator parent);
+           const ir::Expr& tensor, Mode mode, Iterator parent,
+           Datatype posType=Int(), Datatype coordType=Int());
 
   /// Get the tensor path this iterator list iterates over.
   /// @deprecated
@@ -63,7 +63,12 @@ enum Property {
   Compute,
   Print,
   Comment,
-  Accumulate  /// Accumulate into the result (+=)
+  Accumulate,  /// Accumulate into the result (+=)
+  ParallelAssemble, /// Assemble sparse results with parallel count/fill passes
+  ParallelReduce,   /// Compute reductions over the root loop in parallel
+  DeterministicReduce, /// Compute parallel reductions without atomics
+  SymbolicAssemble, /// Count result coordinates before allocating the indices
+  UnrollBlocks      /// Fully unroll the loops over coordinates within blocks
 };
 
 /// Lower the tensor object with a defined expression and an iteration schedule
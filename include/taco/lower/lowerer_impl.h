@@ -5,6 +5,7 @@
 #include <map>
 #include <set>
 #include <memory>
+#include <functional>
 #include "taco/lower/iterator.h"
 #include "taco/util/uncopyable.h"
 
@@ -37,6 +38,7 @@ class ModeAccess;
 namespace ir {
 class Stmt;
 class Expr;
+enum class LoopKind;
 }
 
 class LowererImpl : public util::Uncopyable {
@@ -56,6 +58,42 @@ protected:
   /// Lower a forall statement.
   virtual ir::Stmt lowerForall(Forall forall);
 
+  /// Retrieve the kind of loop to emit for a forall.  Parallel foralls are
+  /// checked to not race on the results they write.
+  ir::LoopKind getLoopKind(Forall forall);
+
+  /// Check whether a forall is a parallel loop that computes reductions into
+  /// results that are not indexed by its index variable.
+  bool isParallelReduction(Forall forall) const;
+
+  /**
+   * Lower a parallel forall that reduces into some of its results.  The
+   * iterations in [begin, end) are split into a fixed number of chunks that
+   * are evaluated in parallel.  Each chunk reduces into private partial
+   * results, which are combined in chunk order after the loop.  Tensor results
+   * whose components are written by the loop body are instead updated with
+   * atomics when the forall's reduction strategy allows it and the result is
+   * too large to privatize per chunk.
+   *
+   * \param forall
+   *      The parallel reduction forall.
+   * \param coordinate
+   *      The IR variable the forall iterates over (a coordinate or position).
+   * \param begin
+   *      The first value of the iteration variable.
+   * \param end
+   *      One past the last value of the iteration variable.
+   * \param lowerBody
+   *      A function that lowers the loop body.  It is called once for each
+   *      version of the loop that is emitted.
+   *
+   * \return
+   *      IR code to compute the forall loop.
+   */
+  ir::Stmt lowerParallelReduction(Forall forall, ir::Expr coordinate,
+                                  ir::Expr begin, ir::Expr end,
+                                  std::function<ir::Stmt()> lowerBody);
+
   /// Lower a forall that iterates over all the coordinates in the forall index
   /// var's dimension, and locates tensor positions from the locate iterators.
   virtual ir::Stmt lowerForallDimension(Forall forall,
@@ -297,6 +335,23 @@ private:
   /// Map from iterators to the index variables they contribute to.
   std::map<Iterator, IndexVar> indexVars;
 
+  /// Results whose value arrays have been allocated and/or initialized.
+  std::set<TensorVar> initializedValues;
+
+  /// Whether the code being lowered is nested in a parallel loop.
+  bool inParallelLoop;
+
+  /// Map from results that an enclosing parallel forall reduces into the same
+  /// component of in every iteration, to private partial result variables.
+  std::map<TensorVar, ir::Expr> partialResults;
+
+  /// Map from results reduced into by an enclosing parallel forall to private
+  /// copies of their value arrays and the offset of the current chunk's copy.
+  std::map<TensorVar, std::pair<ir::Expr,ir::Expr>> privateValues;
+
+  /// Results reduced into by an enclosing parallel forall with atomics.
+  std::set<TensorVar> atomicResults;
+
   class Visitor;
   friend class Visitor;
   std::shared_ptr<Visitor> visitor;
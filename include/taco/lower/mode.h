@@ -2,6 +2,7 @@
 #define TACO_MODE_H
 
 #include <string>
+#include <vector>
 
 #include "taco/format.h"
 
@@ -75,6 +76,11 @@ public:
   ModePack();
   ModePack(size_t numModes, ModeFormat modeType, ir::Expr tensor, int mode);
 
+  /// Construct a mode pack whose index arrays have the given element types
+  /// (e.g. the level's array types in the tensor format).
+  ModePack(size_t numModes, ModeFormat modeType, ir::Expr tensor, int mode,
+           const std::vector<Datatype>& arrayTypes);
+
   /// Returns number of tensor modes belonging to mode pack.
   size_t getNumModes() const;
 
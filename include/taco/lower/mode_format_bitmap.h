@@ -0,0 +1,45 @@
+#ifndef TACO_MODE_FORMAT_BITMAP_H
+#define TACO_MODE_FORMAT_BITMAP_H
+
+#include "taco/lower/mode_format_impl.h"
+
+namespace taco {
+
+/// A bitmap level stores the coordinates of every parent position as one bit
+/// per coordinate, in a bits array of 64-bit words, and the position of the
+/// first coordinate stored in every word in a pos array.  The position of a
+/// coordinate is the position of its word plus the number of lower bits set in
+/// the word, so components are packed without storing their coordinates.
+class BitmapModeFormat : public ModeFormatImpl {
+public:
+  BitmapModeFormat();
+
+  virtual ~BitmapModeFormat() {}
+
+  virtual ModeFormat copy(std::vector<ModeFormat::Property> properties) const;
+
+  virtual ModeFunction coordIterBounds(std::vector<ir::Expr> parentCoords,
+                                       Mode mode) const;
+  virtual ModeFunction coordIterAccess(ir::Expr parentPos,
+                                       std::vector<ir::Expr> coords,
+                                       Mode mode) const;
+
+  virtual ModeFunction locate(ir::Expr parentPos,
+                              std::vector<ir::Expr> coords,
+                              Mode mode) const;
+
+  virtual ModeFunction wordIterBounds(ir::Expr parentPos, Mode mode) const;
+  virtual ModeFunction wordIterAccess(ir::Expr parentPos, ir::Expr word,
+                                      Mode mode) const;
+
+  virtual std::vector<ir::Expr> getArrays(ir::Expr tensor, int mode) const;
+
+protected:
+  ir::Expr getPosArray(ModePack pack) const;
+  ir::Expr getBitsArray(ModePack pack) const;
+  ir::Expr getNumWords(ModePack pack) const;
+};
+
+}
+
+#endif
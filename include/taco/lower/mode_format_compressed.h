@@ -29,6 +29,7 @@ public:
       ir::Expr sz, Mode mode) const;
   virtual ir::Stmt getAppendFinalizeLevel(ir::Expr szPrev, 
       ir::Expr sz, Mode mode) const;
+  virtual ir::Stmt getAppendReserveCoords(ir::Expr sz, Mode mode) const;
 
   virtual std::vector<ir::Expr> getArrays(ir::Expr tensor, int mode) const;
 
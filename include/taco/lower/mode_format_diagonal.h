@@ -0,0 +1,36 @@
+#ifndef TACO_MODE_FORMAT_DIAGONAL_H
+#define TACO_MODE_FORMAT_DIAGONAL_H
+
+#include "taco/lower/mode_format_impl.h"
+
+namespace taco {
+
+/// A diagonal level stores the rows of a diagonal of a matrix whose offset is
+/// the coordinate of its parent level.  Its coordinates are the rows the
+/// diagonal crosses, which are computed from the offset and the dimensions
+/// without loading coordinates, and every diagonal has a position per row.
+class DiagonalModeFormat : public ModeFormatImpl {
+public:
+  DiagonalModeFormat();
+
+  virtual ~DiagonalModeFormat() {}
+
+  virtual ModeFormat copy(std::vector<ModeFormat::Property> properties) const;
+
+  virtual ModeFunction coordIterBounds(std::vector<ir::Expr> parentCoords,
+                                       Mode mode) const;
+  virtual ModeFunction coordIterAccess(ir::Expr parentPos,
+                                       std::vector<ir::Expr> coords,
+                                       Mode mode) const;
+
+  virtual std::vector<ir::Expr> getArrays(ir::Expr tensor, int mode) const;
+
+protected:
+  ir::Expr getNumRows(ModePack pack) const;
+  ir::Expr getOffsetArray(ModePack pack) const;
+  ir::Expr getNumColumns(ModePack pack) const;
+};
+
+}
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef TACO_MODE_FORMAT_HASHED_H
+#define TACO_MODE_FORMAT_HASHED_H
+
+#include "taco/lower/mode_format_impl.h"
+
+namespace taco {
+
+/// A hashed level stores the coordinates of every parent position in an open
+/// addressing hash table of fixed width, stored in a size array that holds the
+/// table width and a crd array that holds the buckets of all tables (-1 marks
+/// empty buckets).  The position of a coordinate is the position of its
+/// bucket, which is found by linear probing from the coordinate modulo the
+/// table width.
+class HashedModeFormat : public ModeFormatImpl {
+public:
+  HashedModeFormat();
+  HashedModeFormat(bool isFull, bool isUnique);
+
+  virtual ~HashedModeFormat() {}
+
+  virtual ModeFormat copy(std::vector<ModeFormat::Property> properties) const;
+
+  virtual ModeFunction posIterBounds(ir::Expr parentPos, Mode mode) const;
+  virtual ModeFunction posIterAccess(ir::Expr pos, std::vector<ir::Expr> coords,
+                                     Mode mode) const;
+
+  virtual ModeFunction locate(ir::Expr parentPos,
+                              std::vector<ir::Expr> coords,
+                              Mode mode) const;
+
+  virtual ir::Stmt getInsertCoord(ir::Expr p,
+      const std::vector<ir::Expr>& i, Mode mode) const;
+  virtual ir::Expr getSize(Mode mode) const;
+  virtual ir::Stmt getInsertInitCoords(ir::Expr pBegin,
+      ir::Expr pEnd, Mode mode) const;
+  virtual ir::Stmt getInsertInitLevel(ir::Expr szPrev,
+      ir::Expr sz, Mode mode) const;
+  virtual ir::Stmt getInsertFinalizeLevel(ir::Expr szPrev,
+      ir::Expr sz, Mode mode) const;
+
+  virtual std::vector<ir::Expr> getArrays(ir::Expr tensor, int mode) const;
+
+protected:
+  ir::Expr getSizeArray(ModePack pack) const;
+  ir::Expr getCoordArray(ModePack pack) const;
+};
+
+}
+
+#endif
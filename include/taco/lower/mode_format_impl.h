@@ -66,7 +66,7 @@ public:
   ModeFormatImpl(std::string name, bool isFull, bool isOrdered,
                  bool isUnique, bool isBranchless, bool isCompact,
                  bool hasCoordValIter, bool hasCoordPosIter, bool hasLocate,
-                 bool hasInsert, bool hasAppend);
+                 bool hasInsert, bool hasAppend, bool hasWordIter=false);
 
   virtual ~ModeFormatImpl();
 
@@ -109,6 +109,21 @@ public:
                               Mode mode) const;
 
 
+  /// The word iteration capability's iterator function computes a range
+  /// [result[0], result[1]) of 64-bit words to iterate over, where the set
+  /// bits of word w mark the stored coordinates 64w to 64w+63.
+  /// `word_iter_bounds(p_{k−1}) -> begin_{k}, end_{k}`
+  virtual ModeFunction wordIterBounds(ir::Expr parentPos, Mode mode) const;
+
+  /// The word iteration capability's access function maps a word iterator
+  /// variable to the word (result[0]) and to the position of the first
+  /// coordinate stored in the word (result[1]).  The position of a coordinate
+  /// is the position of the word plus the number of lower bits set in it.
+  /// `word_iter_access(p_{k−1}, w_{k}) -> bits_{k}, p_{k}`
+  virtual ModeFunction wordIterAccess(ir::Expr parentPos, ir::Expr word,
+                                      Mode mode) const;
+
+
   /// Level functions that implement insert capabilitiy.
   /// @{
   virtual ir::Stmt
@@ -116,6 +131,11 @@ public:
 
   virtual ir::Expr getSize(Mode mode) const;
 
+  /// Returns the number of positions of the level given the number of
+  /// positions of its parent level, which is `getSize` positions for every
+  /// parent position unless the level overrides it.
+  virtual ir::Expr getNumPositions(ir::Expr szPrev, Mode mode) const;
+
   virtual ir::Stmt
   getInsertInitCoords(ir::Expr pBegin, ir::Expr pEnd, Mode mode) const;
 
@@ -139,11 +159,18 @@ public:
   virtual ir::Stmt
   getAppendInitEdges(ir::Expr pPrevBegin, ir::Expr pPrevEnd, Mode mode) const;
 
+  /// Initialize the level.  `sz` is the number of coordinates to allocate
+  /// room for (e.g. counted by a symbolic pass), or zero if it is unknown.
   virtual ir::Stmt
   getAppendInitLevel(ir::Expr szPrev, ir::Expr sz, Mode mode) const;
 
   virtual ir::Stmt
   getAppendFinalizeLevel(ir::Expr szPrev, ir::Expr sz, Mode mode) const;
+
+  /// Resize the coordinate storage of the level to hold exactly `sz`
+  /// coordinates, when the number of coordinates is known before appending.
+  virtual ir::Stmt
+  getAppendReserveCoords(ir::Expr sz, Mode mode) const;
   /// @}
 
   /// Returns arrays associated with a tensor mode
@@ -163,6 +190,7 @@ public:
   const bool hasLocate;
   const bool hasInsert;
   const bool hasAppend;
+  const bool hasWordIter;
 };
 
 static const int DEFAULT_ALLOC_SIZE = 1 << 20;
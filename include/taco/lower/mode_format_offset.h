@@ -0,0 +1,31 @@
+#ifndef TACO_MODE_FORMAT_OFFSET_H
+#define TACO_MODE_FORMAT_OFFSET_H
+
+#include "taco/lower/mode_format_impl.h"
+
+namespace taco {
+
+/// An offset level stores the column of every position of a diagonal level,
+/// which is the row of the position plus the offset of its diagonal, so that
+/// it stores only the offsets of the diagonals and loads no coordinates.
+class OffsetModeFormat : public ModeFormatImpl {
+public:
+  OffsetModeFormat();
+
+  virtual ~OffsetModeFormat() {}
+
+  virtual ModeFormat copy(std::vector<ModeFormat::Property> properties) const;
+
+  virtual ModeFunction posIterBounds(ir::Expr parentPos, Mode mode) const;
+  virtual ModeFunction posIterAccess(ir::Expr pos, std::vector<ir::Expr> coords,
+                                     Mode mode) const;
+
+  virtual std::vector<ir::Expr> getArrays(ir::Expr tensor, int mode) const;
+
+protected:
+  ir::Expr getOffsetArray(ModePack pack) const;
+};
+
+}
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef TACO_MODE_FORMAT_PERMUTED_H
+#define TACO_MODE_FORMAT_PERMUTED_H
+
+#include "taco/lower/mode_format_impl.h"
+
+namespace taco {
+
+/// A permuted level stores the rows of a dense level in the order of the rows
+/// of a sliced ELLPACK matrix, so that the kernels that multiply it see the
+/// rows of every slice as the coordinates of the level.  Its rows array holds
+/// the row of every coordinate, or -1 for coordinates that pad the last slice,
+/// and its size array holds the number of rows.
+class PermutedModeFormat : public ModeFormatImpl {
+public:
+  PermutedModeFormat();
+
+  virtual ~PermutedModeFormat() {}
+
+  virtual ModeFormat copy(std::vector<ModeFormat::Property> properties) const;
+
+  virtual ModeFunction coordIterBounds(std::vector<ir::Expr> parentCoords,
+                                       Mode mode) const;
+  virtual ModeFunction coordIterAccess(ir::Expr parentPos,
+                                       std::vector<ir::Expr> coords,
+                                       Mode mode) const;
+
+  virtual ModeFunction locate(ir::Expr parentPos,
+                              std::vector<ir::Expr> coords,
+                              Mode mode) const;
+
+  virtual ir::Expr getSize(Mode mode) const;
+  virtual ir::Expr getNumPositions(ir::Expr szPrev, Mode mode) const;
+
+  virtual std::vector<ir::Expr> getArrays(ir::Expr tensor, int mode) const;
+
+protected:
+  ir::Expr getSliceHeight(ModePack pack) const;
+  ir::Expr getSizeArray(ModePack pack) const;
+  ir::Expr getRowsArray(ModePack pack) const;
+};
+
+}
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef TACO_MODE_FORMAT_SLICED_H
+#define TACO_MODE_FORMAT_SLICED_H
+
+#include "taco/lower/mode_format_impl.h"
+
+namespace taco {
+
+/// A sliced level stores the slots of the slices of a sliced ELLPACK matrix,
+/// where every slice of rows stores as many slots as its longest row has
+/// components.  Its pos array holds the first slot of every slice, and the
+/// coordinates of the slots are their positions.
+class SlicedModeFormat : public ModeFormatImpl {
+public:
+  SlicedModeFormat();
+
+  virtual ~SlicedModeFormat() {}
+
+  virtual ModeFormat copy(std::vector<ModeFormat::Property> properties) const;
+
+  virtual ModeFunction posIterBounds(ir::Expr parentPos, Mode mode) const;
+  virtual ModeFunction posIterAccess(ir::Expr pos, std::vector<ir::Expr> coords,
+                                     Mode mode) const;
+
+  virtual std::vector<ir::Expr> getArrays(ir::Expr tensor, int mode) const;
+
+protected:
+  ir::Expr getPosArray(ModePack pack) const;
+};
+
+}
+
+#endif
@@ -8,6 +8,9 @@
 #include "taco/util/collections.h"
 
 namespace taco {
+namespace util {
+class MappedFile;
+}
 
 /// An array is a smart pointer to raw memory together with an element type,
 /// a size (number of elements) and a reclamation policy.
@@ -16,7 +19,9 @@ public:
   /// The memory reclamation policy of Array objects. UserOwns means the Array
   /// object will not free its data, free means it will reclaim data  with the
   /// C free function and delete means it will reclaim data with delete[].
-  enum Policy {UserOwns, Free, Delete};
+  /// Mapped means the data is a region of a mapped file, which the Array
+  /// object keeps mapped until it and the other arrays in the file are gone.
+  enum Policy {UserOwns, Free, Delete, Mapped};
 
   /// Construct an empty array of undefined elements.
   Array();
@@ -24,6 +29,11 @@ public:
   /// Construct an array of elements of the given type.
   Array(Datatype type, void* data, size_t size, Policy policy=Free);
 
+  /// Construct an array of elements of the given type that are stored in a
+  /// region of a mapped file, with the Mapped policy.
+  Array(Datatype type, void* data, size_t size,
+        std::shared_ptr<const util::MappedFile> file);
+
   /// Returns the type of the array elements
   const Datatype& getType() const;
 
@@ -0,0 +1,70 @@
+/// Read and write the taco binary format, which stores the packed storage of a
+/// tensor verbatim: its format, its dimensions and its index and value arrays.
+/// Files are read by mapping them into memory and using the arrays in place,
+/// so reading costs the same for any number of components, and processes that
+/// read the same file share its pages.
+
+#ifndef TACO_FILE_IO_BIN_H
+#define TACO_FILE_IO_BIN_H
+
+#include <istream>
+#include <ostream>
+#include <string>
+
+#include "taco/format.h"
+#include "taco/storage/storage.h"
+
+namespace taco {
+class TensorBase;
+class Format;
+
+/// Read a binary tensor from a file.  The arrays of tensors that are read in
+/// the format they were written in are mapped from the file, and tensors that
+/// are read in any other format are repacked.
+TensorBase readBinary(std::string filename, const ModeFormat& modetype,
+                      bool pack=true);
+
+/// Read a binary tensor from a file.
+TensorBase readBinary(std::string filename, const Format& format,
+                      bool pack=true);
+
+/// Read a binary tensor from a stream.  The arrays are copied from the stream.
+TensorBase readBinary(std::istream& stream, const ModeFormat& modetype,
+                      bool pack=true);
+
+/// Read a binary tensor from a stream.
+TensorBase readBinary(std::istream& stream, const Format& format,
+                      bool pack=true);
+
+/// Read a binary tensor from a file in the format it was written in.
+TensorStorage readToStorageBinary(std::string filename);
+
+/// Read a binary tensor from a file.
+TensorStorage readToStorageBinary(std::string filename,
+                                  const ModeFormat& modetype);
+
+/// Read a binary tensor from a file.
+TensorStorage readToStorageBinary(std::string filename, const Format& format);
+
+/// Read a binary tensor from a stream.
+TensorStorage readToStorageBinary(std::istream& stream,
+                                  const ModeFormat& modetype);
+
+/// Read a binary tensor from a stream.
+TensorStorage readToStorageBinary(std::istream& stream, const Format& format);
+
+/// Write a packed tensor to a binary file.
+void writeBinary(std::string filename, const TensorBase& tensor);
+
+/// Write a packed tensor to a binary stream.
+void writeBinary(std::ostream& stream, const TensorBase& tensor);
+
+/// Write tensor storage to a binary file.
+void writeFromStorageBinary(std::string filename, const TensorStorage& storage);
+
+/// Write tensor storage to a binary stream.
+void writeFromStorageBinary(std::ostream& stream, const TensorStorage& storage);
+
+}
+
+#endif
@@ -49,7 +49,9 @@ void writeRHS();
 TensorBase readRB(std::string filename, const ModeFormat& modetype, 
                   bool pack=true);
 
-/// Read an rb matrix from a file.
+/// Read an rb matrix from a file.  The file is parsed in parallel into the
+/// arrays of a CSC matrix, which CSC matrices use as is and CSR matrices
+/// transpose.  Matrices in other formats are packed from their coordinates.
 TensorBase readRB(std::string filename, const Format& format, bool pack=true);
 
 /// Read an rb matrix from a stream
@@ -21,6 +21,51 @@ namespace ir {
 class Stmt;
 }
 
+/// How packing resolves components that are inserted at the same coordinate
+/// more than once.
+enum class DuplicatePolicy {
+  /// Keep the component that was inserted first (and warn).
+  First,
+
+  /// Keep the component that was inserted last.
+  Last,
+
+  /// Keep the sum of the components.
+  Sum,
+
+  /// Report an error.
+  Error
+};
+
+/// A batch of components to pack.  The components are stored either
+/// interleaved, as the coordinates of each component (one int per mode, in
+/// mode order) followed by its value, or as one coordinate array per mode and
+/// a value array.
+struct ComponentBatch {
+  /// The interleaved components (nullptr if stored as arrays)
+  const char* components = nullptr;
+
+  /// The coordinate arrays and value array
+  std::vector<const int*> coordinates;
+  const char* values = nullptr;
+
+  /// The number of components
+  size_t size = 0;
+};
+
+/// Pack batches of components into a format.  The components may be in any
+/// order and are sorted in parallel, and components with the same coordinate
+/// are merged according to `duplicates`, where the components of earlier
+/// batches count as inserted first.
+TensorStorage pack(Datatype                           componentType,
+                   const std::vector<int>&            dimensions,
+                   const Format&                      format,
+                   const std::vector<ComponentBatch>& batches,
+                   DuplicatePolicy duplicates=DuplicatePolicy::First);
+
+/// Pack tensor coordinates into a format. The coordinates must be stored as a
+/// structure of arrays, that is one vector per level coordinate and one vector
+/// for the values. The coordinates must be sorted lexicographically.
 TensorStorage pack(Datatype                             datatype,
                    const std::vector<int>&              dimensions,
                    const Format&                        format,
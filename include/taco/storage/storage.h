@@ -3,6 +3,8 @@
 
 #include <vector>
 #include <memory>
+#include <algorithm>
+#include <complex>
 
 #include "taco/format.h"
 #include "taco/storage/index.h"
@@ -19,6 +21,21 @@ class Datatype;
 class Index;
 class Array;
 
+/// Returns the component at position pos of a split complex value array of
+/// size components, which stores their real parts followed by their imaginary
+/// parts.  Only complex values can be split.
+template <typename T>
+T getSplitComplexValue(const T* values, size_t size, size_t pos) {
+  return values[pos];
+}
+
+template <typename T>
+std::complex<T> getSplitComplexValue(const std::complex<T>* values,
+                                     size_t size, size_t pos) {
+  const T* parts = (const T*)values;
+  return std::complex<T>(parts[pos], parts[size + pos]);
+}
+
 /// Storage for a tensor object.  Tensor storage consists of a value array that
 /// contains the tensor values and one index per mode.  The type of each
 /// mode index is determined by the mode type in the format, and the
@@ -115,36 +132,121 @@ public:
 
     const_iterator(const TensorStorage* storage, bool isEnd = false) :
         storage(storage),
-        coord(TypedIndexVector(type<T>(), storage->getOrder())),
-        ptrs(TypedIndexVector(type<T>(), storage->getOrder())),
+        coord(TypedIndexVector(type<T>(),
+                               storage->getIndex().getFormat().getOrder())),
+        ptrs(TypedIndexVector(type<T>(),
+                              storage->getIndex().getFormat().getOrder())),
         curVal({std::vector<T>(storage->getOrder()), 0}),
         count(1 + (size_t)isEnd * storage->getIndex().getSize()),
-        advance(false) {
+        advance(false), blockOffset(0) {
       advanceIndex();
     }
 
+    CType getValue(size_t pos) const {
+      // Pattern formats store no values, as all their components are one
+      if (storage->getFormat().isPattern()) {
+        return (CType)1;
+      }
+      const Array& values = storage->getValues();
+      if (storage->getFormat().isSplitComplex()) {
+        return getSplitComplexValue((const CType*)values.getData(),
+                                    values.getSize(), pos);
+      }
+      return ((CType *)values.getData())[pos];
+    }
+
     void advanceIndex() {
-      advanceIndex(0);
-      ++count;
+      // Levels may skip positions that store no component (e.g. the empty
+      // buckets of hashed levels), so the end is found by exhausting the index
+      if (advanceIndex(0)) {
+        ++count;
+      } else {
+        count = 2 + storage->getIndex().getSize();
+      }
     }
 
     bool advanceIndex(int lvl) {
-      const auto& modeTypes = storage->getFormat().getModeFormats();
+      const auto& modeTypes = storage->getIndex().getFormat().getModeFormats();
       const auto& modeOrdering = storage->getFormat().getModeOrdering();
 
-      if (lvl == storage->getOrder()) {
+      // The slots of sliced ELLPACK matrices are stored in the slices, slots,
+      // rows within slices and columns levels of their tensors of slots
+      if (storage->getFormat().isSliced() &&
+          lvl == storage->getIndex().getFormat().getOrder()) {
+        if (advance) {
+          advance = false;
+          return false;
+        }
+
+        const auto& pos = storage->getIndex().getModeIndex(1).getIndexArray(0);
+        const auto rows = storage->getIndex().getModeIndex(2);
+        const size_t sliceHeight = rows.getIndexArray(0).get(0).getAsIndex();
+        const size_t row = coord[0].getAsIndex() * sliceHeight +
+                           coord[2].getAsIndex();
+        const size_t slot = ptrs[1].getAsIndex() -
+            pos.get((int)coord[0].getAsIndex()).getAsIndex();
+
+        // Rows store padding after their components
+        if (slot >= rows.getIndexArray(2).get((int)row).getAsIndex()) {
+          return false;
+        }
+
+        curVal.second = getValue(ptrs[lvl - 1].getAsIndex());
+        curVal.first[0] = (T)rows.getIndexArray(1).get((int)row).getAsIndex();
+        curVal.first[1] = (T)coord[3].getAsIndex();
+
+        advance = true;
+        return true;
+      }
+
+      // The components of diagonal matrices are stored in the diagonals, rows
+      // and columns levels of their tensors of diagonals
+      if (storage->getFormat().isDiagonal() &&
+          lvl == storage->getIndex().getFormat().getOrder()) {
         if (advance) {
           advance = false;
           return false;
         }
+        curVal.second = getValue(ptrs[lvl - 1].getAsIndex());
+        curVal.first[0] = (T)coord[1].getAsIndex();
+        curVal.first[1] = (T)coord[2].getAsIndex();
+        advance = true;
+        return true;
+      }
+
+      if (lvl == storage->getOrder() && !storage->getFormat().isSliced() &&
+          !storage->getFormat().isDiagonal()) {
+        // Every position of the last level of a blocked format stores a
+        // row-major block of components, which are visited in order
+        const auto& blockSizes = storage->getFormat().getBlockSizes();
+        size_t blockVolume = 1;
+        for (int blockSize : blockSizes) {
+          blockVolume *= blockSize;
+        }
+
+        if (advance) {
+          advance = false;
+          if (++blockOffset == blockVolume) {
+            blockOffset = 0;
+            return false;
+          }
+        }
 
         const TypedIndexVal idx = (lvl == 0) ? TypedIndexVal(type<T>(), 0) : ptrs[lvl - 1];
-        curVal.second = ((CType *)storage->getValues().getData())[idx.getAsIndex()];
+        curVal.second = getValue(idx.getAsIndex() * blockVolume +
+                                blockOffset);
 
         for (int i = 0; i < lvl; ++i) {
           const size_t mode = modeOrdering[i];
           curVal.first[mode] = (T)coord[i].getAsIndex();
         }
+        size_t offset = blockOffset;
+        for (int i = (int)blockSizes.size(); i-- > 0;) {
+          const size_t mode = modeOrdering[i];
+          curVal.first[mode] = curVal.first[mode] * blockSizes[mode] +
+                               offset % blockSizes[mode];
+          offset /= blockSizes[mode];
+        }
 
         advance = true;
         return true;
@@ -170,9 +272,11 @@ public:
             return true;
           }
         }
-      } else if (modeTypes[lvl] == Sparse) {
+      } else if (modeTypes[lvl].getName() == Compressed.getName() ||
+                 modeTypes[lvl].getName() == Sliced.getName()) {
+        // The coordinates of sliced levels are their positions
+        const bool isSliced = (modeTypes[lvl].getName() == Sliced.getName());
         const auto& pos = modeIndex.getIndexArray(0);
-        const auto& idx = modeIndex.getIndexArray(1);
         TypedIndexVal k = (lvl == 0) ? TypedIndexVal(type<T>(),0) : ptrs[lvl-1];
 
         if (advance) {
@@ -182,13 +286,108 @@ public:
         for (ptrs[lvl] = (int)pos.get((int)k.getAsIndex()).getAsIndex();
              ptrs[lvl] < (int)pos.get((int)k.getAsIndex()+1).getAsIndex();
              ++ptrs[lvl]) {
-          coord[lvl] = (int)idx.get((int)ptrs[lvl].getAsIndex()).getAsIndex();
+          coord[lvl] = isSliced ? (int)ptrs[lvl].getAsIndex()
+              : (int)modeIndex.getIndexArray(1).get(
+                    (int)ptrs[lvl].getAsIndex()).getAsIndex();
 
         resume_sparse:
           if (advanceIndex(lvl + 1)) {
             return true;
           }
         }
+      } else if (modeTypes[lvl].getName() == Singleton.getName()) {
+        const auto& idx = modeIndex.getIndexArray(0);
+        if (!advance) {
+          ptrs[lvl] = ptrs[lvl-1];
+          coord[lvl] = (int)idx.get((int)ptrs[lvl].getAsIndex()).getAsIndex();
+        }
+        if (advanceIndex(lvl + 1)) {
+          return true;
+        }
+      } else if (modeTypes[lvl].getName() == Diagonal.getName()) {
+        // Rows whose columns lie within the matrix
+        const auto& offsets = modeIndex.getIndexArray(1);
+        const int offset =
+            (int)offsets.get((int)coord[lvl-1].getAsIndex()).getAsIndex();
+        const int numRows = storage->getDimensions()[0];
+        const int numColumns = storage->getDimensions()[1];
+        TypedIndexVal begin = ptrs[lvl - 1] * TypedIndexVal(type<T>(), numRows);
+
+        if (advance) {
+          goto resume_diagonal;
+        }
+
+        for (coord[lvl] = std::max(0, -offset);
+             coord[lvl] < std::min(numRows, numColumns - offset);
+             ++coord[lvl]) {
+          ptrs[lvl] = begin + coord[lvl];
+
+        resume_diagonal:
+          if (advanceIndex(lvl + 1)) {
+            return true;
+          }
+        }
+      } else if (modeTypes[lvl].getName() == Offset.getName()) {
+        const auto& offsets = modeIndex.getIndexArray(0);
+        if (!advance) {
+          ptrs[lvl] = ptrs[lvl-1];
+          coord[lvl] = (int)coord[lvl-1].getAsIndex() + (int)offsets.get(
+              (int)coord[lvl-2].getAsIndex()).getAsIndex();
+        }
+        if (advanceIndex(lvl + 1)) {
+          return true;
+        }
+      } else if (modeTypes[lvl].getName() == Hashed.getName()) {
+        const auto& idx = modeIndex.getIndexArray(1);
+        TypedIndexVal width(type<T>(),
+                            (int)modeIndex.getIndexArray(0)[0].getAsIndex());
+        TypedIndexVal begin = (lvl == 0) ? TypedIndexVal(type<T>(), 0)
+                                         : ptrs[lvl - 1] * width;
+
+        if (advance) {
+          goto resume_hashed;
+        }
+
+        for (ptrs[lvl] = begin; ptrs[lvl] < begin + width; ++ptrs[lvl]) {
+          // Empty buckets store -1
+          if ((int)idx.get((int)ptrs[lvl].getAsIndex()).getAsIndex() < 0) {
+            continue;
+          }
+          coord[lvl] = (int)idx.get((int)ptrs[lvl].getAsIndex()).getAsIndex();
+
+        resume_hashed:
+          if (advanceIndex(lvl + 1)) {
+            return true;
+          }
+        }
+      } else if (modeTypes[lvl].getName() == Bitmap.getName()) {
+        // The set bits of a parent position store consecutive positions,
+        // starting at the position of its first word
+        const uint64_t* bits =
+            (const uint64_t*)modeIndex.getIndexArray(1).getData();
+        const int dimension = storage->getDimensions()[modeOrdering[lvl]];
+        const int numWords = (dimension + 63) / 64;
+        const int k = (lvl == 0) ? 0 : (int)ptrs[lvl - 1].getAsIndex();
+        TypedIndexVal size(type<T>(), dimension);
+
+        if (advance) {
+          goto resume_bitmap;
+        }
+
+        ptrs[lvl] = (int)modeIndex.getIndexArray(0).get(
+            k * numWords).getAsIndex();
+        for (coord[lvl] = 0; coord[lvl] < size; ++coord[lvl]) {
+          if (((bits[k * numWords + coord[lvl].getAsIndex() / 64] >>
+                (coord[lvl].getAsIndex() % 64)) & 1) == 0) {
+            continue;
+          }
+
+        resume_bitmap:
+          if (advanceIndex(lvl + 1)) {
+            return true;
+          }
+          ++ptrs[lvl];
+        }
       } else {
         taco_not_supported_yet;
       }
@@ -202,6 +401,7 @@ public:
     std::pair<std::vector<T>,CType>  curVal;
     size_t                           count;
     bool                             advance;
+    size_t                           blockOffset;
   };
 
   /// Wrapper to template the index and value types used during
@@ -268,7 +468,12 @@ enum class FileType {
   ttx,
 
   /// .rb  - The rutherford-boeing sparse matrix format.
-  rb
+  rb,
+
+  /// .tbin - The taco binary format.  It stores the packed index and value
+  ///        arrays of a tensor verbatim, so that they are mapped from the file
+  ///        when it is read instead of being parsed and packed.
+  tbin
 };
 
 /// Read a tensor from a file. The file format is inferred from the filename
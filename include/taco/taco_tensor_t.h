@@ -7,21 +7,24 @@
 
 #include <cstdint>
 
-typedef enum { taco_mode_dense, taco_mode_sparse } taco_mode_t;
+typedef enum { taco_mode_dense, taco_mode_sparse, taco_mode_singleton,
+               taco_mode_hashed, taco_mode_sliced, taco_mode_diagonal,
+               taco_mode_offset, taco_mode_bitmap, taco_mode_permuted }
+             taco_mode_t;
 
 typedef struct taco_tensor_t {
   int32_t      order;         // tensor order (number of modes)
-  int32_t*     dimensions;    // tensor dimensions
+  int64_t*     dimensions;    // tensor dimensions
   int32_t      csize;         // component size
   int32_t*     mode_ordering; // mode storage ordering
   taco_mode_t* mode_types;    // mode storage types
   uint8_t***   indices;       // tensor index data (per mode)
   uint8_t*     vals;          // tensor values
-  int32_t      vals_size;     // values array size
+  int64_t      vals_size;     // values array size
 } taco_tensor_t;
 
 taco_tensor_t *init_taco_tensor_t(int32_t order, int32_t csize,
-                        int32_t* dimensions, int32_t* modeOrdering,
+                        int64_t* dimensions, int32_t* modeOrdering,
                         taco_mode_t* mode_types);
 
 void deinit_taco_tensor_t(taco_tensor_t* t);
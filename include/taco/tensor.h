@@ -4,6 +4,7 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include <future>
 #include <cassert>
 
 #include "taco/type.h"
@@ -16,6 +17,7 @@
 #include "taco/storage/array.h"
 #include "taco/storage/typed_vector.h"
 #include "taco/storage/typed_index.h"
+#include "taco/storage/pack.h"
 
 #include "taco/util/name_generator.h"
 #include "taco/error.h"
@@ -74,7 +76,9 @@ public:
   /// Get the order of the tensor (the number of modes).
   int getOrder() const;
 
-  /// Get the dimension of a tensor mode.
+  /// Get the dimension of a tensor mode.  Dimensions are at most INT_MAX, while
+  /// the number of components and the generated kernels are not limited to 32
+  /// bits.
   int getDimension(int mode) const;
 
   /// Get a vector with the dimension of each tensor mode.
@@ -133,9 +137,23 @@ public:
     coordinateBufferUsed += coordinateSize;
   }
 
+  /// Insert components in bulk, given as an Int32 coordinate array for every
+  /// mode and a value array of the same size.  The arrays are not copied:
+  /// `pack` reads them directly, and the tensor holds on to them until then,
+  /// so arrays with the Free or Delete policy pass their ownership to the
+  /// tensor, while arrays with the UserOwns policy must outlive the `pack`.
+  void insert(const std::vector<Array>& coordinates, const Array& values);
+
   /// Pack tensor into the given format
   void pack();
 
+  /// Set how `pack` resolves components that were inserted at the same
+  /// coordinate more than once.  By default the first component is kept.
+  void setDuplicatePolicy(DuplicatePolicy duplicatePolicy);
+
+  /// Get how `pack` resolves duplicate components.
+  DuplicatePolicy getDuplicatePolicy() const;
+
   /// Set the tensor's storage
   void setStorage(TensorStorage storage);
 
@@ -180,9 +198,18 @@ public:
   /// Set the expression to be evaluated when calling compute or assemble.
   Assignment getAssignment() const;
 
-  /// Compile the tensor expression.
+  /// Compile the tensor expression. Kernels are cached process-wide, so if a
+  /// structurally identical expression over tensors with the same types and
+  /// formats has already been compiled, this tensor shares its kernels.
   void compile(bool assembleWhileCompute=false);
 
+  /// Compile the tensor expression without waiting for the C compiler. The
+  /// expression is lowered on the calling thread and the generated code is
+  /// compiled by a bounded pool of worker threads (see `ir::getCompilePool`).
+  /// The returned future becomes ready when compilation finishes;
+  /// `assemble`, `compute` and `getSource` wait for it as needed.
+  std::shared_future<void> compileAsync(bool assembleWhileCompute=false);
+
   /// Assemble the tensor storage, including index and value arrays.
   void assemble();
 
@@ -192,6 +219,8 @@ public:
   void assemble(std::vector<void*> arguments);
 
   /// Compute the given expression and put the values in the tensor storage.
+  /// Unless the tensor was compiled to assemble while computing, repeated
+  /// calls do not allocate and cost little more than calling the kernel.
   void compute();
 
   /// Compute the given expression and put the values in the tensor storage
@@ -218,12 +247,44 @@ public:
   void printAssembleIR(std::ostream& stream, bool color=false,
                        bool simplify=false) const;
 
-  /// Set the size of the initial index allocations.  The default size is 1MB.
+  /// Set the number of coordinates and values that the indices and values of
+  /// compressed results are initially allocated for, e.g. a hint of the
+  /// number of nonzeros of the result.  The default size is 2^20.
   void setAllocSize(size_t allocSize);
 
   /// Get the size of the initial index allocations.
   size_t getAllocSize() const;
 
+  /// Count the coordinates of compressed results with a symbolic pass over
+  /// the operands before assembling them, so that their indices and values are
+  /// allocated at their exact sizes rather than grown from the initial
+  /// allocation size.
+  void setSymbolicAssemble(bool symbolicAssemble);
+
+  /// True iff compressed results are sized by a symbolic pass.
+  bool getSymbolicAssemble() const;
+
+  /// Assemble compressed results with a parallel count pass followed by a
+  /// parallel fill pass, instead of appending to them sequentially.  Enabled
+  /// by default when taco is built with OpenMP.
+  void setParallelAssemble(bool parallelAssemble);
+
+  /// True iff compressed results are assembled in parallel.
+  bool getParallelAssemble() const;
+
+  /// Compute reductions over the outermost loop (e.g. dot products and
+  /// transposed matrix-vector products) in parallel, with the given strategy
+  /// for combining the threads' partial results.  Enabled by default, with
+  /// the fast strategy, when taco is built with OpenMP.
+  void setParallelReduce(bool parallelReduce,
+                         ReductionStrategy strategy=ReductionStrategy::Fast);
+
+  /// True iff reductions over the outermost loop are computed in parallel.
+  bool getParallelReduce() const;
+
+  /// Get the strategy of parallel reductions.
+  ReductionStrategy getReductionStrategy() const;
+
   /// Get the taco_tensor_t representation of this tensor.
   taco_tensor_t* getTacoTensorT();
 
@@ -250,6 +311,11 @@ private:
   struct Content;
   std::shared_ptr<Content> content;
 
+  std::shared_future<void> lowerAndCompile(bool assembleWhileCompute,
+                                           bool async);
+  void waitForCompile() const;
+  void** packArguments() const;
+
   std::shared_ptr<std::vector<char>> coordinateBuffer;
   size_t                             coordinateBufferUsed;
   size_t                             coordinateSize;
@@ -487,6 +553,21 @@ void getCSCArrays(const TensorBase& tensor,
 /// Pack the operands in the given expression.
 void packOperands(const TensorBase& tensor);
 
+/// Statistics of the process-wide cache of kernels compiled by
+/// `TensorBase::compile`.
+struct CompileCacheStats {
+  size_t hits;    ///< Compilations that reused cached kernels.
+  size_t misses;  ///< Compilations that lowered and compiled new kernels.
+  size_t size;    ///< Number of cached kernels.
+};
+
+/// Returns the hit and miss counts of the compiled kernel cache.
+CompileCacheStats getCompileCacheStats();
+
+/// Removes all kernels from the compiled kernel cache and resets its counts.
+/// Tensors that already share cached kernels keep them.
+void clearCompileCache();
+
 /// Iterate over the typed values of a TensorBase.
 template <typename CType>
 Tensor<CType> iterate(const TensorBase& tensor) {
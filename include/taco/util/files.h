@@ -3,6 +3,10 @@
 
 #include <string>
 #include <fstream>
+#include <istream>
+#include <memory>
+
+#include "taco/util/uncopyable.h"
 
 namespace taco {
 namespace util {
@@ -11,5 +15,53 @@ std::string sanitizePath(std::string path);
 
 void openStream(std::fstream& stream, std::string path, std::fstream::openmode mode);
 
+/// A file that is mapped read-only into memory for as long as the object
+/// lives.  The pages are read in by the operating system as they are touched.
+class MappedFile : Uncopyable {
+public:
+  /// Map the file at the given path.  Copy-on-write mappings may be written
+  /// to, and the writes stay private to the process and are not written to
+  /// the file.
+  MappedFile(std::string path, bool copyOnWrite=false);
+
+  /// Unmap the file.
+  ~MappedFile();
+
+  /// Returns the first byte of the file.
+  const char* getData() const;
+  char* getData();
+
+  /// Returns the number of bytes in the file.
+  size_t getSize() const;
+
+private:
+  char*  data;
+  size_t size;
+};
+
+/// Returns true if the path names a gzip compressed file.
+bool isGzipPath(std::string path);
+
+/// Returns true if taco is built with zlib and can read gzip files.
+bool isGzipSupported();
+
+/// An input stream over the decompressed contents of a gzip file.  The file is
+/// decompressed on a separate thread that runs a few blocks ahead of the
+/// reader, so decompression overlaps with whatever the reader does with the
+/// contents.  Errors in the compressed data are reported by the read that
+/// reaches them.  Reading gzip files requires taco to be built with zlib.
+class GzipInputStream : public std::istream, Uncopyable {
+public:
+  /// Open the gzip file at the given path and start decompressing it.
+  GzipInputStream(std::string path);
+
+  /// Stop decompressing and close the file.
+  ~GzipInputStream();
+
+private:
+  struct Buffer;
+  std::unique_ptr<Buffer> buffer;
+};
+
 }}
 #endif
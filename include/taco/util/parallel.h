@@ -0,0 +1,21 @@
+#ifndef TACO_UTIL_PARALLEL_H
+#define TACO_UTIL_PARALLEL_H
+
+#include <cstddef>
+#include <functional>
+
+namespace taco {
+namespace util {
+
+/// Returns how many threads to split `n` units of work between, so that each
+/// thread gets at least `grain` units.  At least one thread is returned, and
+/// at most one per core.
+size_t getNumThreads(size_t n, size_t grain);
+
+/// Call `f(t, begin, end)` for each of `numThreads` contiguous blocks of
+/// [0,n), on a thread per block.
+void parallelBlocks(size_t n, size_t numThreads,
+                    const std::function<void(size_t,size_t,size_t)>& f);
+
+}}
+#endif
@@ -3,6 +3,8 @@
 
 #include <string>
 #include <sstream>
+#include <iomanip>
+#include <limits>
 #include <vector>
 #include <map>
 
@@ -21,6 +23,15 @@ std::string toString(const T &val) {
   return sstream.str();
 }
 
+/// Turn a floating-point value into a string that reads back as exactly the
+/// same value.
+template <class T>
+std::string toExactString(const T &val) {
+  std::stringstream sstream;
+  sstream << std::setprecision(std::numeric_limits<T>::max_digits10) << val;
+  return sstream.str();
+}
+
 /// Join the elements between begin and end in a sep-separated string.
 template <typename Iterator>
 std::string join(Iterator begin, Iterator end, const std::string &sep=", ") {
@@ -0,0 +1,54 @@
+#ifndef TACO_UTIL_THREAD_POOL_H
+#define TACO_UTIL_THREAD_POOL_H
+
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <future>
+#include <memory>
+#include <functional>
+#include <condition_variable>
+
+#include "taco/util/uncopyable.h"
+
+namespace taco {
+namespace util {
+
+/// A fixed-size pool of worker threads that run submitted tasks in submission
+/// order. At most `numThreads` tasks run at once; the rest wait in a queue.
+class ThreadPool : Uncopyable {
+public:
+  /// Start a pool with the given number of worker threads (at least one).
+  ThreadPool(size_t numThreads);
+
+  /// Wait for the queued tasks to finish and stop the worker threads.
+  ~ThreadPool();
+
+  /// Returns the number of worker threads.
+  size_t getNumThreads() const;
+
+  /// Queue a task and return a future that becomes ready with the task's
+  /// result when a worker thread has run it.
+  template <typename F>
+  std::shared_future<typename std::result_of<F()>::type> submit(F task) {
+    typedef typename std::result_of<F()>::type R;
+    auto packagedTask = std::make_shared<std::packaged_task<R()>>(task);
+    std::shared_future<R> result = packagedTask->get_future().share();
+    enqueue([packagedTask]() { (*packagedTask)(); });
+    return result;
+  }
+
+private:
+  void enqueue(std::function<void()> task);
+  void work();
+
+  std::vector<std::thread>          workers;
+  std::deque<std::function<void()>> tasks;
+  std::mutex                        mutex;
+  std::condition_variable           available;
+  bool                              stopping;
+};
+
+}}
+#endif
@@ -29,22 +29,26 @@ const string cHeaders =
   "#include <stdio.h>\n"
   "#include <stdlib.h>\n"
   "#include <stdint.h>\n"
+  "#include <stdbool.h>\n"
   "#include <math.h>\n"
   "#include <complex.h>\n"
   "#define TACO_MIN(_a,_b) ((_a) < (_b) ? (_a) : (_b))\n"
   "#define TACO_MAX(_a,_b) ((_a) > (_b) ? (_a) : (_b))\n"
   "#ifndef TACO_TENSOR_T_DEFINED\n"
   "#define TACO_TENSOR_T_DEFINED\n"
-  "typedef enum { taco_mode_dense, taco_mode_sparse } taco_mode_t;\n"
+  "typedef enum { taco_mode_dense, taco_mode_sparse, taco_mode_singleton,\n"
+  "               taco_mode_hashed, taco_mode_sliced, taco_mode_diagonal,\n"
+  "               taco_mode_offset, taco_mode_bitmap, taco_mode_permuted }\n"
+  "             taco_mode_t;\n"
   "typedef struct {\n"
   "  int32_t      order;         // tensor order (number of modes)\n"
-  "  int32_t*     dimensions;    // tensor dimensions\n"
+  "  int64_t*     dimensions;    // tensor dimensions\n"
   "  int32_t      csize;         // component size\n"
   "  int32_t*     mode_ordering; // mode storage ordering\n"
   "  taco_mode_t* mode_types;    // mode storage types\n"
   "  uint8_t***   indices;       // tensor index data (per mode)\n"
   "  uint8_t*     vals;          // tensor values\n"
-  "  int32_t      vals_size;     // values array size\n"
+  "  int64_t      vals_size;     // values array size\n"
   "} taco_tensor_t;\n"
   "#endif\n"
   "#endif\n";
@@ -168,26 +172,25 @@ string unpackTensorProperty(string varname, const GetProperty* op,
     ret << tensor->name << "->vals);\n";
     return ret.str();
   } else if (op->property == TensorProperty::ValuesSize) {
-    ret << "int " << varname << " = " << tensor->name << "->vals_size;\n";
+    ret << "int64_t " << varname << " = " << tensor->name << "->vals_size;\n";
     return ret.str();
   }
   
   string tp;
   
-  // for a Dense level, nnz is an int
-  // for a Fixed level, ptr is an int
-  // all others are int*
+  // dimensions are 64-bit, like in taco_tensor_t
+  // all others are pointers to their index type
   if (op->property == TensorProperty::Dimension) {
-    tp = "int";
-    ret << tp << " " << varname << " = (int)("
+    tp = "int64_t";
+    ret << tp << " " << varname << " = (int64_t)("
         << tensor->name << "->dimensions[" << tensor->name << "->mode_ordering[" 
         << op->mode << "]]);\n";
   } else {
     taco_iassert(op->property == TensorProperty::Indices);
-    tp = "int*";
+    tp = toCType(op->type, true);
     auto nm = op->index;
     ret << tp << " restrict " << varname << " = ";
-    ret << "(int*)(" << tensor->name << "->indices[" << op->mode;
+    ret << "(" << tp << ")(" << tensor->name << "->indices[" << op->mode;
     ret << "][" << nm << "]);\n";
   }
   
@@ -607,6 +610,16 @@ void CodeGen_C::visit(const Max* op) {
   stream << ")";
 }
 
+void CodeGen_C::visit(const Store* op) {
+  if (op->use_atomics) {
+    doIndent();
+    out << "#pragma omp atomic";
+    out << "\n";
+  }
+
+  IRPrinter::visit(op);
+}
+
 void CodeGen_C::visit(const Allocate* op) {
   string elementType = toCType(op->var.type(), false);
 
@@ -630,6 +643,14 @@ void CodeGen_C::visit(const Allocate* op) {
     stream << endl;
 }
 
+void CodeGen_C::visit(const Free* op) {
+  doIndent();
+  stream << "free(";
+  op->var.accept(this);
+  stream << ");";
+  stream << endl;
+}
+
 void CodeGen_C::visit(const Sqrt* op) {
   taco_tassert(op->type.isFloat() && op->type.getNumBits() == 64) <<
       "Codegen doesn't currently support non-double sqrt";
@@ -637,6 +658,18 @@ void CodeGen_C::visit(const Sqrt* op) {
   op->a.accept(this);
   stream << ")";
 }
+
+void CodeGen_C::visit(const Popcount* op) {
+  stream << "__builtin_popcountll(";
+  op->a.accept(this);
+  stream << ")";
+}
+
+void CodeGen_C::visit(const Ctz* op) {
+  stream << "__builtin_ctzll(";
+  op->a.accept(this);
+  stream << ")";
+}
   
 void CodeGen_C::generateShim(const Stmt& func, stringstream &ret) {
   const Function *funcPtr = func.as<Function>();
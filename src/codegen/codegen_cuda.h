@@ -37,8 +37,12 @@ protected:
   void visit(const GetProperty*);
   void visit(const Min*);
   void visit(const Max*);
+  void visit(const Store*);
   void visit(const Allocate*);
+  void visit(const Free*);
   void visit(const Sqrt*);
+  void visit(const Popcount*);
+  void visit(const Ctz*);
   void visit(const Add*);
   void visit(const Sub*);
   void visit(const Mul*);
@@ -2,12 +2,22 @@
 
 #include <iostream>
 #include <fstream>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <thread>
 #include <dlfcn.h>
+#include <dirent.h>
 #include <unistd.h>
+#include <utime.h>
+#include <sys/stat.h>
 
 #include "taco/error.h"
 #include "taco/util/strings.h"
 #include "taco/util/env.h"
+#include "taco/util/thread_pool.h"
 #include "codegen/codegen_c.h"
 #include "codegen/codegen_cuda.h"
 #include "taco/cuda.h"
@@ -74,7 +84,7 @@ void Module::compileToStaticLibrary(string path, string prefix) {
   
 namespace {
 
-void writeShims(vector<Stmt> funcs, string path, string prefix) {
+string writeShims(vector<Stmt> funcs, string path, string prefix) {
   stringstream shims;
   for (auto func: funcs) {
     if (should_use_CUDA_codegen()) {
@@ -97,10 +107,137 @@ void writeShims(vector<Stmt> funcs, string path, string prefix) {
   shims_file << "#include \"" << path << prefix << ".h\"\n";
   shims_file << shims.str();
   shims_file.close();
+  return shims.str();
+}
+
+// Bump this whenever the layout of cached libraries changes, so that stale
+// libraries from an older taco are never picked up.
+const string kernelCacheVersion = "taco-kernel-cache-1";
+
+/// 64-bit FNV-1a hash.  Unlike std::hash it is stable across processes and
+/// standard library implementations, which the on-disk cache relies on.
+uint64_t fnv1a(const string& str, uint64_t hash=0xcbf29ce484222325ull) {
+  for (unsigned char c : str) {
+    hash ^= c;
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+/// Returns the output of `cc --version`, so that libraries compiled by a
+/// different compiler that goes by the same name are not reused.  The output
+/// is computed once per compiler and process.
+string getCompilerVersion(const string& cc) {
+  static mutex versionMutex;
+  static map<string,string> versions;
+  lock_guard<mutex> lock(versionMutex);
+  if (versions.count(cc) == 0) {
+    string version;
+    FILE* pipe = popen((cc + " --version 2>&1").c_str(), "r");
+    if (pipe != nullptr) {
+      char buffer[256];
+      while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
+        version += buffer;
+      }
+      pclose(pipe);
+    }
+    versions.insert({cc, version});
+  }
+  return versions.at(cc);
+}
+
+/// Returns the kernel cache directory (with a trailing slash), or the empty
+/// string if the cache is disabled.  The cache is enabled by pointing the
+/// TACO_CACHE_DIR environment variable at a directory.
+string getKernelCacheDir() {
+  string cachedir = util::getFromEnv("TACO_CACHE_DIR", "");
+  if (cachedir == "") {
+    return "";
+  }
+  if (cachedir.back() != '/') {
+    cachedir += '/';
+  }
+  if (access(cachedir.c_str(), W_OK) != 0 &&
+      (mkdir(cachedir.c_str(), 0755) != 0 ||
+       access(cachedir.c_str(), W_OK) != 0)) {
+    taco_uwarning << "Unable to write to kernel cache directory " << cachedir
+                  << ". Kernels will not be cached.";
+    return "";
+  }
+  return cachedir;
+}
+
+/// Remove the least recently used libraries from the cache directory until
+/// the total size of the cached libraries is at most TACO_CACHE_SIZE
+/// megabytes (1024 by default).  The library at `keep` is never removed.
+void evictFromKernelCache(string cachedir, string keep) {
+  long long maxSize =
+      atoll(util::getFromEnv("TACO_CACHE_SIZE", "1024").c_str()) << 20;
+
+  DIR* dir = opendir(cachedir.c_str());
+  if (dir == nullptr) {
+    return;
+  }
+  vector<pair<time_t,string>> entries;
+  map<string,long long> sizes;
+  long long totalSize = 0;
+  while (struct dirent* entry = readdir(dir)) {
+    string name = entry->d_name;
+    if (name.size() < 3 || name.substr(name.size() - 3) != ".so") {
+      continue;
+    }
+    string path = cachedir + name;
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+      continue;
+    }
+    entries.push_back({st.st_mtime, path});
+    sizes[path] = st.st_size;
+    totalSize += st.st_size;
+  }
+  closedir(dir);
+
+  // Other processes may evict the same files concurrently, so failures to
+  // unlink are ignored.  Processes that already opened an evicted library
+  // keep their mapping.
+  sort(entries.begin(), entries.end());
+  for (auto& entry : entries) {
+    if (totalSize <= maxSize) {
+      break;
+    }
+    if (entry.second != keep) {
+      unlink(entry.second.c_str());
+      totalSize -= sizes[entry.second];
+    }
+  }
+}
+
+/// Copy the library at `libpath` into the cache as `cachepath`.  The library
+/// is first written to a file that is private to this process and then
+/// renamed, so other processes never observe a partially written library.
+void insertIntoKernelCache(string libpath, string cachepath, string libname) {
+  string tmppath = cachepath + "." + to_string(getpid()) + "." + libname;
+  {
+    ifstream src(libpath, ios::binary);
+    ofstream dst(tmppath, ios::binary);
+    dst << src.rdbuf();
+    if (!src || !dst) {
+      unlink(tmppath.c_str());
+      return;
+    }
+  }
+  if (rename(tmppath.c_str(), cachepath.c_str()) != 0) {
+    unlink(tmppath.c_str());
+  }
 }
 
 } // anonymous namespace
 
+// The C and CUDA code generators share global state, so modules compiled on
+// different threads generate their source one at a time.  Only the external
+// compiler invocations run concurrently.
+static mutex codegenMutex;
+
 string Module::compile() {
   string prefix = tmpdir+libname;
   string fullpath = prefix + ".so";
@@ -120,6 +257,9 @@ string Module::compile() {
     cc = util::getFromEnv(target.compiler_env, target.compiler);
     cflags = util::getFromEnv("TACO_CFLAGS",
     "-O3 -ffast-math -std=c99") + " -shared -fPIC";
+#ifdef USE_OPENMP
+    cflags += " -fopenmp";
+#endif
     file_ending = ".c";
     shims_file_ending = ".c";
   }
@@ -129,23 +269,73 @@ string Module::compile() {
     prefix + "_shims" + shims_file_ending + " " +
     "-o " + prefix + ".so";
 
-  // open the output file & write out the source
-  compileToSource(tmpdir, libname);
-  
-  // write out the shims
-  writeShims(funcs, tmpdir, libname);
+  string shims;
+  {
+    lock_guard<mutex> lock(codegenMutex);
+
+    // open the output file & write out the source
+    compileToSource(tmpdir, libname);
+
+    // write out the shims
+    shims = writeShims(funcs, tmpdir, libname);
+  }
+
+  // reuse a library compiled earlier, possibly by another process, from the
+  // same source with the same compiler and flags
+  string cachedir = getKernelCacheDir();
+  string cachepath;
+  if (cachedir != "") {
+    uint64_t key = fnv1a(kernelCacheVersion);
+    for (auto& part : {source.str(), header.str(), shims, cc,
+                       getCompilerVersion(cc), cflags, file_ending}) {
+      key = fnv1a(part, fnv1a(to_string(part.size()), key));
+    }
+    stringstream keyname;
+    keyname << hex << key;
+    cachepath = cachedir + keyname.str() + ".so";
+
+    lib_handle = dlopen(cachepath.data(), RTLD_NOW | RTLD_LOCAL);
+    if (lib_handle != nullptr) {
+      // mark the library as recently used for eviction
+      utime(cachepath.data(), nullptr);
+      loadFuncPtrs();
+      return cachepath;
+    }
+  }
   
   // now compile it
   int err = system(cmd.data());
   taco_uassert(err == 0) << "Compilation command failed:\n" << cmd
     << "\nreturned " << err;
 
+  if (cachepath != "") {
+    insertIntoKernelCache(fullpath, cachepath, libname);
+    evictFromKernelCache(cachedir, cachepath);
+  }
+
   // use dlsym() to open the compiled library
   lib_handle = dlopen(fullpath.data(), RTLD_NOW | RTLD_LOCAL);
+  loadFuncPtrs();
 
   return fullpath;
 }
 
+void Module::loadFuncPtrs() {
+  funcPtrs.clear();
+  for (auto& func : funcs) {
+    string name = func.as<Function>()->name;
+    funcPtrs[name] = dlsym(lib_handle, name.data());
+    funcPtrs["_shim_" + name] = dlsym(lib_handle, ("_shim_" + name).data());
+  }
+}
+
+util::ThreadPool& getCompilePool() {
+  static util::ThreadPool pool(
+      atoi(util::getFromEnv("TACO_COMPILE_THREADS",
+                            to_string(thread::hardware_concurrency())).c_str()));
+  return pool;
+}
+
 void Module::setSource(string source) {
   this->source << source;
   moduleFromUserSource = true;
@@ -156,18 +346,25 @@ string Module::getSource() {
 }
 
 void* Module::getFuncPtr(std::string name) {
+  auto funcPtr = funcPtrs.find(name);
+  if (funcPtr != funcPtrs.end()) {
+    return funcPtr->second;
+  }
   return dlsym(lib_handle, name.data());
 }
 
-int Module::callFuncPackedRaw(std::string name, void** args) {
+int Module::callFuncPtr(void* funcPtr, void** args) {
   typedef int (*fnptr_t)(void**);
   static_assert(sizeof(void*) == sizeof(fnptr_t),
     "Unable to cast dlsym() returned void pointer to function pointer");
-  void* v_func_ptr = getFuncPtr(name);
   fnptr_t func_ptr;
-  *reinterpret_cast<void**>(&func_ptr) = v_func_ptr;
+  *reinterpret_cast<void**>(&func_ptr) = funcPtr;
   return func_ptr(args);
 }
 
+int Module::callFuncPackedRaw(std::string name, void** args) {
+  return callFuncPtr(getFuncPtr(name), args);
+}
+
 } // namespace ir
 } // namespace taco
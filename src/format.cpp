@@ -1,14 +1,23 @@
 #include "taco/format.h"
 
 #include <iostream>
+#include <algorithm>
 #include <climits>
 #include <vector>
 #include <initializer_list>
 
 #include "taco/lower/mode_format_dense_old.h"
 #include "taco/lower/mode_format_compressed.h"
+#include "taco/lower/mode_format_singleton.h"
+#include "taco/lower/mode_format_hashed.h"
+#include "taco/lower/mode_format_sliced.h"
+#include "taco/lower/mode_format_diagonal.h"
+#include "taco/lower/mode_format_offset.h"
+#include "taco/lower/mode_format_bitmap.h"
+#include "taco/lower/mode_format_permuted.h"
 
 #include "taco/error.h"
+#include "taco/util/collections.h"
 #include "taco/util/strings.h"
 
 using namespace std;
@@ -87,16 +96,104 @@ Datatype Format::getCoordinateTypeIdx(size_t level) const {
   if (level >= levelArrayTypes.size()) {
     return Int32;
   }
-  if (getModeFormats()[level] == Sparse) {
-    return levelArrayTypes[level][1];
+  return levelArrayTypes[level].back();
+}
+
+Datatype Format::getPositionType(size_t level) const {
+  Datatype type = Int32;
+  for (size_t i = 0; i <= level && i < levelArrayTypes.size(); i++) {
+    // Branchless levels (e.g. singleton) share their parent's positions
+    if (!levelArrayTypes[i].empty() && !getModeFormats()[i].isBranchless()) {
+      type = max_type(type, levelArrayTypes[i][0]);
+    }
   }
-  return levelArrayTypes[level][0];
+  return type;
 }
 
 void Format::setLevelArrayTypes(std::vector<std::vector<Datatype>> levelArrayTypes) {
   this->levelArrayTypes = levelArrayTypes;
 }
 
+bool Format::isBlocked() const {
+  return !blockSizes.empty();
+}
+
+const std::vector<int>& Format::getBlockSizes() const {
+  return this->blockSizes;
+}
+
+void Format::setBlockSizes(std::vector<int> blockSizes) {
+  taco_uassert(blockSizes.size() == (size_t)getOrder()) <<
+      "A blocked format must have one block size per mode";
+  taco_uassert(!isPattern() && !isSplitComplex()) <<
+      "Pattern and split complex formats cannot be blocked";
+  for (int blockSize : blockSizes) {
+    taco_uassert(blockSize > 0) << "Block sizes must be positive";
+  }
+  this->blockSizes = blockSizes;
+}
+
+bool Format::isSliced() const {
+  return sliceHeight >= 0;
+}
+
+int Format::getSliceHeight() const {
+  return sliceHeight;
+}
+
+int Format::getSortWindow() const {
+  return sortWindow;
+}
+
+void Format::setSlicing(int sliceHeight, int sortWindow) {
+  taco_uassert(getOrder() == 2 &&
+               getModeFormats()[0].getName() == Sliced.getName() &&
+               getModeFormats()[1].getName() == Singleton.getName() &&
+               getModeOrdering()[0] == 0) <<
+      "Only {Sliced,Singleton} matrix formats can be sliced";
+  taco_uassert(!isPattern() && !isSplitComplex()) <<
+      "Pattern and split complex formats cannot be sliced";
+  taco_uassert(sliceHeight >= 0) << "Slice heights must not be negative";
+  taco_uassert(sortWindow > 0) << "Sort windows must be positive";
+  this->sliceHeight = sliceHeight;
+  this->sortWindow = sortWindow;
+}
+
+bool Format::isDiagonal() const {
+  return getOrder() == 2 &&
+         getModeFormats()[0].getName() == Diagonal.getName() &&
+         getModeFormats()[1].getName() == Offset.getName();
+}
+
+bool Format::isPattern() const {
+  return pattern;
+}
+
+void Format::setPattern(bool pattern) {
+  // The positions of full last levels, and the padding of blocked, sliced
+  // and diagonal formats, store components that are not one but zero
+  taco_uassert(!pattern || (getOrder() > 0 &&
+                            !getModeFormats().back().isFull() &&
+                            !isBlocked() && !isSliced() && !isDiagonal())) <<
+      "Only formats whose last level stores just the nonzero components of "
+      "a tensor can be pattern formats";
+  taco_uassert(!pattern || !isSplitComplex()) <<
+      "Pattern formats store no values to split";
+  this->pattern = pattern;
+}
+
+bool Format::isSplitComplex() const {
+  return splitComplex;
+}
+
+void Format::setSplitComplex(bool splitComplex) {
+  taco_uassert(!splitComplex ||
+               (!isBlocked() && !isSliced() && !isDiagonal() && !isPattern()))
+      << "Only formats that store one value per position can split complex "
+         "values";
+  this->splitComplex = splitComplex;
+}
+
 
 bool operator==(const Format& a, const Format& b){
   const auto aModeTypePacks = a.getModeFormatPacks();
@@ -118,7 +215,11 @@ bool operator==(const Format& a, const Format& b){
       return false;
     }
   } 
-  return true;
+  return a.getBlockSizes() == b.getBlockSizes() &&
+         a.getSliceHeight() == b.getSliceHeight() &&
+         a.getSortWindow() == b.getSortWindow() &&
+         a.isPattern() == b.isPattern() &&
+         a.isSplitComplex() == b.isSplitComplex();
 }
 
 bool operator!=(const Format& a, const Format& b) {
@@ -126,8 +227,22 @@ bool operator!=(const Format& a, const Format& b) {
 }
 
 std::ostream &operator<<(std::ostream& os, const Format& format) {
-  return os << "(" << util::join(format.getModeFormatPacks(), ",") << "; "
-            << util::join(format.getModeOrdering(), ",") << ")";
+  os << "(" << util::join(format.getModeFormatPacks(), ",") << "; "
+     << util::join(format.getModeOrdering(), ",");
+  if (format.isBlocked()) {
+    os << "; " << util::join(format.getBlockSizes(), "x");
+  }
+  if (format.isSliced()) {
+    os << "; sell-" << format.getSliceHeight() << "-"
+       << format.getSortWindow();
+  }
+  if (format.isPattern()) {
+    os << "; pattern";
+  }
+  if (format.isSplitComplex()) {
+    os << "; split";
+  }
+  return os << ")";
 }
 
 
@@ -254,6 +369,11 @@ bool ModeFormat::hasAppend() const {
   return impl->hasAppend;
 }
 
+bool ModeFormat::hasWordIter() const {
+  taco_iassert(defined());
+  return impl->hasWordIter;
+}
+
 bool ModeFormat::defined() const {
   return impl != nullptr;
 }
@@ -329,24 +449,151 @@ ostream& operator<<(ostream& os, const ModeFormatPack& modeFormatPack) {
 ModeFormat ModeFormat::Dense(std::make_shared<old::DenseModeFormat>());
 ModeFormat ModeFormat::Compressed(std::make_shared<CompressedModeFormat>());
 ModeFormat ModeFormat::Sparse = ModeFormat::Compressed;
+ModeFormat ModeFormat::Singleton(std::make_shared<SingletonModeFormat>());
+ModeFormat ModeFormat::Hashed(std::make_shared<HashedModeFormat>());
+ModeFormat ModeFormat::Sliced(std::make_shared<SlicedModeFormat>());
+ModeFormat ModeFormat::Diagonal(std::make_shared<DiagonalModeFormat>());
+ModeFormat ModeFormat::Offset(std::make_shared<OffsetModeFormat>());
+ModeFormat ModeFormat::Bitmap(std::make_shared<BitmapModeFormat>());
+ModeFormat ModeFormat::Permuted(std::make_shared<PermutedModeFormat>());
 
 ModeFormat ModeFormat::dense = ModeFormat::Dense;
 ModeFormat ModeFormat::compressed = ModeFormat::Compressed;
 ModeFormat ModeFormat::sparse = ModeFormat::Compressed;
+ModeFormat ModeFormat::singleton = ModeFormat::Singleton;
+ModeFormat ModeFormat::hashed = ModeFormat::Hashed;
+ModeFormat ModeFormat::sliced = ModeFormat::Sliced;
+ModeFormat ModeFormat::diagonal = ModeFormat::Diagonal;
+ModeFormat ModeFormat::offset = ModeFormat::Offset;
+ModeFormat ModeFormat::bitmap = ModeFormat::Bitmap;
+ModeFormat ModeFormat::permuted = ModeFormat::Permuted;
 
 const ModeFormat Dense = ModeFormat::Dense;
 const ModeFormat Compressed = ModeFormat::Compressed;
 const ModeFormat Sparse = ModeFormat::Compressed;
+const ModeFormat Singleton = ModeFormat::Singleton;
+const ModeFormat Hashed = ModeFormat::Hashed;
+const ModeFormat Sliced = ModeFormat::Sliced;
+const ModeFormat Diagonal = ModeFormat::Diagonal;
+const ModeFormat Offset = ModeFormat::Offset;
+const ModeFormat Bitmap = ModeFormat::Bitmap;
+const ModeFormat Permuted = ModeFormat::Permuted;
 
 const ModeFormat dense = ModeFormat::Dense;
 const ModeFormat compressed = ModeFormat::Compressed;
 const ModeFormat sparse = ModeFormat::Compressed;
+const ModeFormat singleton = ModeFormat::Singleton;
+const ModeFormat hashed = ModeFormat::Hashed;
+const ModeFormat sliced = ModeFormat::Sliced;
+const ModeFormat diagonal = ModeFormat::Diagonal;
+const ModeFormat offset = ModeFormat::Offset;
+const ModeFormat bitmap = ModeFormat::Bitmap;
+const ModeFormat permuted = ModeFormat::Permuted;
 
 const Format CSR({Dense, Sparse}, {0,1});
 const Format CSC({Dense, Sparse}, {1,0});
 const Format DCSR({Sparse, Sparse}, {0,1});
 const Format DCSC({Sparse, Sparse}, {1,0});
 
+Format COO(int order) {
+  taco_uassert(order > 0) << "COO tensors must have at least one mode";
+  vector<ModeFormatPack> modeFormats;
+  modeFormats.push_back(ModeFormat::Compressed(
+      {order > 1 ? ModeFormat::NOT_UNIQUE : ModeFormat::UNIQUE}));
+  for (int i = 1; i < order; i++) {
+    modeFormats.push_back(ModeFormat::Singleton(
+        {i < order - 1 ? ModeFormat::NOT_UNIQUE : ModeFormat::UNIQUE}));
+  }
+  return Format(modeFormats);
+}
+
+Format BCSR(int blockRows, int blockCols) {
+  Format format({Dense, Sparse});
+  format.setBlockSizes({blockRows, blockCols});
+  return format;
+}
+
+Format ELL() {
+  return SELL(0);
+}
+
+Format SELL(int sliceHeight, int sortWindow) {
+  Format format({Sliced, Singleton});
+  format.setSlicing(sliceHeight, sortWindow);
+  return format;
+}
+
+Format DIA() {
+  return Format({Diagonal, Offset});
+}
+
+Format getBlockTensorFormat(const Format& format) {
+  taco_iassert(format.isBlocked());
+  const int order = format.getOrder();
+  vector<ModeFormatPack> modeFormatPacks = format.getModeFormatPacks();
+  vector<int> modeOrdering = format.getModeOrdering();
+  for (int i = 0; i < order; i++) {
+    modeFormatPacks.push_back(Dense);
+    modeOrdering.push_back(order + format.getModeOrdering()[i]);
+  }
+  Format blockTensorFormat(modeFormatPacks, modeOrdering);
+  if (!format.getLevelArrayTypes().empty()) {
+    vector<vector<Datatype>> levelArrayTypes = format.getLevelArrayTypes();
+    for (int i = 0; i < order; i++) {
+      levelArrayTypes.push_back({Int32});
+    }
+    blockTensorFormat.setLevelArrayTypes(levelArrayTypes);
+  }
+  return blockTensorFormat;
+}
+
+vector<int> getBlockTensorDimensions(const vector<int>& dimensions,
+                                     const Format& format) {
+  taco_iassert(format.isBlocked());
+  const vector<int>& blockSizes = format.getBlockSizes();
+  vector<int> blockTensorDimensions;
+  for (size_t i = 0; i < dimensions.size(); i++) {
+    // Checked here, since blocked storage is also mapped from files
+    taco_uassert(dimensions[i] % blockSizes[i] == 0) <<
+        "Mode " << i << " has dimension " << dimensions[i] << ", which is " <<
+        "not a multiple of its block size " << blockSizes[i];
+    blockTensorDimensions.push_back(dimensions[i] / blockSizes[i]);
+  }
+  util::append(blockTensorDimensions, blockSizes);
+  return blockTensorDimensions;
+}
+
+Format getSliceTensorFormat(const Format& format) {
+  taco_iassert(format.isSliced());
+  return Format({Dense, Sliced, Dense, Singleton});
+}
+
+vector<int> getSliceTensorDimensions(const vector<int>& dimensions,
+                                     const Format& format) {
+  taco_iassert(format.isSliced());
+  const int sliceHeight = (format.getSliceHeight() > 0)
+                          ? format.getSliceHeight() : max(dimensions[0], 1);
+  // Computed in 64 bits, since rounding up may overflow near INT_MAX
+  const int numSlices = (int)(((long long)dimensions[0] + sliceHeight - 1) /
+                              sliceHeight);
+  return {numSlices, dimensions[1], sliceHeight, dimensions[1]};
+}
+
+Format getDiagonalTensorFormat(const Format& format) {
+  taco_iassert(format.isDiagonal());
+  return Format({Dense, Diagonal, Offset});
+}
+
+vector<int> getDiagonalTensorDimensions(const vector<int>& dimensions,
+                                        const Format& format) {
+  taco_iassert(format.isDiagonal());
+  const long long numDiagonals =
+      max((long long)dimensions[0] + dimensions[1] - 1, 0ll);
+  taco_uassert(numDiagonals <= INT_MAX) << "A " << dimensions[0] << "x" <<
+      dimensions[1] << " matrix has more than INT_MAX diagonals";
+  return {(int)numDiagonals, dimensions[0], dimensions[1]};
+}
+
 bool isDense(const Format& format) {
   for (ModeFormat modeFormat : format.getModeFormats()) {
     if (modeFormat != Dense) {
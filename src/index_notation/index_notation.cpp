@@ -235,6 +235,8 @@ struct Equals : public IndexNotationVisitorStrict {
     }
     auto bnode = to<ForallNode>(bStmt.ptr);
     if (anode->indexVar != bnode->indexVar ||
+        anode->strategy != bnode->strategy ||
+        anode->reduction != bnode->reduction ||
         !equals(anode->stmt, bnode->stmt)) {
       eq = false;
       return;
@@ -789,12 +791,41 @@ template <> Assignment to<Assignment>(IndexStmt s) {
 }
 
 
+// enum class ParallelStrategy
+std::ostream& operator<<(std::ostream& os, const ParallelStrategy& strategy) {
+  switch (strategy) {
+    case ParallelStrategy::NotParallel:
+      return os << "serial";
+    case ParallelStrategy::Static:
+      return os << "static";
+    case ParallelStrategy::Dynamic:
+      return os << "dynamic";
+  }
+  taco_unreachable;
+  return os;
+}
+
+
+// enum class ReductionStrategy
+std::ostream& operator<<(std::ostream& os, const ReductionStrategy& reduction) {
+  switch (reduction) {
+    case ReductionStrategy::Fast:
+      return os << "fast";
+    case ReductionStrategy::Deterministic:
+      return os << "deterministic";
+  }
+  taco_unreachable;
+  return os;
+}
+
+
 // class Forall
 Forall::Forall(const ForallNode* n) : IndexStmt(n) {
 }
 
-Forall::Forall(IndexVar indexVar, IndexStmt stmt)
-    : Forall(new ForallNode(indexVar, stmt)) {
+Forall::Forall(IndexVar indexVar, IndexStmt stmt, ParallelStrategy strategy,
+               ReductionStrategy reduction)
+    : Forall(new ForallNode(indexVar, stmt, strategy, reduction)) {
 }
 
 IndexVar Forall::getIndexVar() const {
@@ -805,8 +836,17 @@ IndexStmt Forall::getStmt() const {
   return getNode(*this)->stmt;
 }
 
-Forall forall(IndexVar i, IndexStmt expr) {
-  return Forall(i, expr);
+ParallelStrategy Forall::getParallelStrategy() const {
+  return getNode(*this)->strategy;
+}
+
+ReductionStrategy Forall::getReductionStrategy() const {
+  return getNode(*this)->reduction;
+}
+
+Forall forall(IndexVar i, IndexStmt expr, ParallelStrategy strategy,
+              ReductionStrategy reduction) {
+  return Forall(i, expr, strategy, reduction);
 }
 
 template <> bool isa<Forall>(IndexStmt s) {
@@ -1460,6 +1500,7 @@ struct GetIndexVars : IndexNotationVisitor {
   void visit(const AssignmentNode* node) {
     add(node->lhs.getIndexVars());
     IndexNotationVisitor::visit(node->lhs);
+    IndexNotationVisitor::visit(node->rhs);
   }
 };
 
@@ -1622,7 +1663,8 @@ private:
       stmt = op;
     }
     else {
-      stmt = new ForallNode(op->indexVar, body);
+      stmt = new ForallNode(op->indexVar, body, op->strategy,
+                            op->reduction);
     }
   }
 
@@ -177,6 +177,12 @@ void IndexNotationPrinter::visit(const AssignmentNode* op) {
 void IndexNotationPrinter::visit(const ForallNode* op) {
   os << "forall(" << op->indexVar << ", ";
   op->stmt.accept(this);
+  if (op->strategy != ParallelStrategy::NotParallel) {
+    os << ", " << op->strategy;
+    if (op->reduction != ReductionStrategy::Fast) {
+      os << ", " << op->reduction;
+    }
+  }
   os << ")";
 }
 
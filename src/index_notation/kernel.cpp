@@ -1,6 +1,7 @@
 #include "taco/index_notation/kernel.h"
 
 #include <iostream>
+#include <cstring>
 
 #include "taco/index_notation/index_notation.h"
 #include "taco/lower/lower.h"
@@ -9,6 +10,7 @@
 #include "taco/storage/index.h"
 #include "taco/storage/array.h"
 #include "taco/taco_tensor_t.h"
+#include "taco/util/thread_pool.h"
 
 using namespace std;
 
@@ -16,6 +18,12 @@ namespace taco {
 
 struct Kernel::Content {
   shared_ptr<ir::Module> module;
+
+  // Pointers to the shims that unpack the taco_tensor_t arguments, resolved
+  // once so that invoking the kernel does not look functions up by name.
+  void* evaluateShim;
+  void* assembleShim;
+  void* computeShim;
 };
 
 Kernel::Kernel() : content(nullptr) {
@@ -28,6 +36,9 @@ Kernel::Kernel() : content(nullptr) {
 Kernel::Kernel(IndexStmt stmt, shared_ptr<ir::Module> module, void* evaluate,
                void* assemble, void* compute) : content(new Content) {
   content->module = module;
+  content->evaluateShim = module->getFuncPtr("_shim_evaluate");
+  content->assembleShim = module->getFuncPtr("_shim_assemble");
+  content->computeShim  = module->getFuncPtr("_shim_compute");
   this->numResults = getResultTensorVars(stmt).size();
   this->evaluateFunction = evaluate;
   this->assembleFunction = assemble;
@@ -57,15 +68,24 @@ void unpackResults(size_t numResults, const vector<void*> arguments,
     for (int i = 0; i < storage.getOrder(); i++) {
       ModeFormat modeType = format.getModeFormats()[i];
       if (modeType == Dense) {
-        Array size = makeArray({*(int*)tensorData->indices[i][0]});
+        Datatype sizeType = format.getCoordinateTypePos(i);
+        Array size = makeArray(sizeType, 1);
+        memcpy(size.getData(), tensorData->indices[i][0],
+               sizeType.getNumBytes());
         modeIndices.push_back(ModeIndex({size}));
-        num *= ((int*)tensorData->indices[i][0])[0];
-      } else if (modeType == Sparse) {
-        auto size = ((int*)tensorData->indices[i][0])[num];
-        Array pos = Array(type<int>(), tensorData->indices[i][0], num+1, Array::UserOwns);
-        Array idx = Array(type<int>(), tensorData->indices[i][1], size, Array::UserOwns);
+        num *= size.get(0).getAsIndex();
+      } else if (modeType.getName() == Compressed.getName()) {
+        Array pos = Array(format.getCoordinateTypePos(i),
+                          tensorData->indices[i][0], num+1, Array::UserOwns);
+        auto size = pos.get(num).getAsIndex();
+        Array idx = Array(format.getCoordinateTypeIdx(i),
+                          tensorData->indices[i][1], size, Array::UserOwns);
         modeIndices.push_back(ModeIndex({pos, idx}));
         num = size;
+      } else if (modeType.getName() == Singleton.getName()) {
+        Array idx = Array(format.getCoordinateTypeIdx(i),
+                          tensorData->indices[i][0], num, Array::UserOwns);
+        modeIndices.push_back(ModeIndex({idx}));
       } else {
         taco_not_supported_yet;
       }
@@ -77,24 +97,28 @@ void unpackResults(size_t numResults, const vector<void*> arguments,
 
 bool Kernel::operator()(const vector<TensorStorage>& args) const {
   vector<void*> arguments = packArguments(args);
-  int result = content->module->callFuncPacked("evaluate", arguments.data());
+  int result = ir::Module::callFuncPtr(content->evaluateShim, arguments.data());
   unpackResults(this->numResults, arguments, args);
   return (result == 0);
 }
 
 bool Kernel::assemble(const vector<TensorStorage>& args) const {
   vector<void*> arguments = packArguments(args);
-  int result = content->module->callFuncPacked("assemble", arguments.data());
+  int result = ir::Module::callFuncPtr(content->assembleShim, arguments.data());
   unpackResults(this->numResults, arguments, args);
   return (result == 0);
 }
 
 bool Kernel::compute(const vector<TensorStorage>& args) const {
   vector<void*> arguments = packArguments(args);
-  int result = content->module->callFuncPacked("compute", arguments.data());
+  int result = ir::Module::callFuncPtr(content->computeShim, arguments.data());
   return (result == 0);
 }
 
+bool Kernel::computePacked(void** args) const {
+  return ir::Module::callFuncPtr(content->computeShim, args) == 0;
+}
+
 bool Kernel::defined() {
   return content != nullptr;
 }
@@ -103,7 +127,7 @@ std::ostream& operator<<(std::ostream& os, const Kernel& kernel) {
   return os << kernel.content->module->getSource();
 }
 
-Kernel compile(IndexStmt stmt) {
+static shared_ptr<ir::Module> lowerToModule(IndexStmt stmt) {
   string reason;
   taco_uassert(isConcreteNotation(stmt, &reason))
       << "Statement not valid concrete index notation and cannot be compiled. "
@@ -113,12 +137,28 @@ Kernel compile(IndexStmt stmt) {
   module->addFunction(lower(stmt, "compute",  false, true));
   module->addFunction(lower(stmt, "assemble", true, false));
   module->addFunction(lower(stmt, "evaluate", true, true));
-  module->compile();
+  return module;
+}
 
+static Kernel loadKernel(IndexStmt stmt, shared_ptr<ir::Module> module) {
   void* evaluate = module->getFuncPtr("evaluate");
   void* assemble = module->getFuncPtr("assemble");
   void* compute  = module->getFuncPtr("compute");
   return Kernel(stmt, module, evaluate, assemble, compute);
 }
 
+Kernel compile(IndexStmt stmt) {
+  shared_ptr<ir::Module> module = lowerToModule(stmt);
+  module->compile();
+  return loadKernel(stmt, module);
+}
+
+shared_future<Kernel> compileAsync(IndexStmt stmt) {
+  shared_ptr<ir::Module> module = lowerToModule(stmt);
+  return ir::getCompilePool().submit([stmt, module]() {
+    module->compile();
+    return loadKernel(stmt, module);
+  });
+}
+
 }
@@ -4,6 +4,7 @@
 #include "taco/index_notation/index_notation_rewriter.h"
 #include "taco/index_notation/index_notation_nodes.h"
 #include "taco/error/error_messages.h"
+#include "taco/util/collections.h"
 
 #include <iostream>
 
@@ -20,6 +21,10 @@ Transformation::Transformation(Precompute precompute)
     : transformation(new Precompute(precompute)) {
 }
 
+Transformation::Transformation(Parallelize parallelize)
+    : transformation(new Parallelize(parallelize)) {
+}
+
 IndexStmt Transformation::apply(IndexStmt stmt, string* reason) const {
   return transformation->apply(stmt, reason);
 }
@@ -94,7 +99,11 @@ IndexStmt Reorder::apply(IndexStmt stmt, string* reason) const {
         }
         auto forallj = to<Forall>(foralli.getStmt());
         if (forallj.getIndexVar() == j) {
-          stmt = forall(j, forall(i, forallj.getStmt()));
+          stmt = forall(j, forall(i, forallj.getStmt(),
+                                  foralli.getParallelStrategy(),
+                                  foralli.getReductionStrategy()),
+                        forallj.getParallelStrategy(),
+                        forallj.getReductionStrategy());
           return;
         }
       }
@@ -254,4 +263,123 @@ std::ostream& operator<<(std::ostream& os, const Precompute& precompute) {
   return os;
 }
 
+
+
+// class Parallelize
+struct Parallelize::Content {
+  IndexVar i;
+  ParallelStrategy strategy;
+  ReductionStrategy reduction;
+};
+
+Parallelize::Parallelize(IndexVar i, ParallelStrategy strategy)
+    : Parallelize(i, strategy, ReductionStrategy::Fast) {
+}
+
+Parallelize::Parallelize(IndexVar i, ParallelStrategy strategy,
+                         ReductionStrategy reduction)
+    : content(new Content) {
+  content->i = i;
+  content->strategy = strategy;
+  content->reduction = reduction;
+}
+
+IndexVar Parallelize::geti() const {
+  return content->i;
+}
+
+ParallelStrategy Parallelize::getStrategy() const {
+  return content->strategy;
+}
+
+ReductionStrategy Parallelize::getReductionStrategy() const {
+  return content->reduction;
+}
+
+IndexStmt Parallelize::apply(IndexStmt stmt, std::string* reason) const {
+  INIT_REASON(reason);
+
+  string r;
+  if (!isConcreteNotation(stmt, &r)) {
+    *reason = "The index statement is not valid concrete index notation: " + r;
+    return IndexStmt();
+  }
+
+  // Precondition: The statement contains a forall of i
+  IndexVar i = geti();
+  Forall foralli;
+  match(stmt,
+    function<void(const ForallNode*,Matcher*)>([&](const ForallNode* op,
+                                                   Matcher* ctx) {
+      if (op->indexVar == i) {
+        foralli = op;
+      }
+      else {
+        ctx->match(op->stmt);
+      }
+    })
+  );
+  if (!foralli.defined()) {
+    *reason = "There is no forall of index variable " + util::toString(i) +
+              " to parallelize.";
+    return IndexStmt();
+  }
+
+  // Precondition: Iterations of the forall do not overwrite the same result
+  // components (they may reduce into them) or share temporaries
+  bool races = false;
+  match(foralli.getStmt(),
+    function<void(const AssignmentNode*)>([&](const AssignmentNode* op) {
+      if (!races && !util::contains(op->lhs.getIndexVars(), i) &&
+          !op->op.defined()) {
+        *reason = "The result " + util::toString(op->lhs) + " is not " +
+                  "indexed by " + util::toString(i) + ", so iterations of " +
+                  "the forall of " + util::toString(i) + " overwrite the " +
+                  "same components.";
+        races = true;
+      }
+    }),
+    function<void(const WhereNode*)>([&](const WhereNode* op) {
+      if (!races) {
+        *reason = "The forall of " + util::toString(i) + " contains " +
+                  "temporaries that would be shared between threads.";
+        races = true;
+      }
+    })
+  );
+  if (races) {
+    return IndexStmt();
+  }
+
+  struct ParallelizeRewriter : public IndexNotationRewriter {
+    using IndexNotationRewriter::visit;
+
+    Parallelize parallelize;
+    ParallelizeRewriter(Parallelize parallelize) : parallelize(parallelize) {}
+
+    void visit(const ForallNode* node) {
+      if (node->indexVar == parallelize.geti()) {
+        stmt = forall(node->indexVar, node->stmt, parallelize.getStrategy(),
+                      parallelize.getReductionStrategy());
+        return;
+      }
+      IndexNotationRewriter::visit(node);
+    }
+  };
+  return ParallelizeRewriter(*this).rewrite(stmt);
+}
+
+void Parallelize::print(std::ostream& os) const {
+  os << "parallelize(" << geti() << ", " << getStrategy();
+  if (getReductionStrategy() != ReductionStrategy::Fast) {
+    os << ", " << getReductionStrategy();
+  }
+  os << ")";
+}
+
+std::ostream& operator<<(std::ostream& os, const Parallelize& parallelize) {
+  parallelize.print(os);
+  return os;
+}
+
 }
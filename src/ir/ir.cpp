@@ -249,6 +249,20 @@ Expr Sqrt::make(Expr a) {
   return sqrt;
 }
 
+Expr Popcount::make(Expr a) {
+  Popcount *popcount = new Popcount;
+  popcount->a = a;
+  popcount->type = Int();
+  return popcount;
+}
+
+Expr Ctz::make(Expr a) {
+  Ctz *ctz = new Ctz;
+  ctz->a = a;
+  ctz->type = Int();
+  return ctz;
+}
+
 // Binary Expressions
 // helper
 Datatype max_expr_type(Expr a, Expr b);
@@ -382,6 +396,14 @@ Expr BitOr::make(Expr a, Expr b) {
   return bitOr;
 }
 
+Expr Shl::make(Expr a, Expr b) {
+  Shl *shl = new Shl;
+  shl->type = a.type();
+  shl->a = a;
+  shl->b = b;
+  return shl;
+}
+
 // Boolean binary ops
 Expr Eq::make(Expr a, Expr b) {
   Eq *eq = new Eq;
@@ -521,11 +543,12 @@ Stmt Scope::make(Stmt scopedStmt) {
 }
 
 // Store to an array
-Stmt Store::make(Expr arr, Expr loc, Expr data) {
+Stmt Store::make(Expr arr, Expr loc, Expr data, bool use_atomics) {
   Store *store = new Store;
   store->arr = arr;
   store->loc = loc;
   store->data = data;
+  store->use_atomics = use_atomics;
   return store;
 }
 
@@ -543,8 +566,9 @@ Stmt IfThenElse::make(Expr cond, Stmt then, Stmt otherwise) {
   ite->cond = cond;
   ite->then = then;
   ite->otherwise = otherwise;
-  ite->then = Scope::make(then);
-  ite->otherwise = otherwise.defined() ? Scope::make(otherwise) : otherwise;
+  ite->then = isa<Scope>(then) ? then : Scope::make(then);
+  ite->otherwise = (!otherwise.defined() || isa<Scope>(otherwise))
+                   ? otherwise : Scope::make(otherwise);
   return ite;
 }
 
@@ -654,6 +678,15 @@ Stmt Allocate::make(Expr var, Expr num_elements, bool is_realloc, Expr old_eleme
   return alloc;
 }
 
+// Free
+Stmt Free::make(Expr var) {
+  taco_iassert(var.as<Var>() && var.as<Var>()->is_ptr) <<
+      "Can only free memory of a pointer-typed Var";
+  Free* free = new Free;
+  free->var = var;
+  return free;
+}
+
 // Comment
 Stmt Comment::make(std::string text) {
   Comment* comment = new Comment;
@@ -686,6 +719,8 @@ Expr GetProperty::make(Expr tensor, TensorProperty property, int mode,
   //TODO: deal with the fact that some of these are pointers
   if (property == TensorProperty::Values)
     gp->type = tensor.type();
+  else if (property == TensorProperty::ValuesSize)
+    gp->type = Int64;
   else
     gp->type = Int();
   
@@ -693,6 +728,19 @@ Expr GetProperty::make(Expr tensor, TensorProperty property, int mode,
 }
 
 
+Expr GetProperty::make(Expr tensor, TensorProperty property, int mode,
+                       int index, std::string name, Datatype type) {
+  taco_iassert(property == TensorProperty::Indices);
+  GetProperty* gp = new GetProperty;
+  gp->tensor = tensor;
+  gp->property = property;
+  gp->mode = mode;
+  gp->name = name;
+  gp->index = index;
+  gp->type = type;
+  return gp;
+}
+
 // GetProperty
 Expr GetProperty::make(Expr tensor, TensorProperty property, int mode) {
   GetProperty* gp = new GetProperty;
@@ -703,6 +751,8 @@ Expr GetProperty::make(Expr tensor, TensorProperty property, int mode) {
   //TODO: deal with the fact that these are pointers.
   if (property == TensorProperty::Values)
     gp->type = tensor.type();
+  else if (property == TensorProperty::ValuesSize)
+    gp->type = Int64;
   else
     gp->type = Int();
   
@@ -746,6 +796,10 @@ template<> void ExprNode<Neg>::accept(IRVisitorStrict *v)
     const { v->visit((const Neg*)this); }
 template<> void ExprNode<Sqrt>::accept(IRVisitorStrict *v)
     const { v->visit((const Sqrt*)this); }
+template<> void ExprNode<Popcount>::accept(IRVisitorStrict *v)
+    const { v->visit((const Popcount*)this); }
+template<> void ExprNode<Ctz>::accept(IRVisitorStrict *v)
+    const { v->visit((const Ctz*)this); }
 template<> void ExprNode<Add>::accept(IRVisitorStrict *v)
     const { v->visit((const Add*)this); }
 template<> void ExprNode<Sub>::accept(IRVisitorStrict *v)
@@ -764,6 +818,8 @@ template<> void ExprNode<BitAnd>::accept(IRVisitorStrict *v)
     const { v->visit((const BitAnd*)this); }
 template<> void ExprNode<BitOr>::accept(IRVisitorStrict *v)
     const { v->visit((const BitOr*)this); }
+template<> void ExprNode<Shl>::accept(IRVisitorStrict *v)
+    const { v->visit((const Shl*)this); }
 template<> void ExprNode<Eq>::accept(IRVisitorStrict *v)
     const { v->visit((const Eq*)this); }
 template<> void ExprNode<Neq>::accept(IRVisitorStrict *v)
@@ -808,6 +864,8 @@ template<> void StmtNode<Assign>::accept(IRVisitorStrict *v)
     const { v->visit((const Assign*)this); }
 template<> void StmtNode<Allocate>::accept(IRVisitorStrict *v)
     const { v->visit((const Allocate*)this); }
+template<> void StmtNode<Free>::accept(IRVisitorStrict *v)
+    const { v->visit((const Free*)this); }
 template<> void StmtNode<Comment>::accept(IRVisitorStrict *v)
     const { v->visit((const Comment*)this); }
 template<> void StmtNode<BlankLine>::accept(IRVisitorStrict *v)
@@ -6,8 +6,8 @@
 namespace taco {
 namespace ir {
 
-Stmt compoundStore(Expr a, Expr i, Expr val) {
-  return Store::make(a, i, Add::make(Load::make(a, i), val));
+Stmt compoundStore(Expr a, Expr i, Expr val, bool use_atomics) {
+  return Store::make(a, i, Add::make(Load::make(a, i), val), use_atomics);
 }
 
 Stmt compoundAssign(Expr a, Expr val) {
@@ -24,8 +24,13 @@ Expr conjunction(std::vector<Expr> exprs) {
 }
 
 Stmt doubleSizeIfFull(Expr a, Expr size, Expr needed) {
-  Stmt resize = Assign::make(size, Mul::make(size, 2));
-  Stmt realloc = Allocate::make(a, Mul::make(size, 2), true, size);
+  Datatype type = size.type();
+  Expr two = Literal::make(TypedComponentVal(type, 2), type);
+  if (needed.type() != type) {
+    needed = Cast::make(needed, type);
+  }
+  Stmt resize = Assign::make(size, Mul::make(size, two));
+  Stmt realloc = Allocate::make(a, Mul::make(size, two), true, size);
   Stmt ifBody = Block::make({realloc, resize});
   return IfThenElse::make(Lte::make(size,needed), ifBody);
 }
@@ -9,8 +9,8 @@ namespace ir {
 class Expr;
 class Stmt;
 
-/// Generate `a[i] += val;`
-Stmt compoundStore(Expr a, Expr i, Expr val);
+/// Generate `a[i] += val;`, optionally as an atomic update.
+Stmt compoundStore(Expr a, Expr i, Expr val, bool use_atomics=false);
 
 /// Generate `a += val;`
 Stmt compoundAssign(Expr a, Expr val);
@@ -95,20 +95,22 @@ void IRPrinter::visit(const Literal* op) {
     break;
     case Datatype::Float32:
       stream << ((op->getValue<float>() != 0.0)
-                 ? util::toString(op->getValue<float>()) : "0.0");
+                 ? util::toExactString(op->getValue<float>()) : "0.0");
     break;
     case Datatype::Float64:
       stream << ((op->getValue<double>()!=0.0)
-                 ? util::toString(op->getValue<double>()) : "0.0");
+                 ? util::toExactString(op->getValue<double>()) : "0.0");
     break;
     case Datatype::Complex64: {
       std::complex<float> val = op->getValue<std::complex<float>>();
-      stream << val.real() << " + I*" << val.imag();
+      stream << util::toExactString(val.real()) << " + I*"
+             << util::toExactString(val.imag());
     }
     break;
     case Datatype::Complex128: {
       std::complex<double> val = op->getValue<std::complex<double>>();
-      stream << val.real() << " + I*" << val.imag();
+      stream << util::toExactString(val.real()) << " + I*"
+             << util::toExactString(val.imag());
     }
     break;
     case Datatype::Undefined:
@@ -142,6 +144,18 @@ void IRPrinter::visit(const Sqrt* op) {
   stream << ")";
 }
 
+void IRPrinter::visit(const Popcount* op) {
+  stream << "popcount(";
+  op->a.accept(this);
+  stream << ")";
+}
+
+void IRPrinter::visit(const Ctz* op) {
+  stream << "ctz(";
+  op->a.accept(this);
+  stream << ")";
+}
+
 void IRPrinter::visit(const Add* op) {
   printBinOp(op->a, op->b, "+", Precedence::ADD);
 }
@@ -188,6 +202,10 @@ void IRPrinter::visit(const BitOr* op){
   printBinOp(op->a, op->b, "|", Precedence::BOR);
 }
 
+void IRPrinter::visit(const Shl* op){
+  printBinOp(op->a, op->b, "<<", Precedence::SHL);
+}
+
 void IRPrinter::visit(const Eq* op){
   printBinOp(op->a, op->b, "==", Precedence::EQ);
 }
@@ -395,7 +413,19 @@ void IRPrinter::visit(const While* op) {
 }
 
 void IRPrinter::visit(const Block* op) {
-  acceptJoin(this, stream, op->contents, "");
+  for (auto& stmt : op->contents) {
+    // Scopes in blocks (e.g. unrolled loop iterations) are printed as compound
+    // statements, as their declarations may be repeated
+    if (isa<Scope>(stmt)) {
+      doIndent();
+      stream << "{" << endl;
+      stmt.accept(this);
+      doIndent();
+      stream << "}" << endl;
+    } else {
+      stmt.accept(this);
+    }
+  }
 }
 
 void IRPrinter::visit(const Scope* op) {
@@ -496,6 +526,13 @@ void IRPrinter::visit(const Allocate* op) {
   stream << endl;
 }
 
+void IRPrinter::visit(const Free* op) {
+  doIndent();
+  stream << "free ";
+  op->var.accept(this);
+  stream << endl;
+}
+
 void IRPrinter::visit(const Comment* op) {
   doIndent();
   stream << commentString(op->text);
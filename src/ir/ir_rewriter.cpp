@@ -78,6 +78,14 @@ void IRRewriter::visit(const Sqrt* op) {
   expr = visitUnaryOp(op, this);
 }
 
+void IRRewriter::visit(const Popcount* op) {
+  expr = visitUnaryOp(op, this);
+}
+
+void IRRewriter::visit(const Ctz* op) {
+  expr = visitUnaryOp(op, this);
+}
+
 void IRRewriter::visit(const Add* op) {
   expr = visitBinaryOp(op, this);
 }
@@ -128,6 +136,10 @@ void IRRewriter::visit(const BitOr* op) {
   expr = visitBinaryOp(op, this);
 }
 
+void IRRewriter::visit(const Shl* op) {
+  expr = visitBinaryOp(op, this);
+}
+
 void IRRewriter::visit(const Eq* op) {
   expr = visitBinaryOp(op, this);
 }
@@ -241,7 +253,7 @@ void IRRewriter::visit(const Store* op) {
     stmt = op;
   }
   else {
-    stmt = Store::make(arr, loc, data);
+    stmt = Store::make(arr, loc, data, op->use_atomics);
   }
 }
 
@@ -364,6 +376,16 @@ void IRRewriter::visit(const Allocate* op) {
   }
 }
 
+void IRRewriter::visit(const Free* op) {
+  Expr var = rewrite(op->var);
+  if (var == op->var) {
+    stmt = op;
+  }
+  else {
+    stmt = Free::make(var);
+  }
+}
+
 void IRRewriter::visit(const Comment* op) {
   stmt = op;
 }
@@ -395,6 +417,10 @@ void IRRewriter::visit(const GetProperty* op) {
   if (tensor == op->tensor) {
     expr = op;
   }
+  else if (op->property == TensorProperty::Indices) {
+    expr = GetProperty::make(tensor, op->property, op->mode, op->index,
+                             op->name, op->type);
+  }
   else {
     expr = GetProperty::make(tensor, op->property, op->mode, op->index, op->name);
   }
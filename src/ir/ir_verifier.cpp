@@ -86,6 +86,14 @@ protected:
     op->b.accept(this);
   }
 
+  void visit(const Shl *op) {
+    if (op->a.type() != op->type) {
+      messages << "Node: " << (Expr)op << " has operand with incorrect type\n";
+    }
+    op->a.accept(this);
+    op->b.accept(this);
+  }
+
   void visit(const BitOr *op) {
     // TODO: do we want to enforce integer-ness?
     auto tp = op->type;
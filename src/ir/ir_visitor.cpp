@@ -28,6 +28,14 @@ void IRVisitor::visit(const Sqrt* op) {
   op->a.accept(this);
 }
 
+void IRVisitor::visit(const Popcount* op) {
+  op->a.accept(this);
+}
+
+void IRVisitor::visit(const Ctz* op) {
+  op->a.accept(this);
+}
+
 void IRVisitor::visit(const Add* op) {
   op->a.accept(this);
   op->b.accept(this);
@@ -74,6 +82,11 @@ void IRVisitor::visit(const BitOr* op){
   op->b.accept(this);
 }
 
+void IRVisitor::visit(const Shl* op){
+  op->a.accept(this);
+  op->b.accept(this);
+}
+
 void IRVisitor::visit(const Eq* op){
   op->a.accept(this);
   op->b.accept(this);
@@ -193,6 +206,10 @@ void IRVisitor::visit(const Allocate* op) {
   op->num_elements.accept(this);
 }
 
+void IRVisitor::visit(const Free* op) {
+  op->var.accept(this);
+}
+
 void IRVisitor::visit(const GetProperty* op) {
   op->tensor.accept(this);
 }
@@ -314,7 +314,9 @@ ir::Stmt simplify(const ir::Stmt& stmt) {
     void visit(const Scope* scope) {
       declarations.scope();
       varsToReplace.scope();
-      stmt = rewrite(scope->scopedStmt);
+      Stmt scopedStmt = rewrite(scope->scopedStmt);
+      stmt = (scopedStmt == scope->scopedStmt) ? scope
+                                               : Scope::make(scopedStmt);
       varsToReplace.unscope();
       declarations.unscope();
     }
@@ -347,9 +349,48 @@ ir::Stmt simplify(const ir::Stmt& stmt) {
       if (!assign->lhs.type().isInt()) {
         return;
       }
-      
+      invalidate(assign->lhs);
+    }
+
+    void visit(const For* loop) {
+      invalidateAssignedVars(loop->contents);
+      ExpressionSimplifier::visit(loop);
+    }
+
+    void visit(const While* loop) {
+      invalidateAssignedVars(loop->contents);
+      ExpressionSimplifier::visit(loop);
+    }
+
+    void visit(const Var* var) {
+      expr = varsToReplace.contains(var) ? varsToReplace.get(var).first : var;
+      if (declarations.contains(expr)) {
+        necessaryDecls.insert(declarations.get(expr));
+      }
+    }
+
+    // Variables assigned in a loop body hold different values in different
+    // iterations, so their uses anywhere in the loop cannot be replaced.
+    void invalidateAssignedVars(Stmt body) {
+      struct AssignedVars : IRVisitor {
+        std::vector<Expr> vars;
+        using IRVisitor::visit;
+        void visit(const Assign* assign) {
+          if (isa<Var>(assign->lhs) && assign->lhs.type().isInt()) {
+            vars.push_back(assign->lhs);
+          }
+        }
+      };
+      AssignedVars assignedVars;
+      body.accept(&assignedVars);
+      for (auto& var : assignedVars.vars) {
+        invalidate(var);
+      }
+    }
+
+    void invalidate(Expr var) {
       std::queue<Expr> invalidVars;
-      invalidVars.push(assign->lhs);
+      invalidVars.push(var);
 
       while (!invalidVars.empty()) {
         Expr invalidVar = invalidVars.front();
@@ -365,13 +406,6 @@ ir::Stmt simplify(const ir::Stmt& stmt) {
         }
       }
     }
-
-    void visit(const Var* var) {
-      expr = varsToReplace.contains(var) ? varsToReplace.get(var).first : var;
-      if (declarations.contains(expr)) {
-        necessaryDecls.insert(declarations.get(expr));
-      }
-    }
   };
 
   Simplifier copyPropagation;
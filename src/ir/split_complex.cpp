@@ -0,0 +1,324 @@
+#include "split_complex.h"
+
+#include <map>
+#include <complex>
+#include <functional>
+
+#include "taco/ir/ir.h"
+#include "taco/ir/ir_visitor.h"
+#include "taco/ir/ir_rewriter.h"
+#include "taco/error.h"
+#include "taco/util/collections.h"
+
+using namespace std;
+
+namespace taco {
+namespace ir {
+
+/// The real and imaginary parts of a complex expression.  The imaginary part
+/// of complex expressions that are real (e.g. real operands that are promoted
+/// to complex) is undefined.
+typedef pair<Expr,Expr> Parts;
+
+static Datatype getPartType(Datatype type) {
+  taco_iassert(type.isComplex());
+  return (type.getKind() == Datatype::Complex64) ? Float32 : Float64;
+}
+
+static Expr sum(Expr a, Expr b) {
+  return !a.defined() ? b : (!b.defined() ? a : Add::make(a, b));
+}
+
+static Expr difference(Expr a, Expr b) {
+  return !b.defined() ? a : (!a.defined() ? Neg::make(b) : Sub::make(a, b));
+}
+
+static Expr product(Expr a, Expr b) {
+  return (a.defined() && b.defined()) ? Mul::make(a, b) : Expr();
+}
+
+static bool isSameArray(Expr a, Expr b) {
+  if (a == b) {
+    return true;
+  }
+  if (!isa<GetProperty>(a) || !isa<GetProperty>(b)) {
+    return false;
+  }
+  auto aProperty = to<GetProperty>(a);
+  auto bProperty = to<GetProperty>(b);
+  return aProperty->tensor == bProperty->tensor &&
+         aProperty->property == bProperty->property &&
+         aProperty->mode == bProperty->mode &&
+         aProperty->index == bProperty->index;
+}
+
+/// Returns true if the location is the location of an imaginary part in the
+/// values of a split tensor.
+static bool isImaginaryLocation(Expr loc) {
+  return isa<Add>(loc) && isa<GetProperty>(to<Add>(loc)->b) &&
+         to<GetProperty>(to<Add>(loc)->b)->property ==
+             TensorProperty::ValuesSize;
+}
+
+/// Returns true if the expression reads the real parts stored in the variable
+/// or array.
+static bool readsRealPart(Expr expr, Expr var) {
+  struct Reads : public IRVisitor {
+    using IRVisitor::visit;
+    Expr var;
+    bool reads = false;
+    void visit(const Var* op) {
+      reads |= (Expr(op) == var);
+    }
+    void visit(const Load* op) {
+      reads |= isSameArray(op->arr, var) && !isImaginaryLocation(op->loc);
+      op->loc.accept(this);
+    }
+  };
+  Reads visitor;
+  visitor.var = var;
+  expr.accept(&visitor);
+  return visitor.reads;
+}
+
+struct ComplexSplitter : public IRRewriter {
+  using IRRewriter::visit;
+
+  /// The tensors that store split values, and their variables with real
+  /// components
+  map<Expr,Expr> tensors;
+
+  /// The parts of complex variables and arrays
+  map<Expr,Parts> parts;
+
+  ComplexSplitter(const vector<Expr>& splitTensors) {
+    for (auto& tensor : splitTensors) {
+      const Var* var = tensor.as<Var>();
+      taco_iassert(var != nullptr && var->is_tensor);
+      tensors.insert({tensor, Var::make(var->name, getPartType(var->type),
+                                        var->is_ptr, var->is_tensor)});
+    }
+  }
+
+  Parts getParts(Expr var) {
+    if (!util::contains(parts, var)) {
+      const Var* complexVar = var.as<Var>();
+      taco_iassert(complexVar != nullptr) <<
+          "Only complex variables and arrays can be split";
+      Datatype type = getPartType(complexVar->type);
+      parts.insert({var, {Var::make(complexVar->name + "_re", type,
+                                    complexVar->is_ptr),
+                          Var::make(complexVar->name + "_im", type,
+                                    complexVar->is_ptr)}});
+    }
+    return parts.at(var);
+  }
+
+  /// Returns the arrays and locations of the parts of a component of a
+  /// complex array.  Split tensors store the imaginary parts of their values
+  /// after the real parts of all of them.
+  pair<Parts,Parts> getComponentParts(Expr arr, Expr loc) {
+    loc = rewrite(loc);
+    if (isa<GetProperty>(arr)) {
+      taco_iassert(to<GetProperty>(arr)->property == TensorProperty::Values);
+      taco_iassert(util::contains(tensors, to<GetProperty>(arr)->tensor)) <<
+          "Complex values must be split to be computed with real arithmetic";
+      Expr vals = rewrite(arr);
+      Expr size = GetProperty::make(to<GetProperty>(vals)->tensor,
+                                    TensorProperty::ValuesSize);
+      return {{vals, loc}, {vals, Add::make(loc, size)}};
+    }
+    Parts arrays = getParts(arr);
+    return {{arrays.first, loc}, {arrays.second, loc}};
+  }
+
+  Expr getImaginaryPart(const Parts& parts, Datatype type) {
+    return parts.second.defined() ? parts.second
+                                  : Literal::zero(getPartType(type));
+  }
+
+  Parts split(Expr expr) {
+    if (!expr.type().isComplex()) {
+      return {rewrite(expr), Expr()};
+    }
+
+    if (isa<Literal>(expr)) {
+      auto literal = to<Literal>(expr);
+      if (literal->type.getKind() == Datatype::Complex64) {
+        auto value = literal->getValue<std::complex<float>>();
+        return {Literal::make(value.real()), Literal::make(value.imag())};
+      }
+      auto value = literal->getValue<std::complex<double>>();
+      return {Literal::make(value.real()), Literal::make(value.imag())};
+    }
+    else if (isa<Var>(expr)) {
+      return getParts(expr);
+    }
+    else if (isa<Load>(expr)) {
+      auto load = to<Load>(expr);
+      auto component = getComponentParts(load->arr, load->loc);
+      return {Load::make(component.first.first, component.first.second),
+              Load::make(component.second.first, component.second.second)};
+    }
+    else if (isa<Neg>(expr)) {
+      Parts a = split(to<Neg>(expr)->a);
+      return {Neg::make(a.first), difference(Expr(), a.second)};
+    }
+    else if (isa<Add>(expr)) {
+      Parts a = split(to<Add>(expr)->a);
+      Parts b = split(to<Add>(expr)->b);
+      return {Add::make(a.first, b.first), sum(a.second, b.second)};
+    }
+    else if (isa<Sub>(expr)) {
+      Parts a = split(to<Sub>(expr)->a);
+      Parts b = split(to<Sub>(expr)->b);
+      return {Sub::make(a.first, b.first), difference(a.second, b.second)};
+    }
+    else if (isa<Mul>(expr)) {
+      // (a + bi)(c + di) = (ac - bd) + (ad + bc)i
+      Parts a = split(to<Mul>(expr)->a);
+      Parts b = split(to<Mul>(expr)->b);
+      return {difference(Mul::make(a.first, b.first),
+                         product(a.second, b.second)),
+              sum(product(a.first, b.second), product(a.second, b.first))};
+    }
+    else if (isa<Div>(expr)) {
+      Parts a = split(to<Div>(expr)->a);
+      Parts b = split(to<Div>(expr)->b);
+      if (!b.second.defined()) {
+        return {Div::make(a.first, b.first),
+                a.second.defined() ? Div::make(a.second, b.first) : Expr()};
+      }
+      // (a + bi)/(c + di) = ((ac + bd) + (bc - ad)i) / (cc + dd)
+      Expr norm = Add::make(Mul::make(b.first, b.first),
+                            Mul::make(b.second, b.second));
+      return {Div::make(sum(Mul::make(a.first, b.first),
+                            product(a.second, b.second)), norm),
+              Div::make(difference(product(a.second, b.first),
+                                   Mul::make(a.first, b.second)), norm)};
+    }
+    else if (isa<Cast>(expr)) {
+      auto cast = to<Cast>(expr);
+      Datatype type = getPartType(cast->type);
+      Parts a = split(cast->a);
+      return {Cast::make(a.first, type),
+              a.second.defined() ? Cast::make(a.second, type) : Expr()};
+    }
+    taco_not_supported_yet << ": splitting complex " << expr;
+    return Parts();
+  }
+
+  /// Assigns the parts of a complex value to the variables or arrays that
+  /// store the real part in re, through a temporary if the imaginary part
+  /// reads the real part that is assigned before it.
+  Stmt assignParts(Expr re, Parts value, function<Stmt(Expr)> assignRe,
+                   function<Stmt(Expr)> assignIm, string name,
+                   Datatype type) {
+    Expr imaginaryPart = getImaginaryPart(value, type);
+    if (!readsRealPart(imaginaryPart, re)) {
+      return Block::make({assignRe(value.first), assignIm(imaginaryPart)});
+    }
+    Expr realPart = Var::make(name + "_re_val", getPartType(type));
+    return Block::make({VarDecl::make(realPart, value.first),
+                        assignIm(imaginaryPart), assignRe(realPart)});
+  }
+
+  void visit(const Var* op) {
+    if (util::contains(tensors, Expr(op))) {
+      expr = tensors.at(op);
+      return;
+    }
+    taco_iassert(!op->type.isComplex()) <<
+        "Complex variables must be split with their expressions";
+    expr = op;
+  }
+
+  void visit(const VarDecl* op) {
+    if (!op->var.type().isComplex()) {
+      IRRewriter::visit(op);
+      return;
+    }
+    Parts var = getParts(op->var);
+    Parts rhs = split(op->rhs);
+    stmt = Block::make({VarDecl::make(var.first, rhs.first),
+                        VarDecl::make(var.second,
+                                      getImaginaryPart(rhs, op->var.type()))});
+  }
+
+  void visit(const Assign* op) {
+    if (!op->lhs.type().isComplex()) {
+      IRRewriter::visit(op);
+      return;
+    }
+    Parts lhs = getParts(op->lhs);
+    stmt = assignParts(lhs.first, split(op->rhs),
+                       [&](Expr value) {
+                         return Assign::make(lhs.first, value);
+                       },
+                       [&](Expr value) {
+                         return Assign::make(lhs.second, value);
+                       }, to<Var>(op->lhs)->name, op->lhs.type());
+  }
+
+  void visit(const Store* op) {
+    if (!op->data.type().isComplex()) {
+      IRRewriter::visit(op);
+      return;
+    }
+    auto component = getComponentParts(op->arr, op->loc);
+    Parts re = component.first;
+    Parts im = component.second;
+    string name = isa<Var>(op->arr) ? to<Var>(op->arr)->name
+                                    : to<GetProperty>(op->arr)->name;
+    stmt = assignParts(re.first, split(op->data),
+                       [&](Expr value) {
+                         return Store::make(re.first, re.second, value,
+                                            op->use_atomics);
+                       },
+                       [&](Expr value) {
+                         return Store::make(im.first, im.second, value,
+                                            op->use_atomics);
+                       }, name, op->data.type());
+  }
+
+  void visit(const Allocate* op) {
+    if (!op->var.type().isComplex()) {
+      IRRewriter::visit(op);
+      return;
+    }
+    Expr numElements = rewrite(op->num_elements);
+    if (isa<GetProperty>(op->var)) {
+      // Split tensors record the number of their values, which locates the
+      // imaginary parts
+      taco_iassert(!op->is_realloc) << "Split values cannot be reallocated";
+      Expr vals = rewrite(op->var);
+      Expr size = GetProperty::make(to<GetProperty>(vals)->tensor,
+                                    TensorProperty::ValuesSize);
+      stmt = Block::make({Allocate::make(vals, Mul::make(2, numElements)),
+                          Assign::make(size, numElements)});
+      return;
+    }
+    Parts arrays = getParts(op->var);
+    Expr oldElements = op->old_elements.defined()
+                       ? rewrite(op->old_elements) : Expr();
+    stmt = Block::make({Allocate::make(arrays.first, numElements,
+                                       op->is_realloc, oldElements),
+                        Allocate::make(arrays.second, numElements,
+                                       op->is_realloc, oldElements)});
+  }
+
+  void visit(const Free* op) {
+    if (!op->var.type().isComplex()) {
+      IRRewriter::visit(op);
+      return;
+    }
+    Parts arrays = getParts(op->var);
+    stmt = Block::make({Free::make(arrays.first), Free::make(arrays.second)});
+  }
+};
+
+Stmt splitComplex(Stmt function, const vector<Expr>& tensors) {
+  return ComplexSplitter(tensors).rewrite(function);
+}
+
+}}
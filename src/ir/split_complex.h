@@ -0,0 +1,20 @@
+#ifndef TACO_IR_SPLIT_COMPLEX_H
+#define TACO_IR_SPLIT_COMPLEX_H
+
+#include <vector>
+
+namespace taco {
+
+namespace ir {
+class Expr;
+class Stmt;
+
+/// Rewrite a function that computes complex values to compute their real and
+/// imaginary parts with real arithmetic.  The given tensors store their values
+/// split into the real parts of all components followed by their imaginary
+/// parts, and complex variables and arrays are split into one variable or
+/// array per part.
+Stmt splitComplex(Stmt function, const std::vector<Expr>& tensors);
+
+}}
+#endif
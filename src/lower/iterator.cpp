@@ -34,9 +34,10 @@ struct Iterator::Content {
 Iterator::Iterator() : content(nullptr) {
 }
 
-Iterator::Iterator(IndexVar indexVar) : content(new Content) {
+Iterator::Iterator(IndexVar indexVar, Datatype coordType)
+    : content(new Content) {
   content->indexVar = indexVar;
-  content->coordVar = Var::make(indexVar.getName(), Int());
+  content->coordVar = Var::make(indexVar.getName(), coordType);
 }
 
 Iterator::Iterator(ir::Expr tensor) : content(new Content) {
@@ -47,7 +48,8 @@ Iterator::Iterator(ir::Expr tensor) : content(new Content) {
 }
 
 Iterator::Iterator(IndexVar indexVar, Expr tensor, Mode mode, Iterator parent,
-                   string name) : content(new Content) {
+                   string name, Datatype posType, Datatype coordType)
+    : content(new Content) {
   content->indexVar = indexVar;
 
   content->mode = mode;
@@ -56,17 +58,18 @@ Iterator::Iterator(IndexVar indexVar, Expr tensor, Mode mode, Iterator parent,
   string modeName = mode.getName();
   content->tensor = tensor;
 
-  content->posVar   = Var::make("p" + modeName,            Int());
-  content->endVar   = Var::make("p" + modeName + "_end",   Int());
-  content->beginVar = Var::make("p" + modeName + "_begin", Int());
+  content->posVar   = Var::make("p" + modeName,            posType);
+  content->endVar   = Var::make("p" + modeName + "_end",   posType);
+  content->beginVar = Var::make("p" + modeName + "_begin", posType);
 
-  content->coordVar = Var::make(name, Int());
-  content->segendVar = Var::make(modeName + "_segend", Int());
+  content->coordVar = Var::make(name, coordType);
+  content->segendVar = Var::make(modeName + "_segend", posType);
   content->validVar = Var::make("v" + modeName, Bool);
 }
 
 Iterator::Iterator(const old::TensorPath& path, std::string coordVarName,
-                   const ir::Expr& tensor, Mode mode, Iterator parent)
+                   const ir::Expr& tensor, Mode mode, Iterator parent,
+                   Datatype posType, Datatype coordType)
     : content(new Content) {
   content->path = path;
 
@@ -75,12 +78,13 @@ Iterator::Iterator(const old::TensorPath& path, std::string coordVarName,
 
   string modeName = mode.getName();
   content->tensor = tensor;
-  content->posVar = Var::make("p" + modeName, Int());
-  content->coordVar = Var::make(coordVarName + util::toString(tensor), Int());
-  content->endVar = Var::make(modeName + "_end", Int());
-  content->segendVar = Var::make(modeName + "_segend", Int());
+  content->posVar = Var::make("p" + modeName, posType);
+  content->coordVar = Var::make(coordVarName + util::toString(tensor),
+                                coordType);
+  content->endVar = Var::make(modeName + "_end", posType);
+  content->segendVar = Var::make(modeName + "_segend", posType);
   content->validVar = Var::make("v" + modeName, Bool);
-  content->beginVar = Var::make(modeName + "_begin", Int());
+  content->beginVar = Var::make(modeName + "_begin", posType);
 }
 
 const Iterator& Iterator::getParent() const {
@@ -212,6 +216,12 @@ bool Iterator::hasAppend() const {
   return getMode().defined() && getMode().getModeFormat().hasAppend();
 }
 
+bool Iterator::hasWordIter() const {
+  taco_iassert(defined());
+  if (isDimensionIterator()) return false;
+  return getMode().defined() && getMode().getModeFormat().hasWordIter();
+}
+
 ModeFunction Iterator::coordBounds(const std::vector<ir::Expr>& coords) const {
   taco_iassert(defined() && content->mode.defined());
   return getMode().getModeFormat().impl->coordIterBounds(coords, getMode());
@@ -229,12 +239,35 @@ ModeFunction Iterator::posBounds() const {
                                                getMode());
 }
 
+ModeFunction Iterator::posBounds(const ir::Expr& parentPos) const {
+  taco_iassert(defined() && content->mode.defined());
+  return getMode().getModeFormat().impl->posIterBounds(parentPos, getMode());
+}
+
 ModeFunction Iterator::posAccess(const std::vector<ir::Expr>& coords) const {
   taco_iassert(defined() && content->mode.defined());
   return getMode().getModeFormat().impl->posIterAccess(getPosVar(),
                                                  coords, getMode());
 }
 
+ModeFunction Iterator::posAccess(const ir::Expr& pos,
+                                 const std::vector<ir::Expr>& coords) const {
+  taco_iassert(defined() && content->mode.defined());
+  return getMode().getModeFormat().impl->posIterAccess(pos, coords, getMode());
+}
+
+ModeFunction Iterator::wordBounds() const {
+  taco_iassert(defined() && content->mode.defined());
+  return getMode().getModeFormat().impl->wordIterBounds(getParent().getPosVar(),
+                                                       getMode());
+}
+
+ModeFunction Iterator::wordAccess(const ir::Expr& word) const {
+  taco_iassert(defined() && content->mode.defined());
+  return getMode().getModeFormat().impl->wordIterAccess(getParent().getPosVar(),
+                                                       word, getMode());
+}
+
 ModeFunction Iterator::locate(const std::vector<ir::Expr>& coords) const {
   taco_iassert(defined() && content->mode.defined());
   return getMode().getModeFormat().impl->locate(getParent().getPosVar(),
@@ -251,6 +284,11 @@ Expr Iterator::getSize() const {
   return getMode().getModeFormat().impl->getSize(getMode());
 }
 
+Expr Iterator::getNumPositions(const Expr& szPrev) const {
+  taco_iassert(defined() && content->mode.defined());
+  return getMode().getModeFormat().impl->getNumPositions(szPrev, getMode());
+}
+
 Stmt Iterator::getInsertInitCoords(const Expr& pBegin, const Expr& pEnd) const {
   taco_iassert(defined() && content->mode.defined());
   return getMode().getModeFormat().impl->getInsertInitCoords(pBegin, pEnd,
@@ -301,6 +339,11 @@ Stmt Iterator::getAppendFinalizeLevel(const Expr& szPrev, const Expr& sz) const{
                                                               getMode());
 }
 
+Stmt Iterator::getAppendReserveCoords(const Expr& sz) const {
+  taco_iassert(defined() && content->mode.defined());
+  return getMode().getModeFormat().impl->getAppendReserveCoords(sz, getMode());
+}
+
 bool Iterator::defined() const {
   return content != nullptr;
 }
@@ -359,6 +402,7 @@ Iterators Iterators::make(IndexStmt stmt,
 {
   map<ModeAccess,Iterator> levelIterators;
   map<IndexVar,Iterator>   modeIterators;
+  vector<IndexVar>         forallVars;
 
   taco_iassert(indexVars != nullptr);
   match(stmt,
@@ -379,8 +423,12 @@ Iterators Iterators::make(IndexStmt stmt,
         vector<Expr> arrays;
         taco_iassert(modeTypePack.getModeFormats().size() > 0);
 
-        ModePack modePack(modeTypePack.getModeFormats().size(),
-                          modeTypePack.getModeFormats()[0], tensorVarIR, level);
+        ModePack modePack = (size_t)level <= format.getLevelArrayTypes().size()
+            ? ModePack(modeTypePack.getModeFormats().size(),
+                       modeTypePack.getModeFormats()[0], tensorVarIR, level,
+                       format.getLevelArrayTypes()[level-1])
+            : ModePack(modeTypePack.getModeFormats().size(),
+                       modeTypePack.getModeFormats()[0], tensorVarIR, level);
 
         int pos = 0;
         for (auto& modeType : modeTypePack.getModeFormats()) {
@@ -391,7 +439,9 @@ Iterators Iterators::make(IndexStmt stmt,
                     parentModeType);
 
           string name = indexVar.getName() + n->tensorVar.getName();
-          Iterator iterator(indexVar, tensorVarIR, mode, parent, name);
+          Iterator iterator(indexVar, tensorVarIR, mode, parent, name,
+                            format.getPositionType(level-1),
+                            format.getCoordinateTypeIdx(level-1));
           levelIterators.insert({{Access(n),level}, iterator});
           indexVars->insert({iterator, indexVar});
 
@@ -404,7 +454,7 @@ Iterators Iterators::make(IndexStmt stmt,
     }),
     function<void(const ForallNode*, Matcher*)>([&](const ForallNode* n,
                                                     Matcher* m) {
-      modeIterators.insert({n->indexVar, n->indexVar});
+      forallVars.push_back(n->indexVar);
       m->match(n->stmt);
     }),
     function<void(const AssignmentNode*,Matcher*)>([&](const AssignmentNode* n,
@@ -413,6 +463,18 @@ Iterators Iterators::make(IndexStmt stmt,
       m->match(n->lhs);
     })
   );
+
+  // Dimension iterators must hold the widest coordinate of the levels they
+  // merge, or coordinates of 64-bit levels get truncated
+  for (auto& indexVar : forallVars) {
+    Datatype coordType = Int();
+    for (auto& iterator : *indexVars) {
+      if (iterator.second == indexVar) {
+        coordType = max_type(coordType, iterator.first.getCoordVar().type());
+      }
+    }
+    modeIterators.insert({indexVar, Iterator(indexVar, coordType)});
+  }
   return Iterators(levelIterators, modeIterators);
 }
 
@@ -41,8 +41,12 @@ Iterators::Iterators(const IterationGraph& graph,
       vector<Expr> arrays;
       taco_iassert(modeTypePack.getModeFormats().size() > 0);
 
-      ModePack modePack(modeTypePack.getModeFormats().size(),
-                        modeTypePack.getModeFormats()[0], tensorVarExpr, level);
+      ModePack modePack = (size_t)level <= format.getLevelArrayTypes().size()
+          ? ModePack(modeTypePack.getModeFormats().size(),
+                     modeTypePack.getModeFormats()[0], tensorVarExpr, level,
+                     format.getLevelArrayTypes()[level-1])
+          : ModePack(modeTypePack.getModeFormats().size(),
+                     modeTypePack.getModeFormats()[0], tensorVarExpr, level);
 
       int pos = 0;
       for (auto& modeType : modeTypePack.getModeFormats()) {
@@ -52,7 +56,9 @@ Iterators::Iterators(const IterationGraph& graph,
 
         taco_iassert(path.getStep(level-1).getStep() == level-1);
         std::string indexVarName = path.getVariables()[level-1].getName();
-        Iterator iterator(path, indexVarName, tensorVarExpr, mode, parent);
+        Iterator iterator(path, indexVarName, tensorVarExpr, mode, parent,
+                          format.getPositionType(level-1),
+                          format.getCoordinateTypeIdx(level-1));
         iterators.insert({path.getStep(level-1), iterator});
         parent = iterator;
 
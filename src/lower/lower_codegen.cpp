@@ -96,6 +96,12 @@ ir::Expr lowerToScalarExpression(const IndexExpr& indexExpr,
         expr = temporaries.at(op->tensorVar);
         return;
       }
+      // Every component of a pattern format is one
+      if (op->tensorVar.getFormat().isPattern()) {
+        Datatype type = op->tensorVar.getType().getDataType();
+        expr = ir::Literal::make(TypedComponentVal(type, 1), type);
+        return;
+      }
       TensorPath path = iterationGraph.getTensorPath(op);
       Type type = op->tensorVar.getType();
       Iterator iterator = (type.getShape().getOrder() == 0)
@@ -195,6 +201,15 @@ ir::Stmt mergePathIndexVars(ir::Expr var, vector<ir::Expr> pathVars){
   return ir::Assign::make(var, ir::Min::make(pathVars));
 }
 
+/// Returns the narrowest type that can hold the coordinates of all iterators.
+static Datatype coordinateType(const std::vector<Iterator>& iterators) {
+  Datatype type = Int();
+  for (const auto& iterator : iterators) {
+    type = max_type(type, iterator.getCoordVar().type());
+  }
+  return type;
+}
+
 ir::Expr min(const std::string resultName,
              const std::vector<Iterator>& iterators,
              std::vector<Stmt>* statements) {
@@ -211,8 +226,8 @@ ir::Expr min(const std::string resultName,
     }
   }
 
-  ir::Expr minVar = ir::Var::make(resultName, Int());
-  ir::Expr minExpr = ir::Min::make(getIdxVars(iterators));
+  ir::Expr minVar = ir::Var::make(resultName, coordinateType(iterators));
+  ir::Expr minExpr = ir::Min::make(getIdxVars(iterators), minVar.type());
   ir::Stmt initIdxStmt = ir::VarDecl::make(minVar, minExpr);
   statements->push_back(initIdxStmt);
   
@@ -226,7 +241,7 @@ minWithIndicator(const std::string resultName,
   taco_iassert(iterators.size() >= 2 && 
                (int)iterators.size() <= UInt().getNumBits());
   taco_iassert(statements != nullptr);
-  ir::Expr minVar = ir::Var::make(resultName, Int());
+  ir::Expr minVar = ir::Var::make(resultName, coordinateType(iterators));
   ir::Expr minInd = ir::Var::make(std::string("c") + resultName, UInt());
  
   ir::Stmt initMinIdx = ir::VarDecl::make(minVar, iterators[0].getCoordVar());
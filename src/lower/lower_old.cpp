@@ -6,6 +6,7 @@
 #include "taco/ir/ir_visitor.h"
 #include "taco/ir/simplify.h"
 #include "ir/ir_generators.h"
+#include "ir/split_complex.h"
 
 #include "lower_codegen.h"
 #include "iterators.h"
@@ -30,6 +31,19 @@ using namespace taco::ir;
 namespace taco {
 namespace old {
 
+/// Passes of the two-phase assembly of a compressed result level.  The COUNT
+/// pass stores the number of coordinates of every segment, which are prefix
+/// summed into the pos array, and the FILL pass then writes the coordinates
+/// (and values) of each segment starting at its final position.  The SYMBOLIC
+/// pass of sequential assembly only advances the result pos variables, to
+/// count the coordinates of every appended level before allocating it.
+enum AssemblePass {
+  ASSEMBLE,
+  COUNT,
+  FILL,
+  SYMBOLIC
+};
+
 struct Ctx {
   /// Determines what kind of code to emit (e.g. compute and/or assembly)
   std::set<Property>       properties;
@@ -48,6 +62,18 @@ struct Ctx {
 
   Expr                     valsCapacity;
 
+  /// Result iterator whose segments are assembled independently of each other
+  /// (undefined if the result is assembled sequentially).
+  Iterator                 rowIterator;
+  AssemblePass             pass = ASSEMBLE;
+
+  /// Chunk variable of a parallel reduction over the root loop (undefined if
+  /// the root loop is not a parallel reduction), and the code that initializes
+  /// and finalizes the private partial results of a chunk.
+  Expr                     reductionChunk;
+  Stmt                     initChunk;
+  Stmt                     finalizeChunk;
+
   Ctx(const IterationGraph& iterationGraph,
           const set<Property>& properties,
           const map<TensorVar,Expr>& tensorVars) {
@@ -60,6 +86,12 @@ struct Ctx {
 struct Target {
   Expr tensor;
   Expr pos;
+
+  /// Offset of the components in a chunk-private copy of the result values
+  Expr offset;
+
+  /// Whether the components are reduced into atomically
+  bool atomic = false;
 };
 
 enum ComputeCase {
@@ -146,9 +178,12 @@ static void emitComputeExpr(const Target& target, const IndexVar& indexVar,
                                       ctx.iterationGraph, ctx.temporaries);
   auto& iterationGraph = ctx.iterationGraph;
   if (target.pos.defined()) {
+    Expr pos = target.offset.defined()
+               ? ir::Add::make(target.offset, Cast::make(target.pos, Int64))
+               : target.pos;
     Stmt store = iterationGraph.hasReductionVariableAncestor(indexVar) || accum
-        ? compoundStore(target.tensor, target.pos, expr)
-        :   Store::make(target.tensor, target.pos, expr);
+        ? compoundStore(target.tensor, pos, expr, target.atomic)
+        :   Store::make(target.tensor, pos, expr);
     stmts->push_back(store);
   }
   else {
@@ -159,17 +194,179 @@ static void emitComputeExpr(const Target& target, const IndexVar& indexVar,
   }
 }
 
+/// Returns the compressed result iterator whose segments can be assembled in
+/// parallel, one segment per coordinate of the outer dense result mode (e.g.
+/// the rows of a CSR result), or an undefined iterator if there is none.
+static Iterator getRowLocalIterator(const IndexExpr& indexExpr,
+                                    const Ctx& ctx) {
+  const auto& graph = ctx.iterationGraph;
+  const TensorPath& resultPath = graph.getResultTensorPath();
+  if (!util::contains(ctx.properties, ParallelAssemble) ||
+      util::contains(ctx.properties, Accumulate) ||
+      resultPath.getSize() != 2 || graph.getRoots().size() != 1) {
+    return Iterator();
+  }
+
+  const auto& resultVars = resultPath.getVariables();
+  if (graph.getRoots()[0] != resultVars[0] ||
+      graph.getChildren(resultVars[0]) != vector<IndexVar>({resultVars[1]})) {
+    return Iterator();
+  }
+
+  Iterator outer = ctx.iterators[resultPath.getStep(0)];
+  Iterator inner = ctx.iterators[resultPath.getStep(1)];
+  if (!outer.hasInsert() || !inner.hasAppend() || inner.isBranchless() ||
+      !inner.hasPosIter()) {
+    return Iterator();
+  }
+
+  // The outer loop must be a for loop that does not merge its operands
+  MergeLattice lattice = MergeLattice::make(indexExpr, resultVars[0], graph,
+                                            ctx.iterators);
+  if (lattice.getRangeIterators().size() != 1 ||
+      !lattice.getRangeIterators()[0].isUnique()) {
+    return Iterator();
+  }
+  return inner;
+}
+
+static bool isRowLocal(const Iterator& iterator, const Ctx& ctx) {
+  return iterator.defined() && ctx.rowIterator.defined() &&
+         iterator == ctx.rowIterator;
+}
+
+/// Number of chunks that the iterations of a parallel reduction are split
+/// into.  Chunks are combined in order, so results are independent of the
+/// number of threads.
+static const long long REDUCTION_CHUNKS = 64;
+
+/// Largest result that parallel reductions copy into every chunk.  Larger
+/// results are reduced into with atomics by fast reductions, and serially by
+/// deterministic reductions.
+static const long long MAX_PRIVATIZED_SIZE = 1 << 15;
+
+/// Returns true iff the root loop over the reduction variable `indexVar` can be
+/// computed as a parallel reduction, whose chunks reduce into private partial
+/// results.
+static bool isParallelReduction(const IndexVar& indexVar,
+                                const IndexExpr& indexExpr, const Ctx& ctx) {
+  const auto& graph = ctx.iterationGraph;
+  if (!util::contains(ctx.properties, ParallelReduce) ||
+      !util::contains(ctx.properties, Compute) ||
+      util::contains(ctx.properties, Assemble) ||
+      !graph.isReduction(indexVar) || graph.getAncestors(indexVar).size() != 1) {
+    return false;
+  }
+
+  // Every result level must be random access to be privatized
+  const TensorPath& resultPath = graph.getResultTensorPath();
+  for (size_t i = 0; i < resultPath.getSize(); i++) {
+    if (!ctx.iterators[resultPath.getStep(i)].hasInsert()) {
+      return false;
+    }
+  }
+
+  // The root loop must be a single for loop that does not merge its operands
+  MergeLattice lattice = MergeLattice::make(indexExpr, indexVar, graph,
+                                            ctx.iterators);
+  return lattice.getPoints().size() == 1 &&
+         lattice.getRangeIterators().size() == 1 &&
+         lattice.getRangeIterators()[0].isUnique();
+}
+
+/// Split the iterations of the root loop of a parallel reduction into chunks
+/// that are computed in parallel.
+static Stmt lowerReductionChunks(Expr var, Expr begin, Expr end, Stmt body,
+                                 const Ctx& ctx) {
+  const string name = var.as<Var>()->name;
+  Expr extent = Var::make(name + "_extent", Int());
+  Expr chunkSize = Var::make(name + "_chunk_size", Int());
+  Expr chunkBegin = Var::make(name + "_begin", Int());
+  Expr chunkEnd = Var::make(name + "_end", Int());
+  Expr chunk = ctx.reductionChunk;
+
+  Stmt initExtent = VarDecl::make(extent, ir::Sub::make(end, begin));
+  Stmt initChunkSize = VarDecl::make(chunkSize,
+      ir::Div::make(ir::Add::make(extent, REDUCTION_CHUNKS - 1),
+                    REDUCTION_CHUNKS));
+  Stmt initBegin = VarDecl::make(chunkBegin,
+      ir::Add::make(begin, Min::make(ir::Mul::make(chunk, chunkSize), extent)));
+  Stmt initEnd = VarDecl::make(chunkEnd,
+      ir::Add::make(begin, Min::make(ir::Mul::make(ir::Add::make(chunk, 1ll),
+                                                   chunkSize), extent)));
+
+  Stmt loop = For::make(var, chunkBegin, chunkEnd, 1ll, body);
+  Stmt chunkBody = Block::make({ctx.initChunk, initBegin, initEnd, loop,
+                                ctx.finalizeChunk});
+  return Block::make({initExtent, initChunkSize,
+                      For::make(chunk, 0ll, REDUCTION_CHUNKS, 1ll, chunkBody,
+                                LoopKind::Static)});
+}
+
+/// Returns true if compute kernels track the positions of the appended result
+/// level at `step`, which they must unless a level below it is appended to, as
+/// the positions of the levels below are otherwise computed from its positions.
+static bool isPositionTracked(const TensorPathStep& step, const Ctx& ctx) {
+  const TensorPath& resultPath = step.getPath();
+  for (size_t i = step.getStep() + 1; i < resultPath.getSize(); i++) {
+    if (ctx.iterators[resultPath.getStep(i)].hasAppend()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Largest number of iterations of the loops that are fully unrolled over the
+/// coordinates within blocks.
+static const long long MAX_UNROLLED_ITERATIONS = 8;
+
+/// Fully unrolls a loop with literal bounds into scoped copies of its body,
+/// which each declare the loop variable as a constant, so that the C compiler
+/// can keep small dense blocks in registers and vectorize across the copies.
+/// Returns an undefined statement if the loop is not unrolled.
+static Stmt unrollLoop(Expr var, Expr begin, Expr end, Stmt body) {
+  begin = ir::simplify(begin);
+  end = ir::simplify(end);
+  auto isIntLiteral = [](Expr bound) {
+    return isa<ir::Literal>(bound) &&
+           (bound.type().isInt() || bound.type().isUInt());
+  };
+  auto getValue = [](Expr bound) {
+    const ir::Literal* literal = to<ir::Literal>(bound);
+    return literal->type.isUInt() ? (long long)literal->getUIntValue()
+                                  : (long long)literal->getIntValue();
+  };
+  if (!isIntLiteral(begin) || !isIntLiteral(end)) {
+    return Stmt();
+  }
+  const long long first = getValue(begin);
+  const long long last = getValue(end);
+  if (last - first > MAX_UNROLLED_ITERATIONS) {
+    return Stmt();
+  }
+  vector<Stmt> copies;
+  for (long long k = first; k < last; k++) {
+    Stmt initVar = VarDecl::make(var, ir::Literal::make(k, var.type()));
+    copies.push_back(Scope::make(Block::make({initVar, body})));
+  }
+  return Block::make(copies);
+}
+
 static LoopKind doParallelize(const IndexVar& indexVar, const Expr& tensor,
                               const Ctx& ctx) {
   if (ctx.iterationGraph.getAncestors(indexVar).size() != 1 ||
       ctx.iterationGraph.isReduction(indexVar) ||
-      util::contains(ctx.properties, Assemble)) {
+      (util::contains(ctx.properties, Assemble) &&
+       !ctx.rowIterator.defined())) {
     return LoopKind::Serial;
   }
 
+  // Results are written in parallel if every level is random access or is
+  // assembled one segment per loop iteration.
   const TensorPath& resultPath = ctx.iterationGraph.getResultTensorPath();
   for (size_t i = 0; i < resultPath.getSize(); i++){
-    if (!ctx.iterators[resultPath.getStep(i)].hasInsert()) {
+    Iterator iterator = ctx.iterators[resultPath.getStep(i)];
+    if (!iterator.hasInsert() && !isRowLocal(iterator, ctx)) {
       return LoopKind::Serial;
     }
   }
@@ -274,7 +471,7 @@ static vector<Iterator> removeIterator(const Expr& idx,
 }
 
 static Stmt createIfStatements(const vector<pair<Expr,Stmt>> &cases,
-                               const MergeLattice& lattice,
+                               bool isFull,
                                const Expr switchExpr) {
   if (cases.size() == 1 && isa<ir::Literal>(cases[0].first) &&
       to<ir::Literal>(cases[0].first)->getValue<bool>()) {
@@ -302,7 +499,7 @@ static Stmt createIfStatements(const vector<pair<Expr,Stmt>> &cases,
 
   return switchExpr.defined()
          ? Switch::make(ifCases, switchExpr)
-         : Case::make(ifCases, lattice.isFull());
+         : Case::make(ifCases, isFull);
 }
 
 static std::vector<Expr> getIdxVars(std::map<Iterator,Expr>& idxVars,
@@ -349,19 +546,63 @@ static vector<Stmt> lower(const Target&      target,
   const bool emitCompute  = util::contains(ctx.properties, Compute);
   const bool emitAssemble = util::contains(ctx.properties, Assemble);
 
+  // Emit loops over 64-bit words if every lattice point only iterates over
+  // levels that store bitmaps.  The words of the levels are combined with
+  // bitwise and/or into the coordinates of any lattice point, whose set bits
+  // are visited in order by counting trailing zeros.
+  bool emitWords = true;
+  for (auto& point : lattice.getPoints()) {
+    for (auto& iterator : point.getRangers()) {
+      emitWords &= iterator.hasWordIter();
+    }
+  }
+  std::vector<Iterator> wordIterators;
+  if (emitWords) {
+    for (auto& iterator : lattice.getIterators()) {
+      if (iterator.hasWordIter()) {
+        wordIterators.push_back(iterator);
+      }
+    }
+  }
+
   // Emit while loops to merge inputs if need to co-iterate two or more inputs
   // or if deduplication is needed.
-  const bool emitMerge = (latticeRangeIterators.size() > 1) ||
-                         !latticeRangeIterators[0].isUnique();
+  const bool emitMerge = !emitWords &&
+                         ((latticeRangeIterators.size() > 1) ||
+                          !latticeRangeIterators[0].isUnique());
+  if (emitMerge && latticeRangeIterators.size() > 1) {
+    for (auto& iterator : latticeRangeIterators) {
+      taco_uassert(iterator.isOrdered()) << "Cannot co-iterate the " <<
+          "unordered level " << iterator.getMode() << " with other levels";
+      taco_uassert(!iterator.hasWordIter()) << "Cannot co-iterate the " <<
+          "bitmap level " << iterator.getMode() << " with levels that are " <<
+          "not bitmaps";
+    }
+  }
 
   std::vector<Stmt> code;
 
   // Emit code to initialize pos variables:
   // B2_pos = B2_pos_arr[B1_pos];
-  ModeFunction iterFunc;
-  for (auto& iterator : latticeRangeIterators) {
+  // (loops over words are bounded by the words of any of the levels)
+  ModeFunction iterFunc = emitWords ? wordIterators[0].wordBounds()
+                                    : ModeFunction();
+  const std::vector<Iterator> boundedIterators =
+      emitWords ? std::vector<Iterator>() : latticeRangeIterators;
+  for (auto& iterator : boundedIterators) {
     if (iterator.hasPosIter()) {
       iterFunc = iterator.posBounds();
+
+      // The children of a level with duplicate coordinates iterate over the
+      // positions of the whole segment of duplicates
+      const Iterator& parent = iterator.getParent();
+      if (parent.isModeIterator() && !parent.isUnique()) {
+        Expr lastPos = ir::Sub::make(parent.getSegendVar(), 1ll);
+        ModeFunction lastFunc = iterator.posBounds(lastPos);
+        taco_iassert(!iterFunc.compute().defined() &&
+                     !lastFunc.compute().defined());
+        iterFunc = ModeFunction(Stmt(), {iterFunc[0], simplify(lastFunc[1])});
+      }
     } else {
       taco_iassert(iterator.hasCoordIter());
       auto coords = getIdxVars(ctx.idxVars, iterator, false);
@@ -382,6 +623,16 @@ static vector<Stmt> lower(const Target&      target,
     }
   }
 
+  // Segments that are assembled independently start at the position computed
+  // by the count pass, or at zero while counting.
+  if (isRowLocal(resultIterator, ctx)) {
+    Expr parentPos = resultIterator.getParent().getPosVar();
+    Expr initPos = (ctx.pass == COUNT)
+                   ? Expr(0ll)
+                   : resultIterator.posBounds(parentPos).getResults()[0];
+    code.push_back(VarDecl::make(resultIterator.getPosVar(), initPos));
+  }
+
   if (emitAssemble && resultIterator.defined()) {
     if (resultIterator.hasAppend() && !resultIterator.isBranchless()) {
       Expr begin = resultIterator.getBeginVar();
@@ -389,8 +640,8 @@ static vector<Stmt> lower(const Target&      target,
       code.push_back(initBegin);
     }
 
-    if (resultIterator.getParent().hasAppend() ||
-        resultStep == resultPath.getStep(0)) {
+    if (ctx.pass != SYMBOLIC && (resultIterator.getParent().hasAppend() ||
+        resultStep == resultPath.getStep(0))) {
       Expr resultParentPos = resultIterator.getParent().getPosVar();
       Expr initBegin = resultParentPos;
       Expr initEnd = simplify(ir::Add::make(resultParentPos, 1ll));
@@ -450,24 +701,118 @@ static vector<Stmt> lower(const Target&      target,
     }
   }
 
-  // Emit one loop per lattice point lp
+  // Loops over words load the word of every level, and the position of its
+  // first coordinate, into variables:
+  // uint64_t a1_word = a1_bits[pa0 * ((a1_dimension + 63) / 64) + iw];
+  // int32_t a1_wordpos = a1_pos[pa0 * ((a1_dimension + 63) / 64) + iw];
+  Expr wordVar, wordMask;
+  std::vector<Stmt> wordDecls;
+  std::map<Iterator,std::pair<Expr,Expr>> words;
+  if (emitWords) {
+    wordVar = Var::make(indexVar.getName() + "w", Int());
+    wordMask = Var::make(indexVar.getName() + "_mask", UInt64);
+    for (auto& iterator : wordIterators) {
+      const string name = iterator.getMode().getName();
+      Expr word = Var::make(name + "_word", UInt64);
+      Expr wordPos = Var::make(name + "_wordpos", iterator.getPosVar().type());
+      ModeFunction access = iterator.wordAccess(wordVar);
+      wordDecls.push_back(VarDecl::make(word, simplify(access[0])));
+      wordDecls.push_back(VarDecl::make(wordPos, simplify(access[1])));
+      words.insert({iterator, {word, wordPos}});
+    }
+
+    // The mask holds the coordinates of any lattice point, whose words are
+    // combined with bitwise and (points that iterate over a superset of the
+    // levels of another point add no coordinates)
+    std::vector<Expr> pointMasks;
+    const auto& points = lattice.getPoints();
+    for (size_t i = 0; i < points.size(); i++) {
+      const std::vector<Iterator> pointWords =
+          util::remove(points[i].getIterators(),
+                       util::remove(points[i].getIterators(), wordIterators));
+      bool isCovered = false;
+      for (size_t j = 0; j < points.size() && !isCovered; j++) {
+        const std::vector<Iterator> otherWords =
+            util::remove(points[j].getIterators(),
+                         util::remove(points[j].getIterators(), wordIterators));
+        isCovered = (j != i && otherWords.size() < pointWords.size() &&
+                     util::remove(otherWords, pointWords).empty());
+      }
+      if (isCovered) {
+        continue;
+      }
+      Expr pointMask = words.at(pointWords[0]).first;
+      for (size_t j = 1; j < pointWords.size(); j++) {
+        pointMask = BitAnd::make(pointMask, words.at(pointWords[j]).first);
+      }
+      pointMasks.push_back(pointMask);
+    }
+    Expr mask = pointMasks[0];
+    for (size_t i = 1; i < pointMasks.size(); i++) {
+      mask = BitOr::make(mask, pointMasks[i]);
+    }
+    wordDecls.push_back(VarDecl::make(wordMask, mask));
+  }
+
+  // Emit one loop per lattice point lp, or one loop over words that visits
+  // the coordinates of every lattice point
   std::vector<Stmt> loops;
   for (MergePoint lp : lattice.getPoints()) {
+    if (emitWords && lp != lattice.getPoints()[0]) {
+      break;
+    }
     MergeLattice lpLattice = lattice.getSubLattice(lp);
 
     const std::vector<Iterator>& lpIterators = lp.getIterators();
     const std::vector<Iterator>& lpRangeIterators = lp.getRangers();
 
+    // Levels iterated over a word at a time compute positions from the words
     const std::vector<Iterator> lpLocateIterators = util::remove(
-        lpIterators, lpRangeIterators);
+        lpIterators, emitWords ? wordIterators : lpRangeIterators);
 
     std::vector<Stmt> loopBody;
     std::set<Iterator> guardedIters;
 
+    // Emit code to visit the next coordinate in the mask, and to compute the
+    // positions of the levels from their words:
+    // int i = iw * 64 + ctz(i_mask);
+    // uint64_t i_bit = i_mask & -i_mask;
+    // i_mask = i_mask - i_bit;
+    // int pa1 = a1_wordpos + popcount(a1_word & (i_bit - 1));
+    // bool a1_valid = (a1_word & i_bit) != 0;
+    Expr wordIdx;
+    if (emitWords) {
+      wordIdx = Var::make(indexVar.getName(), Int());
+      Expr bit = Var::make(indexVar.getName() + "_bit", UInt64);
+      loopBody.push_back(VarDecl::make(wordIdx,
+          ir::Add::make(ir::Mul::make(wordVar, 64), Ctz::make(wordMask))));
+      loopBody.push_back(VarDecl::make(bit,
+          BitAnd::make(wordMask, ir::Neg::make(wordMask))));
+      loopBody.push_back(Assign::make(wordMask, ir::Sub::make(wordMask, bit)));
+      for (auto& iterator : wordIterators) {
+        Expr word = words.at(iterator).first;
+        Expr wordPos = words.at(iterator).second;
+        Expr pos = ir::Add::make(wordPos,
+            Popcount::make(BitAnd::make(word, ir::Sub::make(bit, 1ull))));
+        loopBody.push_back(VarDecl::make(iterator.getPosVar(), pos));
+
+        // Levels that store the coordinates of every lattice point are valid
+        bool isInEveryPoint = true;
+        for (auto& point : lattice.getPoints()) {
+          isInEveryPoint &= util::contains(point.getIterators(), iterator);
+        }
+        if (!isInEveryPoint) {
+          Expr valid = Neq::make(BitAnd::make(word, bit), 0ull);
+          loopBody.push_back(VarDecl::make(iterator.getValidVar(), valid));
+          guardedIters.insert(iterator);
+        }
+      }
+    }
+
     // Emit code to initialize sequential access idx variables:
     // int kB = B1_idx_arr[B1_pos];
     // int kc = c0_idx_arr[c0_pos];
-    for (auto& iterator : lpRangeIterators) {
+    for (auto& iterator : util::remove(lpRangeIterators, wordIterators)) {
       ModeFunction access;
       if (iterator.hasPosIter()) {
         const auto coords = getIdxVars(ctx.idxVars, iterator, false);
@@ -500,14 +845,16 @@ static vector<Stmt> lower(const Target&      target,
     std::vector<Stmt> mergeCode;
 
     const bool mergeWithSwitch =
-        (lpRangeIterators.size() > 2 &&
+        (!emitWords && lpRangeIterators.size() > 2 &&
          lpRangeIterators.size() <= (size_t)UInt().getNumBits() &&
          lpLattice.getSize() == (1u << lpRangeIterators.size()) - 1);
 
     // Emit code to initialize the index variable:
     // k = min(kB, kc);
     Expr idx, ind;
-    if (mergeWithSwitch) {
+    if (emitWords) {
+      idx = wordIdx;
+    } else if (mergeWithSwitch) {
       std::tie(idx, ind) = minWithIndicator(indexVar.getName(),
                                             lpRangeIterators, &mergeCode);
     } else {
@@ -524,6 +871,10 @@ static vector<Stmt> lower(const Target&      target,
 
     // Emit code to initialize random access pos variables:
     // D1_pos = (D0_pos * 3) + k;
+    // Coordinates that a full result level stores no position for (e.g. the
+    // rows that pad the slices of a permuted level) are skipped, whereas
+    // coordinates that other result levels do not find are inserted.
+    Expr resultValid = true;
     for (size_t i = 0; i < lpLocateIterators.size() +
          (resultIterator.defined() && resultIterator.hasInsert()); ++i) {
       Iterator iterator = (i == lpLocateIterators.size()) ? resultIterator :
@@ -538,12 +889,17 @@ static vector<Stmt> lower(const Target&      target,
         mergeCode.push_back(locate.compute());
       }
       mergeCode.push_back(initPos);
-      if (!isa<ir::Literal>(locate.getResults()[1]) && iterator != resultIterator) {
+      if (!isa<ir::Literal>(locate.getResults()[1]) &&
+          (iterator != resultIterator || iterator.isFull())) {
         Stmt initValid = VarDecl::make(iterator.getValidVar(),
                                        locate.getResults()[1]);
 
         mergeCode.push_back(initValid);
-        guardedIters.insert(iterator);
+        if (iterator == resultIterator) {
+          resultValid = iterator.getValidVar();
+        } else {
+          guardedIters.insert(iterator);
+        }
       } else {
         taco_iassert(iterator == resultIterator ||
                      (locate.getResults()[1].type().isBool() &&
@@ -551,19 +907,34 @@ static vector<Stmt> lower(const Target&      target,
       }
     }
 
+    // Emit code to find the end of the segment of positions that store the
+    // same coordinate in levels with duplicate coordinates:
+    // int B1_segend = pB1 + 1;
+    // while (B1_segend < pB1_end && B1_crd[B1_segend] == iB) B1_segend++;
     for (auto& iterator : lpRangeIterators) {
       if (iterator.hasPosIter() && !iterator.isUnique()) {
         Expr segendVar = iterator.getSegendVar();
         Expr nextPos = ir::Add::make(iterator.getPosVar(), 1ll);
         Stmt initSegend = VarDecl::make(segendVar, nextPos);
         mergeCode.push_back(initSegend);
+
+        const auto coords = getIdxVars(ctx.idxVars, iterator, false);
+        ModeFunction segendAccess = iterator.posAccess(segendVar, coords);
+        taco_iassert(!segendAccess.compute().defined());
+        Expr isDuplicate = And::make(Lt::make(segendVar, iterator.getEndVar()),
+                                     Eq::make(segendAccess[0],
+                                              iterator.getCoordVar()));
+        Stmt incSegend = Assign::make(segendVar,
+                                      ir::Add::make(segendVar, 1ll));
+        mergeCode.push_back(While::make(isDuplicate, incSegend));
       }
     }
 
     // Emit code to resize vals array when simultaneously performing assembly
     // and compute and result components are appended
     Stmt maybeResizeVals;
-    if (emitCompute && emitAssemble && resultIterator.defined() &&
+    if (emitCompute && emitAssemble && ctx.pass != FILL &&
+        resultIterator.defined() &&
         resultIterator.hasAppend() && resultStep == resultPath.getLastStep()) {
       Expr resultTensor = resultIterator.getTensor();
       Expr vals = GetProperty::make(resultTensor, TensorProperty::Values);
@@ -702,12 +1073,13 @@ static vector<Stmt> lower(const Target&      target,
 
           if (emitAssemble) {
             if (resultIterator.hasAppend()) {
-              Stmt appendCoord = resultIterator.getAppendCoord(resultPos, idx);
+              Stmt appendCoord = (ctx.pass == COUNT || ctx.pass == SYMBOLIC)
+                  ? Stmt() : resultIterator.getAppendCoord(resultPos, idx);
 
               if (appendCoord.defined()) {
                 assemblyStmts.push_back(appendCoord);
               }
-            } else {
+            } else if (ctx.pass != SYMBOLIC) {
               taco_iassert(resultIterator.hasInsert());
 
               const auto idxVars = getIdxVars(ctx.idxVars, resultIterator, true);
@@ -720,7 +1092,7 @@ static vector<Stmt> lower(const Target&      target,
           }
 
           if (resultIterator.hasAppend() && (emitAssemble ||
-              ivarCase == LAST_FREE)) {
+              isPositionTracked(resultStep, ctx))) {
             Expr nextPos = ir::Add::make(resultPos, 1ll);
             Stmt incPos = Assign::make(resultPos, nextPos);
             assemblyStmts.push_back(incPos);
@@ -728,7 +1100,7 @@ static vector<Stmt> lower(const Target&      target,
 
           Iterator resIter = resultIterator;
           while (resIter.isBranchless()) {
-            if (emitAssemble && resIter.hasAppend()) {
+            if (emitAssemble && ctx.pass != SYMBOLIC && resIter.hasAppend()) {
               Expr resPos = resIter.getPosVar();
               Expr resParentPos = resIter.getParent().getPosVar();
               Stmt appendEdges = resIter.getAppendEdges(
@@ -745,7 +1117,7 @@ static vector<Stmt> lower(const Target&      target,
               break;
             }
 
-            if (emitAssemble) {
+            if (emitAssemble && ctx.pass != SYMBOLIC) {
               if (resIter.hasAppend()) {
                 Expr resPos = resIter.getPosVar();
                 Expr idxVar = ctx.idxVars[resIter];
@@ -763,13 +1135,14 @@ static vector<Stmt> lower(const Target&      target,
               }
             }
 
-            if (resIter.hasAppend()) {
+            if (emitAssemble && resIter.hasAppend()) {
               Expr resPos = resIter.getPosVar();
               Stmt incPos = Assign::make(resPos, ir::Add::make(resPos, 1ll));
               assemblyStmts.push_back(incPos);
 
               Expr initBegin = ir::Sub::make(resPos, 1ll);
-              Stmt initEdges = resIter.getAppendInitEdges(initBegin, resPos);
+              Stmt initEdges = (ctx.pass == SYMBOLIC) ? Stmt() :
+                  resIter.getAppendInitEdges(initBegin, resPos);
               if (initEdges.defined()) {
                 assemblyStmts.push_back(initEdges);
               }
@@ -794,18 +1167,25 @@ static vector<Stmt> lower(const Target&      target,
       const auto caseIterators = removeIterator(idx, lqRangeIterators);
       Expr cond = mergeWithSwitch ?
           indicatorMask(lpRangeIterators, caseIterators) : [&]() {
+          if (emitWords) {
+            return simplify(allValidDerefs(lqIterators, guardedIters));
+          }
           Expr allEqual = allEqualTo(caseIterators, idx);
           Expr allValid = allValidDerefs(lqLocateIterators, guardedIters);
           return simplify(And::make(allEqual, allValid));
         }();
       cases.push_back({cond, Block::make(caseBody)});
     }
-    mergeCode.push_back(createIfStatements(cases, lpLattice, ind));
+    // (the mask of a loop over words only holds coordinates of the cases)
+    Stmt caseCode = createIfStatements(cases, emitWords || lpLattice.isFull(),
+                                       ind);
+    mergeCode.push_back(isValue(resultValid, true) ? caseCode
+                        : IfThenElse::make(resultValid, caseCode));
 
     // Emit code to increment sequential access `pos` variables. Variables that
     // may not be consumed in an iteration (i.e. their iteration space is
-    // different from the loop iteration space) are guarded by a conditional:
-    // TODO: handle increment of non-unique iterators
+    // different from the loop iteration space) are guarded by a conditional.
+    // Iterators over duplicate coordinates skip to the end of the segment.
     if (emitMerge) {
       // pB1 += (k == kB);
       // pc0 += (k == kc);
@@ -814,34 +1194,76 @@ static vector<Stmt> lower(const Target&      target,
           Iterator iterator = lpRangeIterators[i];
           Expr ivar = iterator.getIteratorVar();
           Expr cmpExpr = Neq::make(BitAnd::make(ind, 1ull << i), 0ull);
-          Expr incExpr = Cast::make(cmpExpr, ivar.type());
-          Stmt incIVar = Assign::make(ivar, ir::Add::make(ivar, incExpr));
+          Stmt incIVar = (iterator.hasPosIter() && !iterator.isUnique())
+              ? IfThenElse::make(cmpExpr,
+                                 Assign::make(ivar, iterator.getSegendVar()))
+              : Assign::make(ivar, ir::Add::make(ivar,
+                                                 Cast::make(cmpExpr,
+                                                            ivar.type())));
           mergeCode.push_back(incIVar);
         }
       } else {
         for (const auto& iterator : lpRangeIterators) {
           Expr ivar = iterator.getIteratorVar();
-          Expr incExpr = (iterator.getCoordVar() == idx || iterator.isFull()) ?
-              1ll : [&]() {
-                Expr tensorIdx = iterator.getCoordVar();
-                return Cast::make(Eq::make(tensorIdx, idx), ivar.type());
-              }();
+          Expr tensorIdx = iterator.getCoordVar();
+          if (iterator.hasPosIter() && !iterator.isUnique()) {
+            Stmt skip = Assign::make(ivar, iterator.getSegendVar());
+            mergeCode.push_back((tensorIdx == idx) ? skip :
+                IfThenElse::make(Eq::make(tensorIdx, idx), skip));
+            continue;
+          }
+          Expr incExpr = (tensorIdx == idx || iterator.isFull()) ?
+              1ll : Cast::make(Eq::make(tensorIdx, idx), ivar.type());
           Stmt inc = Assign::make(ivar, ir::Add::make(ivar, incExpr));
           mergeCode.push_back(inc);
         }
       }
     }
 
-    util::append(loopBody, mergeCode);
+    // Positions of a range iterator that store no coordinate (e.g. the empty
+    // buckets of a hash table) are skipped.
+    Expr rangeValid = emitWords ? true
+                                : allValidDerefs(lpRangeIterators, guardedIters);
+    if (!isValue(rangeValid, true)) {
+      taco_iassert(!emitMerge);
+      loopBody.push_back(IfThenElse::make(rangeValid, Block::make(mergeCode)));
+    } else {
+      util::append(loopBody, mergeCode);
+    }
 
-    // Emit loop (while loop for merges and for loop for non-merges)
+    // Emit loop (while loop for merges and for loop for non-merges, whose
+    // body visits the set bits of the mask of every word for loops over words)
     Stmt mergeLoopBody = Block::make(loopBody);
+    if (emitWords) {
+      std::vector<Stmt> wordBody = wordDecls;
+      wordBody.push_back(While::make(Neq::make(wordMask, 0ull),
+                                     mergeLoopBody));
+      mergeLoopBody = Block::make(wordBody);
+    }
     Stmt mergeLoop = emitMerge ?
         While::make(noneExhausted(lpRangeIterators), mergeLoopBody) : [&]() {
-        Iterator iter = lpRangeIterators[0];
-        return For::make(iter.getIteratorVar(), iterFunc.getResults()[0],
+        Iterator iter = emitWords ? wordIterators[0] : lpRangeIterators[0];
+        Expr loopVar = emitWords ? wordVar : iter.getIteratorVar();
+        if (ctx.reductionChunk.defined() &&
+            iterationGraph.getAncestors(indexVar).size() == 1) {
+          return lowerReductionChunks(loopVar,
+                                      iterFunc.getResults()[0],
+                                      iterFunc.getResults()[1],
+                                      mergeLoopBody, ctx);
+        }
+        LoopKind kind = doParallelize(indexVar, iter.getTensor(), ctx);
+        if (kind == LoopKind::Serial && !emitWords &&
+            util::contains(ctx.properties, UnrollBlocks)) {
+          Stmt unrolled = unrollLoop(loopVar,
+                                     iterFunc.getResults()[0],
+                                     iterFunc.getResults()[1], mergeLoopBody);
+          if (unrolled.defined()) {
+            return unrolled;
+          }
+        }
+        return For::make(loopVar, iterFunc.getResults()[0],
                          iterFunc.getResults()[1], 1ll, mergeLoopBody,
-                         doParallelize(indexVar, iter.getTensor(), ctx), doParallelize(indexVar, iter.getTensor(), ctx) != LoopKind::Serial);
+                         kind, kind != LoopKind::Serial);
       }();
     loops.push_back(mergeLoop);
   }
@@ -849,7 +1271,8 @@ static vector<Stmt> lower(const Target&      target,
 
   // Emit a store of the  segment size to the result pos index
   // A2_pos_arr[A1_pos + 1] = A2_pos;
-  if (emitAssemble && resultIterator.defined() && resultIterator.hasAppend() &&
+  if (emitAssemble && ctx.pass != FILL && ctx.pass != SYMBOLIC &&
+      resultIterator.defined() && resultIterator.hasAppend() &&
       !resultIterator.isBranchless()) {
     Expr resultParentPos = resultIterator.getParent().getPosVar();
     Stmt appendEdges = resultIterator.getAppendEdges(resultParentPos,
@@ -863,6 +1286,89 @@ static vector<Stmt> lower(const Target&      target,
   return code;
 }
 
+/// Lowers a root loop over a reduction variable to a parallel loop over chunks
+/// of its iterations.  Each chunk reduces into private partial results (one
+/// partial value for scalar results, and a copy of the values for results with
+/// dense levels), which are then added to the result in chunk order.  Results
+/// that are too large to copy into every chunk are instead reduced into
+/// atomically, or by the serial loop if reductions must be deterministic.
+static vector<Stmt> lowerParallelReduction(const Target& target,
+                                           const IndexVar& indexVar,
+                                           const IndexExpr& indexExpr,
+                                           const string& name, Ctx& ctx) {
+  const TensorPath& resultPath = ctx.iterationGraph.getResultTensorPath();
+  Datatype type = target.tensor.type();
+  Expr chunk = Var::make(indexVar.getName() + "_chunk", Int());
+  Expr c = Var::make("chunk", Int());
+
+  // Number of result components
+  Expr size = 1ll;
+  for (auto& var : resultPath.getVariables()) {
+    Iterator iterator = ctx.iterators[resultPath.getStep(var)];
+    size = simplify(iterator.getNumPositions(size));
+  }
+
+  auto lowerChunks = [&](bool privatize) {
+    Target chunkTarget = target;
+    vector<Stmt> allocate, initChunk, finalizeChunk, combine;
+    if (resultPath.getSize() == 0) {
+      Expr partials = Var::make(name + "_partials", type, true);
+      Expr partial = Var::make(name + "_partial", type);
+      allocate.push_back(Allocate::make(partials, REDUCTION_CHUNKS));
+      initChunk.push_back(VarDecl::make(partial, ir::Literal::zero(type)));
+      finalizeChunk.push_back(Store::make(partials, chunk, partial));
+      Stmt add = compoundStore(target.tensor, target.pos,
+                               Load::make(partials, c));
+      combine.push_back(For::make(c, 0ll, REDUCTION_CHUNKS, 1ll, add));
+      combine.push_back(Free::make(partials));
+      chunkTarget.tensor = partial;
+      chunkTarget.pos = Expr();
+    }
+    else if (privatize) {
+      Expr privates = Var::make(name + "_privates", type, true);
+      Expr offset = Var::make(name + "_offset", Int64);
+      Expr p = Var::make("p" + name, Int());
+      allocate.push_back(Allocate::make(privates,
+          ir::Mul::make(REDUCTION_CHUNKS, Cast::make(size, Int64))));
+      initChunk.push_back(VarDecl::make(offset,
+          ir::Mul::make(Cast::make(chunk, Int64), Cast::make(size, Int64))));
+      initChunk.push_back(For::make(p, 0ll, size, 1ll,
+          Store::make(privates, ir::Add::make(offset, Cast::make(p, Int64)),
+                      ir::Literal::zero(type))));
+      Expr loc = ir::Add::make(ir::Mul::make(Cast::make(c, Int64),
+                                             Cast::make(size, Int64)),
+                               Cast::make(p, Int64));
+      Stmt add = compoundStore(target.tensor, p, Load::make(privates, loc));
+      combine.push_back(For::make(p, 0ll, size, 1ll,
+                                  For::make(c, 0ll, REDUCTION_CHUNKS, 1ll, add),
+                                  LoopKind::Static));
+      combine.push_back(Free::make(privates));
+      chunkTarget.tensor = privates;
+      chunkTarget.offset = offset;
+    }
+    else {
+      chunkTarget.atomic = true;
+    }
+
+    Ctx chunkCtx = ctx;
+    chunkCtx.reductionChunk = chunk;
+    chunkCtx.initChunk = Block::make(initChunk);
+    chunkCtx.finalizeChunk = Block::make(finalizeChunk);
+    auto loops = lower(chunkTarget, indexVar, indexExpr, {}, chunkCtx);
+    return Block::make({Block::make(allocate), Block::make(loops),
+                        Block::make(combine)});
+  };
+
+  if (resultPath.getSize() == 0) {
+    return {lowerChunks(true)};
+  }
+  Stmt unprivatized = util::contains(ctx.properties, DeterministicReduce)
+      ? Block::make(lower(target, indexVar, indexExpr, {}, ctx))
+      : lowerChunks(false);
+  return {IfThenElse::make(Lte::make(size, MAX_PRIVATIZED_SIZE),
+                           lowerChunks(true), unprivatized)};
+}
+
 Stmt lower(Assignment assignment, string functionName, set<Property> properties,
            long long allocSize) {
   TensorVar tensorVar = assignment.getLhs().getTensorVar();
@@ -891,6 +1397,7 @@ Stmt lower(Assignment assignment, string functionName, set<Property> properties,
 
   IterationGraph iterationGraph = IterationGraph::make(assignment);
   Ctx ctx(iterationGraph, properties, tensorVars);
+  ctx.rowIterator = getRowLocalIterator(indexExpr, ctx);
 
   std::vector<Stmt> init, body, finalize;
 
@@ -908,23 +1415,76 @@ Stmt lower(Assignment assignment, string functionName, set<Property> properties,
                                       TensorProperty::Values);
     target.pos = resultIterator.getPosVar();
 
+    // Number of segments and of coordinates of the row-local result level
+    Expr rowSegments, rowNnz;
+
+    // Count the coordinates of every appended result level with a symbolic
+    // pass, so that the levels and values are allocated at their exact sizes.
+    map<IndexVar,Expr> levelSizes;
+    if (emitAssemble && !ctx.rowIterator.defined() &&
+        util::contains(properties, SymbolicAssemble)) {
+      // The symbolic pass iterates with its own iterator variables, so that
+      // the assembly pass declares and starts its iterators afresh.
+      Ctx symbolicCtx = ctx;
+      symbolicCtx.iterators = Iterators(iterationGraph, tensorVars);
+      symbolicCtx.properties.erase(Compute);
+      symbolicCtx.pass = SYMBOLIC;
+
+      vector<Stmt> symbolic;
+      const auto& resultVars = resultPath.getVariables();
+      for (auto& indexVar : resultVars) {
+        Iterator iter = symbolicCtx.iterators[resultPath.getStep(indexVar)];
+        if (iter.hasAppend()) {
+          symbolic.push_back(VarDecl::make(iter.getPosVar(), 0ll));
+        }
+      }
+
+      if (!symbolic.empty()) {
+        for (auto& root : roots) {
+          util::append(symbolic, lower(target, root, indexExpr, {},
+                                       symbolicCtx));
+        }
+        util::append(init, symbolic);
+
+        for (size_t i = 0; i < resultVars.size(); i++) {
+          Iterator iter =
+              symbolicCtx.iterators[resultPath.getStep(resultVars[i])];
+          if (iter.hasAppend()) {
+            Expr nnz = Var::make(name + to_string(i + 1) + "_nnz", Int64);
+            init.push_back(VarDecl::make(nnz, iter.getPosVar()));
+            levelSizes.insert({resultVars[i], nnz});
+          }
+        }
+      }
+    }
+
     Expr prevSz = 1ll;
     for (auto& indexVar : resultPath.getVariables()) {
       Iterator iter = ctx.iterators[resultPath.getStep(indexVar)];
-      Expr sz = iter.hasAppend() ? 0ll :
-                simplify(ir::Mul::make(prevSz, iter.getSize()));
+      Expr sz = iter.hasAppend()
+                ? (util::contains(levelSizes, indexVar)
+                   ? levelSizes.at(indexVar) : Expr(0ll))
+                : simplify(iter.getNumPositions(prevSz));
 
       if (emitAssemble) {
+        // Appended levels of unknown size start at the initial allocation size
+        Expr capacity = (isa<ir::Literal>(sz) &&
+                         to<ir::Literal>(sz)->equalsScalar(0))
+                        ? Expr(allocSize) : sz;
         Stmt initLevel = iter.hasAppend() ?
-                         iter.getAppendInitLevel(prevSz, sz) :
+                         iter.getAppendInitLevel(prevSz, capacity) :
                          iter.getInsertInitLevel(prevSz, sz);
         if (initLevel.defined()) {
           init.push_back(initLevel);
         }
       }
 
-      if (iter.hasAppend() && (emitAssemble ||
-          indexVar == resultPath.getVariables().back())) {
+      if (isRowLocal(iter, ctx)) {
+        rowSegments = prevSz;
+        rowNnz = Var::make(name + "_nnz", Int64);
+      }
+      else if (iter.hasAppend() && (emitAssemble ||
+          isPositionTracked(resultPath.getStep(indexVar), ctx))) {
         // Emit code to initialize result pos variable
         Stmt initIter = VarDecl::make(iter.getPosVar(), 0ll);
         body.push_back(initIter);
@@ -940,9 +1500,9 @@ Stmt lower(Assignment assignment, string functionName, set<Property> properties,
                  to<ir::Literal>(prevSz)->equalsScalar(0)) ?
                 (emitAssemble ? allocSize : valsSize) : prevSz;
 
-      if (emitAssemble) {
+      if (emitAssemble && !ctx.rowIterator.defined()) {
         const std::string valsCapacityName = name + "_vals_capacity";
-        ctx.valsCapacity = Var::make(valsCapacityName, Int());
+        ctx.valsCapacity = Var::make(valsCapacityName, Int64);
 
         Stmt initValsCapacity = VarDecl::make(ctx.valsCapacity, sz);
         Stmt allocVals = Allocate::make(target.tensor, sz);
@@ -963,26 +1523,71 @@ Stmt lower(Assignment assignment, string functionName, set<Property> properties,
         } else if (resultIterator.hasInsert() && needsZero(ctx) &&
                    (!isa<ir::Literal>(sz) ||
                    !to<ir::Literal>(sz)->equalsScalar(allocSize))) {
-          Expr iterVar = Var::make("p" + name, Int());
+          Expr iterVar = Var::make("p" + name, Int64);
           Stmt zeroStmt = Store::make(target.tensor, iterVar, zero);
           body.push_back(For::make(iterVar, 0ll, sz, 1ll, zeroStmt, LoopKind::Static, false));
         }
       }
     }
 
-    for (auto& root : roots) {
-      // TODO: check if generated loop nest is required (i.e., if it modifies
-      //       output arrays)
-      auto loopNest = lower(target, root, indexExpr, {}, ctx);
-      util::append(body, loopNest);
+    if (emitAssemble && ctx.rowIterator.defined()) {
+      // Count the coordinates of every segment and prefix sum the counts into
+      // the pos array, so that the coordinates and values can be filled in
+      // with one independent loop iteration per segment.
+      Ctx countCtx = ctx;
+      countCtx.properties.erase(Compute);
+      countCtx.pass = COUNT;
+      auto countLoops = lower(target, roots[0], indexExpr, {}, countCtx);
+      util::append(body, countLoops);
+
+      Stmt prefixSum = ctx.rowIterator.getAppendFinalizeLevel(rowSegments,
+                                                              rowNnz);
+      if (prefixSum.defined()) {
+        body.push_back(prefixSum);
+      }
+      Expr nnz = ctx.rowIterator.posBounds(rowSegments).getResults()[0];
+      body.push_back(VarDecl::make(rowNnz, nnz));
+
+      Stmt reserveCoords = ctx.rowIterator.getAppendReserveCoords(rowNnz);
+      if (reserveCoords.defined()) {
+        body.push_back(reserveCoords);
+      }
+      if (emitCompute) {
+        body.push_back(Allocate::make(target.tensor, rowNnz));
+      }
+
+      Ctx fillCtx = ctx;
+      fillCtx.pass = FILL;
+      auto fillLoops = lower(target, roots[0], indexExpr, {}, fillCtx);
+      util::append(body, fillLoops);
+    }
+    else {
+      for (auto& root : roots) {
+        if (isParallelReduction(root, indexExpr, ctx)) {
+          util::append(body, lowerParallelReduction(target, root, indexExpr,
+                                                    name, ctx));
+          continue;
+        }
+
+        // TODO: check if generated loop nest is required (i.e., if it modifies
+        //       output arrays)
+        auto loopNest = lower(target, root, indexExpr, {}, ctx);
+        util::append(body, loopNest);
+      }
     }
 
     if (emitAssemble) {
       Expr prevSz = 1ll;
       for (auto& indexVar : resultPath.getVariables()) {
         Iterator iter = ctx.iterators[resultPath.getStep(indexVar)];
+        if (isRowLocal(iter, ctx)) {
+          // Already finalized after the count pass
+          prevSz = rowNnz;
+          continue;
+        }
+
         Expr sz = iter.hasAppend() ? iter.getPosVar() :
-                  simplify(ir::Mul::make(prevSz, iter.getSize()));
+                  simplify(iter.getNumPositions(prevSz));
 
         Stmt finalizeLevel = iter.hasAppend() ?
                              iter.getAppendFinalizeLevel(prevSz, sz) :
@@ -1035,7 +1640,23 @@ Stmt lower(Assignment assignment, string functionName, set<Property> properties,
     util::append(body, finalize);
   }
 
-  return Function::make(functionName, results, parameters, Block::make(body));
+  Stmt function = Function::make(functionName, results, parameters,
+                                 Block::make(body));
+
+  // Compute split complex values with real arithmetic over their parts.
+  // Complex scalars store their real part before their imaginary part either
+  // way, so they are split along with the tensors.
+  vector<Expr> splitTensors;
+  bool hasSplitComplex = false;
+  for (auto& tensor : tensorVars) {
+    if (tensor.first.getFormat().isSplitComplex() ||
+        (tensor.first.getOrder() == 0 &&
+         tensor.first.getType().getDataType().isComplex())) {
+      splitTensors.push_back(tensor.second);
+    }
+    hasSplitComplex |= tensor.first.getFormat().isSplitComplex();
+  }
+  return hasSplitComplex ? splitComplex(function, splitTensors) : function;
 }
 
 }}
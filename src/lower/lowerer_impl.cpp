@@ -89,6 +89,8 @@ Stmt LowererImpl::lower(IndexStmt stmt, string name, bool assemble,
                         bool compute) {
   this->assemble = assemble;
   this->compute = compute;
+  this->initializedValues.clear();
+  this->inParallelLoop = false;
 
   // Create result and parameter variables
   vector<TensorVar> results = getResultTensorVars(stmt);
@@ -127,6 +129,7 @@ Stmt LowererImpl::lower(IndexStmt stmt, string name, bool assemble,
       }),
       function<void(const AccessNode*)>([&](const AccessNode* n) {
         auto ivars = n->indexVars;
+        if (!util::contains(ivars, ivar)) return;
         int loc = (int)distance(ivars.begin(),
                                 find(ivars.begin(),ivars.end(), ivar));
         dimension = GetProperty::make(tensorVars.at(n->tensorVar),
@@ -165,7 +168,8 @@ Stmt LowererImpl::lower(IndexStmt stmt, string name, bool assemble,
         Expr resultIR = resultVars.at(result);
         Expr vals = GetProperty::make(resultIR, TensorProperty::Values);
         Expr valsSize = GetProperty::make(resultIR, TensorProperty::ValuesSize);
-        headerStmts.push_back(Assign::make(valsSize, 1));
+        Expr one = ir::Literal::make((int64_t)1, Int64);
+        headerStmts.push_back(Assign::make(valsSize, one));
         headerStmts.push_back(Allocate::make(vals, valsSize));
       }
     }
@@ -221,8 +225,13 @@ Stmt LowererImpl::lowerAssignment(Assignment assignment) {
     Expr var = getTensorVar(result);
     Expr rhs = lower(assignment.getRhs());
 
+    // Reduction into the private partial result of a parallel forall chunk.
+    if (util::contains(partialResults, result)) {
+      Expr partial = partialResults.at(result);
+      return Assign::make(partial, ir::Add::make(partial, rhs));
+    }
     // Assignment to scalar variables.
-    if (isScalar(result.getType())) {
+    else if (isScalar(result.getType())) {
       if (!assignment.getOperator().defined()) {
         return Assign::make(var, rhs);
       }
@@ -245,7 +254,23 @@ Stmt LowererImpl::lowerAssignment(Assignment assignment) {
         resizeValueArray = doubleSizeIfFull(values, size, loc);
       }
 
-      Stmt computeStmt = Store::make(values, loc, rhs);
+      // Reductions into results of parallel foralls write the current chunk's
+      // private copy of the values or update the values atomically.
+      if (util::contains(privateValues, result)) {
+        Expr offset = privateValues.at(result).second;
+        values = privateValues.at(result).first;
+        loc = ir::Add::make(offset, ir::Cast::make(loc, Int64));
+      }
+      bool atomic = util::contains(atomicResults, result);
+
+      // Compound assignments add to the component, which was zero-initialized
+      // if the last result level supports insert.
+      if (assignment.getOperator().defined() && lastIterator.hasInsert()) {
+        taco_iassert(isa<taco::Add>(assignment.getOperator()));
+        rhs = ir::Add::make(Load::make(values, loc), rhs);
+      }
+
+      Stmt computeStmt = Store::make(values, loc, rhs, atomic);
 
       return resizeValueArray.defined()
              ? Block::make(resizeValueArray,  computeStmt)
@@ -290,6 +315,296 @@ splitAppenderAndInserters(const vector<Iterator>& results) {
 }
 
 
+static
+vector<Iterator> getIteratorsFrom(IndexVar var, vector<Iterator> iterators);
+static bool allInsert(vector<Iterator> iterators);
+
+LoopKind LowererImpl::getLoopKind(Forall forall) {
+  IndexVar i = forall.getIndexVar();
+  switch (forall.getParallelStrategy()) {
+    case ParallelStrategy::NotParallel:
+      return LoopKind::Serial;
+    case ParallelStrategy::Static:
+    case ParallelStrategy::Dynamic:
+      // Iterations must write disjoint result components, and the result
+      // levels they write must be inserted into rather than appended to, as
+      // appends share a position counter across iterations.
+      for (auto& write : getResultAccesses(forall)) {
+        // Parallel reductions are lowered by lowerParallelReduction.  Loops
+        // that only assemble do not write the values they reduce, and
+        // reductions nested in parallel loops are serial.
+        if (!util::contains(write.getIndexVars(), i)) {
+          taco_iassert(!isParallelReduction(forall));
+          return LoopKind::Serial;
+        }
+        taco_uassert(allInsert(getIteratorsFrom(i, getIterators(write))))
+            << "The forall of " << i << " cannot be parallelized, since its "
+            << "iterations race on the result " << write;
+      }
+      return (forall.getParallelStrategy() == ParallelStrategy::Static)
+             ? LoopKind::Static : LoopKind::Dynamic;
+  }
+  taco_unreachable;
+  return LoopKind::Serial;
+}
+
+
+// Number of chunks the iterations of a parallel reduction are split into.  The
+// chunks reduce into private partial results that are combined in chunk order,
+// so the results do not depend on the number of threads.
+static const int REDUCTION_CHUNKS = 64;
+
+// Largest number of components of a tensor result that a fast parallel
+// reduction privatizes per chunk.  Larger results are updated atomically.
+static const int MAX_PRIVATIZED_SIZE = 1 << 15;
+
+bool LowererImpl::isParallelReduction(Forall forall) const {
+  // Nested parallel loops are not run in parallel by OpenMP by default, and the
+  // partial results of a reduction nested in a parallel loop would be shared
+  // by the threads of that loop, so such reductions are serial.
+  if (!generateComputeCode() || inParallelLoop ||
+      forall.getParallelStrategy() == ParallelStrategy::NotParallel) {
+    return false;
+  }
+  for (auto& write : getResultAccesses(forall)) {
+    if (!util::contains(write.getIndexVars(), forall.getIndexVar())) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+Stmt LowererImpl::lowerParallelReduction(Forall forall, Expr coordinate,
+                                         Expr begin, Expr end,
+                                         function<Stmt()> lowerBody) {
+  IndexVar i = forall.getIndexVar();
+  bool deterministic =
+      forall.getReductionStrategy() == ReductionStrategy::Deterministic;
+
+  // Iterations may reduce into the same result components, but not overwrite
+  // them.
+  set<IndexVar> innerVars;
+  match(forall.getStmt(),
+    function<void(const AssignmentNode*)>([&](const AssignmentNode* op) {
+      taco_uassert(util::contains(op->lhs.getIndexVars(), i) ||
+                   op->op.defined())
+          << "The forall of " << i << " cannot be parallelized, since its "
+          << "iterations overwrite the result " << op->lhs;
+    }),
+    function<void(const ForallNode*,Matcher*)>([&](const ForallNode* op,
+                                                   Matcher* ctx) {
+      innerVars.insert(op->indexVar);
+      ctx->match(op->stmt);
+    })
+  );
+
+  // Results that every iteration reduces into the same component of get
+  // private partial results.  Results whose reduced components are selected
+  // by inner loops get private copies of their values, or are updated
+  // atomically.
+  vector<Access> partials;
+  vector<Access> privatizable;
+  vector<Access> atomics;
+  set<TensorVar> reduced;
+  for (auto& write : getResultAccesses(forall)) {
+    vector<Iterator> writeIterators = getIterators(write);
+    if (util::contains(write.getIndexVars(), i)) {
+      taco_uassert(allInsert(getIteratorsFrom(i, writeIterators)))
+          << "The forall of " << i << " cannot be parallelized, since its "
+          << "iterations race on the result " << write;
+      continue;
+    }
+    if (!reduced.insert(write.getTensorVar()).second) continue;
+
+    vector<IndexVar> writeVars = write.getIndexVars();
+    size_t numInner = count_if(writeVars.begin(), writeVars.end(),
+                               [&](IndexVar var) {
+                                 return util::contains(innerVars, var);
+                               });
+    if (numInner == 0) {
+      taco_uassert(writeIterators.empty() || writeIterators.back().hasInsert())
+          << "The forall of " << i << " cannot be parallelized, since the "
+          << "result " << write << " it reduces into does not support insert";
+      partials.push_back(write);
+    }
+    else {
+      taco_uassert(allInsert(writeIterators))
+          << "The forall of " << i << " cannot be parallelized, since the "
+          << "result " << write << " it reduces into does not support insert";
+      if (numInner == writeVars.size()) {
+        privatizable.push_back(write);
+      }
+      else {
+        // Only the components selected by the enclosing loops are reduced
+        // into, so a private copy of all the values would be mostly unused.
+        taco_uassert(!deterministic)
+            << "The forall of " << i << " cannot be reduced deterministically "
+            << "into " << write << ", since the result is indexed by both "
+            << "inner and enclosing loops";
+        atomics.push_back(write);
+      }
+    }
+  }
+
+  // The values of privatized results are all their components
+  map<TensorVar,Expr> sizes;
+  Expr totalSize = 0;
+  for (auto& write : privatizable) {
+    vector<Iterator> writeIterators = getIterators(write);
+    Expr size = writeIterators[0].getSize();
+    for (size_t j = 1; j < writeIterators.size(); j++) {
+      size = ir::Mul::make(size, writeIterators[j].getSize());
+    }
+    sizes.insert({write.getTensorVar(), size});
+    totalSize = ir::Add::make(totalSize, size);
+  }
+
+  // Split the iterations into chunks of (almost) equal size
+  Expr extent = Var::make(i.getName() + "_extent", Int());
+  Expr chunkSize = Var::make(i.getName() + "_chunk_size", Int());
+  Stmt declChunkSize =
+      Block::make(VarDecl::make(extent, ir::Sub::make(end, begin)),
+                  VarDecl::make(chunkSize,
+                                ir::Div::make(ir::Add::make(extent,
+                                                            REDUCTION_CHUNKS-1),
+                                              REDUCTION_CHUNKS)));
+
+  auto lowerChunks = [&](bool privatize) {
+    Expr chunk = Var::make(i.getName() + "_chunk", Int());
+    Expr chunkBegin = Var::make(i.getName() + "_begin", Int());
+    Expr chunkEnd = Var::make(i.getName() + "_end", Int());
+
+    vector<Stmt> allocate;
+    vector<Stmt> initChunk;
+    vector<Stmt> finalizeChunk;
+    vector<Stmt> combine;
+
+    initChunk.push_back(
+        VarDecl::make(chunkBegin,
+                      ir::Add::make(begin,
+                                    Min::make(ir::Mul::make(chunk, chunkSize),
+                                              extent))));
+    initChunk.push_back(
+        VarDecl::make(chunkEnd,
+                      ir::Add::make(begin,
+                                    Min::make(ir::Mul::make(ir::Add::make(chunk,
+                                                                          1),
+                                                            chunkSize),
+                                              extent))));
+
+    for (auto& write : partials) {
+      TensorVar result = write.getTensorVar();
+      Datatype type = result.getType().getDataType();
+      Expr partialArray = Var::make(result.getName() + "_partials", type, true);
+      Expr partial = Var::make(result.getName() + "_partial", type);
+      allocate.push_back(Allocate::make(partialArray, REDUCTION_CHUNKS));
+      initChunk.push_back(VarDecl::make(partial, ir::Literal::zero(type)));
+      finalizeChunk.push_back(Store::make(partialArray, chunk, partial));
+      partialResults.insert({result, partial});
+
+      // Add the partial results, in chunk order, to the result component
+      Expr c = Var::make("chunk", Int());
+      Expr var = getTensorVar(result);
+      Stmt add;
+      if (isScalar(result.getType())) {
+        add = Assign::make(var, ir::Add::make(var, Load::make(partialArray, c)));
+      }
+      else {
+        Expr values = GetProperty::make(var, TensorProperty::Values);
+        Expr loc = generateValueLocExpr(write);
+        add = Store::make(values, loc,
+                          ir::Add::make(Load::make(values, loc),
+                                        Load::make(partialArray, c)));
+      }
+      combine.push_back(For::make(c, 0, REDUCTION_CHUNKS, 1, add));
+      combine.push_back(Free::make(partialArray));
+    }
+
+    for (auto& write : privatizable) {
+      TensorVar result = write.getTensorVar();
+      if (!privatize) {
+        atomicResults.insert(result);
+        continue;
+      }
+      Datatype type = result.getType().getDataType();
+      Expr size = sizes.at(result);
+      Expr privates = Var::make(result.getName() + "_privates", type, true);
+      Expr offset = Var::make(result.getName() + "_offset", Int64);
+      Expr numChunks = ir::Literal::make((int64_t)REDUCTION_CHUNKS, Int64);
+      allocate.push_back(Allocate::make(privates,
+                                        ir::Mul::make(numChunks,
+                                                      ir::Cast::make(size,
+                                                                     Int64))));
+      initChunk.push_back(VarDecl::make(offset,
+                                        ir::Mul::make(ir::Cast::make(chunk,
+                                                                     Int64),
+                                                      ir::Cast::make(size,
+                                                                     Int64))));
+      Expr p = Var::make("p" + result.getName(), Int());
+      initChunk.push_back(For::make(p, 0, size, 1,
+                                    Store::make(privates,
+                                                ir::Add::make(offset,
+                                                   ir::Cast::make(p, Int64)),
+                                                ir::Literal::zero(type))));
+      privateValues.insert({result, {privates, offset}});
+
+      // Add the private copies, in chunk order, to the result values
+      Expr values = GetProperty::make(getTensorVar(result),
+                                      TensorProperty::Values);
+      Expr c = Var::make("chunk", Int());
+      Expr q = Var::make("p" + result.getName(), Int());
+      Expr loc = ir::Add::make(ir::Mul::make(ir::Cast::make(c, Int64),
+                                             ir::Cast::make(size, Int64)),
+                               ir::Cast::make(q, Int64));
+      Stmt add = Store::make(values, q,
+                             ir::Add::make(Load::make(values, q),
+                                           Load::make(privates, loc)));
+      combine.push_back(For::make(q, 0, size, 1,
+                                  For::make(c, 0, REDUCTION_CHUNKS, 1, add),
+                                  LoopKind::Static));
+      combine.push_back(Free::make(privates));
+    }
+
+    for (auto& write : atomics) {
+      atomicResults.insert(write.getTensorVar());
+    }
+
+    inParallelLoop = true;
+    Stmt body = lowerBody();
+    inParallelLoop = false;
+
+    for (auto& result : reduced) {
+      partialResults.erase(result);
+      privateValues.erase(result);
+      atomicResults.erase(result);
+    }
+
+    Stmt loop = For::make(coordinate, chunkBegin, chunkEnd, 1, body);
+    Stmt chunks = For::make(chunk, 0, REDUCTION_CHUNKS, 1,
+                            Block::make(Block::make(initChunk),
+                                        loop,
+                                        Block::make(finalizeChunk)),
+                            LoopKind::Static);
+    return Block::make(Block::make(allocate),
+                       chunks,
+                       Block::make(combine));
+  };
+
+  // Privatize results unless they are too large and atomics are allowed
+  Stmt reduction;
+  if (deterministic || privatizable.empty()) {
+    reduction = lowerChunks(true);
+  }
+  else {
+    reduction = IfThenElse::make(Lte::make(totalSize, MAX_PRIVATIZED_SIZE),
+                                 lowerChunks(true),
+                                 lowerChunks(false));
+  }
+  return Block::make(declChunkSize, reduction);
+}
+
+
 Stmt LowererImpl::lowerForall(Forall forall)
 {
   MergeLattice lattice = MergeLattice::make(forall, iterators);
@@ -345,16 +660,30 @@ Stmt LowererImpl::lowerForallDimension(Forall forall,
                                        vector<Iterator> appenders)
 {
   Expr coordinate = getCoordinateVar(forall.getIndexVar());
+  Expr dimension = getDimension(forall.getIndexVar());
+
+  Stmt posAppend = generateAppendPositions(appenders);
+
+  if (isParallelReduction(forall)) {
+    return Block::blanks(lowerParallelReduction(forall, coordinate,
+                                                0, dimension, [&]() {
+                           return lowerForallBody(coordinate, forall.getStmt(),
+                                                  locators, inserters,
+                                                  appenders);
+                         }),
+                         posAppend);
+  }
 
+  LoopKind kind = getLoopKind(forall);
+  bool enclosed = inParallelLoop;
+  inParallelLoop = enclosed || kind != LoopKind::Serial;
   Stmt body = lowerForallBody(coordinate, forall.getStmt(),
                               locators, inserters, appenders);
-
-  Stmt posAppend = generateAppendPositions(appenders);
+  inParallelLoop = enclosed;
 
   // Emit loop with preamble and postamble
-  Expr dimension = getDimension(forall.getIndexVar());
-  return Block::blanks(For::make(coordinate, 0, dimension, 1, body,
-                                 LoopKind::Serial, false),
+  return Block::blanks(For::make(coordinate, 0, dimension, 1, body, kind,
+                                 false),
                        posAppend);
 }
 
@@ -376,18 +705,36 @@ Stmt LowererImpl::lowerForallPosition(Forall forall, Iterator iterator,
   Expr coordinateArray= iterator.posAccess(coordinates(iterator)).getResults()[0];
   Stmt declareCoordinate = VarDecl::make(coordinate, coordinateArray);
 
-  Stmt body = lowerForallBody(coordinate, forall.getStmt(),
-                              locators, inserters, appenders);
-
   // Code to append positions
   Stmt posAppend = generateAppendPositions(appenders);
 
-  // Loop with preamble and postamble
   ModeFunction bounds = iterator.posBounds();
+  if (isParallelReduction(forall)) {
+    return Block::blanks(bounds.compute(),
+                         lowerParallelReduction(forall, iterator.getPosVar(),
+                                                bounds[0], bounds[1], [&]() {
+                           return Block::make(declareCoordinate,
+                                              lowerForallBody(coordinate,
+                                                              forall.getStmt(),
+                                                              locators,
+                                                              inserters,
+                                                              appenders));
+                         }),
+                         posAppend);
+  }
+
+  LoopKind kind = getLoopKind(forall);
+  bool enclosed = inParallelLoop;
+  inParallelLoop = enclosed || kind != LoopKind::Serial;
+  Stmt body = lowerForallBody(coordinate, forall.getStmt(),
+                              locators, inserters, appenders);
+  inParallelLoop = enclosed;
+
+  // Loop with preamble and postamble
   return Block::blanks(bounds.compute(),
                        For::make(iterator.getPosVar(), bounds[0], bounds[1], 1,
                                  Block::make(declareCoordinate, body),
-                                 LoopKind::Serial, false),
+                                 kind, false),
                        posAppend);
 }
 
@@ -474,7 +821,8 @@ Stmt LowererImpl::lowerMergePoint(MergeLattice pointLattice,
   else {
     // Multiple position iterators so the smallest is the resolved coordinate
     resolveCoordinate = VarDecl::make(coordinate,
-                                          Min::make(coordinates(mergers)));
+                                      Min::make(coordinates(mergers),
+                                                coordinate.type()));
   }
 
   // Locate positions
@@ -584,6 +932,11 @@ Stmt LowererImpl::lowerMulti(Multi multi) {
 Expr LowererImpl::lowerAccess(Access access) {
   TensorVar var = access.getTensorVar();
   Expr varIR = getTensorVar(var);
+  // Every component of a pattern format is one
+  if (var.getFormat().isPattern()) {
+    Datatype type = var.getType().getDataType();
+    return ir::Literal::make(TypedComponentVal(type, 1), type);
+  }
   return (isScalar(var.getType()))
          ? varIR
          : Load::make(GetProperty::make(varIR, TensorProperty::Values),
@@ -767,7 +1120,8 @@ Stmt LowererImpl::initResultArrays(vector<Access> writes)
         Expr valuesArr = GetProperty::make(tensor, TensorProperty::Values);
         Expr valsSize = GetProperty::make(tensor, TensorProperty::ValuesSize);
 
-        Stmt assignValsSize = Assign::make(valsSize, DEFAULT_ALLOC_SIZE);
+        Stmt assignValsSize = Assign::make(valsSize,
+            ir::Literal::make((int64_t)DEFAULT_ALLOC_SIZE, Int64));
         Stmt allocVals = Allocate::make(valuesArr, valsSize);
 
         initArrays.push_back(Block::make(assignValsSize, allocVals));
@@ -839,14 +1193,34 @@ Stmt LowererImpl::initValueArrays(IndexVar var, vector<Access> writes) {
   vector<Stmt> result;
 
   for (auto& write : writes) {
+    // Scalar results are stack variables.  Values that were already
+    // initialized by an enclosing loop must not be initialized again inside
+    // that loop, as that would discard earlier iterations' values, and race
+    // if the loop is parallel.
+    if (write.getTensorVar().getOrder() == 0 ||
+        util::contains(initializedValues, write.getTensorVar())) {
+      continue;
+    }
+
     Expr tensor = getTensorVar(write.getTensorVar());
     Expr values = GetProperty::make(tensor, TensorProperty::Values);
     Expr valuesSizeVar = GetProperty::make(tensor, TensorProperty::ValuesSize);
 
-    vector<Iterator> iterators = getIteratorsFrom(var, getIterators(write));
-    taco_iassert(iterators.size() > 0);
+    // A loop that reduces into a result, and that is not inside a loop that
+    // initialized it, initializes all its values.
+    vector<Iterator> writeIterators = getIterators(write);
+    vector<Iterator> iterators = getIteratorsFrom(var, writeIterators);
+    if (iterators.empty()) {
+      iterators = writeIterators;
+    }
     if (!allInsert(iterators)) continue;
 
+    // The values were already initialized by the loop over the parent level
+    // if it also inserts.
+    size_t level = writeIterators.size() - iterators.size();
+    if (level > 0 && writeIterators[level - 1].hasInsert()) continue;
+    initializedValues.insert(write.getTensorVar());
+
     Expr size = iterators[0].getSize();
     for (size_t i = 1; i < iterators.size(); i++) {
       size = ir::Mul::make(size, iterators[i].getSize());
@@ -854,7 +1228,8 @@ Stmt LowererImpl::initValueArrays(IndexVar var, vector<Access> writes) {
 
     if (generateAssembleCode()) {
       // Allocate value memory
-      result.push_back(Assign::make(valuesSizeVar, size));
+      result.push_back(Assign::make(valuesSizeVar,
+                                    ir::Cast::make(size, Int64)));
       result.push_back(Allocate::make(values, valuesSizeVar));
     }
 
@@ -1010,7 +1385,9 @@ Stmt LowererImpl::generatePostAllocValues(vector<Access> writes) {
       Expr valuesArr = GetProperty::make(tensor, TensorProperty::Values);
       Expr valuesSize = GetProperty::make(tensor, TensorProperty::ValuesSize);
 
-      result.push_back(Assign::make(valuesSize, lastIterator.getPosVar()));
+      result.push_back(Assign::make(valuesSize,
+                                    ir::Cast::make(lastIterator.getPosVar(),
+                                                   Int64)));
       result.push_back(Allocate::make(valuesArr, valuesSize));
     }
   }
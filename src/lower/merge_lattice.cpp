@@ -144,6 +144,13 @@ private:
 
   void visit(const AssignmentNode* node) {
     MergeLattice l = build(node->rhs);
+
+    // Results that are not indexed by the loop variable are reduced into, and
+    // are not iterated over by the loop
+    if (!util::contains(node->lhs.getIndexVars(), i)) {
+      lattice = l;
+      return;
+    }
     Iterator result = getIterator(node->lhs);
 
     // Add result to each point in l (as appender or inserter)
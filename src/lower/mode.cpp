@@ -111,6 +111,19 @@ ModePack::ModePack(size_t numModes, ModeFormat modeType, ir::Expr tensor,
   content->arrays = modeType.impl->getArrays(tensor, mode);
 }
 
+ModePack::ModePack(size_t numModes, ModeFormat modeType, ir::Expr tensor,
+                   int mode, const std::vector<Datatype>& arrayTypes)
+    : ModePack(numModes, modeType, tensor, mode) {
+  for (size_t i = 0; i < content->arrays.size() && i < arrayTypes.size(); i++) {
+    const ir::GetProperty* array = content->arrays[i].as<ir::GetProperty>();
+    if (array != nullptr && array->property == ir::TensorProperty::Indices) {
+      content->arrays[i] = ir::GetProperty::make(array->tensor, array->property,
+                                             array->mode, array->index,
+                                             array->name, arrayTypes[i]);
+    }
+  }
+}
+
 size_t ModePack::getNumModes() const {
   return content->numModes;
 }
@@ -0,0 +1,96 @@
+#include "taco/lower/mode_format_bitmap.h"
+
+#include "taco/util/strings.h"
+
+using namespace std;
+using namespace taco::ir;
+
+namespace taco {
+
+BitmapModeFormat::BitmapModeFormat() :
+    ModeFormatImpl("bitmap", false, true, true, false, true, true, false,
+                   true, false, false, true) {}
+
+ModeFormat BitmapModeFormat::copy(
+    vector<ModeFormat::Property> properties) const {
+  return ModeFormat(std::make_shared<BitmapModeFormat>());
+}
+
+ModeFunction BitmapModeFormat::coordIterBounds(vector<Expr> parentCoords,
+                                               Mode mode) const {
+  return ModeFunction(Stmt(), {0, mode.getModePack().getArray(2)});
+}
+
+ModeFunction BitmapModeFormat::coordIterAccess(Expr parentPos,
+                                               vector<Expr> coords,
+                                               Mode mode) const {
+  Expr idx = coords.back();
+  Expr w = Add::make(Mul::make(getNumWords(mode.getModePack()), parentPos),
+                     Div::make(idx, 64));
+  Expr word = Load::make(getBitsArray(mode.getModePack()), w);
+  Expr bit = Shl::make(Cast::make(1, UInt64), Rem::make(idx, 64));
+  Expr pos = Add::make(Load::make(getPosArray(mode.getModePack()), w),
+                       Popcount::make(BitAnd::make(word, Sub::make(bit, 1))));
+  return ModeFunction(Stmt(), {pos, Neq::make(BitAnd::make(word, bit), 0)});
+}
+
+ModeFunction BitmapModeFormat::locate(Expr parentPos, vector<Expr> coords,
+                                      Mode mode) const {
+  // int32_t B2_w = (B2_dimension + 63) / 64 * pB1 + j / 64;
+  // uint64_t B2_word = B2_bits[B2_w];
+  // uint64_t B2_bit = (uint64_t)1 << j % 64;
+  // pB2 = B2_pos[B2_w] + popcount(B2_word & (B2_bit - 1));
+  Expr idx = coords.back();
+  Expr w = Var::make(mode.getName() + "_w", Int());
+  Expr word = Var::make(mode.getName() + "_word", UInt64);
+  Expr bit = Var::make(mode.getName() + "_bit", UInt64);
+  Stmt initW = VarDecl::make(w,
+      Add::make(Mul::make(getNumWords(mode.getModePack()), parentPos),
+                Div::make(idx, 64)));
+  Stmt initWord = VarDecl::make(word,
+      Load::make(getBitsArray(mode.getModePack()), w));
+  Stmt initBit = VarDecl::make(bit,
+      Shl::make(Cast::make(1, UInt64), Rem::make(idx, 64)));
+
+  Expr pos = Add::make(Load::make(getPosArray(mode.getModePack()), w),
+                       Popcount::make(BitAnd::make(word, Sub::make(bit, 1))));
+  Expr found = Neq::make(BitAnd::make(word, bit), 0);
+  return ModeFunction(Block::make({initW, initWord, initBit}), {pos, found});
+}
+
+ModeFunction BitmapModeFormat::wordIterBounds(Expr parentPos,
+                                              Mode mode) const {
+  return ModeFunction(Stmt(), {0, getNumWords(mode.getModePack())});
+}
+
+ModeFunction BitmapModeFormat::wordIterAccess(Expr parentPos, Expr word,
+                                              Mode mode) const {
+  Expr w = Add::make(Mul::make(getNumWords(mode.getModePack()), parentPos),
+                     word);
+  return ModeFunction(Stmt(),
+                      {Load::make(getBitsArray(mode.getModePack()), w),
+                       Load::make(getPosArray(mode.getModePack()), w)});
+}
+
+vector<Expr> BitmapModeFormat::getArrays(Expr tensor, int mode) const {
+  std::string arraysName = util::toString(tensor) + std::to_string(mode);
+  return {GetProperty::make(tensor, TensorProperty::Indices,
+                            mode-1, 0, arraysName+"_pos"),
+          GetProperty::make(tensor, TensorProperty::Indices,
+                            mode-1, 1, arraysName+"_bits", UInt64),
+          GetProperty::make(tensor, TensorProperty::Dimension, mode-1)};
+}
+
+Expr BitmapModeFormat::getPosArray(ModePack pack) const {
+  return pack.getArray(0);
+}
+
+Expr BitmapModeFormat::getBitsArray(ModePack pack) const {
+  return pack.getArray(1);
+}
+
+Expr BitmapModeFormat::getNumWords(ModePack pack) const {
+  return Div::make(Add::make(pack.getArray(2), 63), 64);
+}
+
+}
@@ -102,7 +102,7 @@ Stmt CompressedModeFormat::getAppendInitEdges(Expr pPrevBegin,
     return maybeResizePos;
   }
 
-  Expr pVar = Var::make("p" + mode.getName(), Int());
+  Expr pVar = Var::make("p" + mode.getName(), posArray.type());
   Expr ub = Add::make(pPrevEnd, 1);
   Stmt storePos = Store::make(posArray, pVar, 0);
   Stmt initPos = For::make(pVar, pPrevBegin, ub, 1, storePos);
@@ -112,7 +112,15 @@ Stmt CompressedModeFormat::getAppendInitEdges(Expr pPrevBegin,
 
 Stmt CompressedModeFormat::getAppendInitLevel(Expr szPrev, Expr sz,
                                               Mode mode) const {
-  Expr capacity = Literal::make(allocSize, Datatype::Int32);
+  // The coordinates are allocated at the size of the level if the lowerer
+  // knows it, and otherwise at the default allocation size
+  Expr capacity = sz;
+  if (isa<Literal>(sz) && to<Literal>(sz)->equalsScalar(0)) {
+    capacity = Literal::make(allocSize, Datatype::Int32);
+  }
+  else if (!isa<Literal>(sz)) {
+    capacity = Max::make(sz, 1);
+  }
   Expr posArray = getPosArray(mode.getModePack());
   Expr posCapacity = getPosCapacity(mode);
   Expr initCapacity = isa<Literal>(szPrev)
@@ -126,7 +134,7 @@ Stmt CompressedModeFormat::getAppendInitLevel(Expr szPrev, Expr sz,
         mode.getParentModeType().hasAppend())
       ? Store::make(posArray, 0, 0)
       : [&]() {
-          Expr pVar = Var::make("p" + mode.getName(), Int());
+          Expr pVar = Var::make("p" + mode.getName(), posArray.type());
           Stmt storePos = Store::make(posArray, pVar, 0);
           return For::make(pVar, 0, Add::make(szPrev,1), 1, storePos);
         }();
@@ -154,19 +162,33 @@ Stmt CompressedModeFormat::getAppendFinalizeLevel(Expr szPrev,
     return Stmt();
   }
 
-  Expr csVar = Var::make("cs" + mode.getName(), Int());
+  Expr posArray = getPosArray(mode.getModePack());
+  Expr csVar = Var::make("cs" + mode.getName(), posArray.type());
   Stmt initCs = VarDecl::make(csVar, 0);
   
-  Expr pVar = Var::make("p" + mode.getName(), Int());
-  Expr loadPos = Load::make(getPosArray(mode.getModePack()), pVar);
+  Expr pVar = Var::make("p" + mode.getName(), posArray.type());
+  Expr loadPos = Load::make(posArray, pVar);
   Stmt incCs = Assign::make(csVar, Add::make(csVar, loadPos));
-  Stmt updatePos = Store::make(getPosArray(mode.getModePack()), pVar, csVar);
+  Stmt updatePos = Store::make(posArray, pVar, csVar);
   Stmt body = Block::make({incCs, updatePos});
   Stmt finalizeLoop = For::make(pVar, 1, Add::make(szPrev, 1), 1, body);
 
   return Block::make({initCs, finalizeLoop});
 }
 
+Stmt CompressedModeFormat::getAppendReserveCoords(Expr sz, Mode mode) const {
+  if (mode.getPackLocation() != (mode.getModePack().getNumModes() - 1)) {
+    return Stmt();
+  }
+
+  Expr idxCapacity = getCoordCapacity(mode);
+  Expr newCapacity = Max::make(sz, 1);
+  Stmt reallocIdxArray = Allocate::make(getCoordArray(mode.getModePack()),
+                                        newCapacity, true, idxCapacity);
+  Stmt updateIdxCapacity = Assign::make(idxCapacity, newCapacity);
+  return Block::make({reallocIdxArray, updateIdxCapacity});
+}
+
 vector<Expr> CompressedModeFormat::getArrays(Expr tensor, int mode) const {
   std::string arraysName = util::toString(tensor) + std::to_string(mode);
   return {GetProperty::make(tensor, TensorProperty::Indices,
@@ -187,7 +209,8 @@ Expr CompressedModeFormat::getPosCapacity(Mode mode) const {
   const std::string varName = mode.getName() + "_pos_size";
  
   if (!mode.hasVar(varName)) {
-    Expr posCapacity = Var::make(varName, Int());
+    Expr posCapacity = Var::make(varName,
+                                 getPosArray(mode.getModePack()).type());
     mode.addVar(varName, posCapacity);
     return posCapacity;
   }
@@ -199,7 +222,8 @@ Expr CompressedModeFormat::getCoordCapacity(Mode mode) const {
   const std::string varName = mode.getName() + "_crd_size";
   
   if (!mode.hasVar(varName)) {
-    Expr idxCapacity = Var::make(varName, Int());
+    Expr idxCapacity = Var::make(varName,
+                                 getPosArray(mode.getModePack()).type());
     mode.addVar(varName, idxCapacity);
     return idxCapacity;
   }
@@ -0,0 +1,59 @@
+#include "taco/lower/mode_format_diagonal.h"
+
+#include "taco/util/strings.h"
+
+using namespace std;
+using namespace taco::ir;
+
+namespace taco {
+
+DiagonalModeFormat::DiagonalModeFormat() :
+    ModeFormatImpl("diagonal", false, true, true, false, false, true, false,
+                   false, false, false) {}
+
+ModeFormat DiagonalModeFormat::copy(
+    vector<ModeFormat::Property> properties) const {
+  return ModeFormat(std::make_shared<DiagonalModeFormat>());
+}
+
+ModeFunction DiagonalModeFormat::coordIterBounds(vector<Expr> parentCoords,
+                                                 Mode mode) const {
+  // Rows i whose columns i + offset lie within the matrix
+  Expr offset = Load::make(getOffsetArray(mode.getModePack()),
+                           parentCoords.back());
+  Expr begin = Max::make(0, Neg::make(offset), Int32);
+  Expr end = Min::make(getNumRows(mode.getModePack()),
+                       Sub::make(getNumColumns(mode.getModePack()), offset),
+                       Int32);
+  return ModeFunction(Stmt(), {begin, end});
+}
+
+ModeFunction DiagonalModeFormat::coordIterAccess(Expr parentPos,
+                                                 vector<Expr> coords,
+                                                 Mode mode) const {
+  Expr pos = Add::make(Mul::make(parentPos, getNumRows(mode.getModePack())),
+                       coords.back());
+  return ModeFunction(Stmt(), {pos, true});
+}
+
+vector<Expr> DiagonalModeFormat::getArrays(Expr tensor, int mode) const {
+  std::string arraysName = util::toString(tensor) + std::to_string(mode);
+  return {GetProperty::make(tensor, TensorProperty::Dimension, mode-1),
+          GetProperty::make(tensor, TensorProperty::Indices,
+                            mode-1, 1, arraysName+"_offset"),
+          GetProperty::make(tensor, TensorProperty::Dimension, mode)};
+}
+
+Expr DiagonalModeFormat::getNumRows(ModePack pack) const {
+  return pack.getArray(0);
+}
+
+Expr DiagonalModeFormat::getOffsetArray(ModePack pack) const {
+  return pack.getArray(1);
+}
+
+Expr DiagonalModeFormat::getNumColumns(ModePack pack) const {
+  return pack.getArray(2);
+}
+
+}
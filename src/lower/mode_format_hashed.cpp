@@ -0,0 +1,129 @@
+#include "taco/lower/mode_format_hashed.h"
+
+#include "taco/util/strings.h"
+
+using namespace std;
+using namespace taco::ir;
+
+namespace taco {
+
+HashedModeFormat::HashedModeFormat() : HashedModeFormat(false, true) {}
+
+HashedModeFormat::HashedModeFormat(bool isFull, bool isUnique) :
+    ModeFormatImpl("hashed", isFull, false, isUnique, false, false, false,
+                   true, true, true, false) {}
+
+ModeFormat HashedModeFormat::copy(
+    vector<ModeFormat::Property> properties) const {
+  bool isFull = this->isFull;
+  bool isUnique = this->isUnique;
+  for (const auto property : properties) {
+    switch (property) {
+      case ModeFormat::FULL:
+        isFull = true;
+        break;
+      case ModeFormat::NOT_FULL:
+        isFull = false;
+        break;
+      case ModeFormat::UNIQUE:
+        isUnique = true;
+        break;
+      case ModeFormat::NOT_UNIQUE:
+        isUnique = false;
+        break;
+      default:
+        break;
+    }
+  }
+  return ModeFormat(std::make_shared<HashedModeFormat>(isFull, isUnique));
+}
+
+ModeFunction HashedModeFormat::posIterBounds(Expr parentPos, Mode mode) const {
+  Expr width = getSize(mode);
+  Expr pbegin = Mul::make(parentPos, width);
+  Expr pend = Mul::make(Add::make(parentPos, 1), width);
+  return ModeFunction(Stmt(), {pbegin, pend});
+}
+
+ModeFunction HashedModeFormat::posIterAccess(ir::Expr pos,
+                                             std::vector<ir::Expr> coords,
+                                             Mode mode) const {
+  Expr idx = Load::make(getCoordArray(mode.getModePack()), pos);
+  return ModeFunction(Stmt(), {idx, Neq::make(idx, -1)});
+}
+
+ModeFunction HashedModeFormat::locate(ir::Expr parentPos,
+                                      std::vector<ir::Expr> coords,
+                                      Mode mode) const {
+  // int64_t B2_probe = pB1 * B2_size[0] + i % B2_size[0];
+  // while (B2_crd[B2_probe] != i && B2_crd[B2_probe] != -1) {
+  //   B2_probe = B2_probe + 1;
+  //   if (B2_probe == (pB1 + 1) * B2_size[0]) B2_probe = pB1 * B2_size[0];
+  // }
+  Expr crdArray = getCoordArray(mode.getModePack());
+  Expr width = getSize(mode);
+  Expr idx = coords.back();
+  Expr begin = Mul::make(parentPos, width);
+  Expr end = Mul::make(Add::make(parentPos, 1), width);
+
+  Expr probe = Var::make(mode.getName() + "_probe", Int64);
+  Stmt initProbe = VarDecl::make(probe, Add::make(begin, Rem::make(idx, width)));
+  Expr bucket = Load::make(crdArray, probe);
+  Expr isCollision = And::make(Neq::make(bucket, idx), Neq::make(bucket, -1));
+  Stmt nextProbe = Block::make({
+      Assign::make(probe, Add::make(probe, 1)),
+      IfThenElse::make(Eq::make(probe, end), Assign::make(probe, begin))});
+  Stmt findBucket = While::make(isCollision, nextProbe);
+
+  return ModeFunction(Block::make({initProbe, findBucket}),
+                      {probe, Eq::make(bucket, idx)});
+}
+
+Stmt HashedModeFormat::getInsertCoord(Expr p, const std::vector<Expr>& i,
+                                      Mode mode) const {
+  return Store::make(getCoordArray(mode.getModePack()), p, i.back());
+}
+
+Expr HashedModeFormat::getSize(Mode mode) const {
+  return Load::make(getSizeArray(mode.getModePack()), 0);
+}
+
+Stmt HashedModeFormat::getInsertInitCoords(Expr pBegin, Expr pEnd,
+                                           Mode mode) const {
+  // The buckets of all tables are emptied when the level is initialized
+  return Stmt();
+}
+
+Stmt HashedModeFormat::getInsertInitLevel(Expr szPrev, Expr sz,
+                                          Mode mode) const {
+  Expr crdArray = getCoordArray(mode.getModePack());
+  Stmt allocCrd = Allocate::make(crdArray, Max::make(sz, 1));
+
+  Expr pVar = Var::make("p" + mode.getName(), Int64);
+  Stmt emptyBucket = Store::make(crdArray, pVar, -1);
+  Stmt emptyTables = For::make(pVar, 0, sz, 1, emptyBucket);
+  return Block::make({allocCrd, emptyTables});
+}
+
+Stmt HashedModeFormat::getInsertFinalizeLevel(Expr szPrev, Expr sz,
+                                              Mode mode) const {
+  return Stmt();
+}
+
+vector<Expr> HashedModeFormat::getArrays(Expr tensor, int mode) const {
+  std::string arraysName = util::toString(tensor) + std::to_string(mode);
+  return {GetProperty::make(tensor, TensorProperty::Indices,
+                            mode-1, 0, arraysName+"_size"),
+          GetProperty::make(tensor, TensorProperty::Indices,
+                            mode-1, 1, arraysName+"_crd")};
+}
+
+Expr HashedModeFormat::getSizeArray(ModePack pack) const {
+  return pack.getArray(0);
+}
+
+Expr HashedModeFormat::getCoordArray(ModePack pack) const {
+  return pack.getArray(1);
+}
+
+}
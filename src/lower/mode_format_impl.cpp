@@ -58,11 +58,13 @@ ModeFormatImpl::ModeFormatImpl(const std::string name,
                            bool isFull, bool isOrdered, bool isUnique,
                            bool isBranchless, bool isCompact,
                            bool hasCoordValIter, bool hasCoordPosIter,
-                           bool hasLocate, bool hasInsert, bool hasAppend) :
+                           bool hasLocate, bool hasInsert, bool hasAppend,
+                           bool hasWordIter) :
     name(name), isFull(isFull), isOrdered(isOrdered),
     isUnique(isUnique), isBranchless(isBranchless), isCompact(isCompact), 
     hasCoordValIter(hasCoordValIter), hasCoordPosIter(hasCoordPosIter), 
-    hasLocate(hasLocate), hasInsert(hasInsert), hasAppend(hasAppend) {
+    hasLocate(hasLocate), hasInsert(hasInsert), hasAppend(hasAppend),
+    hasWordIter(hasWordIter) {
 }
 
 ModeFormatImpl::~ModeFormatImpl() {
@@ -94,6 +96,16 @@ ModeFunction ModeFormatImpl::locate(ir::Expr parentPos,
                                   Mode mode) const {
   return ModeFunction();
 }
+
+ModeFunction ModeFormatImpl::wordIterBounds(ir::Expr parentPos,
+                                            Mode mode) const {
+  return ModeFunction();
+}
+
+ModeFunction ModeFormatImpl::wordIterAccess(ir::Expr parentPos, ir::Expr word,
+                                            Mode mode) const {
+  return ModeFunction();
+}
   
 Stmt ModeFormatImpl::getInsertCoord(Expr p,
     const std::vector<Expr>& i, Mode mode) const {
@@ -104,6 +116,10 @@ Expr ModeFormatImpl::getSize(Mode mode) const {
   return Expr();
 }
 
+Expr ModeFormatImpl::getNumPositions(Expr szPrev, Mode mode) const {
+  return Mul::make(szPrev, getSize(mode));
+}
+
 Stmt ModeFormatImpl::getInsertInitCoords(Expr pBegin,
     Expr pEnd, Mode mode) const {
   return Stmt();
@@ -144,4 +160,8 @@ Stmt ModeFormatImpl::getAppendFinalizeLevel(Expr szPrev,
   return Stmt();
 }
 
+Stmt ModeFormatImpl::getAppendReserveCoords(Expr sz, Mode mode) const {
+  return Stmt();
+}
+
 }
@@ -0,0 +1,42 @@
+#include "taco/lower/mode_format_offset.h"
+
+#include "taco/util/strings.h"
+
+using namespace std;
+using namespace taco::ir;
+
+namespace taco {
+
+OffsetModeFormat::OffsetModeFormat() :
+    ModeFormatImpl("offset", false, true, true, true, true, false, true,
+                   false, false, false) {}
+
+ModeFormat OffsetModeFormat::copy(
+    vector<ModeFormat::Property> properties) const {
+  return ModeFormat(std::make_shared<OffsetModeFormat>());
+}
+
+ModeFunction OffsetModeFormat::posIterBounds(Expr parentPos, Mode mode) const {
+  return ModeFunction(Stmt(), {parentPos, Add::make(parentPos, 1)});
+}
+
+ModeFunction OffsetModeFormat::posIterAccess(ir::Expr pos,
+                                             std::vector<ir::Expr> coords,
+                                             Mode mode) const {
+  taco_iassert(coords.size() >= 2);
+  Expr offset = Load::make(getOffsetArray(mode.getModePack()),
+                           coords[coords.size() - 2]);
+  return ModeFunction(Stmt(), {Add::make(coords.back(), offset), true});
+}
+
+vector<Expr> OffsetModeFormat::getArrays(Expr tensor, int mode) const {
+  std::string arraysName = util::toString(tensor) + std::to_string(mode);
+  return {GetProperty::make(tensor, TensorProperty::Indices,
+                            mode-1, 0, arraysName+"_offset")};
+}
+
+Expr OffsetModeFormat::getOffsetArray(ModePack pack) const {
+  return pack.getArray(0);
+}
+
+}
@@ -0,0 +1,75 @@
+#include "taco/lower/mode_format_permuted.h"
+
+#include "taco/util/strings.h"
+
+using namespace std;
+using namespace taco::ir;
+
+namespace taco {
+
+PermutedModeFormat::PermutedModeFormat() :
+    ModeFormatImpl("permuted", true, true, true, false, false, true, false,
+                   true, true, false) {}
+
+ModeFormat PermutedModeFormat::copy(
+    vector<ModeFormat::Property> properties) const {
+  return ModeFormat(std::make_shared<PermutedModeFormat>());
+}
+
+ModeFunction PermutedModeFormat::coordIterBounds(vector<Expr> coords,
+                                                 Mode mode) const {
+  return ModeFunction(Stmt(), {0ll, getSize(mode)});
+}
+
+ModeFunction PermutedModeFormat::coordIterAccess(Expr parentPos,
+                                                 vector<Expr> coords,
+                                                 Mode mode) const {
+  Expr row = Load::make(getRowsArray(mode.getModePack()),
+                        Add::make(Mul::make(parentPos, getSize(mode)),
+                                  coords.back()));
+  return ModeFunction(Stmt(), {row, Gte::make(row, 0)});
+}
+
+ModeFunction PermutedModeFormat::locate(Expr parentPos, vector<Expr> coords,
+                                        Mode mode) const {
+  // int32_t y2_row = y2_rows[pA2 * 2 + i];
+  Expr row = Var::make(mode.getName() + "_row", Int32);
+  Stmt initRow = VarDecl::make(row, Load::make(
+      getRowsArray(mode.getModePack()),
+      Add::make(Mul::make(parentPos, getSize(mode)), coords.back())));
+  return ModeFunction(initRow, {row, Gte::make(row, 0)});
+}
+
+Expr PermutedModeFormat::getSize(Mode mode) const {
+  return (mode.getSize().isFixed() && mode.getSize().getSize() < 16) ?
+         (long long)mode.getSize().getSize() :
+         getSliceHeight(mode.getModePack());
+}
+
+Expr PermutedModeFormat::getNumPositions(Expr szPrev, Mode mode) const {
+  // The positions are the rows, whichever slices hold them
+  return Load::make(getSizeArray(mode.getModePack()), 0);
+}
+
+vector<Expr> PermutedModeFormat::getArrays(Expr tensor, int mode) const {
+  std::string arraysName = util::toString(tensor) + std::to_string(mode);
+  return {GetProperty::make(tensor, TensorProperty::Dimension, mode-1),
+          GetProperty::make(tensor, TensorProperty::Indices,
+                            mode-1, 0, arraysName+"_size"),
+          GetProperty::make(tensor, TensorProperty::Indices,
+                            mode-1, 1, arraysName+"_rows")};
+}
+
+Expr PermutedModeFormat::getSliceHeight(ModePack pack) const {
+  return pack.getArray(0);
+}
+
+Expr PermutedModeFormat::getSizeArray(ModePack pack) const {
+  return pack.getArray(1);
+}
+
+Expr PermutedModeFormat::getRowsArray(ModePack pack) const {
+  return pack.getArray(2);
+}
+
+}
@@ -0,0 +1,121 @@
+#include "taco/lower/mode_format_singleton.h"
+
+#include "ir/ir_generators.h"
+#include "taco/ir/simplify.h"
+#include "taco/util/strings.h"
+
+using namespace std;
+using namespace taco::ir;
+
+namespace taco {
+
+SingletonModeFormat::SingletonModeFormat() :
+    SingletonModeFormat(false, true, true) {}
+
+SingletonModeFormat::SingletonModeFormat(bool isFull, bool isOrdered,
+                                         bool isUnique, long long allocSize) :
+    ModeFormatImpl("singleton", isFull, isOrdered, isUnique, true, true, false,
+                   true, false, false, true), allocSize(allocSize) {}
+
+ModeFormat SingletonModeFormat::copy(
+    vector<ModeFormat::Property> properties) const {
+  bool isFull = this->isFull;
+  bool isOrdered = this->isOrdered;
+  bool isUnique = this->isUnique;
+  for (const auto property : properties) {
+    switch (property) {
+      case ModeFormat::FULL:
+        isFull = true;
+        break;
+      case ModeFormat::NOT_FULL:
+        isFull = false;
+        break;
+      case ModeFormat::ORDERED:
+        isOrdered = true;
+        break;
+      case ModeFormat::NOT_ORDERED:
+        isOrdered = false;
+        break;
+      case ModeFormat::UNIQUE:
+        isUnique = true;
+        break;
+      case ModeFormat::NOT_UNIQUE:
+        isUnique = false;
+        break;
+      default:
+        break;
+    }
+  }
+  const auto singletonVariant =
+      std::make_shared<SingletonModeFormat>(isFull, isOrdered, isUnique);
+  return ModeFormat(singletonVariant);
+}
+
+ModeFunction SingletonModeFormat::posIterBounds(Expr parentPos,
+                                                Mode mode) const {
+  return ModeFunction(Stmt(), {parentPos, Add::make(parentPos, 1)});
+}
+
+ModeFunction SingletonModeFormat::posIterAccess(ir::Expr pos,
+                                                std::vector<ir::Expr> coords,
+                                                Mode mode) const {
+  Expr idx = Load::make(getCoordArray(mode.getModePack()), pos);
+  return ModeFunction(Stmt(), {idx, true});
+}
+
+Stmt SingletonModeFormat::getAppendCoord(Expr p, Expr i, Mode mode) const {
+  Expr idxArray = getCoordArray(mode.getModePack());
+  Stmt storeIdx = Store::make(idxArray, p, i);
+  Stmt maybeResizeIdx = doubleSizeIfFull(idxArray, getCoordCapacity(mode), p);
+  return Block::make({maybeResizeIdx, storeIdx});
+}
+
+Stmt SingletonModeFormat::getAppendInitLevel(Expr szPrev, Expr sz,
+                                             Mode mode) const {
+  // A singleton level has as many coordinates as its parent has positions
+  Expr capacity = sz;
+  if (isa<Literal>(sz) && to<Literal>(sz)->equalsScalar(0)) {
+    capacity = Literal::make(allocSize, Datatype::Int32);
+  }
+  else if (!isa<Literal>(sz)) {
+    capacity = Max::make(sz, 1);
+  }
+  Expr idxCapacity = getCoordCapacity(mode);
+  Stmt initIdxCapacity = VarDecl::make(idxCapacity, capacity);
+  Stmt allocIdxArray = Allocate::make(getCoordArray(mode.getModePack()),
+                                      idxCapacity);
+  return Block::make({initIdxCapacity, allocIdxArray});
+}
+
+Stmt SingletonModeFormat::getAppendReserveCoords(Expr sz, Mode mode) const {
+  Expr idxCapacity = getCoordCapacity(mode);
+  Expr newCapacity = Max::make(sz, 1);
+  Stmt reallocIdxArray = Allocate::make(getCoordArray(mode.getModePack()),
+                                        newCapacity, true, idxCapacity);
+  Stmt updateIdxCapacity = Assign::make(idxCapacity, newCapacity);
+  return Block::make({reallocIdxArray, updateIdxCapacity});
+}
+
+vector<Expr> SingletonModeFormat::getArrays(Expr tensor, int mode) const {
+  std::string arraysName = util::toString(tensor) + std::to_string(mode);
+  return {GetProperty::make(tensor, TensorProperty::Indices,
+                            mode-1, 0, arraysName+"_crd")};
+}
+
+Expr SingletonModeFormat::getCoordArray(ModePack pack) const {
+  return pack.getArray(0);
+}
+
+Expr SingletonModeFormat::getCoordCapacity(Mode mode) const {
+  const std::string varName = mode.getName() + "_crd_size";
+
+  if (!mode.hasVar(varName)) {
+    Expr idxCapacity = Var::make(varName, Int64);
+    mode.addVar(varName, idxCapacity);
+    return idxCapacity;
+  }
+
+  return mode.getVar(varName);
+}
+
+}
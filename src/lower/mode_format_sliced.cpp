@@ -0,0 +1,42 @@
+#include "taco/lower/mode_format_sliced.h"
+
+#include "taco/util/strings.h"
+
+using namespace std;
+using namespace taco::ir;
+
+namespace taco {
+
+SlicedModeFormat::SlicedModeFormat() :
+    ModeFormatImpl("sliced", false, true, true, false, true, false, true,
+                   false, false, false) {}
+
+ModeFormat SlicedModeFormat::copy(
+    vector<ModeFormat::Property> properties) const {
+  return ModeFormat(std::make_shared<SlicedModeFormat>());
+}
+
+ModeFunction SlicedModeFormat::posIterBounds(Expr parentPos, Mode mode) const {
+  Expr pbegin = Load::make(getPosArray(mode.getModePack()), parentPos);
+  Expr pend = Load::make(getPosArray(mode.getModePack()),
+                         Add::make(parentPos, 1));
+  return ModeFunction(Stmt(), {pbegin, pend});
+}
+
+ModeFunction SlicedModeFormat::posIterAccess(ir::Expr pos,
+                                             std::vector<ir::Expr> coords,
+                                             Mode mode) const {
+  return ModeFunction(Stmt(), {pos, true});
+}
+
+vector<Expr> SlicedModeFormat::getArrays(Expr tensor, int mode) const {
+  std::string arraysName = util::toString(tensor) + std::to_string(mode);
+  return {GetProperty::make(tensor, TensorProperty::Indices,
+                            mode-1, 0, arraysName+"_pos")};
+}
+
+Expr SlicedModeFormat::getPosArray(ModePack pack) const {
+  return pack.getArray(0);
+}
+
+}
@@ -7,6 +7,7 @@
 #include "taco/error.h"
 #include "taco/util/uncopyable.h"
 #include "taco/util/strings.h"
+#include "taco/util/files.h"
 #include "taco/cuda.h"
 
 using namespace std;
@@ -19,11 +20,17 @@ struct Array::Content : util::Uncopyable {
   size_t size;
   Policy policy = Array::UserOwns;
 
+  // The mapped file that holds the data of arrays with the Mapped policy
+  std::shared_ptr<const util::MappedFile> file;
+
   ~Content() {
     switch (policy) {
       case UserOwns:
         // do nothing
         break;
+      case Mapped:
+        // the file is unmapped when its last array is destroyed
+        break;
       case Free:
         if (should_use_CUDA_unified_memory()) {
           cuda_unified_free(data);
@@ -98,6 +105,12 @@ Array::Array(Datatype type, void* data, size_t size, Policy policy) : Array() {
   content->policy = policy;
 }
 
+Array::Array(Datatype type, void* data, size_t size,
+             std::shared_ptr<const util::MappedFile> file)
+    : Array(type, data, size, Mapped) {
+  content->file = file;
+}
+
 const Datatype& Array::getType() const {
   return content->type;
 }
@@ -205,6 +218,9 @@ std::ostream& operator<<(std::ostream& os, Array::Policy policy) {
     case Array::Delete:
       os << "delete";
       break;
+    case Array::Mapped:
+      os << "mapped";
+      break;
   }
   return os;
 }
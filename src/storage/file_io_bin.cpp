@@ -0,0 +1,468 @@
+#include "taco/storage/file_io_bin.h"
+
+#include <fstream>
+#include <cstdint>
+#include <climits>
+#include <cstring>
+#include <memory>
+#include <functional>
+#include <vector>
+
+#include "taco/tensor.h"
+#include "taco/format.h"
+#include "taco/error.h"
+#include "taco/storage/storage.h"
+#include "taco/storage/index.h"
+#include "taco/storage/array.h"
+#include "taco/util/files.h"
+#include "text_parser.h"
+
+using namespace std;
+
+namespace taco {
+
+// A binary file starts with a magic string, the version of the file format, a
+// byte order mark and the number of header words.  The header words describe
+// the tensor (component type, dimensions, format and index format) and the
+// type, size and file offset of every index array and of the value array.
+// The arrays follow the header, aligned so that mapped arrays can be used in
+// place by vectorized kernels.
+
+static const char MAGIC[8] = {'T','A','C','O','B','I','N','\0'};
+static const uint64_t VERSION = 1;
+static const uint64_t BYTE_ORDER_MARK = 0x0102030405060708ull;
+static const size_t PREAMBLE_SIZE = sizeof(MAGIC) + 3 * sizeof(uint64_t);
+static const size_t ARRAY_ALIGNMENT = 64;
+
+/// Mode format properties, stored as a bit mask
+enum PropertyBit {
+  FULL = 1, ORDERED = 2, UNIQUE = 4, BRANCHLESS = 8, COMPACT = 16
+};
+
+static size_t alignOffset(size_t offset) {
+  return (offset + ARRAY_ALIGNMENT - 1) / ARRAY_ALIGNMENT * ARRAY_ALIGNMENT;
+}
+
+// Write functions ---
+
+/// Builds the header words of a file.
+struct HeaderWriter {
+  vector<uint64_t> words;
+
+  /// The arrays of the file, and the header words that store their offsets
+  vector<Array>  arrays;
+  vector<size_t> offsetWords;
+
+  void put(uint64_t word) {
+    words.push_back(word);
+  }
+
+  void putString(const string& str) {
+    put(str.size());
+    for (size_t i = 0; i < str.size(); i += sizeof(uint64_t)) {
+      uint64_t word = 0;
+      memcpy(&word, &str[i], min(sizeof(uint64_t), str.size() - i));
+      put(word);
+    }
+  }
+
+  void putFormat(const Format& format) {
+    put(format.getModeFormatPacks().size());
+    for (auto& modeFormatPack : format.getModeFormatPacks()) {
+      put(modeFormatPack.getModeFormats().size());
+      for (auto& modeFormat : modeFormatPack.getModeFormats()) {
+        putString(modeFormat.getName());
+        put((modeFormat.isFull() ? FULL : 0) |
+            (modeFormat.isOrdered() ? ORDERED : 0) |
+            (modeFormat.isUnique() ? UNIQUE : 0) |
+            (modeFormat.isBranchless() ? BRANCHLESS : 0) |
+            (modeFormat.isCompact() ? COMPACT : 0));
+      }
+    }
+    put(format.getModeOrdering().size());
+    for (int mode : format.getModeOrdering()) {
+      put(mode);
+    }
+    put(format.getLevelArrayTypes().size());
+    for (auto& arrayTypes : format.getLevelArrayTypes()) {
+      put(arrayTypes.size());
+      for (auto& arrayType : arrayTypes) {
+        put(arrayType.getKind());
+      }
+    }
+    put(format.getBlockSizes().size());
+    for (int blockSize : format.getBlockSizes()) {
+      put(blockSize);
+    }
+    put((int64_t)format.getSliceHeight());
+    put(format.getSortWindow());
+    put(format.isPattern());
+    put(format.isSplitComplex());
+  }
+
+  void putArray(const Array& array) {
+    put(array.getType().getKind());
+    put(array.getSize());
+    offsetWords.push_back(words.size());
+    put(0);
+    arrays.push_back(array);
+  }
+};
+
+void writeFromStorageBinary(std::ostream& stream, const TensorStorage& storage) {
+  HeaderWriter header;
+  header.put(storage.getComponentType().getKind());
+  header.put(storage.getDimensions().size());
+  for (int dimension : storage.getDimensions()) {
+    header.put(dimension);
+  }
+  header.putFormat(storage.getFormat());
+  const Index& index = storage.getIndex();
+  header.putFormat(index.getFormat());
+  header.put(index.numModeIndices());
+  for (int i = 0; i < index.numModeIndices(); i++) {
+    const ModeIndex& modeIndex = index.getModeIndex(i);
+    header.put(modeIndex.numIndexArrays());
+    for (int j = 0; j < modeIndex.numIndexArrays(); j++) {
+      header.putArray(modeIndex.getIndexArray(j));
+    }
+  }
+  header.putArray(storage.getValues());
+
+  // Lay out the arrays after the header
+  size_t offset = PREAMBLE_SIZE + header.words.size() * sizeof(uint64_t);
+  for (size_t i = 0; i < header.arrays.size(); i++) {
+    offset = alignOffset(offset);
+    header.words[header.offsetWords[i]] = offset;
+    offset += header.arrays[i].getSize() *
+              header.arrays[i].getType().getNumBytes();
+  }
+
+  uint64_t numWords = header.words.size();
+  stream.write(MAGIC, sizeof(MAGIC));
+  stream.write((const char*)&VERSION, sizeof(VERSION));
+  stream.write((const char*)&BYTE_ORDER_MARK, sizeof(BYTE_ORDER_MARK));
+  stream.write((const char*)&numWords, sizeof(numWords));
+  stream.write((const char*)header.words.data(),
+               header.words.size() * sizeof(uint64_t));
+  offset = PREAMBLE_SIZE + header.words.size() * sizeof(uint64_t);
+  const char padding[ARRAY_ALIGNMENT] = {0};
+  for (auto& array : header.arrays) {
+    stream.write(padding, alignOffset(offset) - offset);
+    offset = alignOffset(offset);
+    size_t numBytes = array.getSize() * array.getType().getNumBytes();
+    stream.write((const char*)array.getData(), numBytes);
+    offset += numBytes;
+  }
+  taco_uassert(stream.good()) << "Error writing binary tensor";
+}
+
+void writeFromStorageBinary(std::string filename, const TensorStorage& storage) {
+  std::fstream file;
+  util::openStream(file, filename, fstream::out | fstream::binary);
+  writeFromStorageBinary(file, storage);
+  file.close();
+}
+
+void writeBinary(std::ostream& stream, const TensorBase& tensor) {
+  writeFromStorageBinary(stream, tensor.getStorage());
+}
+
+void writeBinary(std::string filename, const TensorBase& tensor) {
+  writeFromStorageBinary(filename, tensor.getStorage());
+}
+
+// Read functions ---
+
+/// Reads the header words of a file, and wraps the arrays that they describe.
+struct HeaderReader {
+  const char* data;
+  size_t      size;
+  size_t      numWords;
+  size_t      word;
+
+  /// Makes an array from a region of the file
+  function<Array(Datatype,const char*,size_t)> makeArray;
+
+  HeaderReader(const char* data, size_t size,
+               function<Array(Datatype,const char*,size_t)> makeArray)
+      : data(data), size(size), word(0), makeArray(makeArray) {
+    taco_uassert(size >= PREAMBLE_SIZE &&
+                 memcmp(data, MAGIC, sizeof(MAGIC)) == 0) <<
+        "Not a taco binary tensor";
+    uint64_t version, byteOrderMark, numWords;
+    memcpy(&version, data + sizeof(MAGIC), sizeof(uint64_t));
+    memcpy(&byteOrderMark, data + sizeof(MAGIC) + sizeof(uint64_t),
+           sizeof(uint64_t));
+    memcpy(&numWords, data + sizeof(MAGIC) + 2 * sizeof(uint64_t),
+           sizeof(uint64_t));
+    taco_uassert(version == VERSION) <<
+        "Unsupported taco binary tensor version " << version;
+    taco_uassert(byteOrderMark == BYTE_ORDER_MARK) <<
+        "The taco binary tensor was written with a different byte order";
+    taco_uassert(numWords <= (size - PREAMBLE_SIZE) / sizeof(uint64_t)) <<
+        "Truncated taco binary tensor";
+    this->numWords = numWords;
+  }
+
+  uint64_t get() {
+    taco_uassert(word < numWords) << "Corrupt taco binary tensor header";
+    uint64_t value;
+    memcpy(&value, data + PREAMBLE_SIZE + word * sizeof(uint64_t),
+           sizeof(uint64_t));
+    word++;
+    return value;
+  }
+
+  /// Returns a number of elements that follow in the header, each of which
+  /// takes at least one word.
+  size_t getCount() {
+    uint64_t count = get();
+    taco_uassert(count <= numWords - word) <<
+        "Corrupt taco binary tensor header";
+    return count;
+  }
+
+  int getInt() {
+    int64_t value = (int64_t)get();
+    taco_uassert(value >= INT_MIN && value <= INT_MAX) <<
+        "Corrupt taco binary tensor header";
+    return (int)value;
+  }
+
+  Datatype getType() {
+    uint64_t kind = get();
+    taco_uassert(kind <= Datatype::Undefined) <<
+        "Corrupt taco binary tensor header";
+    return Datatype((Datatype::Kind)kind);
+  }
+
+  string getString() {
+    size_t length = get();
+    taco_uassert(length <= (numWords - word) * sizeof(uint64_t)) <<
+        "Corrupt taco binary tensor header";
+    string str(length, '\0');
+    for (size_t i = 0; i < length; i += sizeof(uint64_t)) {
+      uint64_t value = get();
+      memcpy(&str[i], &value, min(sizeof(uint64_t), length - i));
+    }
+    return str;
+  }
+
+  ModeFormat getModeFormat() {
+    string name = getString();
+    uint64_t properties = get();
+    for (ModeFormat modeFormat : {Dense, Compressed, Singleton, Hashed, Sliced,
+                                  Diagonal, Offset, Bitmap}) {
+      if (modeFormat.getName() == name) {
+        return modeFormat({
+          (properties & FULL) ? ModeFormat::FULL : ModeFormat::NOT_FULL,
+          (properties & ORDERED) ? ModeFormat::ORDERED
+                                 : ModeFormat::NOT_ORDERED,
+          (properties & UNIQUE) ? ModeFormat::UNIQUE : ModeFormat::NOT_UNIQUE,
+          (properties & BRANCHLESS) ? ModeFormat::BRANCHLESS
+                                    : ModeFormat::NOT_BRANCHLESS,
+          (properties & COMPACT) ? ModeFormat::COMPACT
+                                 : ModeFormat::NOT_COMPACT
+        });
+      }
+    }
+    taco_uerror << "Unknown mode format in taco binary tensor: " << name;
+    return ModeFormat();
+  }
+
+  Format getFormat() {
+    vector<ModeFormatPack> modeFormatPacks(getCount(), ModeFormatPack(Dense));
+    for (auto& modeFormatPack : modeFormatPacks) {
+      vector<ModeFormat> modeFormats(getCount());
+      for (auto& modeFormat : modeFormats) {
+        modeFormat = getModeFormat();
+      }
+      modeFormatPack = ModeFormatPack(modeFormats);
+    }
+    vector<int> modeOrdering(getCount());
+    for (auto& mode : modeOrdering) {
+      mode = getInt();
+    }
+    Format format(modeFormatPacks, modeOrdering);
+    vector<vector<Datatype>> levelArrayTypes(getCount());
+    for (auto& arrayTypes : levelArrayTypes) {
+      arrayTypes.resize(getCount());
+      for (auto& arrayType : arrayTypes) {
+        arrayType = getType();
+      }
+    }
+    format.setLevelArrayTypes(levelArrayTypes);
+    vector<int> blockSizes(getCount());
+    for (auto& blockSize : blockSizes) {
+      blockSize = getInt();
+    }
+    if (!blockSizes.empty()) {
+      format.setBlockSizes(blockSizes);
+    }
+    int sliceHeight = getInt();
+    int sortWindow = getInt();
+    if (sliceHeight >= 0) {
+      format.setSlicing(sliceHeight, sortWindow);
+    }
+    format.setPattern(get());
+    format.setSplitComplex(get());
+    return format;
+  }
+
+  Array getArray() {
+    Datatype type = getType();
+    size_t numElements = get();
+    size_t offset = get();
+    taco_uassert(type.getKind() != Datatype::Undefined && offset <= size &&
+                 numElements <= (size - offset) / type.getNumBytes() &&
+                 offset % ARRAY_ALIGNMENT == 0) <<
+        "Truncated taco binary tensor";
+    return makeArray(type, data + offset, numElements);
+  }
+
+  TensorStorage getStorage() {
+    Datatype componentType = getType();
+    vector<int> dimensions(getCount());
+    for (auto& dimension : dimensions) {
+      dimension = getInt();
+    }
+    Format format = getFormat();
+    Format indexFormat = getFormat();
+    vector<ModeIndex> modeIndices(getCount());
+    for (auto& modeIndex : modeIndices) {
+      vector<Array> indexArrays(getCount());
+      for (auto& indexArray : indexArrays) {
+        indexArray = getArray();
+      }
+      modeIndex = ModeIndex(indexArrays);
+    }
+    TensorStorage storage(componentType, dimensions, format);
+    storage.setIndex(Index(indexFormat, modeIndices));
+    storage.setValues(getArray());
+    return storage;
+  }
+};
+
+/// Read the storage of a mapped file, whose arrays are used in place.
+static TensorStorage readStorage(std::string filename) {
+  // Writes to the arrays stay private to the process
+  auto file = make_shared<util::MappedFile>(filename, true);
+  HeaderReader header(file->getData(), file->getSize(),
+      [&](Datatype type, const char* data, size_t size) {
+        return Array(type, const_cast<char*>(data), size,
+                     shared_ptr<const util::MappedFile>(file));
+      });
+  return header.getStorage();
+}
+
+/// Read the storage of a stream, whose arrays are copied.  The arrays are
+/// located by their offsets, so the whole stream is held in memory while the
+/// arrays are copied from it.
+static TensorStorage readStorage(std::istream& stream) {
+  string buffer = readRemaining(stream);
+  HeaderReader header(buffer.data(), buffer.size(),
+      [](Datatype type, const char* data, size_t size) {
+        Array array = makeArray(type, size);
+        memcpy(array.getData(), data, size * type.getNumBytes());
+        return array;
+      });
+  return header.getStorage();
+}
+
+template <typename T>
+static void insertComponents(TensorBase& tensor, const TensorStorage& storage) {
+  for (auto& component : storage.iterator<int,T>()) {
+    tensor.insert(component.first, component.second);
+  }
+}
+
+/// Returns a tensor with the storage if it is in the given format, or with the
+/// components of the storage inserted otherwise.
+static TensorBase makeTensor(const TensorStorage& storage, const Format& format,
+                             bool pack) {
+  // The tensor takes the format of the storage, whose array types may differ
+  // from the defaults of the given format
+  if (format == storage.getFormat()) {
+    TensorBase tensor(storage.getComponentType(), storage.getDimensions(),
+                      storage.getFormat());
+    tensor.setStorage(storage);
+    return tensor;
+  }
+
+  TensorBase tensor(storage.getComponentType(), storage.getDimensions(),
+                    format);
+  switch (storage.getComponentType().getKind()) {
+    case Datatype::UInt8: insertComponents<uint8_t>(tensor, storage); break;
+    case Datatype::UInt16: insertComponents<uint16_t>(tensor, storage); break;
+    case Datatype::UInt32: insertComponents<uint32_t>(tensor, storage); break;
+    case Datatype::UInt64: insertComponents<uint64_t>(tensor, storage); break;
+    case Datatype::Int8: insertComponents<int8_t>(tensor, storage); break;
+    case Datatype::Int16: insertComponents<int16_t>(tensor, storage); break;
+    case Datatype::Int32: insertComponents<int32_t>(tensor, storage); break;
+    case Datatype::Int64: insertComponents<int64_t>(tensor, storage); break;
+    case Datatype::Float32: insertComponents<float>(tensor, storage); break;
+    case Datatype::Float64: insertComponents<double>(tensor, storage); break;
+    case Datatype::Complex64:
+      insertComponents<std::complex<float>>(tensor, storage);
+      break;
+    case Datatype::Complex128:
+      insertComponents<std::complex<double>>(tensor, storage);
+      break;
+    default:
+      taco_not_supported_yet << ": repacking binary tensors of type " <<
+          storage.getComponentType();
+  }
+  if (pack) {
+    tensor.pack();
+  }
+  return tensor;
+}
+
+static TensorBase makeTensor(const TensorStorage& storage,
+                             const ModeFormat& modetype, bool pack) {
+  return makeTensor(storage, Format(vector<ModeFormatPack>(
+                                 storage.getOrder(), modetype)), pack);
+}
+
+TensorBase readBinary(std::string filename, const ModeFormat& modetype,
+                      bool pack) {
+  return makeTensor(readStorage(filename), modetype, pack);
+}
+
+TensorBase readBinary(std::string filename, const Format& format, bool pack) {
+  return makeTensor(readStorage(filename), format, pack);
+}
+
+TensorBase readBinary(std::istream& stream, const ModeFormat& modetype,
+                      bool pack) {
+  return makeTensor(readStorage(stream), modetype, pack);
+}
+
+TensorBase readBinary(std::istream& stream, const Format& format, bool pack) {
+  return makeTensor(readStorage(stream), format, pack);
+}
+
+TensorStorage readToStorageBinary(std::string filename) {
+  return readStorage(filename);
+}
+
+TensorStorage readToStorageBinary(std::string filename,
+                                  const ModeFormat& modetype) {
+  return makeTensor(readStorage(filename), modetype, true).getStorage();
+}
+
+TensorStorage readToStorageBinary(std::string filename, const Format& format) {
+  return makeTensor(readStorage(filename), format, true).getStorage();
+}
+
+TensorStorage readToStorageBinary(std::istream& stream,
+                                  const ModeFormat& modetype) {
+  return makeTensor(readStorage(stream), modetype, true).getStorage();
+}
+
+TensorStorage readToStorageBinary(std::istream& stream, const Format& format) {
+  return makeTensor(readStorage(stream), format, true).getStorage();
+}
+
+}
@@ -13,19 +13,186 @@
 #include "taco/util/strings.h"
 #include "taco/util/timers.h"
 #include "taco/util/files.h"
+#include "taco/util/parallel.h"
+#include "text_parser.h"
 
 using namespace std;
 
 namespace taco {
 
+/// Symmetric entries are mirrored by fewer threads if there are fewer than
+/// this many entries per thread
+static const size_t MIRROR_GRAIN = 1 << 16;
+
+/// Check the MatrixMarket header line, and return its storage format
+/// (coordinate or array) and whether the tensor is symmetric.
+static string readHeader(const string& line, bool* symm) {
+  std::stringstream lineStream(line);
+  string head, type, formats, field, symmetry;
+  lineStream >> head >> type >> formats >> field >> symmetry;
+  taco_uassert(head=="%%MatrixMarket") << "Unknown header of MatrixMarket";
+  // type = [matrix tensor]
+  taco_uassert((type=="matrix") || (type=="tensor"))
+                                       << "Unknown type of MatrixMarket";
+  // formats = [coordinate array]
+  // field = [real integer complex pattern]
+  taco_uassert(field=="real")          << "MatrixMarket field not available";
+  // symmetry = [general symmetric skew-symmetric Hermitian]
+  taco_uassert((symmetry=="general") || (symmetry=="symmetric"))
+                                       << "MatrixMarket symmetry not available";
+  *symm = (symmetry=="symmetric");
+  return formats;
+}
+
+/// Parses the body of a coordinate MatrixMarket file that follows its header
+/// line, which may be given a block of lines at a time.  The entries are split
+/// into chunks of lines that are parsed in parallel, straight into their place
+/// in the coordinate and value arrays, and the entries of symmetric matrices
+/// are mirrored in bulk once all entries are parsed.
+struct SparseParser {
+  bool        symm;
+  bool        hasHeader;
+  size_t      nnz;
+  vector<int> dimensions;
+  EntryParser entries;
+
+  SparseParser(bool symm)
+      : symm(symm), hasHeader(false), nnz(0), entries('%', "MatrixMarket") {
+  }
+
+  void parse(const char* begin, const char* end) {
+    if (!hasHeader) {
+      // Skip comments at the top of the file
+      while (begin < end &&
+             isBlankOrComment(begin, findLineEnd(begin, end), '%')) {
+        begin = findNextLine(begin, end);
+      }
+      if (begin == end) {
+        return;
+      }
+      parseHeader(begin, findLineEnd(begin, end));
+      begin = findNextLine(begin, end);
+    }
+    entries.parse(begin, end);
+  }
+
+  /// Parse the first non-comment line, which is the header with dimensions.
+  void parseHeader(const char* begin, const char* lineEnd) {
+    const char* headerLine = begin;
+    vector<long long> header;
+    long long value;
+    while (parseInteger(begin, lineEnd, &value)) {
+      taco_uassert(value >= 0) << "Negative size in MatrixMarket header";
+      header.push_back(value);
+    }
+    taco_uassert(skipBlanks(begin, lineEnd) == lineEnd)
+        << "Invalid MatrixMarket header: " << string(headerLine, lineEnd);
+    taco_uassert(header.size() >= 2) << "MatrixMarket header has no dimensions";
+
+    // The number of nonzeros may exceed INT_MAX, but the dimensions may not
+    nnz = header.back();
+    header.pop_back();
+    for (long long dimension : header) {
+      taco_uassert(dimension <= INT_MAX) << "Dimension exceeds INT_MAX";
+      dimensions.push_back(static_cast<int>(dimension));
+    }
+    if (symm)
+      taco_uassert(dimensions.size()==2) << "Symmetry only available for matrix";
+    entries.setDimensions(dimensions);
+    hasHeader = true;
+  }
+
+  ParsedComponents finish() {
+    taco_uassert(hasHeader) << "MatrixMarket header has no dimensions";
+    taco_uassert(entries.getSize() == nnz) << "MatrixMarket file has " <<
+        entries.getSize() << " entries, but its header says " << nnz;
+    if (symm) {
+      mirror();
+    }
+    return entries.takeComponents(dimensions);
+  }
+
+  /// Append the mirrors of the off-diagonal entries of a symmetric matrix.
+  void mirror() {
+    const size_t numMirrorThreads = util::getNumThreads(nnz, MIRROR_GRAIN);
+    vector<size_t> mirrorOffsets(numMirrorThreads + 1, 0);
+    int* rows = entries.getCoordinates(0);
+    int* cols = entries.getCoordinates(1);
+    util::parallelBlocks(nnz, numMirrorThreads,
+                         [&](size_t t, size_t begin, size_t end) {
+      for (size_t i = begin; i < end; i++) {
+        mirrorOffsets[t+1] += (rows[i] != cols[i]);
+      }
+    });
+    for (size_t t = 0; t < numMirrorThreads; t++) {
+      mirrorOffsets[t+1] += mirrorOffsets[t];
+    }
+
+    const size_t size = nnz + mirrorOffsets[numMirrorThreads];
+    entries.reserve(size);
+    rows = entries.getCoordinates(0);
+    cols = entries.getCoordinates(1);
+    double* values = entries.getValues();
+    util::parallelBlocks(nnz, numMirrorThreads,
+                         [&](size_t t, size_t begin, size_t end) {
+      size_t j = nnz + mirrorOffsets[t];
+      for (size_t i = begin; i < end; i++) {
+        if (rows[i] != cols[i]) {
+          rows[j] = cols[i];
+          cols[j] = rows[i];
+          values[j] = values[i];
+          j++;
+        }
+      }
+    });
+    entries.setSize(size);
+  }
+};
+
+/// Parse the body of a coordinate MatrixMarket file in [begin,end).
+static ParsedComponents parseSparse(const char* begin, const char* end,
+                                    bool symm) {
+  SparseParser parser(symm);
+  parser.parse(begin, end);
+  return parser.finish();
+}
+
+/// Parse the body of a coordinate MatrixMarket file in the rest of a stream a
+/// block of lines at a time.
+static ParsedComponents parseSparse(std::istream& stream, bool symm) {
+  SparseParser parser(symm);
+  parseLineBlocks(stream, [&](const char* begin, const char* end) {
+    parser.parse(begin, end);
+  });
+  return parser.finish();
+}
+
 // TensorBase read functions ---
 
 template <typename T>
 TensorBase dispatchReadMTX(std::string filename, const T& format, bool pack) {
-  std::fstream file;
-  util::openStream(file, filename, fstream::in);
-  TensorBase tensor = readMTX(file, format, pack);
-  file.close();
+  // Coordinate files are parsed straight from a mapping of the file
+  util::MappedFile mappedFile(filename);
+  const char* begin = mappedFile.getData();
+  const char* end = begin + mappedFile.getSize();
+  if (begin == end) {
+    return TensorBase();
+  }
+  bool symm;
+  string formats = readHeader(string(begin, findLineEnd(begin, end)), &symm);
+  if (formats != "coordinate") {
+    std::fstream file;
+    util::openStream(file, filename, fstream::in);
+    TensorBase tensor = readMTX(file, format, pack);
+    file.close();
+    return tensor;
+  }
+
+  TensorBase tensor = makeTensor(parseSparse(findNextLine(begin, end), end,
+                                             symm), format);
+  if (pack) {
+    tensor.pack();
+  }
   return tensor;
 }
 
@@ -45,21 +212,8 @@ TensorBase dispatchReadMTX(std::istream& stream, const T& format, bool pack) {
   }
 
   // Read Header
-  std::stringstream lineStream(line);
-  string head, type, formats, field, symmetry;
-  lineStream >> head >> type >> formats >> field >> symmetry;
-  taco_uassert(head=="%%MatrixMarket") << "Unknown header of MatrixMarket";
-  // type = [matrix tensor]
-  taco_uassert((type=="matrix") || (type=="tensor"))
-                                       << "Unknown type of MatrixMarket";
-  // formats = [coordinate array]
-  // field = [real integer complex pattern]
-  taco_uassert(field=="real")          << "MatrixMarket field not available";
-  // symmetry = [general symmetric skew-symmetric Hermitian]
-  taco_uassert((symmetry=="general") || (symmetry=="symmetric"))
-                                       << "MatrixMarket symmetry not available";
-
-  bool symm = (symmetry=="symmetric");
+  bool symm;
+  string formats = readHeader(line, &symm);
 
   TensorBase tensor;
   if (formats=="coordinate")
@@ -87,69 +241,7 @@ TensorBase readMTX(std::istream& stream, const Format& format, bool pack) {
 template <typename T>
 TensorBase dispatchReadSparse(std::istream& stream, const T& format, 
                               bool symm) {
-  string line;
-  std::getline(stream,line);
-
-  // Skip comments at the top of the file
-  string token;
-  do {
-    std::stringstream lineStream(line);
-    lineStream >> token;
-    if (token[0] != '%') {
-      break;
-    }
-  } while (std::getline(stream, line));
-
-  // The first non-comment line is the header with dimensions
-  vector<int> dimensions;
-  char* linePtr = (char*)line.data();
-  while (size_t dimension = strtoul(linePtr, &linePtr, 10)) {
-    taco_uassert(dimension <= INT_MAX) << "Dimension exceeds INT_MAX";
-    dimensions.push_back(static_cast<int>(dimension));
-  }
-  size_t nnz = dimensions[dimensions.size()-1];
-  dimensions.pop_back();
-  if (symm)
-    taco_uassert(dimensions.size()==2) << "Symmetry only available for matrix";
-
-  vector<int> coordinates;
-  vector<double> values;
-  coordinates.reserve(nnz*dimensions.size());
-  values.reserve(nnz);
-
-  while (std::getline(stream, line)) {
-    linePtr = (char*)line.data();
-    for (size_t i=0; i < dimensions.size(); i++) {
-      long index = strtol(linePtr, &linePtr, 10);
-      taco_uassert(index <= INT_MAX) << "Index exceeds INT_MAX";
-      coordinates.push_back(static_cast<int>(index));
-    }
-    double val = strtod(linePtr, &linePtr);
-    values.push_back(val);
-  }
-
-  // Create matrix
-  TensorBase tensor(type<double>(), dimensions, format);
-  if (symm)
-    tensor.reserve(2*nnz);
-  else
-    tensor.reserve(nnz);
-
-  // Insert coordinates
-  std::vector<int> coord;
-  for (size_t i = 0; i < nnz; i++) {
-    coord.clear();
-    for (size_t mode = 0; mode < dimensions.size(); mode++) {
-      coord.push_back(coordinates[i*dimensions.size() + mode] -1);
-    }
-    tensor.insert(coord, values[i]);
-    if (symm && coord.front() != coord.back()) {
-      std::reverse(coord.begin(), coord.end());
-      tensor.insert(coord, values[i]);
-    }
-  }
-
-  return tensor;
+  return makeTensor(parseSparse(stream, symm), format);
 }
 
 TensorBase readSparse(std::istream& stream, const ModeFormat& modetype, 
@@ -237,11 +329,21 @@ TensorBase readDense(std::istream& stream, const Format& format, bool symm) {
 
 template <typename T>
 TensorStorage dispatchReadMTX(std::string filename, const T& format) {
-  std::fstream file;
-  util::openStream(file, filename, fstream::in);
-  TensorStorage storage = readToStorageMTX(file, format);
-  file.close();
-  return storage;
+  // Coordinate files are parsed straight from a mapping of the file
+  util::MappedFile mappedFile(filename);
+  const char* begin = mappedFile.getData();
+  const char* end = begin + mappedFile.getSize();
+  taco_uassert(begin != end) << "The provided file is empty. Can't generate a TensorStorage object.";
+  bool symm;
+  string formats = readHeader(string(begin, findLineEnd(begin, end)), &symm);
+  if (formats != "coordinate") {
+    std::fstream file;
+    util::openStream(file, filename, fstream::in);
+    TensorStorage storage = readToStorageMTX(file, format);
+    file.close();
+    return storage;
+  }
+  return makeStorage(parseSparse(findNextLine(begin, end), end, symm), format);
 }
 
 TensorStorage readToStorageMTX(std::string filename, const ModeFormat& modetype) {
@@ -256,24 +358,11 @@ template <typename T>
 TensorStorage dispatchReadMTX(std::istream& stream, const T& format) {
   string line;
   bool streamIsEmpty = !std::getline(stream, line);
-  taco_uassert(streamIsEmpty) << "The provided input stream is empty. Can't generate a TensorStorage object.";
+  taco_uassert(!streamIsEmpty) << "The provided input stream is empty. Can't generate a TensorStorage object.";
 
   // Read Header
-  std::stringstream lineStream(line);
-  string head, type, formats, field, symmetry;
-  lineStream >> head >> type >> formats >> field >> symmetry;
-  taco_uassert(head=="%%MatrixMarket") << "Unknown header of MatrixMarket";
-  // type = [matrix tensor]
-  taco_uassert((type=="matrix") || (type=="tensor"))
-                                       << "Unknown type of MatrixMarket";
-  // formats = [coordinate array]
-  // field = [real integer complex pattern]
-  taco_uassert(field=="real")          << "MatrixMarket field not available";
-  // symmetry = [general symmetric skew-symmetric Hermitian]
-  taco_uassert((symmetry=="general") || (symmetry=="symmetric"))
-                                       << "MatrixMarket symmetry not available";
-
-  bool symm = (symmetry=="symmetric");
+  bool symm;
+  string formats = readHeader(line, &symm);
 
   if (formats=="coordinate")
     return readToStorageSparse(stream,format,symm);
@@ -295,77 +384,7 @@ TensorStorage readToStorageMTX(std::istream& stream, const Format& format) {
 template <typename T>
 TensorStorage dispatchReadToStorageSparse(std::istream& stream, const T& format, 
                               bool symm) {
-  string line;
-  std::getline(stream,line);
-
-  // Skip comments at the top of the file
-  string token;
-  do {
-    std::stringstream lineStream(line);
-    lineStream >> token;
-    if (token[0] != '%') {
-      break;
-    }
-  } while (std::getline(stream, line));
-
-  // The first non-comment line is the header with dimensions
-  vector<int> dimensions;
-  char* linePtr = (char*)line.data();
-  while (size_t dimension = strtoul(linePtr, &linePtr, 10)) {
-    taco_uassert(dimension <= INT_MAX) << "Dimension exceeds INT_MAX";
-    dimensions.push_back(static_cast<int>(dimension));
-  }
-  size_t nnz = dimensions[dimensions.size()-1];
-  dimensions.pop_back();
-  if (symm)
-    taco_uassert(dimensions.size()==2) << "Symmetry only available for matrix";
-
-  vector<int> coordinates;
-  vector<double> values;
-  coordinates.reserve(nnz*dimensions.size());
-  values.reserve(nnz);
-
-  while (std::getline(stream, line)) {
-    linePtr = (char*)line.data();
-    for (size_t i=0; i < dimensions.size(); i++) {
-      long index = strtol(linePtr, &linePtr, 10);
-      taco_uassert(index <= INT_MAX) << "Index exceeds INT_MAX";
-      coordinates.push_back(static_cast<int>(index));
-    }
-    double val = strtod(linePtr, &linePtr);
-    values.push_back(val);
-  }
-
-  size_t order = dimensions.size();
-
-  // Create matrix
-  TensorStorage storage(type<double>(), dimensions, format);
-  std::vector<TypedIndexVector> coords(order, TypedIndexVector(type<double>(), nnz * (1 + symm)));
-
-  // Insert coordinates
-  std::vector<int> coord;
-  size_t symmOffset = 0;
-  for (size_t i = 0; i < nnz; i++) {
-    coord.clear();
-    for (size_t mode = 0; mode < order; mode++) {
-      coord.push_back(coordinates[i * order + mode] -1);
-      coords[mode][i] = coord[mode];
-    }
-    // Symm value
-    if (symm && coord.front() != coord.back()) {
-      std::reverse(coord.begin(), coord.end());
-      for (size_t mode = 0; mode < order; mode++) {
-        coords[mode][nnz + symmOffset] = coord[mode];
-      }
-      symmOffset++;
-      values.push_back(values[i]);
-    }
-  }
-  for (size_t mode = 0; mode < order; mode++) {
-    coords[mode].resize(nnz + symmOffset);
-  }
-
-  return pack(type<double>(), dimensions, format, coords, values.data());
+  return makeStorage(parseSparse(stream, symm), format);
 }
 
 TensorStorage readToStorageSparse(std::istream& stream, const ModeFormat& modetype, 
@@ -6,6 +6,7 @@
 #include <cstdlib>
 #include <cmath>
 #include <climits>
+#include <algorithm>
 
 #include "taco/tensor.h"
 #include "taco/error.h"
@@ -13,7 +14,9 @@
 #include "taco/storage/array.h"
 #include "taco/util/files.h"
 #include "taco/util/collections.h"
+#include "taco/util/parallel.h"
 #include "taco/cuda.h"
+#include "text_parser.h"
 
 using namespace std;
 
@@ -299,97 +302,432 @@ void writeValues(std::ostream &hbfile, int valuesize,
 void readRHS(){  }
 void writeRHS(){  }
 
-// TensorBase read functions ---
+// Parallel reader ---
+
+/// Transposes are split between fewer threads if there are fewer than this
+/// many components per thread
+static const size_t TRANSPOSE_GRAIN = 1 << 16;
+
+/// The layout of the fixed-width fields of a record, from a Fortran format
+/// such as (16I5), (10F7.1) or (1P,4E20.12)
+struct FieldFormat {
+  size_t perRecord;
+  size_t width;
+};
+
+/// The compressed arrays of a matrix, where `pos` has an entry per compressed
+/// dimension (the columns of CSC matrices) and `crd` and `vals` have an entry
+/// per nonzero.
+struct CompressedMatrix {
+  int   numRows;
+  int   numCols;
+  Array pos;
+  Array crd;
+  Array vals;
+};
+
+static bool isDigit(char c) {
+  return c >= '0' && c <= '9';
+}
 
-TensorBase readRB(std::string filename, const ModeFormat& modetype, bool pack) {
-  taco_uassert(false) << "RB files must be loaded into a CSC matrix";
-  return TensorBase();
+static FieldFormat parseFieldFormat(const string& format) {
+  const string descriptors = "IEDFGiedfg";
+  for (size_t i = 0; i < format.size(); i++) {
+    if (descriptors.find(format[i]) == string::npos ||
+        i + 1 == format.size() || !isDigit(format[i+1])) {
+      continue;
+    }
+    size_t countBegin = i;
+    while (countBegin > 0 && isDigit(format[countBegin-1])) {
+      countBegin--;
+    }
+    FieldFormat fieldFormat;
+    fieldFormat.perRecord = (countBegin < i)
+        ? stoul(format.substr(countBegin, i - countBegin)) : 1;
+    fieldFormat.width = stoul(format.substr(i + 1));
+    if (fieldFormat.perRecord > 0 && fieldFormat.width > 0) {
+      return fieldFormat;
+    }
+  }
+  taco_uerror << "Unsupported field format in RB file: " << format;
+  return FieldFormat();
 }
 
-TensorBase readRB(std::string filename, const Format& format, bool pack) {
-  std::fstream file;
-  util::openStream(file, filename, fstream::in);
-  TensorBase tensor = readRB(file, format, pack);
-  file.close();
+/// Parse a value, which may have a Fortran exponent such as 1.5D+03.
+static bool parseValue(const char*& p, const char* end, double* value) {
+  const char* begin = skipBlanks(p, end);
+  if (!parseDouble(p, end, value)) {
+    return false;
+  }
+  if (p < end && (*p == 'D' || *p == 'd')) {
+    const char* tokenEnd = p;
+    while (tokenEnd < end && *tokenEnd != ' ' && *tokenEnd != '\t' &&
+           *tokenEnd != '\r') {
+      tokenEnd++;
+    }
+    string token(begin, tokenEnd);
+    token[p - begin] = 'E';
+    char* parsedEnd;
+    *value = strtod(token.c_str(), &parsedEnd);
+    p = begin + (parsedEnd - token.c_str());
+  }
+  return true;
+}
 
-  return tensor;
+/// Parse the fields of a record.  Records that are laid out in fixed-width
+/// fields are parsed at the offsets of their fields, so numbers need not be
+/// separated by blanks.  Other records, e.g. those that taco writes, are
+/// parsed as numbers separated by blanks.
+template <typename T, typename ParseField>
+static bool parseRecord(const char* line, const char* lineEnd,
+                        FieldFormat format, size_t numFields, T* fields,
+                        ParseField parseField) {
+  while (lineEnd > line && (lineEnd[-1] == ' ' || lineEnd[-1] == '\t' ||
+                            lineEnd[-1] == '\r')) {
+    lineEnd--;
+  }
+  const size_t length = lineEnd - line;
+  if (length > (numFields - 1) * format.width &&
+      length <= numFields * format.width) {
+    bool isFixedWidth = true;
+    for (size_t k = 0; k < numFields && isFixedWidth; k++) {
+      const char* p = line + k * format.width;
+      const char* fieldEnd = min(p + format.width, lineEnd);
+      isFixedWidth = parseField(p, fieldEnd, &fields[k]) &&
+                     skipBlanks(p, fieldEnd) == fieldEnd;
+    }
+    if (isFixedWidth) {
+      return true;
+    }
+  }
+  const char* p = line;
+  for (size_t k = 0; k < numFields; k++) {
+    if (!parseField(p, lineEnd, &fields[k])) {
+      return false;
+    }
+  }
+  return skipBlanks(p, lineEnd) == lineEnd;
 }
 
-TensorBase readRB(std::istream& stream, const ModeFormat& modetype, bool pack) {
-  taco_uassert(false) << "RB files must be loaded into a CSC matrix";
-  return TensorBase();
+/// Returns the starts of the first `numLines` lines of [begin,end), followed
+/// by the start of the line after them.
+static vector<const char*> findLines(const char* begin, const char* end,
+                                     size_t numLines) {
+  const size_t numThreads = getNumParseThreads(end - begin);
+  vector<const char*> chunks = splitLines(begin, end, numThreads);
+  vector<size_t> offsets(numThreads + 1, 0);
+  util::parallelBlocks(numThreads, numThreads, [&](size_t t, size_t, size_t) {
+    for (const char* line = chunks[t]; line < chunks[t+1];
+         line = findNextLine(line, chunks[t+1])) {
+      offsets[t+1]++;
+    }
+  });
+  for (size_t t = 0; t < numThreads; t++) {
+    offsets[t+1] += offsets[t];
+  }
+  taco_uassert(offsets[numThreads] >= numLines) << "RB file has " <<
+      offsets[numThreads] << " data lines, but its header says " << numLines;
+
+  vector<const char*> lines(numLines + 1, end);
+  util::parallelBlocks(numThreads, numThreads, [&](size_t t, size_t, size_t) {
+    size_t i = offsets[t];
+    for (const char* line = chunks[t]; line < chunks[t+1] && i < numLines;
+         line = findNextLine(line, chunks[t+1])) {
+      lines[i++] = line;
+    }
+  });
+  if (numLines > 0) {
+    lines[numLines] = findNextLine(lines[numLines-1], end);
+  }
+  return lines;
 }
 
-TensorBase readRB(std::istream& stream, const Format& format, bool pack) {
-  int rows, cols;
-  int *colptr = NULL;
-  int *rowidx = NULL;
-  double *vals = NULL;
+/// Parse the `numFields` fields of the records [lines[0],lines[numRecords])
+/// into `fields`, in parallel across records.  Every record but the last
+/// holds the number of fields that its format gives, so the fields of each
+/// record go straight to their place.
+template <typename T, typename ParseField>
+static void parseRecords(const char* const* lines, size_t numRecords,
+                         const string& formatString, size_t numFields,
+                         T* fields, ParseField parseField) {
+  if (numFields == 0) {
+    return;
+  }
+  const FieldFormat format = parseFieldFormat(formatString);
+  taco_uassert(numRecords * format.perRecord >= numFields) << "RB file has " <<
+      numRecords << " lines of " << formatString << " fields, which cannot "
+      "hold its " << numFields << " fields";
+
+  const size_t numThreads = getNumParseThreads(lines[numRecords] - lines[0]);
+  vector<string> errors(numThreads);
+  util::parallelBlocks(numRecords, numThreads,
+                       [&](size_t t, size_t begin, size_t end) {
+    for (size_t r = begin; r < end; r++) {
+      const size_t first = r * format.perRecord;
+      if (first >= numFields) {
+        break;
+      }
+      const size_t numRecordFields = min(format.perRecord, numFields - first);
+      const char* lineEnd = findLineEnd(lines[r], lines[r+1]);
+      if (!parseRecord(lines[r], lineEnd, format, numRecordFields,
+                       &fields[first], parseField)) {
+        errors[t] = "Invalid record in RB file: " + string(lines[r], lineEnd);
+        return;
+      }
+    }
+  });
+  for (auto& error : errors) {
+    taco_uassert(error.empty()) << error;
+  }
+}
 
-  readFile(stream, &rows, &cols, &colptr, &rowidx, &vals);
+/// Parse an RB file straight into the CSC arrays of its matrix.  The records
+/// of each section are parsed in parallel, after the lines are located in
+/// parallel.
+static CompressedMatrix parseRB(const char* begin, const char* end) {
+  // The header has four lines, and a fifth if there are right-hand sides
+  const char* headerEnd = begin;
+  for (int i = 0; i < 5; i++) {
+    headerEnd = findNextLine(headerEnd, end);
+  }
+  std::istringstream headerStream(string(begin, headerEnd));
+  std::string title, key, mxtype, ptrfmt, indfmt, valfmt, rhsfmt;
+  int totcrd = -1, ptrcrd = -1, indcrd = -1, valcrd = -1, rhscrd = -1;
+  int nrow = -1, ncol = -1, nnzero = -1, neltvl = -1;
+  readHeader(headerStream, &title, &key,
+             &totcrd, &ptrcrd, &indcrd, &valcrd, &rhscrd,
+             &mxtype, &nrow, &ncol, &nnzero, &neltvl,
+             &ptrfmt, &indfmt, &valfmt, &rhsfmt);
+  taco_uassert(nrow >= 0 && ncol >= 0 && nnzero >= 0 && ptrcrd >= 0 &&
+               indcrd >= 0 && valcrd >= 0) << "Invalid RB header";
+  const char* body = begin;
+  for (int i = 0; i < ((rhscrd > 0) ? 5 : 4); i++) {
+    body = findNextLine(body, end);
+  }
+
+  vector<const char*> lines = findLines(body, end, ptrcrd + indcrd + valcrd);
+  const char* const* ptrLines = lines.data();
+  const char* const* indLines = ptrLines + ptrcrd;
+  const char* const* valLines = indLines + indcrd;
+
+  CompressedMatrix matrix;
+  matrix.numRows = nrow;
+  matrix.numCols = ncol;
+  matrix.pos = makeArray(type<int>(), ncol + 1);
+  matrix.crd = makeArray(type<int>(), nnzero);
+  matrix.vals = makeArray(type<double>(), nnzero);
+
+  auto parseIndex = [](long long size) {
+    return [size](const char*& p, const char* end, int* index) {
+      long long value;
+      if (!parseInteger(p, end, &value) || value < 1 || value > size) {
+        return false;
+      }
+      *index = static_cast<int>(value - 1);
+      return true;
+    };
+  };
+  int* colptr = (int*)matrix.pos.getData();
+  parseRecords(ptrLines, ptrcrd, ptrfmt, ncol + 1, colptr,
+               parseIndex((long long)nnzero + 1));
+  parseRecords(indLines, indcrd, indfmt, nnzero,
+               (int*)matrix.crd.getData(), parseIndex(nrow));
+  parseRecords(valLines, valcrd, valfmt, nnzero,
+               (double*)matrix.vals.getData(), parseValue);
+
+  taco_uassert(colptr[0] == 0 && colptr[ncol] == nnzero) <<
+      "RB column pointers must start at 1 and end at the number of nonzeros "
+      "plus 1";
+  for (int j = 0; j < ncol; j++) {
+    taco_uassert(colptr[j] <= colptr[j+1]) <<
+        "RB column pointers must not decrease";
+  }
+  return matrix;
+}
 
-  taco_uassert(format == CSC) << "RB files must be loaded into a CSC matrix";
-  TensorBase tensor(type<double>(), {(int)rows,(int)cols}, CSC);
+/// Transpose the compressed arrays of a matrix, i.e. convert CSC to CSR.  The
+/// compressed dimension is split into blocks with equal numbers of nonzeros,
+/// each thread counts the coordinates in its block, and each thread then
+/// scatters its block into the place that the counts give it.  Coordinates
+/// stay sorted, as the blocks are in order.
+static CompressedMatrix transpose(const CompressedMatrix& matrix) {
+  const int numCompressed = matrix.numCols;
+  const int numCoordinates = matrix.numRows;
+  const int* pos = (const int*)matrix.pos.getData();
+  const int* crd = (const int*)matrix.crd.getData();
+  const double* vals = (const double*)matrix.vals.getData();
+  const size_t nnz = pos[numCompressed];
+
+  // Every thread has a count per coordinate, so the counts are limited to
+  // about as many as there are nonzeros
+  const size_t numThreads = max(min(util::getNumThreads(nnz, TRANSPOSE_GRAIN),
+                                    nnz / max(numCoordinates, 1)), (size_t)1);
+  vector<int> blocks(numThreads + 1, numCompressed);
+  blocks[0] = 0;
+  for (size_t t = 1; t < numThreads; t++) {
+    blocks[t] = (int)(upper_bound(pos, pos + numCompressed + 1,
+                                  (int)(nnz * t / numThreads)) - pos) - 1;
+    blocks[t] = max(blocks[t], blocks[t-1]);
+  }
 
-  auto storage = tensor.getStorage();
-  Index index(CSC,
-              {ModeIndex({makeArray({(int)cols})}),
-               ModeIndex({makeArray(colptr, cols+1, Array::Free),
-                               makeArray(rowidx, colptr[cols], Array::Free)})});
-  auto values = makeArray(vals, index.getSize(), Array::Free);
+  vector<int> counts(numThreads * numCoordinates, 0);
+  util::parallelBlocks(numThreads, numThreads, [&](size_t t, size_t, size_t) {
+    int* threadCounts = counts.data() + t * numCoordinates;
+    for (int p = pos[blocks[t]]; p < pos[blocks[t+1]]; p++) {
+      threadCounts[crd[p]]++;
+    }
+  });
+
+  CompressedMatrix transposed;
+  transposed.numRows = matrix.numCols;
+  transposed.numCols = matrix.numRows;
+  transposed.pos = makeArray(type<int>(), numCoordinates + 1);
+  transposed.crd = makeArray(type<int>(), nnz);
+  transposed.vals = makeArray(type<double>(), nnz);
+  int* transposedPos = (int*)transposed.pos.getData();
+  int* transposedCrd = (int*)transposed.crd.getData();
+  double* transposedVals = (double*)transposed.vals.getData();
+
+  // Turn the counts into the offsets where each thread writes each
+  // coordinate
+  transposedPos[0] = 0;
+  for (int i = 0; i < numCoordinates; i++) {
+    int offset = transposedPos[i];
+    for (size_t t = 0; t < numThreads; t++) {
+      int count = counts[t * numCoordinates + i];
+      counts[t * numCoordinates + i] = offset;
+      offset += count;
+    }
+    transposedPos[i+1] = offset;
+  }
+
+  util::parallelBlocks(numThreads, numThreads, [&](size_t t, size_t, size_t) {
+    int* offsets = counts.data() + t * numCoordinates;
+    for (int j = blocks[t]; j < blocks[t+1]; j++) {
+      for (int p = pos[j]; p < pos[j+1]; p++) {
+        int q = offsets[crd[p]]++;
+        transposedCrd[q] = j;
+        transposedVals[q] = vals[p];
+      }
+    }
+  });
+  return transposed;
+}
 
+/// Returns the storage of a CSC or CSR matrix, which uses the compressed
+/// arrays in place.
+static TensorStorage makeCompressedStorage(const CompressedMatrix& matrix,
+                                           const Format& format) {
+  const int numCompressed = (format == CSC) ? matrix.numCols : matrix.numRows;
+  TensorStorage storage(type<double>(), {matrix.numRows, matrix.numCols},
+                        format);
+  Index index(format,
+              {ModeIndex({makeArray({numCompressed})}),
+               ModeIndex({matrix.pos, matrix.crd})});
   storage.setIndex(index);
-  storage.setValues(values);
+  storage.setValues(matrix.vals);
+  return storage;
+}
+
+/// Returns the coordinates of the nonzeros of a CSC matrix, which share its
+/// row and value arrays.
+static ParsedComponents getComponents(const CompressedMatrix& matrix) {
+  const int* colptr = (const int*)matrix.pos.getData();
+  const size_t nnz = matrix.crd.getSize();
+  Array cols = makeArray(type<int>(), nnz);
+  int* colData = (int*)cols.getData();
+  util::parallelBlocks(matrix.numCols,
+                       util::getNumThreads(nnz, TRANSPOSE_GRAIN),
+                       [&](size_t, size_t begin, size_t end) {
+    for (size_t j = begin; j < end; j++) {
+      for (int p = colptr[j]; p < colptr[j+1]; p++) {
+        colData[p] = (int)j;
+      }
+    }
+  });
+
+  ParsedComponents components;
+  components.dimensions = {matrix.numRows, matrix.numCols};
+  components.coordinates = {matrix.crd, cols};
+  components.values = matrix.vals;
+  return components;
+}
 
+// TensorBase read functions ---
+
+/// Read a matrix from the contents of an RB file.  CSC matrices use the arrays
+/// parsed from the file, CSR matrices their transpose, and matrices in other
+/// formats are inserted by their coordinates.
+static TensorBase readRB(const char* begin, const char* end,
+                         const Format& format, bool pack) {
+  taco_uassert(format.getOrder() == 2) << "RB files store matrices";
+  CompressedMatrix matrix = parseRB(begin, end);
+  if (format == CSC || format == CSR) {
+    TensorBase tensor(type<double>(), {matrix.numRows, matrix.numCols}, format);
+    tensor.setStorage(makeCompressedStorage(
+        (format == CSC) ? matrix : transpose(matrix), format));
+    return tensor;
+  }
+  TensorBase tensor = makeTensor(getComponents(matrix), format);
   if (pack) {
     tensor.pack();
   }
-
   return tensor;
 }
 
-// TensorStorage read functions ---
-
-TensorStorage readToStorageRB(std::string filename, const ModeFormat& modetype) {
-  taco_uassert(false) << "RB files must be loaded into a CSC matrix";
-  return TensorStorage(Datatype::Undefined, std::vector<int>(), Format());
+TensorBase readRB(std::string filename, const ModeFormat& modetype, bool pack) {
+  return readRB(filename, Format(vector<ModeFormatPack>(2, modetype)), pack);
 }
 
-TensorStorage readToStorageRB(std::string filename, const Format& format) {
-  std::fstream file;
-  util::openStream(file, filename, fstream::in);
-  TensorStorage storage = readToStorageRB(file, format);
-  file.close();
+TensorBase readRB(std::string filename, const Format& format, bool pack) {
+  util::MappedFile file(filename);
+  return readRB(file.getData(), file.getData() + file.getSize(), format, pack);
+}
 
-  return storage;
+TensorBase readRB(std::istream& stream, const ModeFormat& modetype, bool pack) {
+  return readRB(stream, Format(vector<ModeFormatPack>(2, modetype)), pack);
 }
 
-TensorStorage readToStorageRB(std::istream& stream, const ModeFormat& modetype) {
-  taco_uassert(false) << "RB files must be loaded into a CSC matrix";
-  return TensorStorage(Datatype::Undefined, std::vector<int>(), Format());
+/// Streams are read into memory in full before they are parsed, since the
+/// sections of the file are located before their records are parsed in
+/// parallel.
+TensorBase readRB(std::istream& stream, const Format& format, bool pack) {
+  string buffer = readRemaining(stream);
+  return readRB(buffer.data(), buffer.data() + buffer.size(), format, pack);
 }
 
-TensorStorage readToStorageRB(std::istream& stream, const Format& format) {
-  int rows, cols;
-  int *colptr = NULL;
-  int *rowidx = NULL;
-  double *vals = NULL;
+// TensorStorage read functions ---
 
-  readFile(stream, &rows, &cols, &colptr, &rowidx, &vals);
+static TensorStorage readToStorageRB(const char* begin, const char* end,
+                                     const Format& format) {
+  taco_uassert(format.getOrder() == 2) << "RB files store matrices";
+  CompressedMatrix matrix = parseRB(begin, end);
+  if (format == CSC || format == CSR) {
+    return makeCompressedStorage((format == CSC) ? matrix : transpose(matrix),
+                                 format);
+  }
+  return makeStorage(getComponents(matrix), format);
+}
 
-  taco_uassert(format == CSC) << "RB files must be loaded into a CSC matrix";
-  TensorStorage storage(type<double>(), {(int)rows,(int)cols}, CSC);
+TensorStorage readToStorageRB(std::string filename, const ModeFormat& modetype) {
+  return readToStorageRB(filename,
+                         Format(vector<ModeFormatPack>(2, modetype)));
+}
 
-  Index index(CSC,
-              {ModeIndex({makeArray({(int)cols})}),
-               ModeIndex({makeArray(colptr, cols+1, Array::Free),
-                               makeArray(rowidx, colptr[cols], Array::Free)})});
-  auto values = makeArray(vals, index.getSize(), Array::Free);
+TensorStorage readToStorageRB(std::string filename, const Format& format) {
+  util::MappedFile file(filename);
+  return readToStorageRB(file.getData(), file.getData() + file.getSize(),
+                         format);
+}
 
-  storage.setIndex(index);
-  storage.setValues(values);
+TensorStorage readToStorageRB(std::istream& stream, const ModeFormat& modetype) {
+  return readToStorageRB(stream,
+                         Format(vector<ModeFormatPack>(2, modetype)));
+}
 
-  return storage;
+TensorStorage readToStorageRB(std::istream& stream, const Format& format) {
+  string buffer = readRemaining(stream);
+  return readToStorageRB(buffer.data(), buffer.data() + buffer.size(), format);
 }
 
 // Write functions ---
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <fstream>
 #include <cstdlib>
+#include <cstring>
 #include <algorithm>
 #include <vector>
 #include <cmath>
@@ -14,20 +15,59 @@
 #include "taco/storage/pack.h"
 #include "taco/util/strings.h"
 #include "taco/util/files.h"
+#include "taco/util/parallel.h"
+#include "text_parser.h"
 
 using namespace std;
 
 namespace taco {
 
+/// Returns the components that were parsed from a tns file.  The dimensions
+/// are the largest coordinates of every mode.
+static ParsedComponents finishTNS(EntryParser& entries) {
+  taco_uassert(entries.getOrder() > 0) << "The first entry of the tns file "
+                                       << "has no coordinates: ";
+  vector<int> dimensions;
+  for (long long maxCoordinate : entries.getMaxCoordinates()) {
+    dimensions.push_back((int)maxCoordinate);
+  }
+  return entries.takeComponents(dimensions);
+}
+
+/// Parse the components of a tns file in [begin,end).  The order is that of
+/// the first entry.  The entries are counted first, so that chunks of lines are
+/// parsed in parallel straight into their place in exact-size coordinate and
+/// value arrays.
+static ParsedComponents parseTNS(const char* begin, const char* end) {
+  EntryParser entries('#', "tns");
+  entries.parse(begin, end);
+  return finishTNS(entries);
+}
+
+/// Parse the components of a tns file in the rest of a stream a block of lines
+/// at a time.
+static ParsedComponents parseTNS(std::istream& stream) {
+  EntryParser entries('#', "tns");
+  parseLineBlocks(stream, [&](const char* begin, const char* end) {
+    entries.parse(begin, end);
+  });
+  return finishTNS(entries);
+}
 
 // TensorBase read functions ---
 
 template <typename T>
 TensorBase dispatchReadTNS(std::string filename, const T& format, bool pack) {
-  std::fstream file;
-  util::openStream(file, filename, fstream::in);
-  TensorBase tensor = readTNS(file, format, pack);
-  file.close();
+  util::MappedFile file(filename);
+  if (file.getSize() == 0) {
+    return TensorBase();
+  }
+  TensorBase tensor = makeTensor(parseTNS(file.getData(),
+                                          file.getData() + file.getSize()),
+                                 format);
+  if (pack) {
+    tensor.pack();
+  }
   return tensor;
 }
 
@@ -41,54 +81,13 @@ TensorBase readTNS(std::string filename, const Format& format, bool pack) {
 
 template <typename T>
 TensorBase dispatchReadTNS(std::istream& stream, const T& format, bool pack) {
-  std::vector<int>    coordinates;
-  std::vector<double> values;
-
-  std::string line;
-  if (!std::getline(stream, line)) {
+  if (stream.peek() == std::istream::traits_type::eof()) {
     return TensorBase();
   }
-
-  // Infer tensor order from the first coordinate
-  vector<string> toks = util::split(line, " ");
-  size_t order = toks.size()-1;
-  std::vector<int> dimensions(order);
-  std::vector<int> coordinate(order);
-
-  // Load data
-  do {
-    char* linePtr = (char*)line.data();
-    for (size_t i = 0; i < order; i++) {
-      long idx = strtol(linePtr, &linePtr, 10);
-      taco_uassert(idx <= INT_MAX)<<"Coordinate in file is larger than INT_MAX";
-      coordinate[i] = (int)idx - 1;
-      dimensions[i] = std::max(dimensions[i], (int)idx);
-    }
-    coordinates.insert(coordinates.end(), coordinate.begin(), coordinate.end());
-    double val = strtod(linePtr, &linePtr);
-    values.push_back(val);
-
-  } while (std::getline(stream, line));
-
-  // Create tensor
-  const size_t nnz = values.size();
-  TensorBase tensor(type<double>(), dimensions, format);
-  tensor.reserve(nnz);
-
-  // Insert coordinates (TODO add and use bulk insertion)
-  for (size_t i = 0; i < nnz; i++) {
-    for (size_t j = 0; j < order; j++) {
-      coordinate[j] = coordinates[i*order + j];
-    }
-    tensor.insert(coordinate, values[i]);
-  }
-
-  cout << values[3] << endl;
-
+  TensorBase tensor = makeTensor(parseTNS(stream), format);
   if (pack) {
     tensor.pack();
   }
-
   return tensor;
 }
 
@@ -104,11 +103,10 @@ TensorBase readTNS(std::istream& stream, const Format& format, bool pack) {
 
 template <typename T>
 TensorStorage dispatchReadTNS(std::string filename, const T& format) {
-  std::fstream file;
-  util::openStream(file, filename, fstream::in);
-  TensorStorage storage = readToStorageTNS(file, format);
-  file.close();
-  return storage;
+  util::MappedFile file(filename);
+  taco_uassert(file.getSize() != 0) << "The provided file is empty. Can't generate a TensorStorage object.";
+  return makeStorage(parseTNS(file.getData(), file.getData() + file.getSize()),
+                     format);
 }
 
 TensorStorage readToStorageTNS(std::string filename, const ModeFormat& modetype) {
@@ -121,46 +119,8 @@ TensorStorage readToStorageTNS(std::string filename, const Format& format) {
 
 template <typename T>
 TensorStorage dispatchReadTNS(std::istream& stream, const T& format) {
-  std::vector<int>    coordinates;
-  std::vector<double> values;
-
-  std::string line;
-  bool streamIsEmpty = !std::getline(stream, line);
-  taco_uassert(!streamIsEmpty) << "The provided input stream is empty. Can't generate a TensorStorage object.";
-
-  // Infer tensor order from the first coordinate
-  vector<string> toks = util::split(line, " ");
-  size_t order = toks.size() - 1;
-  std::vector<int> dimensions(order);
-  std::vector<int> coordinate(order);
-
-  // Load data
-  do {
-    char* linePtr = (char*)line.data();
-    for (size_t i = 0; i < order; i++) {
-      long idx = strtol(linePtr, &linePtr, 10);
-      taco_uassert(idx <= INT_MAX) << "Coordinate in file is larger than INT_MAX";
-      coordinate[i] = (int)idx - 1;
-      dimensions[i] = std::max(dimensions[i], (int)idx);
-    }
-    coordinates.insert(coordinates.end(), coordinate.begin(), coordinate.end());
-    double val = strtod(linePtr, &linePtr);
-    values.push_back(val);
-
-  } while (std::getline(stream, line));
-
-  // Create tensorStorage
-  TensorStorage storage(type<double>(), dimensions, format);
-  const size_t nnz = values.size();
-  std::vector<TypedIndexVector> coords(order, TypedIndexVector(type<double>(), nnz));
-
-  for (size_t i = 0; i < nnz; i++) {
-    for (size_t j = 0; j < order; j++) {
-      coords[j][i] = coordinates[i * order + j];
-    }
-  }
-  cout << values[3] << endl;
-  return pack(type<double>(), dimensions, format, coords, values.data());
+  taco_uassert(stream.peek() != std::istream::traits_type::eof()) << "The provided input stream is empty. Can't generate a TensorStorage object.";
+  return makeStorage(parseTNS(stream), format);
 }
 
 TensorStorage readToStorageTNS(std::istream& stream, const ModeFormat& modetype) {
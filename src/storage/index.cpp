@@ -57,12 +57,34 @@ size_t Index::getSize() const {
     auto modeIndex = getModeIndex(i);
     if (modeType == Dense) {
       size *= modeIndex.getIndexArray(0).get(0).getAsIndex();
-    } else if (modeType == Sparse) {
+    } else if (modeType.getName() == Compressed.getName() ||
+               modeType.getName() == Sliced.getName()) {
       size = modeIndex.getIndexArray(0).get(size).getAsIndex();
+    } else if (modeType.getName() == Singleton.getName()) {
+      // One coordinate per parent position, so the size does not change
+      continue;
+    } else if (modeType.getName() == Hashed.getName() ||
+               modeType.getName() == Diagonal.getName()) {
+      // One table of buckets, or one position per row, per parent position
+      size *= modeIndex.getIndexArray(0).get(0).getAsIndex();
+    } else if (modeType.getName() == Offset.getName()) {
+      // One column per parent position
+      continue;
+    } else if (modeType.getName() == Bitmap.getName()) {
+      // The pos array ends with the number of coordinates of the level
+      const Array& pos = modeIndex.getIndexArray(0);
+      size = pos.get(pos.getSize() - 1).getAsIndex();
+    } else if (modeType.getName() == Permuted.getName()) {
+      // One position per row, whichever slices hold the rows
+      size = modeIndex.getIndexArray(0).get(0).getAsIndex();
     } else {
       taco_not_supported_yet;
     }
   }
+  // Every position of the last level of a blocked format stores a block
+  for (int blockSize : getFormat().getBlockSizes()) {
+    size *= blockSize;
+  }
   return size;
 }
 
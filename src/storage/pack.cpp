@@ -1,6 +1,9 @@
 #include "taco/storage/pack.h"
 
 #include <climits>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
 
 #include "taco/format.h"
 #include "taco/error.h"
@@ -9,185 +12,1016 @@
 #include "taco/storage/index.h"
 #include "taco/storage/array.h"
 #include "taco/util/collections.h"
+#include "taco/util/parallel.h"
 
 using namespace std;
 
 namespace taco {
 
-#define PACK_NEXT_LEVEL(cend) {                                          \
-  if (i + 1 == modeTypes.size()) {                                       \
-    if (cbegin < cend) {                                                  \
-      memcpy(&values[valuesIndex], &vals[cbegin*dataType.getNumBytes()], dataType.getNumBytes()); \
-    }                                                                     \
-    else {                                                                 \
-      memset(&values[valuesIndex], 0, dataType.getNumBytes());             \
-    }                                                                       \
-    valuesIndex += dataType.getNumBytes();                                \
-  } else {                                                               \
-    valuesIndex = packTensor(dimensions, coords, vals, cbegin, (cend), modeTypes, i+1, \
-    indices, values, dataType, valuesIndex);                             \
-  }                                                                      \
-}
-
-
-/// Count unique entries (assumes the values are sorted)
-static TypedIndexVector getUniqueEntries(TypedIndexVector v, 
-                                         size_t startIndex, size_t endIndex) {
-  TypedIndexVector uniqueEntries(v.getType());
-  TypedIndexVal prev;
-  TypedIndexVal curr;
-  if (endIndex - startIndex > 0){
-    prev = v[startIndex];
-    uniqueEntries.push_back(prev);
-    for (size_t j = startIndex + 1; j < endIndex; j++) {
-      curr = v[j];
-      taco_iassert(curr >= prev);
-      if (curr > prev) {
-        prev = curr;
-        uniqueEntries.push_back(curr);
-      }
-    }
-  }
-  return uniqueEntries;
-}
-
-/// Pack tensor coordinates into an index structure and value array.  The
-/// indices consist of one index per tensor mode, and each index contains
-/// [0,2] index arrays.
-static int packTensor(const vector<int>& dimensions,
-                      const vector<TypedIndexVector>& coords,
-                      char* vals,
-                      size_t begin, size_t end,
-                      const vector<ModeFormat>& modeTypes, size_t i,
-                      std::vector<std::vector<TypedIndexVector>>* indices,
-                      char* values, Datatype dataType, int valuesIndex) {
-  auto& modeType    = modeTypes[i];
-  auto& levelCoords = coords[i];
-  auto& index       = (*indices)[i];
-  if (modeType == Dense) {
-    // Iterate over each index value and recursively pack it's segment
-    size_t cbegin = begin;
-    for (int j=0; j < (int)dimensions[i]; ++j) {
-      // Scan to find segment range of children
-      size_t cend = cbegin;
-      while (cend < end && levelCoords[cend] == j) {
-        cend++;
-      }
-      PACK_NEXT_LEVEL(cend);
-      cbegin = cend;
-    }
-  } else if (modeType == Sparse) {
-    TypedIndexVector indexValues = getUniqueEntries(levelCoords, begin, end);
-
-    // Store segment end: the size of the stored segment is the number of
-    // unique values in the coordinate list
-    index[0].push_back((int)index[1].size() + (int)indexValues.size());
-
-    // Store unique index values for this segment
-    index[1].push_back_vector(indexValues);
-
-    // Iterate over each index value and recursively pack it's segment
-    size_t cbegin = begin;
-    for (int j = 0; j < (int) indexValues.size(); j++) {
-      // Scan to find segment range of children
-      size_t cend = cbegin;
-      while (cend < end && levelCoords[cend] == indexValues[j]) {
-        cend++;
-      }
-      PACK_NEXT_LEVEL(cend);
-      cbegin = cend;
-    }
-  } else {
-    taco_not_supported_yet;
-  }
-  return valuesIndex;
-}
-
-inline bool sameSize(const std::vector<TypedIndexVector>& coordinates) {
-  if (coordinates.size() == 0) return true;
-  size_t num = coordinates[0].size();
-  for (size_t i = 1; i < coordinates.size(); i++) {
-    if (coordinates[i].size() != num) return false;
-  }
-  return true;
+/// Inputs with fewer components than this per thread are packed by fewer
+/// threads, since starting a thread costs more than packing them.
+static const size_t PACK_GRAIN = 1 << 16;
+
+/// Radix sort digit size in bits
+static const int RADIX_BITS = 8;
+static const size_t RADIX = (size_t)1 << RADIX_BITS;
+
+static size_t getNumThreads(size_t numComponents) {
+  return util::getNumThreads(numComponents, PACK_GRAIN);
 }
 
-/// Pack tensor coordinates into a format. The coordinates must be stored as a
-/// structure of arrays, that is one vector per axis coordinate and one vector
-/// for the values. The coordinates must be sorted lexicographically.
-TensorStorage pack(Datatype                             componentType,
-                   const std::vector<int>&              dimensions,
-                   const Format&                        format,
-                   const std::vector<TypedIndexVector>& coordinates,
-                   const void *                         values) {
-  taco_iassert(dimensions.size() == (size_t)format.getOrder());
-  taco_iassert(coordinates.size() == (size_t)format.getOrder());
-  taco_iassert(sameSize(coordinates));
-  taco_iassert(dimensions.size() > 0) << "Scalar packing not supported";
+/// Components are sorted by ids that hold the index of their batch in the
+/// upper bits and their index in the batch in the lower bits
+static const int BATCH_SHIFT = 40;
+static const size_t BATCH_MASK = ((size_t)1 << BATCH_SHIFT) - 1;
 
-  cout << ((double*)values)[3] << endl;
+/// A sort key together with the component it belongs to
+struct KeyIndex {
+  uint64_t key;
+  size_t   index;
+};
 
-  size_t order = dimensions.size();
-  size_t numCoordinates = coordinates[0].size();
+/// Stable LSD radix sort of the lowest `bits` bits of the keys, one digit at
+/// a time.  Every thread histograms and scatters its own block, and digits
+/// that are the same for every key are skipped.
+static void radixSort(vector<KeyIndex>& keys, int bits, size_t numThreads) {
+  size_t n = keys.size();
+  vector<KeyIndex> sorted(n);
+  vector<size_t> offsets(numThreads * RADIX);
+  for (int shift = 0; shift < bits; shift += RADIX_BITS) {
+    fill(offsets.begin(), offsets.end(), 0);
+    util::parallelBlocks(n, numThreads, [&](size_t t, size_t begin, size_t end) {
+      size_t* counts = &offsets[t * RADIX];
+      for (size_t i = begin; i < end; i++) {
+        counts[(keys[i].key >> shift) & (RADIX - 1)]++;
+      }
+    });
 
-  TensorStorage storage(componentType, dimensions, format);
+    // Digit-major, thread-minor prefix sum of the counts
+    bool sameDigit = false;
+    size_t offset = 0;
+    for (size_t digit = 0; digit < RADIX; digit++) {
+      size_t digitBegin = offset;
+      for (size_t t = 0; t < numThreads; t++) {
+        size_t count = offsets[t * RADIX + digit];
+        offsets[t * RADIX + digit] = offset;
+        offset += count;
+      }
+      sameDigit |= (offset - digitBegin == n);
+    }
+    if (sameDigit) {
+      continue;
+    }
 
-  // Create vectors to store pointers to indices/index sizes
-  vector<vector<TypedIndexVector>> indices;
-  indices.reserve(order);
+    util::parallelBlocks(n, numThreads, [&](size_t t, size_t begin, size_t end) {
+      size_t* positions = &offsets[t * RADIX];
+      for (size_t i = begin; i < end; i++) {
+        sorted[positions[(keys[i].key >> shift) & (RADIX - 1)]++] = keys[i];
+      }
+    });
+    swap(keys, sorted);
+  }
+}
 
-  long long int maxSize = 1;
-  for (size_t i=0; i < order; ++i) {
-    ModeFormat modeType = format.getModeFormats()[i];
-    if (modeType == Dense) {
-      indices.push_back({});
-      maxSize *= dimensions[i];
-    } else if (modeType == Sparse) {
-      // Sparse indices have two arrays: a segment array and an index array
-      indices.push_back({TypedIndexVector(format.getCoordinateTypePos(i)),
-                         TypedIndexVector(format.getCoordinateTypeIdx(i))});
+/// Number of bits needed to store coordinates in [0,dimension)
+static int getNumBits(int dimension) {
+  int bits = 0;
+  while (bits < 31 && (1ll << bits) < dimension) {
+    bits++;
+  }
+  return bits;
+}
 
-      // Add start of first segment
-      indices[i][0].push_back(0);
+/// Add the component at `value` into the component at `result`
+static void addComponent(Datatype type, char* result, const char* value) {
+  ComponentTypeUnion a;
+  ComponentTypeUnion b;
+  memcpy(&a, result, type.getNumBytes());
+  memcpy(&b, value, type.getNumBytes());
+  TypedComponentVal sum = TypedComponentVal(type, &a) +
+                          TypedComponentVal(type, &b);
+  memcpy(result, &sum.get(), type.getNumBytes());
+}
 
-      maxSize = numCoordinates;
-    } else {
+/// Merge the sorted components that have the same coordinate.  The components
+/// are read through `coord(k,i)`, the level i coordinate of the k'th
+/// component, and `value(k)`, a pointer to its value.  The merged coordinates
+/// are written to `coords` (one vector per level) and their values to
+/// `values`.  Returns false if there were duplicates.
+template <typename Coord, typename Value>
+static bool mergeDuplicates(size_t n, size_t order, Coord coord, Value value,
+                            Datatype componentType, DuplicatePolicy duplicates,
+                            size_t numThreads, vector<vector<int>>* coords,
+                            vector<char>* values) {
+  // Find the first component of every coordinate
+  vector<uint8_t> first(n);
+  vector<size_t> blockOffsets(numThreads + 1, 0);
+  util::parallelBlocks(n, numThreads, [&](size_t t, size_t begin, size_t end) {
+    size_t count = 0;
+    for (size_t k = begin; k < end; k++) {
+      bool isFirst = (k == 0);
+      for (size_t i = 0; i < order && !isFirst; i++) {
+        isFirst = (coord(k, i) != coord(k-1, i));
+      }
+      first[k] = isFirst;
+      count += isFirst;
+    }
+    blockOffsets[t + 1] = count;
+  });
+  for (size_t t = 0; t < numThreads; t++) {
+    blockOffsets[t + 1] += blockOffsets[t];
+  }
+  size_t numUnique = blockOffsets[numThreads];
+
+  // Copy out the coordinates and merged values of every unique coordinate
+  const size_t valueSize = componentType.getNumBytes();
+  coords->assign(order, vector<int>(numUnique));
+  values->resize(numUnique * valueSize);
+  util::parallelBlocks(n, numThreads, [&](size_t t, size_t begin, size_t end) {
+    size_t j = blockOffsets[t];
+    for (size_t k = begin; k < end; k++) {
+      if (!first[k]) {
+        continue;
+      }
+      size_t kend = k + 1;
+      while (kend < n && !first[kend]) {
+        kend++;
+      }
+
+      for (size_t i = 0; i < order; i++) {
+        (*coords)[i][j] = coord(k, i);
+      }
+      char* merged = &(*values)[j * valueSize];
+      switch (duplicates) {
+        case DuplicatePolicy::First:
+        case DuplicatePolicy::Error:
+          memcpy(merged, value(k), valueSize);
+          break;
+        case DuplicatePolicy::Last:
+          memcpy(merged, value(kend - 1), valueSize);
+          break;
+        case DuplicatePolicy::Sum:
+          memcpy(merged, value(k), valueSize);
+          for (size_t l = k + 1; l < kend; l++) {
+            addComponent(componentType, merged, value(l));
+          }
+          break;
+      }
+      j++;
+    }
+  });
+  return numUnique == n;
+}
+
+/// Copy indices into a new index array of the given type
+template <typename T, typename I>
+static void copyIndex(void* array, const vector<I>& index, size_t numThreads) {
+  T* data = (T*)array;
+  util::parallelBlocks(index.size(), numThreads,
+                 [&](size_t, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      data[i] = (T)index[i];
+    }
+  });
+}
+
+template <typename I>
+static Array makeIndexArray(Datatype type, const vector<I>& index,
+                            size_t numThreads) {
+  Array array = makeArray(type, index.size());
+  switch (type.getKind()) {
+    case Datatype::UInt8:
+      copyIndex<uint8_t>(array.getData(), index, numThreads);
+      break;
+    case Datatype::UInt16:
+      copyIndex<uint16_t>(array.getData(), index, numThreads);
+      break;
+    case Datatype::UInt32:
+      copyIndex<uint32_t>(array.getData(), index, numThreads);
+      break;
+    case Datatype::UInt64:
+      copyIndex<uint64_t>(array.getData(), index, numThreads);
+      break;
+    case Datatype::Int8:
+      copyIndex<int8_t>(array.getData(), index, numThreads);
+      break;
+    case Datatype::Int16:
+      copyIndex<int16_t>(array.getData(), index, numThreads);
+      break;
+    case Datatype::Int32:
+      copyIndex<int32_t>(array.getData(), index, numThreads);
+      break;
+    case Datatype::Int64:
+      copyIndex<int64_t>(array.getData(), index, numThreads);
+      break;
+    default:
       taco_not_supported_yet;
+      break;
+  }
+  return array;
+}
+
+/// Returns true if value is representable by the index type.
+static bool fitsIndexType(Datatype type, size_t value) {
+  int bits = type.getNumBits() - (type.isInt() ? 1 : 0);
+  return bits >= 64 || value < (size_t(1) << bits);
+}
+
+/// Report an error if the coordinates of a level do not fit its crd type.
+static void checkCoordinateType(Datatype crdType, int dimension,
+                                size_t level) {
+  taco_uassert(dimension == 0 || fitsIndexType(crdType, dimension - 1)) <<
+      "Level " << level+1 << " has dimension " << dimension << ", which " <<
+      "overflows its " << crdType << " crd array";
+}
+
+/// Report an error if a component of the batches has a coordinate outside
+/// its dimension, since packing it would write out of bounds.
+static void checkCoordinates(Datatype componentType,
+                             const vector<int>& dimensions,
+                             const vector<ComponentBatch>& batches) {
+  const size_t order = dimensions.size();
+  const size_t componentSize = order * sizeof(int) +
+                               componentType.getNumBytes();
+  auto getCoord = [&](const ComponentBatch& batch, size_t i, size_t mode) {
+    return (batch.components != nullptr)
+           ? ((const int*)&batch.components[i * componentSize])[mode]
+           : batch.coordinates[mode][i];
+  };
+  auto inBounds = [&](const ComponentBatch& batch, size_t i) {
+    for (size_t mode = 0; mode < order; mode++) {
+      int coord = getCoord(batch, i, mode);
+      if (coord < 0 || coord >= dimensions[mode]) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  for (auto& batch : batches) {
+    const size_t numThreads = getNumThreads(batch.size);
+    vector<char> valid(numThreads, 1);
+    util::parallelBlocks(batch.size, numThreads,
+                         [&](size_t t, size_t begin, size_t end) {
+      for (size_t i = begin; i < end && valid[t]; i++) {
+        valid[t] = inBounds(batch, i);
+      }
+    });
+    if (find(valid.begin(), valid.end(), 0) == valid.end()) {
+      continue;
+    }
+
+    // Find the first offending component to report it
+    for (size_t i = 0; i < batch.size; i++) {
+      for (size_t mode = 0; mode < order; mode++) {
+        int coord = getCoord(batch, i, mode);
+        taco_uassert(coord >= 0 && coord < dimensions[mode]) <<
+            "Coordinate " << coord << " of mode " << mode << " is out of " <<
+            "bounds for dimension " << dimensions[mode];
+      }
+    }
+  }
+}
+
+/// Split sorted components into runs of components with the same coordinates
+/// so far, or into one run per component if the level stores duplicate
+/// coordinates.  Stores the coordinate of every run in `crd` and the first run
+/// of every parent position in `pos`, and updates the position of every
+/// component to its run.  Returns the number of runs.
+static size_t packRuns(const vector<int>& levelCoords, bool isUnique,
+                       size_t numPositions, size_t numThreads,
+                       vector<size_t>& positions, vector<uint8_t>& runStart,
+                       vector<int>& crd, vector<size_t>& pos) {
+  size_t n = levelCoords.size();
+
+  // A new run starts where the coordinates so far change, or at every
+  // component if the level stores duplicate coordinates
+  vector<size_t> blockOffsets(numThreads + 1, 0);
+  util::parallelBlocks(n, numThreads, [&](size_t t, size_t begin, size_t end) {
+    size_t count = 0;
+    for (size_t k = max(begin, (size_t)1); k < end; k++) {
+      runStart[k] |= (!isUnique || levelCoords[k] != levelCoords[k-1]);
+    }
+    for (size_t k = begin; k < end; k++) {
+      count += runStart[k];
     }
+    blockOffsets[t + 1] = count;
+  });
+  for (size_t t = 0; t < numThreads; t++) {
+    blockOffsets[t + 1] += blockOffsets[t];
+  }
+  size_t numRuns = blockOffsets[numThreads];
+
+  // Store the coordinate and the parent position of every run
+  crd.resize(numRuns);
+  vector<size_t> parents(numRuns);
+  util::parallelBlocks(n, numThreads, [&](size_t t, size_t begin, size_t end) {
+    size_t run = blockOffsets[t];
+    for (size_t k = begin; k < end; k++) {
+      if (runStart[k]) {
+        crd[run] = levelCoords[k];
+        parents[run] = positions[k];
+        run++;
+      }
+      positions[k] = run - 1;
+    }
+  });
+
+  // The segment of parent position p starts at its first run
+  pos.resize(numPositions + 1);
+  util::parallelBlocks(numPositions + 1, numThreads,
+                 [&](size_t, size_t begin, size_t end) {
+    size_t run = lower_bound(parents.begin(), parents.end(), begin) -
+                 parents.begin();
+    for (size_t p = begin; p < end; p++) {
+      while (run < numRuns && parents[run] < p) {
+        run++;
+      }
+      pos[p] = run;
+    }
+  });
+  return numRuns;
+}
+
+/// Reorder an array of complex values into the real parts of all values
+/// followed by their imaginary parts.
+static void splitComplexValues(Array array, size_t numThreads) {
+  const size_t size = array.getSize();
+  const size_t partSize = array.getType().getNumBytes() / 2;
+  const char* vals = (const char*)array.getData();
+  vector<char> parts(2 * size * partSize);
+  util::parallelBlocks(size, numThreads, [&](size_t, size_t begin, size_t end) {
+    for (size_t k = begin; k < end; k++) {
+      memcpy(&parts[k * partSize], &vals[2 * k * partSize], partSize);
+      memcpy(&parts[(size + k) * partSize], &vals[(2 * k + 1) * partSize],
+             partSize);
+    }
+  });
+  memcpy(array.getData(), parts.data(), parts.size());
+}
+
+/// Pack sorted components with unique coordinates into a format, one level at
+/// a time.  Each component tracks its position in the current level: a
+/// dense level's positions are computed from the parent positions, while a
+/// compressed level stores one coordinate for each run of components with the
+/// same coordinates so far, and its pos array points to the runs of every
+/// parent position.  A singleton level stores the coordinate of every parent
+/// position, and a hashed level stores the coordinates of every parent
+/// position in a hash table.  A bitmap level sets the bits of the runs of
+/// every parent position, whose positions are their runs.
+static TensorStorage packLevels(Datatype componentType,
+                                const vector<int>& dimensions,
+                                const Format& format,
+                                const vector<vector<int>>& coords,
+                                const vector<char>& values,
+                                size_t numThreads) {
+  size_t order = dimensions.size();
+  size_t n = coords.empty() ? 0 : coords[0].size();
+
+  TensorStorage storage(componentType, dimensions, format);
+
+  vector<size_t> positions(n, 0);
+  vector<uint8_t> runStart(n, 0);
+  if (n > 0) {
+    runStart[0] = 1;
   }
+  size_t numPositions = 1;
 
-  void* vals = malloc(maxSize * componentType.getNumBytes());
-  int actual_size = packTensor(dimensions, coordinates, (char *) values, 0,
-                               numCoordinates, format.getModeFormats(), 0,
-                               &indices, (char *)vals, componentType, 0);
-  vals = realloc(vals, actual_size);
+  // Components are sorted by their positions until a hashed level scatters
+  // them over the buckets of its tables
+  bool isSortedByPosition = true;
 
-  // Create a tensor index
   vector<ModeIndex> modeIndices;
   for (size_t i = 0; i < order; i++) {
     ModeFormat modeType = format.getModeFormats()[i];
+    const vector<int>& levelCoords = coords[i];
     if (modeType == Dense) {
-      Array size = makeArray({dimensions[i]});
-      modeIndices.push_back(ModeIndex({size}));
-    } else if (modeType == Sparse) {
-      Array pos = makeArray(format.getCoordinateTypePos(i),indices[i][0].size());
-      memcpy(pos.getData(), indices[i][0].data(),
-             indices[i][0].size()*format.getCoordinateTypePos(i).getNumBytes());
-
-      Array idx = makeArray(format.getCoordinateTypeIdx(i), indices[i][1].size());
-      memcpy(idx.getData(), indices[i][1].data(), indices[i][1].size() * format.getCoordinateTypeIdx(i).getNumBytes());
-      modeIndices.push_back(ModeIndex({pos, idx}));
+      size_t dimension = dimensions[i];
+      util::parallelBlocks(n, numThreads, [&](size_t, size_t begin, size_t end) {
+        for (size_t k = begin; k < end; k++) {
+          positions[k] = positions[k] * dimension + levelCoords[k];
+          runStart[k] |= (k > 0 && levelCoords[k] != levelCoords[k-1]);
+        }
+      });
+      numPositions *= dimension;
+      modeIndices.push_back(ModeIndex({
+          makeIndexArray(format.getCoordinateTypePos(i),
+                         vector<size_t>({dimension}), 1)}));
+    } else if (modeType.getName() == Compressed.getName()) {
+      Datatype crdType = format.getCoordinateTypeIdx(i);
+      checkCoordinateType(crdType, dimensions[i], i);
+      taco_uassert(isSortedByPosition) <<
+          "Level " << i+1 << " is a compressed level, which cannot be " <<
+          "stored below a hashed level";
+
+      vector<int> crd;
+      vector<size_t> pos;
+      size_t numRuns = packRuns(levelCoords, modeType.isUnique(), numPositions,
+                                numThreads, positions, runStart, crd, pos);
+      numPositions = numRuns;
+
+      Datatype posType = format.getCoordinateTypePos(i);
+      taco_uassert(fitsIndexType(posType, numRuns)) <<
+          "Level " << i+1 << " has " << numRuns << " coordinates, which " <<
+          "overflows its " << posType << " pos array; store the level with " <<
+          "Int64 arrays by calling Format::setLevelArrayTypes";
+      modeIndices.push_back(ModeIndex({
+          makeIndexArray(posType, pos, numThreads),
+          makeIndexArray(crdType, crd, numThreads)}));
+    } else if (modeType.getName() == Hashed.getName()) {
+      Datatype crdType = format.getCoordinateTypeIdx(i);
+      checkCoordinateType(crdType, dimensions[i], i);
+      taco_uassert(crdType.isInt()) <<
+          "Level " << i+1 << " is a hashed level, whose " << crdType <<
+          " crd array cannot mark empty buckets with -1";
+      taco_uassert(modeType.isUnique()) <<
+          "Level " << i+1 << " is a hashed level, which cannot store " <<
+          "duplicate coordinates";
+      taco_uassert(isSortedByPosition) <<
+          "Level " << i+1 << " is a hashed level, which cannot be stored " <<
+          "below another hashed level";
+
+      vector<int> runCrd;
+      vector<size_t> runPos;
+      size_t numRuns = packRuns(levelCoords, true, numPositions, numThreads,
+                                positions, runStart, runCrd, runPos);
+
+      // Tables are twice as wide as the largest segment, so that probing
+      // always ends at an empty bucket, or as wide as the dimension, so that
+      // every coordinate has its own bucket
+      size_t maxRuns = 0;
+      for (size_t p = 0; p < numPositions; p++) {
+        maxRuns = max(maxRuns, runPos[p + 1] - runPos[p]);
+      }
+      const size_t width = max(min(2 * maxRuns, (size_t)dimensions[i]),
+                               (size_t)1);
+
+      Datatype sizeType = format.getCoordinateTypePos(i);
+      taco_uassert(fitsIndexType(sizeType, numPositions * width)) <<
+          "Level " << i+1 << " has " << numPositions * width << " buckets, " <<
+          "which overflow its " << sizeType << " positions; store the level " <<
+          "with Int64 arrays by calling Format::setLevelArrayTypes";
+
+      // Insert the runs of every parent position into its table by linear
+      // probing from the coordinate modulo the table width
+      vector<int> crd(numPositions * width, -1);
+      vector<size_t> buckets(numRuns);
+      util::parallelBlocks(numPositions, numThreads,
+                     [&](size_t, size_t begin, size_t end) {
+        for (size_t p = begin; p < end; p++) {
+          const size_t tableBegin = p * width;
+          for (size_t run = runPos[p]; run < runPos[p + 1]; run++) {
+            size_t bucket = runCrd[run] % width;
+            while (crd[tableBegin + bucket] != -1) {
+              bucket = (bucket + 1 == width) ? 0 : bucket + 1;
+            }
+            crd[tableBegin + bucket] = runCrd[run];
+            buckets[run] = tableBegin + bucket;
+          }
+        }
+      });
+      util::parallelBlocks(n, numThreads, [&](size_t, size_t begin, size_t end) {
+        for (size_t k = begin; k < end; k++) {
+          positions[k] = buckets[positions[k]];
+        }
+      });
+      numPositions *= width;
+      isSortedByPosition = false;
+
+      modeIndices.push_back(ModeIndex({
+          makeIndexArray(sizeType, vector<size_t>({width}), 1),
+          makeIndexArray(crdType, crd, numThreads)}));
+    } else if (modeType.getName() == Bitmap.getName()) {
+      taco_uassert(format.getCoordinateTypeIdx(i) == UInt64) <<
+          "Level " << i+1 << " is a bitmap level, whose bits array must " <<
+          "store UInt64 words";
+      taco_uassert(modeType.isUnique()) <<
+          "Level " << i+1 << " is a bitmap level, which cannot store " <<
+          "duplicate coordinates";
+      taco_uassert(isSortedByPosition) <<
+          "Level " << i+1 << " is a bitmap level, which cannot be stored " <<
+          "below a hashed level";
+
+      vector<int> runCrd;
+      vector<size_t> runPos;
+      size_t numRuns = packRuns(levelCoords, true, numPositions, numThreads,
+                                positions, runStart, runCrd, runPos);
+
+      const size_t numWords = ((size_t)dimensions[i] + 63) / 64;
+      Datatype posType = format.getCoordinateTypePos(i);
+      taco_uassert(fitsIndexType(posType, numRuns)) <<
+          "Level " << i+1 << " has " << numRuns << " coordinates, which " <<
+          "overflows its " << posType << " pos array; store the level with " <<
+          "Int64 arrays by calling Format::setLevelArrayTypes";
+
+      // Set the bit of every run, and store the position of the first run
+      // of every word
+      vector<uint64_t> bits(numPositions * numWords, 0);
+      vector<size_t> pos(numPositions * numWords + 1);
+      util::parallelBlocks(numPositions, numThreads,
+                     [&](size_t, size_t begin, size_t end) {
+        for (size_t p = begin; p < end; p++) {
+          for (size_t run = runPos[p]; run < runPos[p + 1]; run++) {
+            bits[p * numWords + runCrd[run] / 64] |=
+                (uint64_t)1 << (runCrd[run] % 64);
+          }
+          size_t run = runPos[p];
+          for (size_t w = p * numWords; w < (p + 1) * numWords; w++) {
+            pos[w] = run;
+            run += __builtin_popcountll(bits[w]);
+          }
+        }
+      });
+      pos[numPositions * numWords] = numRuns;
+      numPositions = numRuns;
+
+      modeIndices.push_back(ModeIndex({
+          makeIndexArray(posType, pos, numThreads),
+          makeIndexArray(UInt64, bits, numThreads)}));
+    } else if (modeType.getName() == Singleton.getName()) {
+      Datatype crdType = format.getCoordinateTypeIdx(i);
+      checkCoordinateType(crdType, dimensions[i], i);
+
+      // Store the coordinate of every parent position, which must be the
+      // same for all components at that position
+      vector<int> crd(numPositions);
+      vector<uint8_t> isAmbiguous(numThreads, 0);
+      util::parallelBlocks(n, numThreads, [&](size_t t, size_t begin, size_t end) {
+        for (size_t k = begin; k < end; k++) {
+          crd[positions[k]] = levelCoords[k];
+          if (k > 0 && levelCoords[k] != levelCoords[k-1]) {
+            isAmbiguous[t] |= (positions[k] == positions[k-1]);
+            runStart[k] = 1;
+          }
+        }
+      });
+      taco_uassert(find(isAmbiguous.begin(), isAmbiguous.end(), 1) ==
+                   isAmbiguous.end()) <<
+          "Level " << i+1 << " is a singleton level, but components share " <<
+          "a position in its parent level; the parent level must store " <<
+          "duplicate coordinates";
+
+      modeIndices.push_back(ModeIndex({
+          makeIndexArray(crdType, crd, numThreads)}));
     } else {
       taco_not_supported_yet;
     }
   }
   storage.setIndex(Index(format, modeIndices));
-  Array array = makeArray(componentType,
-                          actual_size/componentType.getNumBytes());
-  memcpy(array.getData(), vals, actual_size);
+
+  // Pattern formats store no values
+  if (format.isPattern()) {
+    storage.setValues(makeArray(componentType, 0));
+    return storage;
+  }
+
+  // Scatter the values to the positions of the last level
+  const size_t valueSize = componentType.getNumBytes();
+  Array array = makeArray(componentType, numPositions);
+  char* vals = (char*)array.getData();
+  if (n < numPositions) {
+    memset(vals, 0, numPositions * valueSize);
+  }
+  util::parallelBlocks(n, numThreads, [&](size_t, size_t begin, size_t end) {
+    for (size_t k = begin; k < end; k++) {
+      memcpy(&vals[positions[k] * valueSize], &values[k * valueSize],
+             valueSize);
+    }
+  });
+  if (format.isSplitComplex()) {
+    splitComplexValues(array, numThreads);
+  }
   storage.setValues(array);
-  free(vals);
   return storage;
 }
 
+/// Pack components into a blocked format by tiling their coordinates into
+/// block coordinates and coordinates within blocks, and packing them into the
+/// format of the tensor of blocks, whose dense inner levels zero the missing
+/// components of every block.
+static TensorStorage packBlocks(Datatype componentType,
+                                const vector<int>& dimensions,
+                                const Format& format,
+                                const vector<ComponentBatch>& batches,
+                                DuplicatePolicy duplicates) {
+  const size_t order = dimensions.size();
+  const vector<int>& blockSizes = format.getBlockSizes();
+  for (size_t i = 0; i < order; i++) {
+    taco_uassert(dimensions[i] % blockSizes[i] == 0) <<
+        "Mode " << i << " has dimension " << dimensions[i] << ", which is " <<
+        "not a multiple of its block size " << blockSizes[i];
+  }
+
+  const size_t valueSize = componentType.getNumBytes();
+  const size_t componentSize = order * sizeof(int) + valueSize;
+  vector<vector<vector<int>>> blockCoordinates(batches.size());
+  vector<vector<char>> blockValues(batches.size());
+  vector<ComponentBatch> blockBatches(batches.size());
+  for (size_t b = 0; b < batches.size(); b++) {
+    const ComponentBatch& batch = batches[b];
+    const size_t numThreads = getNumThreads(batch.size);
+    vector<vector<int>>& coordinates = blockCoordinates[b];
+    coordinates.resize(2 * order, vector<int>(batch.size));
+    if (batch.components != nullptr) {
+      blockValues[b].resize(batch.size * valueSize);
+    }
+    util::parallelBlocks(batch.size, numThreads,
+                   [&](size_t, size_t begin, size_t end) {
+      for (size_t k = begin; k < end; k++) {
+        const int* coord = (batch.components != nullptr)
+            ? (const int*)&batch.components[k * componentSize] : nullptr;
+        for (size_t i = 0; i < order; i++) {
+          int c = (coord != nullptr) ? coord[i] : batch.coordinates[i][k];
+          coordinates[i][k] = c / blockSizes[i];
+          coordinates[order + i][k] = c % blockSizes[i];
+        }
+        if (coord != nullptr) {
+          memcpy(&blockValues[b][k * valueSize], &coord[order], valueSize);
+        }
+      }
+    });
+
+    ComponentBatch& blockBatch = blockBatches[b];
+    for (auto& modeCoordinates : coordinates) {
+      blockBatch.coordinates.push_back(modeCoordinates.data());
+    }
+    blockBatch.values = (batch.components != nullptr) ? blockValues[b].data()
+                                                      : batch.values;
+    blockBatch.size = batch.size;
+  }
+
+  TensorStorage blockStorage = pack(componentType,
+      getBlockTensorDimensions(dimensions, format),
+      getBlockTensorFormat(format), blockBatches, duplicates);
+
+  // The blocked format stores the levels over the block coordinates and the
+  // values of the blocks
+  vector<ModeIndex> modeIndices;
+  for (size_t i = 0; i < order; i++) {
+    modeIndices.push_back(blockStorage.getIndex().getModeIndex(i));
+  }
+  TensorStorage storage(componentType, dimensions, format);
+  storage.setIndex(Index(format, modeIndices));
+  storage.setValues(blockStorage.getValues());
+  return storage;
+}
+
+/// Pack components into a sliced ELLPACK format by packing them into CSR,
+/// sorting the rows of every window by their number of components, and
+/// storing every slice of rows column-major in as many slots as its longest
+/// row has components.  Padding slots store column 0 and value 0, so that
+/// kernels need not branch on them.
+static TensorStorage packSliced(Datatype componentType,
+                                const vector<int>& dimensions,
+                                const Format& format,
+                                const vector<ComponentBatch>& batches,
+                                DuplicatePolicy duplicates) {
+  TensorStorage csr = pack(componentType, dimensions,
+                           Format({Dense, Compressed}), batches, duplicates);
+  const Array& csrPos = csr.getIndex().getModeIndex(1).getIndexArray(0);
+  const Array& csrCrd = csr.getIndex().getModeIndex(1).getIndexArray(1);
+  taco_iassert(csrPos.getType() == Int32 && csrCrd.getType() == Int32);
+  const int* rowPos = (const int*)csrPos.getData();
+  const int* colIdx = (const int*)csrCrd.getData();
+  const char* csrVals = (const char*)csr.getValues().getData();
+
+  const vector<int> sliceDimensions = getSliceTensorDimensions(dimensions,
+                                                               format);
+  const size_t numRows = dimensions[0];
+  const size_t numSlices = sliceDimensions[0];
+  const size_t sliceHeight = sliceDimensions[2];
+  const size_t sortWindow = format.getSortWindow();
+  const size_t valueSize = componentType.getNumBytes();
+
+  // Sort the rows of every window by decreasing length, keeping rows of equal
+  // length in order, and mark the rows past the last row as padding
+  vector<int> lengths(numSlices * sliceHeight, 0);
+  vector<int> perm(numSlices * sliceHeight, -1);
+  for (size_t i = 0; i < numRows; i++) {
+    perm[i] = (int)i;
+  }
+  for (size_t begin = 0; begin < numRows; begin += sortWindow) {
+    auto end = perm.begin() + min(begin + sortWindow, numRows);
+    stable_sort(perm.begin() + begin, end, [&](int a, int b) {
+      return rowPos[a + 1] - rowPos[a] > rowPos[b + 1] - rowPos[b];
+    });
+  }
+  for (size_t r = 0; r < numRows; r++) {
+    lengths[r] = rowPos[perm[r] + 1] - rowPos[perm[r]];
+  }
+
+  // Every slice stores as many slots as its longest row has components
+  vector<size_t> slotPos(numSlices + 1, 0);
+  for (size_t c = 0; c < numSlices; c++) {
+    int width = 0;
+    for (size_t r = 0; r < sliceHeight; r++) {
+      width = max(width, lengths[c * sliceHeight + r]);
+    }
+    slotPos[c + 1] = slotPos[c] + width;
+  }
+  const size_t numSlots = slotPos[numSlices] * sliceHeight;
+  taco_uassert(fitsIndexType(Int32, numSlots)) <<
+      "The matrix has " << numSlots << " padded components, which overflow " <<
+      "the Int32 positions of sliced ELLPACK formats";
+
+  vector<int> crd(numSlots, 0);
+  Array values = makeArray(componentType, numSlots);
+  memset(values.getData(), 0, numSlots * valueSize);
+  char* vals = (char*)values.getData();
+  util::parallelBlocks(numSlices, getNumThreads(numSlots),
+                 [&](size_t, size_t begin, size_t end) {
+    for (size_t c = begin; c < end; c++) {
+      for (size_t r = 0; r < sliceHeight; r++) {
+        const int row = perm[c * sliceHeight + r];
+        if (row < 0) {
+          continue;
+        }
+        for (int s = 0; s < lengths[c * sliceHeight + r]; s++) {
+          const size_t p = (slotPos[c] + s) * sliceHeight + r;
+          const size_t k = rowPos[row] + s;
+          crd[p] = colIdx[k];
+          memcpy(&vals[p * valueSize], &csrVals[k * valueSize], valueSize);
+        }
+      }
+    }
+  });
+
+  // The rows within slices store the slice height, the rows they hold, and
+  // their lengths
+  const size_t numThreads = getNumThreads(numSlots);
+  vector<ModeIndex> modeIndices = {
+    ModeIndex({makeIndexArray(Int32, vector<size_t>({numSlices}), 1)}),
+    ModeIndex({makeIndexArray(Int32, slotPos, numThreads)}),
+    ModeIndex({makeIndexArray(Int32, vector<size_t>({sliceHeight}), 1),
+               makeIndexArray(Int32, perm, numThreads),
+               makeIndexArray(Int32, lengths, numThreads)}),
+    ModeIndex({makeIndexArray(Int32, crd, numThreads)})
+  };
+  TensorStorage storage(componentType, dimensions, format);
+  storage.setIndex(Index(getSliceTensorFormat(format), modeIndices));
+  storage.setValues(values);
+  return storage;
+}
+
+/// Pack components into a diagonal format by packing them into CSR, finding
+/// the diagonals that have components, and storing the rows of every such
+/// diagonal in a dense array whose rows outside the matrix and missing
+/// components are zero.
+static TensorStorage packDiagonal(Datatype componentType,
+                                  const vector<int>& dimensions,
+                                  const Format& format,
+                                  const vector<ComponentBatch>& batches,
+                                  DuplicatePolicy duplicates) {
+  TensorStorage csr = pack(componentType, dimensions,
+                           Format({Dense, Compressed}), batches, duplicates);
+  const Array& csrPos = csr.getIndex().getModeIndex(1).getIndexArray(0);
+  const Array& csrCrd = csr.getIndex().getModeIndex(1).getIndexArray(1);
+  taco_iassert(csrPos.getType() == Int32 && csrCrd.getType() == Int32);
+  const int* rowPos = (const int*)csrPos.getData();
+  const int* colIdx = (const int*)csrCrd.getData();
+  const char* csrVals = (const char*)csr.getValues().getData();
+
+  const int numRows = dimensions[0];
+  const int maxDiagonals = getDiagonalTensorDimensions(dimensions, format)[0];
+  const size_t numComponents = rowPos[numRows];
+  const size_t valueSize = componentType.getNumBytes();
+
+  // Diagonals are numbered by their offset plus the number of rows minus one
+  vector<int> diagonals(maxDiagonals, -1);
+  for (int i = 0; i < numRows; i++) {
+    for (int k = rowPos[i]; k < rowPos[i + 1]; k++) {
+      diagonals[colIdx[k] - i + numRows - 1] = 0;
+    }
+  }
+  vector<int> offsets;
+  for (int d = 0; d < maxDiagonals; d++) {
+    if (diagonals[d] == 0) {
+      diagonals[d] = (int)offsets.size();
+      offsets.push_back(d - numRows + 1);
+    }
+  }
+  const size_t numDiagonals = offsets.size();
+
+  Array values = makeArray(componentType, numDiagonals * numRows);
+  memset(values.getData(), 0, numDiagonals * numRows * valueSize);
+  char* vals = (char*)values.getData();
+  util::parallelBlocks(numRows, getNumThreads(numComponents),
+                 [&](size_t, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      for (int k = rowPos[i]; k < rowPos[i + 1]; k++) {
+        const size_t d = diagonals[colIdx[k] - (int)i + numRows - 1];
+        memcpy(&vals[(d * numRows + i) * valueSize], &csrVals[k * valueSize],
+               valueSize);
+      }
+    }
+  });
+
+  // The diagonal and offset levels share the offsets of the diagonals
+  Array offsetArray = makeArray(offsets);
+  vector<ModeIndex> modeIndices = {
+    ModeIndex({makeIndexArray(Int32, vector<size_t>({numDiagonals}), 1)}),
+    ModeIndex({makeIndexArray(Int32, vector<size_t>({(size_t)numRows}), 1),
+               offsetArray}),
+    ModeIndex({offsetArray})
+  };
+  TensorStorage storage(componentType, dimensions, format);
+  storage.setIndex(Index(getDiagonalTensorFormat(format), modeIndices));
+  storage.setValues(values);
+  return storage;
+}
+
+TensorStorage pack(Datatype                           componentType,
+                   const std::vector<int>&            dimensions,
+                   const Format&                      format,
+                   const std::vector<ComponentBatch>& batches,
+                   DuplicatePolicy                    duplicates) {
+  taco_iassert(dimensions.size() == (size_t)format.getOrder());
+  taco_iassert(dimensions.size() > 0) << "Scalar packing not supported";
+  taco_iassert(batches.size() <= ((size_t)1 << (64 - BATCH_SHIFT)));
+  checkCoordinates(componentType, dimensions, batches);
+
+  if (format.isBlocked()) {
+    return packBlocks(componentType, dimensions, format, batches, duplicates);
+  }
+  if (format.isSliced()) {
+    return packSliced(componentType, dimensions, format, batches, duplicates);
+  }
+  if (format.isDiagonal()) {
+    return packDiagonal(componentType, dimensions, format, batches,
+                        duplicates);
+  }
+
+  const size_t order = dimensions.size();
+  const size_t componentSize = order * sizeof(int) +
+                               componentType.getNumBytes();
+  size_t numComponents = 0;
+  for (auto& batch : batches) {
+    taco_iassert(batch.size <= BATCH_MASK);
+    taco_iassert(batch.components != nullptr ||
+                 batch.coordinates.size() == order);
+    numComponents += batch.size;
+  }
+  const size_t numThreads = getNumThreads(numComponents);
+
+  // Pack the coordinates in the order of the format's levels
+  const vector<int>& modeOrdering = format.getModeOrdering();
+  vector<int> levelDimensions(order);
+  for (size_t i = 0; i < order; i++) {
+    levelDimensions[i] = dimensions[modeOrdering[i]];
+  }
+
+  // Concatenate the coordinates of a component into fixed-width keys, the
+  // first key holding the coordinates of the outermost levels.  No level is
+  // split between two keys.
+  vector<int> levelBits(order);
+  for (size_t i = 0; i < order; i++) {
+    levelBits[i] = getNumBits(levelDimensions[i]);
+  }
+  vector<vector<size_t>> keyLevels(1);
+  vector<int> keyBits(1, 0);
+  for (size_t i = order; i-- > 0;) {
+    int bits = levelBits[i];
+    if (keyBits.front() + bits > 64) {
+      keyLevels.insert(keyLevels.begin(), vector<size_t>());
+      keyBits.insert(keyBits.begin(), 0);
+    }
+    keyLevels.front().insert(keyLevels.front().begin(), i);
+    keyBits.front() += bits;
+  }
+
+  // Components are identified by their batch and their index in the batch
+  auto getCoord = [&](size_t component, size_t level) {
+    const ComponentBatch& batch = batches[component >> BATCH_SHIFT];
+    size_t i = component & BATCH_MASK;
+    int mode = modeOrdering[level];
+    return (batch.components != nullptr)
+           ? ((const int*)&batch.components[i * componentSize])[mode]
+           : batch.coordinates[mode][i];
+  };
+  auto getValue = [&](size_t component) {
+    const ComponentBatch& batch = batches[component >> BATCH_SHIFT];
+    size_t i = component & BATCH_MASK;
+    return (batch.components != nullptr)
+           ? &batch.components[i * componentSize + order * sizeof(int)]
+           : &batch.values[i * componentType.getNumBytes()];
+  };
+  auto getKey = [&](size_t component, size_t w) {
+    uint64_t key = 0;
+    for (size_t level : keyLevels[w]) {
+      key = (key << levelBits[level]) |
+            (uint64_t)getCoord(component, level);
+    }
+    return key;
+  };
+
+  // Sort the components with a radix sort of their keys, starting with the
+  // least significant key
+  vector<size_t> sorted;
+  for (size_t w = keyLevels.size(); w-- > 0;) {
+    vector<KeyIndex> keys(numComponents);
+    if (sorted.empty()) {
+      size_t batchBegin = 0;
+      for (size_t b = 0; b < batches.size(); b++) {
+        util::parallelBlocks(batches[b].size, numThreads,
+                       [&](size_t, size_t begin, size_t end) {
+          for (size_t i = begin; i < end; i++) {
+            size_t component = (b << BATCH_SHIFT) | i;
+            keys[batchBegin + i] = {getKey(component, w), component};
+          }
+        });
+        batchBegin += batches[b].size;
+      }
+    }
+    else {
+      util::parallelBlocks(numComponents, numThreads,
+                     [&](size_t, size_t begin, size_t end) {
+        for (size_t k = begin; k < end; k++) {
+          keys[k] = {getKey(sorted[k], w), sorted[k]};
+        }
+      });
+    }
+    radixSort(keys, keyBits[w], numThreads);
+
+    sorted.resize(numComponents);
+    util::parallelBlocks(numComponents, numThreads,
+                   [&](size_t, size_t begin, size_t end) {
+      for (size_t k = begin; k < end; k++) {
+        sorted[k] = keys[k].index;
+      }
+    });
+  }
+
+  vector<vector<int>> coords;
+  vector<char> values;
+  bool unique = mergeDuplicates(numComponents, order,
+      [&](size_t k, size_t level) { return getCoord(sorted[k], level); },
+      [&](size_t k) { return getValue(sorted[k]); },
+      componentType, duplicates, numThreads, &coords, &values);
+  if (!unique) {
+    taco_uassert(duplicates != DuplicatePolicy::Error) <<
+        "Components were inserted more than once at the same coordinate";
+    if (duplicates == DuplicatePolicy::First) {
+      taco_uwarning << "Duplicate coordinate ignored when inserting into tensor";
+    }
+  }
+
+  return packLevels(componentType, levelDimensions, format, coords, values,
+                    numThreads);
+}
+
+/// Pack tensor coordinates into a format. The coordinates must be stored as a
+/// structure of arrays, that is one vector per axis coordinate and one vector
+/// for the values. The coordinates must be sorted lexicographically.
+TensorStorage pack(Datatype                             componentType,
+                   const std::vector<int>&              dimensions,
+                   const Format&                        format,
+                   const std::vector<TypedIndexVector>& coordinates,
+                   const void *                         values) {
+  taco_iassert(dimensions.size() == (size_t)format.getOrder());
+  taco_iassert(coordinates.size() == (size_t)format.getOrder());
+  taco_iassert(dimensions.size() > 0) << "Scalar packing not supported";
+  taco_iassert(std::all_of(coordinates.begin(), coordinates.end(),
+                           [&](const TypedIndexVector& levelCoordinates) {
+    return levelCoordinates.size() == coordinates[0].size();
+  }));
+
+  if (format.isBlocked() || format.isSliced() || format.isDiagonal()) {
+    vector<vector<int>> modeCoordinates(coordinates.size());
+    ComponentBatch batch;
+    for (size_t i = 0; i < coordinates.size(); i++) {
+      for (size_t k = 0; k < coordinates[i].size(); k++) {
+        modeCoordinates[i].push_back((int)coordinates[i][k].getAsIndex());
+      }
+      batch.coordinates.push_back(modeCoordinates[i].data());
+    }
+    batch.values = (const char*)values;
+    batch.size = coordinates[0].size();
+    if (format.isBlocked()) {
+      return packBlocks(componentType, dimensions, format, {batch},
+                        DuplicatePolicy::First);
+    }
+    return format.isSliced()
+           ? packSliced(componentType, dimensions, format, {batch},
+                        DuplicatePolicy::First)
+           : packDiagonal(componentType, dimensions, format, {batch},
+                          DuplicatePolicy::First);
+  }
+
+  size_t order = dimensions.size();
+  size_t numCoordinates = coordinates[0].size();
+  size_t numThreads = getNumThreads(numCoordinates);
+  const size_t valueSize = componentType.getNumBytes();
+
+  vector<vector<int>> coords;
+  vector<char> vals;
+  mergeDuplicates(numCoordinates, order,
+      [&](size_t k, size_t level) {
+        return (int)coordinates[level][k].getAsIndex();
+      },
+      [&](size_t k) { return &((const char*)values)[k * valueSize]; },
+      componentType, DuplicatePolicy::First, numThreads, &coords, &vals);
+  return packLevels(componentType, dimensions, format, coords, vals,
+                    numThreads);
+}
+
 }
@@ -11,7 +11,9 @@
 #include "taco/storage/file_io_tns.h"
 #include "taco/storage/file_io_mtx.h"
 #include "taco/storage/file_io_rb.h"
+#include "taco/storage/file_io_bin.h"
 #include "taco/storage/index.h"
+#include "taco/util/files.h"
 #include "taco/util/strings.h"
 
 using namespace std;
@@ -29,30 +31,68 @@ struct TensorStorage::Content {
   Index         index;
   Array         values;
 
+  // The sizes of the dense levels within the blocks of a blocked format
+  vector<Array> blockSizes;
+
   Content(Datatype componentType, vector<int> dimensions, Format format)
       : componentType(componentType), dimensions(dimensions), format(format),
         index(format) {
+    // Kernels see blocked tensors as their tensors of blocks
+    if (format.isBlocked()) {
+      for (int i = 0; i < format.getOrder(); i++) {
+        const int mode = format.getModeOrdering()[i];
+        Array blockSize = makeArray(Int32, 1);
+        blockSize.get(0) = format.getBlockSizes()[mode];
+        blockSizes.push_back(blockSize);
+      }
+      dimensions = getBlockTensorDimensions(dimensions, format);
+      format = getBlockTensorFormat(format);
+    }
+    // Kernels see sliced ELLPACK matrices as their tensors of slots
+    else if (format.isSliced()) {
+      dimensions = getSliceTensorDimensions(dimensions, format);
+      format = getSliceTensorFormat(format);
+    }
+    // Kernels see diagonal matrices as their tensors of diagonals
+    else if (format.isDiagonal()) {
+      dimensions = getDiagonalTensorDimensions(dimensions, format);
+      format = getDiagonalTensorFormat(format);
+    }
     int order = (int)dimensions.size();
 
     taco_iassert(order <= INT_MAX && componentType.getNumBits() <= INT_MAX);
-    vector<int32_t> dimensionsInt32(order);
+    vector<int64_t> dimensionsInt64(order);
     vector<int32_t> modeOrdering(order);
     vector<taco_mode_t> modeTypes(order);
     for (int i=0; i < order; ++i) {
-      dimensionsInt32[i] = dimensions[i];
+      dimensionsInt64[i] = dimensions[i];
       modeOrdering[i] = format.getModeOrdering()[i];
       auto modeType  = format.getModeFormats()[i];
       if (modeType == Dense) {
         modeTypes[i] = taco_mode_dense;
-      } else if (modeType == Sparse) {
+      } else if (modeType.getName() == Compressed.getName()) {
         modeTypes[i] = taco_mode_sparse;
+      } else if (modeType.getName() == Singleton.getName()) {
+        modeTypes[i] = taco_mode_singleton;
+      } else if (modeType.getName() == Hashed.getName()) {
+        modeTypes[i] = taco_mode_hashed;
+      } else if (modeType.getName() == Sliced.getName()) {
+        modeTypes[i] = taco_mode_sliced;
+      } else if (modeType.getName() == Diagonal.getName()) {
+        modeTypes[i] = taco_mode_diagonal;
+      } else if (modeType.getName() == Offset.getName()) {
+        modeTypes[i] = taco_mode_offset;
+      } else if (modeType.getName() == Bitmap.getName()) {
+        modeTypes[i] = taco_mode_bitmap;
+      } else if (modeType.getName() == Permuted.getName()) {
+        modeTypes[i] = taco_mode_permuted;
       } else {
         taco_not_supported_yet;
       }
     }
 
     tensorData = init_taco_tensor_t(order, componentType.getNumBits(),
-                       dimensionsInt32.data(), modeOrdering.data(),
+                       dimensionsInt64.data(), modeOrdering.data(),
                        modeTypes.data());
   }
 
@@ -123,16 +163,19 @@ TensorStorage::operator struct taco_tensor_t*() const {
   taco_tensor_t* tensorData = content->tensorData;
 
   taco_iassert(getComponentType().getNumBits() <= INT_MAX);
+  // Called before every kernel invocation, so avoid copying the format and
+  // index and branch on the mode types already recorded in tensorData.  The
+  // levels of the index are the levels of the tensor the kernels see, except
+  // for the dense levels within the blocks of blocked formats.
   int order = getOrder();
-  Format format = getFormat();
-  Index index = getIndex();
+  const Index& index = getIndex();
 
-  for (int i = 0; i < order; i++) {
-    auto modeType  = format.getModeFormats()[i];
-    auto modeIndex = index.getModeIndex(i);
+  for (int i = 0; i < index.getFormat().getOrder(); i++) {
+    taco_mode_t modeType = tensorData->mode_types[i];
+    const ModeIndex& modeIndex = index.getModeIndex(i);
 
     // Dense modes don't have indices (they iterate over mode sizes)
-    if (modeType == Dense) {
+    if (modeType == taco_mode_dense) {
       // TODO Uncomment assertion and remove code in this conditional
       // taco_iassert(modeIndex.numIndexArrays() == 0)
       //     << modeIndex.numIndexArrays();
@@ -140,7 +183,7 @@ TensorStorage::operator struct taco_tensor_t*() const {
       tensorData->indices[i][0] = (uint8_t*)size.getData();
     }
     // Sparse levels have two indices (pos and idx)
-    else if (modeType == Sparse) {
+    else if (modeType == taco_mode_sparse) {
       // TODO Uncomment assert and remove conditional
       // taco_iassert(modeIndex.numIndexArrays() == 2)
       //     << modeIndex.numIndexArrays();
@@ -151,12 +194,73 @@ TensorStorage::operator struct taco_tensor_t*() const {
         tensorData->indices[i][1] = (uint8_t*)idx.getData();
       }
     }
+    // Singleton levels have one index (idx)
+    else if (modeType == taco_mode_singleton) {
+      if (modeIndex.numIndexArrays() > 0) {
+        const Array& idx = modeIndex.getIndexArray(0);
+        tensorData->indices[i][0] = (uint8_t*)idx.getData();
+      }
+    }
+    // Hashed levels have two indices (size and idx), and results only have
+    // their size until they are assembled
+    else if (modeType == taco_mode_hashed) {
+      if (modeIndex.numIndexArrays() > 0) {
+        const Array& size = modeIndex.getIndexArray(0);
+        tensorData->indices[i][0] = (uint8_t*)size.getData();
+      }
+      if (modeIndex.numIndexArrays() > 1) {
+        const Array& idx = modeIndex.getIndexArray(1);
+        tensorData->indices[i][1] = (uint8_t*)idx.getData();
+      }
+    }
+    // Sliced levels have one index (pos)
+    else if (modeType == taco_mode_sliced) {
+      const Array& pos = modeIndex.getIndexArray(0);
+      tensorData->indices[i][0] = (uint8_t*)pos.getData();
+    }
+    // Diagonal levels have two indices (size and offset), and offset levels
+    // have one (offset)
+    else if (modeType == taco_mode_diagonal) {
+      const Array& size = modeIndex.getIndexArray(0);
+      const Array& offset = modeIndex.getIndexArray(1);
+      tensorData->indices[i][0] = (uint8_t*)size.getData();
+      tensorData->indices[i][1] = (uint8_t*)offset.getData();
+    }
+    else if (modeType == taco_mode_offset) {
+      const Array& offset = modeIndex.getIndexArray(0);
+      tensorData->indices[i][0] = (uint8_t*)offset.getData();
+    }
+    // Bitmap levels have two indices (pos and bits)
+    else if (modeType == taco_mode_bitmap) {
+      const Array& pos = modeIndex.getIndexArray(0);
+      const Array& bits = modeIndex.getIndexArray(1);
+      tensorData->indices[i][0] = (uint8_t*)pos.getData();
+      tensorData->indices[i][1] = (uint8_t*)bits.getData();
+    }
+    // Permuted levels have two indices (size and rows)
+    else if (modeType == taco_mode_permuted) {
+      const Array& size = modeIndex.getIndexArray(0);
+      const Array& rows = modeIndex.getIndexArray(1);
+      tensorData->indices[i][0] = (uint8_t*)size.getData();
+      tensorData->indices[i][1] = (uint8_t*)rows.getData();
+    }
     else {
       taco_not_supported_yet;
     }
   }
+  for (size_t i = 0; i < content->blockSizes.size(); i++) {
+    tensorData->indices[order + i][0] =
+        (uint8_t*)content->blockSizes[i].getData();
+  }
+
+  // The number of diagonals of a diagonal format is known once it is packed
+  if (getFormat().isDiagonal()) {
+    tensorData->dimensions[0] =
+        index.getModeIndex(0).getIndexArray(0).get(0).getAsIndex();
+  }
 
   tensorData->vals  = (uint8_t*)getValues().getData();
+  tensorData->vals_size = getValues().getSize();
 
   return content->tensorData;
 }
@@ -199,24 +303,47 @@ TensorStorage dispatchRead(T& file, FileType filetype, U format) {
     case FileType::rb:
       return readToStorageRB(file, format);
       break;
+    case FileType::tbin:
+      return readToStorageBinary(file, format);
+      break;
   }
+  taco_ierror << "Unknown file type";
+  return TensorStorage(Datatype::Undefined, std::vector<int>(), Format());
+}
+
+/// Read a file, decompressing it on a separate thread while it is parsed if it
+/// is compressed with gzip.
+template <typename U>
+TensorStorage dispatchReadFile(std::string filename, FileType filetype,
+                               U format) {
+  if (util::isGzipPath(filename)) {
+    util::GzipInputStream stream(filename);
+    return dispatchRead(stream, filetype, format);
+  }
+  return dispatchRead(filename, filetype, format);
 }
 
 template <typename U>
 TensorStorage dispatchRead(std::string filename, U format) {
-  string extension = getExtension(filename);
+  // The file type of compressed files is given by the extension before .gz
+  string extension = util::isGzipPath(filename)
+      ? getExtension(filename.substr(0, filename.find_last_of(".")))
+      : getExtension(filename);
 
   if (extension == "ttx") {
-    return dispatchRead(filename, FileType::ttx, format);
+    return dispatchReadFile(filename, FileType::ttx, format);
   }
   else if (extension == "tns") {
-    return dispatchRead(filename, FileType::tns, format);
+    return dispatchReadFile(filename, FileType::tns, format);
   }
   else if (extension == "mtx") {
-    return dispatchRead(filename, FileType::mtx, format);
+    return dispatchReadFile(filename, FileType::mtx, format);
   }
   else if (extension == "rb") {
-    return dispatchRead(filename, FileType::rb, format);
+    return dispatchReadFile(filename, FileType::rb, format);
+  }
+  else if (extension == "tbin") {
+    return dispatchReadFile(filename, FileType::tbin, format);
   }
   else {
     taco_uerror << "File extension not recognized: " << filename << std::endl;
@@ -233,11 +360,11 @@ TensorStorage readToStorage(std::string filename, Format format) {
 }
 
 TensorStorage readToStorage(string filename, FileType filetype, ModeFormat modetype) {
-  return dispatchRead(filename, filetype, modetype);
+  return dispatchReadFile(filename, filetype, modetype);
 }
 
 TensorStorage readToStorage(string filename, FileType filetype, Format format) {
-  return dispatchRead(filename, filetype, format);
+  return dispatchReadFile(filename, filetype, format);
 }
 
 TensorStorage readToStorage(istream& stream, FileType filetype, ModeFormat modetype) {
@@ -260,6 +387,9 @@ void dispatchWrite(string file, const TensorStorage& storage, FileType filetype)
     case FileType::rb:
       writeFromStorageRB(file, storage);
       break;
+    case FileType::tbin:
+      writeFromStorageBinary(file, storage);
+      break;
   }
 }
 
@@ -275,6 +405,9 @@ void dispatchWrite(ostream& file, const TensorStorage& storage, FileType filetyp
     case FileType::rb:
       writeFromStorageRB(file, storage);
       break;
+    case FileType::tbin:
+      writeFromStorageBinary(file, storage);
+      break;
   }
 }
 
@@ -295,6 +428,9 @@ void writeFromStorage(string filename, const TensorStorage& storage) {
   else if (extension == "rb") {
     dispatchWrite(filename, storage, FileType::rb);
   }
+  else if (extension == "tbin") {
+    dispatchWrite(filename, storage, FileType::tbin);
+  }
   else {
     taco_uerror << "File extension not recognized: " << filename << std::endl;
   }
@@ -0,0 +1,418 @@
+#include "text_parser.h"
+
+#include <cstdlib>
+#include <cstdint>
+#include <climits>
+#include <cstring>
+#include <string>
+#include <algorithm>
+
+#include "taco/tensor.h"
+#include "taco/storage/pack.h"
+#include "taco/util/parallel.h"
+
+using namespace std;
+
+namespace taco {
+
+/// Buffers with fewer bytes than this per thread are parsed by fewer threads
+static const size_t PARSE_GRAIN = 1 << 20;
+
+/// The powers of ten that are exactly representable as doubles
+static const double POWERS_OF_TEN[] = {
+  1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+static const int MAX_EXACT_POWER = 22;
+
+/// Doubles represent every integer up to 2^53 exactly
+static const uint64_t MAX_EXACT_MANTISSA = (uint64_t)1 << 53;
+
+/// Mantissas with more digits than this may overflow 64 bits
+static const int MAX_MANTISSA_DIGITS = 19;
+
+static bool isDigit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+static bool isSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+size_t getNumParseThreads(size_t numBytes) {
+  return util::getNumThreads(numBytes, PARSE_GRAIN);
+}
+
+vector<const char*> splitLines(const char* begin, const char* end,
+                               size_t numChunks) {
+  const size_t size = end - begin;
+  vector<const char*> boundaries(numChunks + 1, end);
+  boundaries[0] = begin;
+  for (size_t i = 1; i < numChunks; i++) {
+    const char* boundary = begin + size * i / numChunks;
+    if (boundary <= boundaries[i-1]) {
+      boundary = boundaries[i-1];
+    }
+    else if (boundary[-1] != '\n') {
+      boundary = findNextLine(boundary, end);
+    }
+    boundaries[i] = boundary;
+  }
+  return boundaries;
+}
+
+vector<size_t> countEntries(const vector<const char*>& chunks, char comment) {
+  const size_t numChunks = chunks.size() - 1;
+  vector<size_t> offsets(numChunks + 1, 0);
+  util::parallelBlocks(numChunks, numChunks, [&](size_t t, size_t, size_t) {
+    for (const char* line = chunks[t]; line < chunks[t+1];
+         line = findNextLine(line, chunks[t+1])) {
+      if (!isBlankOrComment(line, findLineEnd(line, chunks[t+1]), comment)) {
+        offsets[t+1]++;
+      }
+    }
+  });
+  for (size_t t = 0; t < numChunks; t++) {
+    offsets[t+1] += offsets[t];
+  }
+  return offsets;
+}
+
+bool parseInteger(const char*& p, const char* end, long long* value) {
+  const char* q = skipBlanks(p, end);
+  bool negative = false;
+  if (q < end && (*q == '-' || *q == '+')) {
+    negative = (*q == '-');
+    q++;
+  }
+  if (q == end || !isDigit(*q)) {
+    return false;
+  }
+  // Clamp values that do not fit, so that callers reject them as out of range
+  unsigned long long magnitude = 0;
+  for (; q < end && isDigit(*q); q++) {
+    magnitude = (magnitude <= (unsigned long long)LLONG_MAX / 10)
+                ? magnitude * 10 + (*q - '0') : (unsigned long long)LLONG_MAX;
+  }
+  magnitude = min(magnitude, (unsigned long long)LLONG_MAX);
+  *value = negative ? -(long long)magnitude : (long long)magnitude;
+  p = q;
+  return true;
+}
+
+/// Parse the number that starts at `p` with `strtod`, which needs a
+/// null-terminated copy of it.
+static bool parseDoubleWithStrtod(const char*& p, const char* end,
+                                  double* value) {
+  const char* tokenEnd = p;
+  while (tokenEnd < end && !isSpace(*tokenEnd)) {
+    tokenEnd++;
+  }
+  string token(p, tokenEnd);
+  char* parsedEnd;
+  *value = strtod(token.c_str(), &parsedEnd);
+  if (parsedEnd == token.c_str()) {
+    return false;
+  }
+  p += parsedEnd - token.c_str();
+  return true;
+}
+
+bool parseDouble(const char*& p, const char* end, double* value) {
+  p = skipBlanks(p, end);
+  const char* q = p;
+  bool negative = false;
+  if (q < end && (*q == '-' || *q == '+')) {
+    negative = (*q == '-');
+    q++;
+  }
+
+  // Read the significant digits into an integer mantissa and a decimal
+  // exponent, and fall back to strtod for numbers that cannot be converted
+  // exactly from them
+  uint64_t mantissa = 0;
+  int numDigits = 0;
+  int exponent = 0;
+  bool hasDigits = false;
+  bool isExact = true;
+  auto readDigit = [&](char digit) {
+    hasDigits = true;
+    if (mantissa == 0 && digit == '0') {
+      return;
+    }
+    if (numDigits == MAX_MANTISSA_DIGITS) {
+      isExact = false;
+      return;
+    }
+    mantissa = mantissa * 10 + (digit - '0');
+    numDigits++;
+  };
+  for (; q < end && isDigit(*q); q++) {
+    readDigit(*q);
+  }
+  if (q < end && *q == '.') {
+    for (q++; q < end && isDigit(*q); q++) {
+      readDigit(*q);
+      exponent--;
+    }
+  }
+  if (!hasDigits) {
+    return parseDoubleWithStrtod(p, end, value);
+  }
+  if (q < end && (*q == 'e' || *q == 'E')) {
+    long long exponentValue;
+    const char* exponentEnd = q + 1;
+    if (exponentEnd < end && isSpace(*exponentEnd)) {
+      isExact = false;
+    }
+    else if (parseInteger(exponentEnd, end, &exponentValue) &&
+             exponentValue >= -MAX_EXACT_POWER - MAX_MANTISSA_DIGITS &&
+             exponentValue <= MAX_EXACT_POWER) {
+      exponent += (int)exponentValue;
+      q = exponentEnd;
+    }
+    else {
+      isExact = false;
+    }
+  }
+  if (q < end && !isSpace(*q)) {
+    isExact = false;
+  }
+
+  if (!isExact || mantissa > MAX_EXACT_MANTISSA ||
+      (mantissa != 0 && (exponent < -MAX_EXACT_POWER ||
+                         exponent > MAX_EXACT_POWER))) {
+    return parseDoubleWithStrtod(p, end, value);
+  }
+
+  // Both the mantissa and the power of ten are exact, so one correctly
+  // rounded operation gives the correctly rounded result
+  double result = (double)mantissa;
+  if (mantissa != 0) {
+    result = (exponent < 0) ? result / POWERS_OF_TEN[-exponent]
+                            : result * POWERS_OF_TEN[exponent];
+  }
+  *value = negative ? -result : result;
+  p = q;
+  return true;
+}
+
+void parseLineBlocks(istream& stream,
+                     const function<void(const char*, const char*)>& parseLines,
+                     size_t blockSize) {
+  vector<char> buffer;
+  size_t carried = 0;
+  while (true) {
+    buffer.resize(carried + blockSize);
+    stream.read(buffer.data() + carried, blockSize);
+    if (stream.gcount() == 0) {
+      break;
+    }
+    const char* begin = buffer.data();
+    const char* end = begin + carried + stream.gcount();
+    const char* linesEnd = end;
+    while (linesEnd > begin && linesEnd[-1] != '\n') {
+      linesEnd--;
+    }
+    if (linesEnd > begin) {
+      parseLines(begin, linesEnd);
+    }
+    carried = end - linesEnd;
+    memmove(buffer.data(), linesEnd, carried);
+  }
+  // The last line need not end with a newline
+  if (carried > 0) {
+    parseLines(buffer.data(), buffer.data() + carried);
+  }
+}
+
+string readRemaining(istream& stream) {
+  string buffer;
+  char block[1 << 16];
+  while (stream.read(block, sizeof(block)) || stream.gcount() > 0) {
+    buffer.append(block, stream.gcount());
+  }
+  return buffer;
+}
+
+EntryParser::EntryParser(char comment, string fileType)
+    : comment(comment), fileType(fileType), values(nullptr), size(0),
+      capacity(0) {
+}
+
+EntryParser::~EntryParser() {
+  for (int* modeCoordinates : coordinates) {
+    free(modeCoordinates);
+  }
+  free(values);
+}
+
+void EntryParser::setDimensions(const vector<int>& dimensions) {
+  taco_iassert(size == 0 && capacity == 0);
+  bounds.assign(dimensions.begin(), dimensions.end());
+  maxCoordinates.assign(dimensions.size(), 0);
+  coordinates.assign(dimensions.size(), nullptr);
+}
+
+void EntryParser::parse(const char* begin, const char* end) {
+  // Infer the order from the first entry
+  if (coordinates.empty()) {
+    while (begin < end &&
+           isBlankOrComment(begin, findLineEnd(begin, end), comment)) {
+      begin = findNextLine(begin, end);
+    }
+    if (begin == end) {
+      return;
+    }
+    const char* firstLineEnd = findLineEnd(begin, end);
+    size_t order = 0;
+    double token;
+    for (const char* p = begin; parseDouble(p, firstLineEnd, &token);) {
+      order++;
+    }
+    taco_uassert(order >= 2) << "The first entry of the " << fileType
+                             << " file has no coordinates: "
+                             << string(begin, firstLineEnd);
+    setDimensions(vector<int>(order - 1, INT_MAX));
+  }
+  const size_t order = coordinates.size();
+
+  // Count the entries of every chunk, so that each chunk knows where in the
+  // arrays its entries go
+  const size_t numThreads = getNumParseThreads(end - begin);
+  vector<const char*> chunks = splitLines(begin, end, numThreads);
+  vector<size_t> offsets = countEntries(chunks, comment);
+  if (size + offsets[numThreads] > capacity) {
+    reserve(max(size + offsets[numThreads], 2 * capacity));
+  }
+
+  // Parse the chunks, recording the largest coordinates and the first
+  // malformed entry of each
+  vector<vector<long long>> threadMaxCoordinates(numThreads, maxCoordinates);
+  vector<string> errors(numThreads);
+  util::parallelBlocks(numThreads, numThreads,
+                       [&](size_t t, size_t, size_t) {
+    vector<long long>& maxCoordinate = threadMaxCoordinates[t];
+    size_t i = size + offsets[t];
+    for (const char* line = chunks[t]; line < chunks[t+1];
+         line = findNextLine(line, chunks[t+1])) {
+      const char* lineEnd = findLineEnd(line, chunks[t+1]);
+      if (isBlankOrComment(line, lineEnd, comment)) {
+        continue;
+      }
+      const char* p = line;
+      for (size_t mode = 0; mode < order; mode++) {
+        long long index;
+        if (!parseInteger(p, lineEnd, &index) || !isFieldEnd(p, lineEnd) ||
+            index < 1 || index > bounds[mode]) {
+          errors[t] = "Invalid coordinate in " + fileType + " entry: " +
+                      string(line, lineEnd);
+          return;
+        }
+        coordinates[mode][i] = static_cast<int>(index - 1);
+        maxCoordinate[mode] = max(maxCoordinate[mode], index);
+      }
+      if (!parseDouble(p, lineEnd, &values[i]) ||
+          skipBlanks(p, lineEnd) != lineEnd) {
+        errors[t] = "Invalid value in " + fileType + " entry: " +
+                    string(line, lineEnd);
+        return;
+      }
+      i++;
+    }
+  });
+  for (auto& error : errors) {
+    if (!error.empty()) {
+      taco_uerror << error;
+    }
+  }
+  for (auto& maxCoordinate : threadMaxCoordinates) {
+    for (size_t mode = 0; mode < order; mode++) {
+      maxCoordinates[mode] = max(maxCoordinates[mode], maxCoordinate[mode]);
+    }
+  }
+  size += offsets[numThreads];
+}
+
+void EntryParser::reserve(size_t capacity) {
+  if (capacity <= this->capacity) {
+    return;
+  }
+  for (int*& modeCoordinates : coordinates) {
+    modeCoordinates = (int*)realloc(modeCoordinates, capacity * sizeof(int));
+  }
+  values = (double*)realloc(values, capacity * sizeof(double));
+  this->capacity = capacity;
+}
+
+size_t EntryParser::getOrder() const {
+  return coordinates.size();
+}
+
+size_t EntryParser::getSize() const {
+  return size;
+}
+
+void EntryParser::setSize(size_t size) {
+  taco_iassert(size <= capacity);
+  this->size = size;
+}
+
+int* EntryParser::getCoordinates(size_t mode) {
+  return coordinates[mode];
+}
+
+double* EntryParser::getValues() {
+  return values;
+}
+
+const vector<long long>& EntryParser::getMaxCoordinates() const {
+  return maxCoordinates;
+}
+
+ParsedComponents EntryParser::takeComponents(const vector<int>& dimensions) {
+  taco_iassert(dimensions.size() == coordinates.size());
+  ParsedComponents components;
+  components.dimensions = dimensions;
+  for (int* modeCoordinates : coordinates) {
+    components.coordinates.push_back(Array(Int32, modeCoordinates, size,
+                                           Array::Free));
+  }
+  components.values = Array(type<double>(), values, size, Array::Free);
+  coordinates.assign(coordinates.size(), nullptr);
+  values = nullptr;
+  return components;
+}
+
+TensorBase makeTensor(const ParsedComponents& components, const Format& format) {
+  TensorBase tensor(type<double>(), components.dimensions, format);
+  tensor.insert(components.coordinates, components.values);
+  return tensor;
+}
+
+TensorBase makeTensor(const ParsedComponents& components,
+                      const ModeFormat& modetype) {
+  return makeTensor(components,
+                    Format(vector<ModeFormatPack>(
+                        components.dimensions.size(), modetype)));
+}
+
+TensorStorage makeStorage(const ParsedComponents& components,
+                          const Format& format) {
+  ComponentBatch batch;
+  for (auto& modeCoordinates : components.coordinates) {
+    batch.coordinates.push_back((const int*)modeCoordinates.getData());
+  }
+  batch.values = (const char*)components.values.getData();
+  batch.size = components.values.getSize();
+  return pack(type<double>(), components.dimensions, format, {batch});
+}
+
+TensorStorage makeStorage(const ParsedComponents& components,
+                          const ModeFormat& modetype) {
+  return makeStorage(components,
+                     Format(vector<ModeFormatPack>(
+                         components.dimensions.size(), modetype)));
+}
+
+}
@@ -0,0 +1,176 @@
+#ifndef TACO_STORAGE_TEXT_PARSER_H
+#define TACO_STORAGE_TEXT_PARSER_H
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include <istream>
+#include <functional>
+
+#include "taco/format.h"
+#include "taco/storage/array.h"
+#include "taco/storage/storage.h"
+#include "taco/util/uncopyable.h"
+
+/// Helpers for the text file readers, which parse a buffer of lines in
+/// parallel.  The buffers need not be null-terminated: every function stops at
+/// the end of the buffer that it is given.
+
+namespace taco {
+class TensorBase;
+
+/// The components parsed from a text file, as an Int32 array of zero-based
+/// coordinates per mode and a Float64 array of values
+struct ParsedComponents {
+  std::vector<int>   dimensions;
+  std::vector<Array> coordinates;
+  Array              values;
+};
+
+/// Returns the number of threads to parse a buffer of the given size with.
+size_t getNumParseThreads(size_t numBytes);
+
+/// Split the lines of [begin,end) into `numChunks` chunks of whole lines.
+/// Returns the `numChunks + 1` chunk boundaries, where chunk `i` is
+/// [boundaries[i], boundaries[i+1]).
+std::vector<const char*> splitLines(const char* begin, const char* end,
+                                    size_t numChunks);
+
+/// Count the lines of every chunk that are not blank or comments.  Returns
+/// the offsets of the first entry of every chunk, followed by the number of
+/// entries in all chunks.
+std::vector<size_t> countEntries(const std::vector<const char*>& chunks,
+                                 char comment);
+
+/// Returns the end of the line that starts at `p`, excluding the newline.
+inline const char* findLineEnd(const char* p, const char* end) {
+  if (p >= end) {
+    return end;
+  }
+  const char* newline = (const char*)memchr(p, '\n', (size_t)(end - p));
+  return (newline != nullptr) ? newline : end;
+}
+
+/// Returns the start of the line after the line that starts at `p`.
+inline const char* findNextLine(const char* p, const char* end) {
+  const char* lineEnd = findLineEnd(p, end);
+  return (lineEnd == end) ? end : lineEnd + 1;
+}
+
+/// Returns the first character at or after `p` that is not a space, a tab or
+/// a carriage return.
+inline const char* skipBlanks(const char* p, const char* end) {
+  while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+    p++;
+  }
+  return p;
+}
+
+/// Returns true if `p` is at the end `end` of a line or at a blank, that is if
+/// a field that was parsed up to `p` is complete.
+inline bool isFieldEnd(const char* p, const char* end) {
+  return p == end || *p == ' ' || *p == '\t' || *p == '\r';
+}
+
+/// Returns true if the line [p,end) is blank or starts with `comment`.
+inline bool isBlankOrComment(const char* p, const char* end, char comment) {
+  p = skipBlanks(p, end);
+  return p == end || *p == comment;
+}
+
+/// Parse a decimal integer after leading blanks in [p,end) and advance `p`
+/// past it.  Returns false if there is no integer at `p`.
+bool parseInteger(const char*& p, const char* end, long long* value);
+
+/// Parse a floating-point number after leading blanks in [p,end) and advance
+/// `p` past it.  Plain decimal numbers are converted directly, and other
+/// numbers with `strtod`, so the results are the same as with `strtod`.
+/// Returns false if there is no number at `p`.
+bool parseDouble(const char*& p, const char* end, double* value);
+
+/// The number of bytes of a stream that are parsed at a time
+const size_t STREAM_BLOCK_SIZE = 1 << 24;
+
+/// Parse the rest of a stream a block of whole lines at a time, so that only
+/// one block is held in memory at a time.  Every block is passed to
+/// `parseLines` as [begin,end), and a line that is cut by the end of a block is
+/// carried over to the next block.  Lines longer than a block grow it.
+void parseLineBlocks(std::istream& stream,
+                     const std::function<void(const char*, const char*)>&
+                         parseLines,
+                     size_t blockSize=STREAM_BLOCK_SIZE);
+
+/// Returns the rest of a stream.  The readers of formats that cannot be parsed
+/// a block of lines at a time hold the whole stream in memory with it.
+std::string readRemaining(std::istream& stream);
+
+/// Parses lines that hold the one-based coordinates of an entry followed by
+/// its value.  The lines may be given a block at a time.  The entries of every
+/// block are counted first, and then parsed in parallel straight into their
+/// place in coordinate and value arrays, which grow as needed.
+class EntryParser : util::Uncopyable {
+public:
+  /// Parse entries of the order of the first entry, whose coordinates may be
+  /// up to INT_MAX.  Lines that start with `comment` are skipped, and errors
+  /// name the file type `fileType`.
+  EntryParser(char comment, std::string fileType);
+
+  /// Free the arrays unless they were taken by `takeComponents`.
+  ~EntryParser();
+
+  /// Fix the order, and bound the coordinates by the dimensions.  Must be
+  /// called before any entries are parsed.
+  void setDimensions(const std::vector<int>& dimensions);
+
+  /// Parse the entries of the lines [begin,end) and append them.
+  void parse(const char* begin, const char* end);
+
+  /// Make room for `capacity` entries in total.
+  void reserve(size_t capacity);
+
+  /// Returns the order, which is 0 until it is fixed or an entry is parsed.
+  size_t getOrder() const;
+
+  /// Returns the number of entries.
+  size_t getSize() const;
+
+  /// Sets the number of entries, up to the capacity, after entries have been
+  /// written directly to the arrays.
+  void setSize(size_t size);
+
+  /// Returns the zero-based coordinates of a mode and the values.
+  int* getCoordinates(size_t mode);
+  double* getValues();
+
+  /// Returns the largest one-based coordinate of every mode.
+  const std::vector<long long>& getMaxCoordinates() const;
+
+  /// Returns the components with the given dimensions, which take the
+  /// ownership of the arrays.
+  ParsedComponents takeComponents(const std::vector<int>& dimensions);
+
+private:
+  char                   comment;
+  std::string            fileType;
+  std::vector<long long> bounds;
+  std::vector<long long> maxCoordinates;
+  std::vector<int*>      coordinates;
+  double*                values;
+  size_t                 size;
+  size_t                 capacity;
+};
+
+/// Returns an unpacked tensor with the components inserted in bulk, which
+/// passes the ownership of their arrays to the tensor.
+TensorBase makeTensor(const ParsedComponents& components, const Format& format);
+TensorBase makeTensor(const ParsedComponents& components,
+                      const ModeFormat& modetype);
+
+/// Pack the components into storage.
+TensorStorage makeStorage(const ParsedComponents& components,
+                          const Format& format);
+TensorStorage makeStorage(const ParsedComponents& components,
+                          const ModeFormat& modetype);
+
+}
+#endif
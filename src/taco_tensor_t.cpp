@@ -27,11 +27,11 @@ void free_mem(void *ptr) {
 }
 
 taco_tensor_t* init_taco_tensor_t(int32_t order, int32_t csize,
-                        int32_t* dimensions, int32_t* modeOrdering,
+                        int64_t* dimensions, int32_t* modeOrdering,
                         taco_mode_t* mode_types) {
   taco_tensor_t* t = (taco_tensor_t *) alloc_mem(sizeof(taco_tensor_t));
   t->order         = order;
-  t->dimensions = (int32_t *) alloc_mem(order * sizeof(int32_t));
+  t->dimensions = (int64_t *) alloc_mem(order * sizeof(int64_t));
   t->mode_ordering = (int32_t *) alloc_mem(order * sizeof(int32_t));
   t->mode_types = (taco_mode_t *) alloc_mem(order * sizeof(taco_mode_t));
   t->indices = (uint8_t ***) alloc_mem(order * sizeof(uint8_t***));
@@ -48,6 +48,27 @@ taco_tensor_t* init_taco_tensor_t(int32_t order, int32_t csize,
       case taco_mode_sparse:
         t->indices[i] = (uint8_t **) alloc_mem(2 * sizeof(uint8_t **));
         break;
+      case taco_mode_singleton:
+        t->indices[i] = (uint8_t **) alloc_mem(1 * sizeof(uint8_t **));
+        break;
+      case taco_mode_hashed:
+        t->indices[i] = (uint8_t **) alloc_mem(2 * sizeof(uint8_t **));
+        break;
+      case taco_mode_sliced:
+        t->indices[i] = (uint8_t **) alloc_mem(1 * sizeof(uint8_t **));
+        break;
+      case taco_mode_diagonal:
+        t->indices[i] = (uint8_t **) alloc_mem(2 * sizeof(uint8_t **));
+        break;
+      case taco_mode_offset:
+        t->indices[i] = (uint8_t **) alloc_mem(1 * sizeof(uint8_t **));
+        break;
+      case taco_mode_bitmap:
+        t->indices[i] = (uint8_t **) alloc_mem(2 * sizeof(uint8_t **));
+        break;
+      case taco_mode_permuted:
+        t->indices[i] = (uint8_t **) alloc_mem(2 * sizeof(uint8_t **));
+        break;
     }
   }
   return t;
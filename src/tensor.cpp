@@ -1,9 +1,12 @@
 #include "taco/tensor.h"
 
 #include <set>
+#include <map>
+#include <mutex>
 #include <cstring>
 #include <fstream>
 #include <sstream>
+#include <iomanip>
 #include <cstdlib>
 #include <climits>
 
@@ -24,11 +27,14 @@
 #include "codegen/codegen_cuda.h"
 #include "taco/taco_tensor_t.h"
 #include "taco/storage/file_io_tns.h"
+#include "taco/storage/file_io_bin.h"
 #include "taco/storage/file_io_mtx.h"
 #include "taco/storage/file_io_rb.h"
+#include "taco/util/files.h"
 #include "taco/util/strings.h"
 #include "taco/util/timers.h"
 #include "taco/util/name_generator.h"
+#include "taco/util/thread_pool.h"
 #include "taco/error/error_messages.h"
 #include "error/error_checks.h"
 #include "taco/storage/typed_vector.h"
@@ -45,6 +51,21 @@ using namespace taco::ir;
 
 namespace taco {
 
+/// How kernels see a dense tensor indexed by the split index variables of
+/// blocked or sliced tensors.  The tensor is reshaped to `dimensions`, and if
+/// the rows of the sliced tensor `rows` are sorted or padded, its level
+/// `permutedLevel` is a permuted level that locates the rows of every slice
+/// through the rows of the sliced tensor.
+struct Reshape {
+  vector<int> dimensions;
+  int         permutedLevel = -1;
+  TensorVar   rows;
+};
+
+static bool operator==(const Reshape& a, const Reshape& b) {
+  return a.dimensions == b.dimensions && a.permutedLevel == b.permutedLevel;
+}
+
 struct TensorBase::Content {
   Datatype           dataType;
   vector<int>        dimensions;
@@ -55,11 +76,41 @@ struct TensorBase::Content {
 
   size_t             allocSize;
   size_t             valuesSize;
+  DuplicatePolicy    duplicatePolicy;
+  bool               symbolicAssemble;
+  bool               parallelAssemble;
+  bool               parallelReduce;
+  ReductionStrategy  reductionStrategy;
 
   Stmt               assembleFunc;
   Stmt               computeFunc;
   bool               assembleWhileCompute;
   shared_ptr<Module> module;
+  shared_future<void> compiled;
+
+  // Resolved when the kernels are first needed after compilation
+  void*              assembleShim;
+  void*              computeShim;
+
+  // Components inserted in bulk, which are packed after the components that
+  // were inserted one at a time before them
+  struct Batch {
+    size_t        numPrecedingComponents;
+    vector<Array> coordinates;
+    Array         values;
+  };
+  vector<Batch>      batches;
+
+  // The operands of the assignment, and the taco_tensor_t arguments passed
+  // to the kernels, which are refreshed in place on every call
+  vector<TensorBase> operands;
+  vector<void*>      arguments;
+
+  // How the kernels see the dense tensors indexed by the split index
+  // variables of blocked or sliced tensors, and the reshaped views of their
+  // storage passed to the kernels by argument
+  map<TensorVar,Reshape>     reshapes;
+  map<size_t,TensorStorage>  views;
 
   Content(string name, Datatype dataType, const vector<int>& dimensions,
           Format format)
@@ -111,7 +162,25 @@ static Format initFormat(Format format) {
       ModeFormat modeType = format.getModeFormats()[i];
       if (modeType == Dense) {
         arrayTypes.push_back(Int32);
-      } else if (modeType == Sparse) {
+      } else if (modeType.getName() == Compressed.getName()) {
+        arrayTypes.push_back(Int32);
+        arrayTypes.push_back(Int32);
+      } else if (modeType.getName() == Singleton.getName()) {
+        arrayTypes.push_back(Int32);
+      } else if (modeType.getName() == Hashed.getName()) {
+        arrayTypes.push_back(Int32);
+        arrayTypes.push_back(Int32);
+      } else if (modeType.getName() == Sliced.getName()) {
+        arrayTypes.push_back(Int32);
+      } else if (modeType.getName() == Diagonal.getName()) {
+        arrayTypes.push_back(Int32);
+        arrayTypes.push_back(Int32);
+      } else if (modeType.getName() == Offset.getName()) {
+        arrayTypes.push_back(Int32);
+      } else if (modeType.getName() == Bitmap.getName()) {
+        arrayTypes.push_back(Int32);
+        arrayTypes.push_back(UInt64);
+      } else if (modeType.getName() == Permuted.getName()) {
         arrayTypes.push_back(Int32);
         arrayTypes.push_back(Int32);
       } else {
@@ -161,22 +230,50 @@ TensorBase::TensorBase(string name, Datatype ctype, vector<int> dimensions,
   taco_uassert((size_t)format.getOrder() == dimensions.size()) <<
       "The number of format mode types (" << format.getOrder() << ") " <<
       "must match the tensor order (" << dimensions.size() << ").";
+  taco_uassert(!format.isSplitComplex() || ctype.isComplex()) <<
+      "Only the values of complex tensors can be split";
 
   content->allocSize = 1 << 20;
-
-  // Initialize dense storage modes
+  content->duplicatePolicy = DuplicatePolicy::First;
+  content->symbolicAssemble = false;
+#ifdef USE_OPENMP
+  content->parallelAssemble = true;
+  content->parallelReduce = true;
+#else
+  content->parallelAssemble = false;
+  content->parallelReduce = false;
+#endif
+  content->reductionStrategy = ReductionStrategy::Fast;
+
+  // Initialize dense storage modes, and the table widths of hashed modes, which
+  // direct-map the coordinates of results
   // TODO: Get rid of this and make code use dimensions instead of dense indices
   vector<ModeIndex> modeIndices(format.getOrder());
   for (int i = 0; i < format.getOrder(); ++i) {
-    if (format.getModeFormats()[i] == Dense) {
+    if (format.getModeFormats()[i] == Dense ||
+        format.getModeFormats()[i].getName() == Hashed.getName()) {
       const size_t idx = format.getModeOrdering()[i];
-      modeIndices[i] = ModeIndex({makeArray({content->dimensions[idx]})});
+      Array size = makeArray(format.getCoordinateTypePos(i), 1);
+      size.get(0) = format.isBlocked()
+          ? content->dimensions[idx] / format.getBlockSizes()[idx]
+          : content->dimensions[idx];
+      modeIndices[i] = ModeIndex({size});
     }
   }
   content->storage.setIndex(Index(format, modeIndices));
 
+  // Sliced ELLPACK and diagonal matrices are stored as tensors of slots and
+  // diagonals, which start empty
+  if (format.isSliced() || format.isDiagonal()) {
+    content->storage = taco::pack(ctype, dimensions,
+                                  content->storage.getFormat(),
+                                  vector<ComponentBatch>());
+  }
+
   content->assembleWhileCompute = false;
   content->module = make_shared<Module>();
+  content->assembleShim = nullptr;
+  content->computeShim = nullptr;
 
   this->coordinateBuffer = shared_ptr<vector<char>>(new vector<char>);
   this->coordinateBufferUsed = 0;
@@ -238,18 +335,62 @@ size_t TensorBase::getAllocSize() const {
   return content->allocSize;
 }
 
-static size_t numIntegersToCompare = 0;
-static int lexicographicalCmp(const void* a, const void* b) {
-  for (size_t i = 0; i < numIntegersToCompare; i++) {
-    int diff = ((int*)a)[i] - ((int*)b)[i];
-    if (diff != 0) {
-      return diff;
-    }
+void TensorBase::setDuplicatePolicy(DuplicatePolicy duplicatePolicy) {
+  content->duplicatePolicy = duplicatePolicy;
+}
+
+DuplicatePolicy TensorBase::getDuplicatePolicy() const {
+  return content->duplicatePolicy;
+}
+
+void TensorBase::setSymbolicAssemble(bool symbolicAssemble) {
+  content->symbolicAssemble = symbolicAssemble;
+}
+
+bool TensorBase::getSymbolicAssemble() const {
+  return content->symbolicAssemble;
+}
+
+void TensorBase::setParallelAssemble(bool parallelAssemble) {
+  content->parallelAssemble = parallelAssemble;
+}
+
+bool TensorBase::getParallelAssemble() const {
+  return content->parallelAssemble;
+}
+
+void TensorBase::setParallelReduce(bool parallelReduce,
+                                   ReductionStrategy strategy) {
+  content->parallelReduce = parallelReduce;
+  content->reductionStrategy = strategy;
+}
+
+bool TensorBase::getParallelReduce() const {
+  return content->parallelReduce;
+}
+
+ReductionStrategy TensorBase::getReductionStrategy() const {
+  return content->reductionStrategy;
+}
+
+void TensorBase::insert(const std::vector<Array>& coordinates,
+                        const Array& values) {
+  taco_uassert(coordinates.size() == (size_t)getOrder()) <<
+      "Wrong number of coordinate arrays";
+  taco_uassert(getOrder() > 0) << "Cannot insert scalars in bulk";
+  taco_uassert(values.getType() == getComponentType()) <<
+      "Cannot insert values of type '" << values.getType() << "' " <<
+      "into a tensor with component type " << getComponentType();
+  for (auto& modeCoordinates : coordinates) {
+    taco_uassert(modeCoordinates.getType() == Int32) <<
+        "Coordinates must be of type " << Int32;
+    taco_uassert(modeCoordinates.getSize() == values.getSize()) <<
+        "The coordinate and value arrays must have the same size";
   }
-  return 0;
+  size_t numPrecedingComponents = coordinateBufferUsed / coordinateSize;
+  content->batches.push_back({numPrecedingComponents, coordinates, values});
 }
 
-/// Pack coordinates into a data structure given by the tensor format.
 void TensorBase::pack() {
   int order = getOrder();
 
@@ -264,102 +405,41 @@ void TensorBase::pack() {
     return;
   }
     
-  /// Permute the coordinates according to the storage mode ordering.
-  /// This is a workaround since the current pack code only packs tensors in the
-  /// ordering of the modes.
-  const std::vector<int>& dimensions = getDimensions();
-  taco_iassert(getFormat().getOrder() == order);
-  std::vector<int> permutation = getFormat().getModeOrdering();
-  std::vector<int> permutedDimensions(order);
-  for (int i = 0; i < order; ++i) {
-    permutedDimensions[i] = dimensions[permutation[i]];
-  }
-  
   taco_iassert((this->coordinateBufferUsed % this->coordinateSize) == 0);
   size_t numCoordinates = this->coordinateBufferUsed / this->coordinateSize;
-  const size_t coordSize = this->coordinateSize;
-  char* coordinatesPtr = coordinateBuffer->data();
-  vector<int> permuteBuffer(order);
-  for (size_t i=0; i < numCoordinates; ++i) {
-    int* coordinate = (int*)coordinatesPtr;
-    for (int j = 0; j < order; j++) {
-      permuteBuffer[j] = coordinate[permutation[j]];
-    }
-    for (int j = 0; j < order; j++) {
-      coordinate[j] = permuteBuffer[j];
-    }
-    coordinatesPtr += this->coordinateSize;
-  }
-  coordinatesPtr = coordinateBuffer->data();  
-  
-  // The pack code expects the coordinates to be sorted
-  numIntegersToCompare = order;
-  qsort(coordinatesPtr, numCoordinates, coordSize, lexicographicalCmp);
-  
 
-  // Move coords into separate arrays and remove duplicates
-  std::vector<TypedIndexVector> coordinates(order);
-  for (int i=0; i < order; ++i) {
-    coordinates[i] = TypedIndexVector(getFormat().getCoordinateTypeIdx(i),
-                                      numCoordinates);
-  }
-  char* values = (char*) malloc(numCoordinates * getComponentType().getNumBytes());
-  // Copy first coordinate-value pair
-  int* lastCoord = (int*)malloc(order * sizeof(int));
-  int j = 1;
-  if (numCoordinates >= 1) {
-    int* coordComponent = (int*)coordinatesPtr;
-    for (int d=0; d < order; ++d) {
-      coordinates[d].set(0, *coordComponent);
-      lastCoord[d] = *coordComponent;
-      coordComponent++;
-    }
-    memcpy(values, coordComponent, getComponentType().getNumBytes());
-  }
-  else {
-    j = 0;
-  }
-  // Copy remaining coordinate-value pairs, removing duplicates
-  int* coord = (int*)malloc(order * sizeof(int));
-  void *value = malloc(getComponentType().getNumBytes());
-  for (size_t i=1; i < numCoordinates; ++i) {
-    int* coordLoc = (int*)&coordinatesPtr[i*coordSize];
-    for (int d=0; d < order; ++d) {
-      coord[d] = *coordLoc;
-      coordLoc++;
-    }
-    memcpy(value, coordLoc, getComponentType().getNumBytes());
-    if (coord != lastCoord) {
-      for (int d = 0; d < order; d++) {
-        coordinates[d].set(j, coord[d]);
-      }
-      memcpy(&values[j * getComponentType().getNumBytes()], value, getComponentType().getNumBytes());
-      j++;
+  // Pack the inserted components in the order they were inserted, reading the
+  // coordinate buffer and the bulk inserted arrays in place
+  vector<ComponentBatch> batches;
+  size_t numBuffered = 0;
+  auto addBuffered = [&](size_t end) {
+    if (end > numBuffered) {
+      ComponentBatch batch;
+      batch.components = &coordinateBuffer->data()[numBuffered *
+                                                   coordinateSize];
+      batch.size = end - numBuffered;
+      batches.push_back(batch);
+      numBuffered = end;
     }
-    else {
-      taco_uwarning << "Duplicate coordinate ignored when inserting into tensor";
-    }
-  }
-  free(value);
-  free(coord);
-  free(lastCoord);
-  if (numCoordinates > 0) {
-    for (int i=0; i < order; ++i) {
-      coordinates[i].resize(j);
+  };
+  for (auto& inserted : content->batches) {
+    addBuffered(inserted.numPrecedingComponents);
+    ComponentBatch batch;
+    for (auto& modeCoordinates : inserted.coordinates) {
+      batch.coordinates.push_back((const int*)modeCoordinates.getData());
     }
-    values = (char *) realloc(values, (j) * getComponentType().getNumBytes());
+    batch.values = (const char*)inserted.values.getData();
+    batch.size = inserted.values.getSize();
+    batches.push_back(batch);
   }
-  taco_iassert(coordinates.size() > 0);
+  addBuffered(numCoordinates);
 
+  content->storage = taco::pack(getComponentType(), getDimensions(),
+                                getFormat(), batches, getDuplicatePolicy());
 
   this->coordinateBuffer->clear();
   this->coordinateBufferUsed = 0;
-
-  // Pack indices and values
-  content->storage = taco::pack(getComponentType(), permutedDimensions,
-                                getFormat(), coordinates, (void*)values);
-
-  free(values);
+  content->batches.clear();
 }
 
 void TensorBase::setStorage(TensorStorage storage) {
@@ -397,15 +477,446 @@ Access TensorBase::operator()(const std::vector<IndexVar>& indices) {
   return Access(new AccessTensorNode(*this, indices));
 }
 
+/// Computes a key that identifies the kernels generated for an assignment.
+/// Tensors and index variables are numbered in order of first appearance
+/// instead of being named, so that structurally identical assignments over
+/// different tensors get the same key as long as the tensors agree on their
+/// types and formats.
+static string getStructuralKey(const Assignment& assignment) {
+  struct StructuralKey : public IndexNotationVisitor {
+    using IndexNotationVisitor::visit;
+    stringstream key;
+    map<TensorVar,int> tensorIds;
+    map<IndexVar,int> indexVarIds;
+
+    void visitIndexVar(const IndexVar& indexVar) {
+      if (!util::contains(indexVarIds, indexVar)) {
+        int id = (int)indexVarIds.size();
+        indexVarIds.insert({indexVar, id});
+      }
+      key << "i" << indexVarIds.at(indexVar);
+    }
+
+    void visit(const AccessNode* node) {
+      TensorVar tensorVar = node->tensorVar;
+      if (!util::contains(tensorIds, tensorVar)) {
+        int id = (int)tensorIds.size();
+        tensorIds.insert({tensorVar, id});
+        Format format = tensorVar.getFormat();
+        key << "{" << tensorVar.getType() << ";" << format << ";";
+        for (auto& arrayTypes : format.getLevelArrayTypes()) {
+          key << "[" << util::join(arrayTypes) << "]";
+        }
+        // Formats print their modes by name only, but modes with different
+        // properties are lowered differently
+        for (auto& modeFormat : format.getModeFormats()) {
+          key << "<" << modeFormat.isFull() << modeFormat.isOrdered()
+              << modeFormat.isUnique() << modeFormat.isBranchless()
+              << modeFormat.isCompact() << ">";
+        }
+        key << "}";
+      }
+      key << "t" << tensorIds.at(tensorVar) << "(";
+      for (auto& indexVar : node->indexVars) {
+        visitIndexVar(indexVar);
+        key << ",";
+      }
+      key << ")";
+    }
+
+    void visit(const LiteralNode* node) {
+      // Kernels have their literals compiled in, so key them on their exact
+      // bits rather than on their rounded printed value
+      Datatype type = node->getDataType();
+      key << "(" << type << ")0x" << hex << setfill('0');
+      const unsigned char* bytes = static_cast<const unsigned char*>(node->val);
+      for (int i = 0; i < type.getNumBytes(); i++) {
+        key << setw(2) << (int)bytes[i];
+      }
+      key << dec << setfill(' ');
+    }
+
+    void visit(const NegNode* node) {
+      key << "-(";
+      node->a.accept(this);
+      key << ")";
+    }
+
+    void visit(const SqrtNode* node) {
+      key << "sqrt(";
+      node->a.accept(this);
+      key << ")";
+    }
+
+    void visitBinary(const BinaryExprNode* node) {
+      key << "(";
+      node->a.accept(this);
+      key << node->getOperatorString();
+      node->b.accept(this);
+      key << ")";
+    }
+    void visit(const AddNode* node) {visitBinary(node);}
+    void visit(const SubNode* node) {visitBinary(node);}
+    void visit(const MulNode* node) {visitBinary(node);}
+    void visit(const DivNode* node) {visitBinary(node);}
+
+    void visit(const ReductionNode* node) {
+      key << "reduce" << to<BinaryExprNode>(node->op.ptr)->getOperatorString();
+      key << "(";
+      visitIndexVar(node->var);
+      key << ",";
+      node->a.accept(this);
+      key << ")";
+    }
+
+    void visit(const AssignmentNode* node) {
+      visit(to<AccessNode>(node->lhs.ptr));
+      if (node->op.defined()) {
+        key << to<BinaryExprNode>(node->op.ptr)->getOperatorString();
+      }
+      key << "=";
+      node->rhs.accept(this);
+    }
+  };
+  StructuralKey structuralKey;
+  assignment.accept(&structuralKey);
+  return structuralKey.key.str();
+}
+
+/// The kernels compiled for an assignment, shared by all tensors whose
+/// assignments have the same structural key.
+struct CompiledKernels {
+  Stmt                assembleFunc;
+  Stmt                computeFunc;
+  shared_ptr<Module>  module;
+  shared_future<void> compiled;
+};
+
+static mutex compileCacheMutex;
+static map<string,CompiledKernels> compileCache;
+static CompileCacheStats compileCacheStats = {0, 0, 0};
+
+/// Rewrites an assignment with blocked, sliced or diagonal tensors into an
+/// assignment over their tensors of blocks, slots or diagonals.  The index
+/// variables that index the modes of blocked tensors and the rows of sliced
+/// tensors are split into block (slice) coordinates and coordinates within
+/// blocks (slices), and the dense tensors they also index are reshaped to
+/// match, so that the loops over the coordinates within blocks and slices have
+/// their sizes as bounds.  How the kernels see the reshaped dense tensors is
+/// stored in `reshapes`.  Diagonal tensors are indexed by a new index variable
+/// over their diagonals before their rows and columns.
+static Assignment makeBlocked(const Assignment& assignment,
+                              map<TensorVar,Reshape>* reshapes) {
+  struct BlockSizes : public IndexNotationVisitor {
+    using IndexNotationVisitor::visit;
+    map<IndexVar,int> blockSizes;
+    map<IndexVar,TensorVar> slicedRows;
+    bool hasBlocked = false;
+    bool hasDiagonal = false;
+
+    void insert(const IndexVar& indexVar, int blockSize) {
+      taco_uassert(!util::contains(blockSizes, indexVar) ||
+                   blockSizes.at(indexVar) == blockSize) <<
+          "Index variable " << indexVar << " indexes modes with different " <<
+          "block sizes";
+      blockSizes.insert({indexVar, blockSize});
+    }
+
+    void visit(const AccessNode* node) {
+      const TensorVar& tensorVar = node->tensorVar;
+      const Format& format = tensorVar.getFormat();
+      for (size_t i = 0; i < format.getBlockSizes().size(); i++) {
+        insert(node->indexVars[i], format.getBlockSizes()[i]);
+        hasBlocked = true;
+      }
+      if (format.isSliced()) {
+        const IndexVar& indexVar = node->indexVars[0];
+        taco_uassert(!util::contains(slicedRows, indexVar) ||
+                     slicedRows.at(indexVar) == tensorVar) <<
+            "Index variable " << indexVar << " indexes the rows of more " <<
+            "than one sliced tensor";
+        vector<int> dimensions;
+        for (auto& dimension : tensorVar.getType().getShape()) {
+          dimensions.push_back((int)dimension.getSize());
+        }
+        insert(indexVar, getSliceTensorDimensions(dimensions, format)[2]);
+        slicedRows.insert({indexVar, tensorVar});
+      }
+      hasDiagonal |= format.isDiagonal();
+    }
+
+    void visit(const AssignmentNode* node) {
+      taco_uassert(!node->lhs.getTensorVar().getFormat().isSliced()) <<
+          "Sliced ELLPACK tensors are only supported as operands";
+      taco_uassert(!node->lhs.getTensorVar().getFormat().isDiagonal()) <<
+          "Diagonal tensors are only supported as operands";
+      visit(to<AccessNode>(node->lhs.ptr));
+      node->rhs.accept(this);
+    }
+  };
+  BlockSizes blockSizes;
+  assignment.accept(&blockSizes);
+  if (blockSizes.blockSizes.empty() && !blockSizes.hasDiagonal) {
+    return assignment;
+  }
+  taco_uassert(!blockSizes.hasBlocked || blockSizes.slicedRows.empty()) <<
+      "Blocked and sliced tensors cannot be combined in one assignment";
+  taco_uassert(!blockSizes.hasDiagonal || blockSizes.blockSizes.empty()) <<
+      "Diagonal tensors cannot be combined with blocked or sliced tensors in " <<
+      "one assignment";
+
+  struct BlockRewriter : public IndexNotationRewriter {
+    using IndexNotationRewriter::visit;
+    map<IndexVar,int> blockSizes;
+    map<IndexVar,TensorVar> slicedRows;
+    map<IndexVar,pair<IndexVar,IndexVar>> splits;
+    map<TensorVar,TensorVar> tensorVars;
+    map<TensorVar,Reshape>* reshapes;
+
+    const pair<IndexVar,IndexVar>& getSplit(const IndexVar& indexVar) {
+      if (!util::contains(splits, indexVar)) {
+        splits.insert({indexVar, {IndexVar(), IndexVar()}});
+      }
+      return splits.at(indexVar);
+    }
+
+    void visit(const AccessNode* op) {
+      const TensorVar& tensorVar = op->tensorVar;
+      const Format& format = tensorVar.getFormat();
+      vector<int> dimensions;
+      for (auto& dimension : tensorVar.getType().getShape()) {
+        dimensions.push_back((int)dimension.getSize());
+      }
+
+      vector<IndexVar> indexVars;
+      vector<int> blockTensorDimensions;
+      Format blockTensorFormat;
+      if (format.isBlocked()) {
+        vector<IndexVar> innerVars;
+        for (auto& indexVar : op->indexVars) {
+          indexVars.push_back(getSplit(indexVar).first);
+          innerVars.push_back(getSplit(indexVar).second);
+        }
+        util::append(indexVars, innerVars);
+        blockTensorDimensions = getBlockTensorDimensions(dimensions, format);
+        blockTensorFormat = getBlockTensorFormat(format);
+      } else if (format.isSliced()) {
+        // The slots of every slice are summed over
+        const IndexVar& column = op->indexVars[1];
+        taco_uassert(!util::contains(blockSizes, column)) <<
+            "The columns of sliced tensor " << tensorVar.getName() <<
+            " are indexed by the rows of a sliced tensor";
+        indexVars = {getSplit(op->indexVars[0]).first, IndexVar(),
+                     getSplit(op->indexVars[0]).second, column};
+        blockTensorDimensions = getSliceTensorDimensions(dimensions, format);
+        blockTensorFormat = getSliceTensorFormat(format);
+      } else if (format.isDiagonal()) {
+        // The diagonals are summed over, and their number is only known once
+        // the tensor is packed
+        indexVars = {IndexVar(), op->indexVars[0], op->indexVars[1]};
+        blockTensorFormat = getDiagonalTensorFormat(format);
+        if (!util::contains(tensorVars, tensorVar)) {
+          Type type(tensorVar.getType().getDataType(),
+                    {Dimension(), Dimension((size_t)dimensions[0]),
+                     Dimension((size_t)dimensions[1])});
+          tensorVars.insert({tensorVar, TensorVar(tensorVar.getName(), type,
+                                                  blockTensorFormat)});
+        }
+        expr = Access(tensorVars.at(tensorVar), indexVars);
+        return;
+      } else {
+        Reshape reshape;
+        for (size_t i = 0; i < op->indexVars.size(); i++) {
+          const IndexVar& indexVar = op->indexVars[i];
+          if (!util::contains(blockSizes, indexVar)) {
+            indexVars.push_back(indexVar);
+            reshape.dimensions.push_back(dimensions[i]);
+            continue;
+          }
+          const int blockSize = blockSizes.at(indexVar);
+          if (util::contains(slicedRows, indexVar)) {
+            // Sorted rows, and rows that pad the last slice, are located
+            // through the rows of the sliced tensor
+            const TensorVar& rows = slicedRows.at(indexVar);
+            const Format& rowsFormat = rows.getFormat();
+            const int numRows = (int)rows.getType().getShape()
+                                    .getDimension(0).getSize();
+            if (rowsFormat.getSortWindow() > 1 || numRows % blockSize != 0) {
+              taco_uassert(reshape.permutedLevel == -1) <<
+                  tensorVar.getName() << " is indexed by the rows of " <<
+                  "sliced tensors in more than one mode";
+              reshape.permutedLevel = (int)reshape.dimensions.size() + 1;
+              reshape.rows = rows;
+            }
+          } else {
+            taco_uassert(dimensions[i] % blockSize == 0) <<
+                "Mode " << i << " of " << tensorVar.getName() << " has " <<
+                "dimension " << dimensions[i] << ", which is not a multiple " <<
+                "of the block size " << blockSize;
+          }
+          indexVars.push_back(getSplit(indexVar).first);
+          indexVars.push_back(getSplit(indexVar).second);
+          reshape.dimensions.push_back(
+              (dimensions[i] + blockSize - 1) / blockSize);
+          reshape.dimensions.push_back(blockSize);
+        }
+        if (indexVars.size() == op->indexVars.size()) {
+          expr = op;
+          return;
+        }
+        bool isRowMajor = true;
+        for (int i = 0; i < format.getOrder(); i++) {
+          isRowMajor &= (format.getModeOrdering()[i] == i);
+        }
+        taco_uassert(isDense(format) && isRowMajor)
+            << "Tensors indexed by the index variables of blocked or sliced "
+            << "tensors must be dense and stored in row-major order, but "
+            << tensorVar.getName() << " has format " << format;
+        blockTensorDimensions = reshape.dimensions;
+        vector<ModeFormatPack> modeFormats(blockTensorDimensions.size(),
+                                           Dense);
+        if (reshape.permutedLevel >= 0) {
+          modeFormats[reshape.permutedLevel] = Permuted;
+        }
+        blockTensorFormat = Format(modeFormats);
+        taco_uassert(!util::contains(*reshapes, tensorVar) ||
+                     reshapes->at(tensorVar) == reshape) <<
+            tensorVar.getName() << " is indexed with different block sizes";
+        reshapes->insert({tensorVar, reshape});
+      }
+
+      if (!util::contains(tensorVars, tensorVar)) {
+        Type type(tensorVar.getType().getDataType(),
+                  Type::makeDimensionVector(blockTensorDimensions));
+        tensorVars.insert({tensorVar, TensorVar(tensorVar.getName(), type,
+                                                blockTensorFormat)});
+      }
+      expr = Access(tensorVars.at(tensorVar), indexVars);
+    }
+
+    void visit(const ReductionNode* op) {
+      IndexExpr a = rewrite(op->a);
+      if (util::contains(blockSizes, op->var)) {
+        const pair<IndexVar,IndexVar>& split = getSplit(op->var);
+        expr = Reduction(op->op, split.first,
+                         Reduction(op->op, split.second, a));
+      } else {
+        expr = (a == op->a) ? IndexExpr(op)
+                            : Reduction(op->op, op->var, a);
+      }
+    }
+
+    void visit(const AssignmentNode* op) {
+      Access lhs(to<AccessNode>(rewrite(op->lhs).ptr));
+      stmt = Assignment(lhs, rewrite(op->rhs), op->op);
+    }
+  };
+  BlockRewriter rewriter;
+  rewriter.blockSizes = blockSizes.blockSizes;
+  rewriter.slicedRows = blockSizes.slicedRows;
+  rewriter.reshapes = reshapes;
+  return Assignment(to<AssignmentNode>(rewriter.rewrite(assignment).ptr));
+}
+
+/// Creates a view of dense storage as the kernels see it reshaped, which
+/// shares its values.  The permuted level of the view, if any, locates its
+/// `numRows` rows through the rows `rows` of a sliced tensor.
+static TensorStorage makeReshapedView(const TensorStorage& storage,
+                                      const Reshape& reshape, int numRows,
+                                      const Array& rows) {
+  vector<ModeFormatPack> modeFormats(reshape.dimensions.size(), Dense);
+  vector<ModeIndex> modeIndices;
+  for (size_t i = 0; i < reshape.dimensions.size(); i++) {
+    Array size = makeArray(Int32, 1);
+    if ((int)i == reshape.permutedLevel) {
+      modeFormats[i] = Permuted;
+      size.get(0) = numRows;
+      modeIndices.push_back(ModeIndex({size, rows}));
+      continue;
+    }
+    size.get(0) = reshape.dimensions[i];
+    modeIndices.push_back(ModeIndex({size}));
+  }
+  Format format(modeFormats);
+  TensorStorage view(storage.getComponentType(), reshape.dimensions, format);
+  view.setIndex(Index(format, modeIndices));
+  view.setValues(storage.getValues());
+  return view;
+}
+
 void TensorBase::compile(bool assembleWhileCompute) {
+  lowerAndCompile(assembleWhileCompute, false);
+}
+
+shared_future<void> TensorBase::compileAsync(bool assembleWhileCompute) {
+  return lowerAndCompile(assembleWhileCompute, true);
+}
+
+shared_future<void> TensorBase::lowerAndCompile(bool assembleWhileCompute,
+                                                bool async) {
   Assignment assignment = getAssignment();
   taco_uassert(assignment.defined())
       << error::compile_without_expr;
 
   content->assembleWhileCompute = assembleWhileCompute;
+  content->assembleShim = nullptr;
+  content->computeShim = nullptr;
+
+  bool newLower = std::getenv("NEW_LOWER") &&
+                  std::string(std::getenv("NEW_LOWER")) == "1";
+
+  content->reshapes.clear();
+  Assignment blockedAssignment = makeBlocked(assignment, &content->reshapes);
+  const bool isBlocked = (blockedAssignment.ptr != assignment.ptr);
+  taco_uassert(!newLower || !isBlocked) <<
+      "Blocked and sliced formats are only supported by the default lowering";
+  for (auto& modeFormat : getFormat().getModeFormats()) {
+    taco_uassert(modeFormat.getName() != Bitmap.getName()) <<
+        "Bitmap levels are only supported in operands";
+  }
+  taco_uassert(!getFormat().isPattern()) <<
+      "Pattern formats are only supported in operands";
+
+  // Kernels compute split complex values with real arithmetic over their
+  // parts, so no other tensor may interleave them
+  bool hasSplitComplex = false;
+  bool hasInterleavedComplex = false;
+  for (auto& tensorVar : getTensorVars(assignment)) {
+    if (tensorVar.getFormat().isSplitComplex()) {
+      hasSplitComplex = true;
+    } else if (tensorVar.getOrder() > 0 &&
+               tensorVar.getType().getDataType().isComplex()) {
+      hasInterleavedComplex = true;
+    }
+  }
+  taco_uassert(!hasSplitComplex || !hasInterleavedComplex) <<
+      "Split complex tensors cannot be computed with tensors whose complex "
+      "values are interleaved";
+  taco_uassert(!newLower || !hasSplitComplex) <<
+      "Split complex formats are only supported by the default lowering";
+  taco_uassert(!getFormat().isSplitComplex() || isDense(getFormat())) <<
+      "Split complex results must be dense";
+
+  stringstream cacheKey;
+  cacheKey << getStructuralKey(assignment) << ";" << newLower << ";"
+           << assembleWhileCompute << ";" << getAllocSize() << ";"
+           << getSymbolicAssemble() << ";" << getParallelAssemble() << ";"
+           << getParallelReduce() << ";" << getReductionStrategy();
+  {
+    lock_guard<mutex> lock(compileCacheMutex);
+    auto cached = compileCache.find(cacheKey.str());
+    if (cached != compileCache.end()) {
+      compileCacheStats.hits++;
+      content->assembleFunc = cached->second.assembleFunc;
+      content->computeFunc = cached->second.computeFunc;
+      content->module = cached->second.module;
+      content->compiled = cached->second.compiled;
+      return content->compiled;
+    }
+    compileCacheStats.misses++;
+  }
 
-  if (std::getenv("NEW_LOWER") && 
-      std::string(std::getenv("NEW_LOWER")) == "1") {
+  if (newLower) {
     IndexStmt stmt = makeConcrete(assignment);
     
     content->assembleFunc = lower(stmt, "assemble", true, false);
@@ -417,15 +928,71 @@ void TensorBase::compile(bool assembleWhileCompute) {
     if (assembleWhileCompute) {
       computeProperties.insert(old::Assemble);
     }
+    if (getSymbolicAssemble()) {
+      assembleProperties.insert(old::SymbolicAssemble);
+      computeProperties.insert(old::SymbolicAssemble);
+    }
+    if (getParallelAssemble()) {
+      assembleProperties.insert(old::ParallelAssemble);
+      computeProperties.insert(old::ParallelAssemble);
+    }
+    if (getParallelReduce()) {
+      computeProperties.insert(old::ParallelReduce);
+      if (getReductionStrategy() == ReductionStrategy::Deterministic) {
+        computeProperties.insert(old::DeterministicReduce);
+      }
+    }
 
-    content->assembleFunc = old::lower(assignment, "assemble", assembleProperties,
-                                       getAllocSize());
-    content->computeFunc  = old::lower(assignment, "compute", computeProperties,
-                                       getAllocSize());
+    if (isBlocked) {
+      assembleProperties.insert(old::UnrollBlocks);
+      computeProperties.insert(old::UnrollBlocks);
+    }
+
+    content->assembleFunc = old::lower(blockedAssignment, "assemble",
+                                       assembleProperties, getAllocSize());
+    content->computeFunc  = old::lower(blockedAssignment, "compute",
+                                       computeProperties, getAllocSize());
   }
-  content->module->addFunction(content->assembleFunc);
-  content->module->addFunction(content->computeFunc);
-  content->module->compile();
+  shared_ptr<Module> module = make_shared<Module>();
+  module->addFunction(content->assembleFunc);
+  module->addFunction(content->computeFunc);
+  content->module = module;
+  if (async) {
+    content->compiled =
+        ir::getCompilePool().submit([module]() { module->compile(); });
+  }
+  else {
+    module->compile();
+    content->compiled = shared_future<void>();
+  }
+
+  lock_guard<mutex> lock(compileCacheMutex);
+  compileCache[cacheKey.str()] = {content->assembleFunc, content->computeFunc,
+                                  content->module, content->compiled};
+  compileCacheStats.size = compileCache.size();
+  return content->compiled;
+}
+
+void TensorBase::waitForCompile() const {
+  if (content->computeShim != nullptr) {
+    return;
+  }
+  if (content->compiled.valid()) {
+    content->compiled.get();
+  }
+  content->assembleShim = content->module->getFuncPtr("_shim_assemble");
+  content->computeShim = content->module->getFuncPtr("_shim_compute");
+}
+
+CompileCacheStats getCompileCacheStats() {
+  lock_guard<mutex> lock(compileCacheMutex);
+  return compileCacheStats;
+}
+
+void clearCompileCache() {
+  lock_guard<mutex> lock(compileCacheMutex);
+  compileCache.clear();
+  compileCacheStats = {0, 0, 0};
 }
 
 taco_tensor_t* TensorBase::getTacoTensorT() {
@@ -433,30 +1000,72 @@ taco_tensor_t* TensorBase::getTacoTensorT() {
 }
 
 static size_t unpackTensorData(const taco_tensor_t& tensorData,
-                               const TensorBase& tensor) {
-  auto storage = tensor.getStorage();
+                               TensorStorage storage) {
   auto format = storage.getFormat();
 
   vector<ModeIndex> modeIndices;
   size_t numVals = 1;
-  for (int i = 0; i < tensor.getOrder(); i++) {
+  for (int i = 0; i < storage.getOrder(); i++) {
     ModeFormat modeType = format.getModeFormats()[i];
     if (modeType == Dense) {
-      Array size = makeArray({*(int*)tensorData.indices[i][0]});
+      Datatype sizeType = format.getCoordinateTypePos(i);
+      Array size = makeArray(sizeType, 1);
+      memcpy(size.getData(), tensorData.indices[i][0],
+             sizeType.getNumBytes());
       modeIndices.push_back(ModeIndex({size}));
-      numVals *= ((int*)tensorData.indices[i][0])[0];
-    } else if (modeType == Sparse) {
-      auto size = ((int*)tensorData.indices[i][0])[numVals];
-      Array pos = Array(type<int>(), tensorData.indices[i][0], numVals+1, Array::UserOwns);
-      Array idx = Array(type<int>(), tensorData.indices[i][1], size, Array::UserOwns);
+      numVals *= size.get(0).getAsIndex();
+    } else if (modeType.getName() == Compressed.getName()) {
+      Array pos = Array(format.getCoordinateTypePos(i),
+                        tensorData.indices[i][0], numVals+1, Array::UserOwns);
+      auto size = pos.get(numVals).getAsIndex();
+      Array idx = Array(format.getCoordinateTypeIdx(i),
+                        tensorData.indices[i][1], size, Array::UserOwns);
       modeIndices.push_back(ModeIndex({pos, idx}));
       numVals = size;
+    } else if (modeType.getName() == Permuted.getName()) {
+      // The rows of reshaped views stay those of the sliced tensor
+      const ModeIndex& modeIndex = storage.getIndex().getModeIndex(i);
+      modeIndices.push_back(modeIndex);
+      numVals = modeIndex.getIndexArray(0).get(0).getAsIndex();
+    } else if (modeType.getName() == Singleton.getName()) {
+      Array idx = Array(format.getCoordinateTypeIdx(i),
+                        tensorData.indices[i][0], numVals, Array::UserOwns);
+      modeIndices.push_back(ModeIndex({idx}));
+    } else if (modeType.getName() == Hashed.getName()) {
+      Datatype sizeType = format.getCoordinateTypePos(i);
+      Array size = makeArray(sizeType, 1);
+      memcpy(size.getData(), tensorData.indices[i][0],
+             sizeType.getNumBytes());
+      numVals *= size.get(0).getAsIndex();
+      Array idx = Array(format.getCoordinateTypeIdx(i),
+                        tensorData.indices[i][1], numVals, Array::UserOwns);
+      modeIndices.push_back(ModeIndex({size, idx}));
     } else {
       taco_not_supported_yet;
     }
   }
+  // Every position of the last level of a blocked format stores a block
+  for (int blockSize : format.getBlockSizes()) {
+    numVals *= blockSize;
+  }
   storage.setIndex(Index(format, modeIndices));
-  storage.setValues(Array(tensor.getComponentType(), tensorData.vals, numVals));
+  storage.setValues(Array(storage.getComponentType(), tensorData.vals,
+                          numVals));
+  return numVals;
+}
+
+/// Unpacks the result of a kernel through the view it was passed as, if the
+/// kernel sees the result reshaped.
+static size_t unpackResult(const taco_tensor_t& tensorData,
+                           const TensorBase& tensor,
+                           const map<size_t,TensorStorage>& views) {
+  TensorStorage storage = tensor.getStorage();
+  if (views.count(0) == 0) {
+    return unpackTensorData(tensorData, storage);
+  }
+  const TensorStorage& view = views.at(0);
+  size_t numVals = unpackTensorData(tensorData, view);
+  storage.setValues(view.getValues());
   return numVals;
 }
 
@@ -479,69 +1088,99 @@ static inline vector<TensorBase> getTensors(const IndexExpr& expr) {
   return getOperands.operands;
 }
 
-static inline
-vector<void*> packArguments(const TensorBase& tensor) {
-  vector<void*> arguments;
-
-  // Pack the result tensor
-  arguments.push_back(tensor.getStorage());
+void** TensorBase::packArguments() const {
+  // The operands are collected on first use, as assignments built from
+  // tensor variables alone (e.g. by the command-line tool) have no operand
+  // tensors to collect and are invoked with explicit arguments.
+  vector<void*>& arguments = content->arguments;
+  if (arguments.empty()) {
+    content->operands = getTensors(getAssignment().getRhs());
+    arguments.resize(content->operands.size() + 1);
+  }
 
-  // Pack operand tensors
-  auto operands = getTensors(tensor.getAssignment().getRhs());
-  for (auto& operand : operands) {
-    arguments.push_back(operand.getStorage());
+  // Pack the result tensor and operand tensors, through reshaped views of
+  // those the kernels see reshaped
+  content->views.clear();
+  for (size_t i = 0; i < arguments.size(); i++) {
+    const TensorBase& tensor = (i == 0) ? *this : content->operands[i - 1];
+    auto reshaped = content->reshapes.find(tensor.getTensorVar());
+    if (reshaped == content->reshapes.end()) {
+      arguments[i] = tensor.getStorage();
+      continue;
+    }
+    const Reshape& reshape = reshaped->second;
+    int numRows = 0;
+    Array rows;
+    if (reshape.permutedLevel >= 0) {
+      for (auto& operand : content->operands) {
+        if (operand.getTensorVar() == reshape.rows) {
+          numRows = operand.getDimension(0);
+          rows = operand.getStorage().getIndex().getModeIndex(2)
+                                                .getIndexArray(1);
+        }
+      }
+      taco_iassert(rows.getSize() > 0 || numRows == 0);
+    }
+    TensorStorage view = makeReshapedView(tensor.getStorage(), reshape,
+                                          numRows, rows);
+    content->views.insert({i, view});
+    arguments[i] = view;
   }
 
-  return arguments;
+  return arguments.data();
 }
 
 void TensorBase::assemble() {
   taco_uassert(this->content->assembleFunc.defined())
       << error::assemble_without_compile;
+  waitForCompile();
 
-  auto arguments = packArguments(*this);
-  content->module->callFuncPacked("assemble", arguments.data());
+  void** arguments = packArguments();
+  Module::callFuncPtr(content->assembleShim, arguments);
 
   if (!content->assembleWhileCompute) {
     taco_tensor_t* tensorData = ((taco_tensor_t*)arguments[0]);
-    content->valuesSize = unpackTensorData(*tensorData, *this);
+    content->valuesSize = unpackResult(*tensorData, *this, content->views);
   }
 }
 
 void TensorBase::assemble(std::vector<void*> arguments) {
   taco_uassert(this->content->assembleFunc.defined())
       << error::assemble_without_compile;
+  waitForCompile();
 
-  content->module->callFuncPacked("assemble", arguments.data());
+  Module::callFuncPtr(content->assembleShim, arguments.data());
 
   if (!content->assembleWhileCompute) {
     taco_tensor_t* tensorData = ((taco_tensor_t*)arguments[0]);
-    content->valuesSize = unpackTensorData(*tensorData, *this);
+    content->valuesSize = unpackTensorData(*tensorData, getStorage());
   }
 }
 
 void TensorBase::compute() {
   taco_uassert(this->content->computeFunc.defined())
       << error::compute_without_compile;
+  waitForCompile();
 
-  auto arguments = packArguments(*this);
-  this->content->module->callFuncPacked("compute", arguments.data());
+  void** arguments = packArguments();
+  Module::callFuncPtr(content->computeShim, arguments);
 
   if (content->assembleWhileCompute) {
     taco_tensor_t* tensorData = ((taco_tensor_t*)arguments[0]);
-    content->valuesSize = unpackTensorData(*tensorData, *this);
+    content->valuesSize = unpackResult(*tensorData, *this, content->views);
   }
 }
 
 void TensorBase::compute(std::vector<void*> arguments) {
   taco_uassert(this->content->computeFunc.defined())
       << error::compute_without_compile;
+  waitForCompile();
 
-  this->content->module->callFuncPacked("compute", arguments.data());
+  Module::callFuncPtr(content->computeShim, arguments.data());
 
   if (content->assembleWhileCompute) {
     taco_tensor_t* tensorData = ((taco_tensor_t*)arguments[0]);
-    content->valuesSize = unpackTensorData(*tensorData, *this);
+    content->valuesSize = unpackTensorData(*tensorData, getStorage());
   }
 }
 
@@ -562,6 +1201,8 @@ void TensorBase::operator=(const IndexExpr& expr) {
 
 void TensorBase::setAssignment(Assignment assignment) {
   content->assignment = makeReductionNotation(assignment);
+  content->operands.clear();
+  content->arguments.clear();
 }
 
 Assignment TensorBase::getAssignment() const {
@@ -579,6 +1220,7 @@ void TensorBase::printAssembleIR(ostream& os, bool color, bool simplify) const {
 }
 
 string TensorBase::getSource() const {
+  waitForCompile();
   return content->module->getSource();
 }
 
@@ -607,6 +1249,10 @@ void TensorBase::compileSource(std::string source) {
     ss << endl;
     CodeGen_C::generateShim(content->computeFunc, ss);
   }
+  content->module = make_shared<Module>();
+  content->compiled = shared_future<void>();
+  content->assembleShim = nullptr;
+  content->computeShim = nullptr;
   content->module->setSource(source + "\n" + ss.str());
   content->module->compile();
 }
@@ -645,8 +1291,53 @@ bool scalarEquals(std::complex<T> a, std::complex<T> b) {
   return true;
 }
   
+static bool hasUnorderedLevel(const TensorBase& tensor) {
+  // Blocks, sorted slices and diagonals are iterated in the order they are
+  // stored
+  if (tensor.getFormat().isBlocked() || tensor.getFormat().isSliced() ||
+      tensor.getFormat().isDiagonal()) {
+    return true;
+  }
+  for (auto& modeFormat : tensor.getFormat().getModeFormats()) {
+    if (!modeFormat.isOrdered()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/// Compares the nonzero components of tensors that are not iterated in
+/// coordinate order.
+template<typename T>
+bool equalsUnordered(const TensorBase& a, const TensorBase& b) {
+  map<vector<int>,T> bComponents;
+  for (auto& component : iterate<T>(b)) {
+    if (!isZero(component.second)) {
+      vector<int> coord(component.first.begin(), component.first.end());
+      bComponents.insert({coord, component.second});
+    }
+  }
+  for (auto& component : iterate<T>(a)) {
+    if (isZero(component.second)) {
+      continue;
+    }
+    vector<int> coord(component.first.begin(), component.first.end());
+    auto bComponent = bComponents.find(coord);
+    if (bComponent == bComponents.end() ||
+        !scalarEquals(component.second, bComponent->second)) {
+      return false;
+    }
+    bComponents.erase(bComponent);
+  }
+  return bComponents.empty();
+}
+
 template<typename T>
 bool equalsTyped(const TensorBase& a, const TensorBase& b) {
+  if (hasUnorderedLevel(a) || hasUnorderedLevel(b)) {
+    return equalsUnordered<T>(a, b);
+  }
+
   auto at = iterate<T>(a);
   auto bt = iterate<T>(b);
   auto ait = at.begin();
@@ -815,26 +1506,47 @@ TensorBase dispatchRead(T& file, FileType filetype, U format, bool pack) {
     case FileType::rb:
       tensor = readRB(file, format, pack);
       break;
+    case FileType::tbin:
+      tensor = readBinary(file, format, pack);
+      break;
   }
   return tensor;
 }
 
+/// Read a file, decompressing it on a separate thread while it is parsed if it
+/// is compressed with gzip.
+template <typename U>
+TensorBase dispatchReadFile(std::string filename, FileType filetype, U format,
+                            bool pack) {
+  if (util::isGzipPath(filename)) {
+    util::GzipInputStream stream(filename);
+    return dispatchRead(stream, filetype, format, pack);
+  }
+  return dispatchRead(filename, filetype, format, pack);
+}
+
 template <typename U>
 TensorBase dispatchRead(std::string filename, U format, bool pack) {
-  string extension = getExtension(filename);
+  // The file type of compressed files is given by the extension before .gz
+  string extension = util::isGzipPath(filename)
+      ? getExtension(filename.substr(0, filename.find_last_of(".")))
+      : getExtension(filename);
 
   TensorBase tensor;
   if (extension == "ttx") {
-    tensor = dispatchRead(filename, FileType::ttx, format, pack);
+    tensor = dispatchReadFile(filename, FileType::ttx, format, pack);
   }
   else if (extension == "tns") {
-    tensor = dispatchRead(filename, FileType::tns, format, pack);
+    tensor = dispatchReadFile(filename, FileType::tns, format, pack);
   }
   else if (extension == "mtx") {
-    tensor = dispatchRead(filename, FileType::mtx, format, pack);
+    tensor = dispatchReadFile(filename, FileType::mtx, format, pack);
   }
   else if (extension == "rb") {
-    tensor = dispatchRead(filename, FileType::rb, format, pack);
+    tensor = dispatchReadFile(filename, FileType::rb, format, pack);
+  }
+  else if (extension == "tbin") {
+    tensor = dispatchReadFile(filename, FileType::tbin, format, pack);
   }
   else {
     taco_uerror << "File extension not recognized: " << filename << std::endl;
@@ -858,11 +1570,11 @@ TensorBase read(std::string filename, Format format, bool pack) {
 
 TensorBase read(string filename, FileType filetype, ModeFormat modetype, 
                 bool pack) {
-  return dispatchRead(filename, filetype, modetype, pack);
+  return dispatchReadFile(filename, filetype, modetype, pack);
 }
 
 TensorBase read(string filename, FileType filetype, Format format, bool pack) {
-  return dispatchRead(filename, filetype, format, pack);
+  return dispatchReadFile(filename, filetype, format, pack);
 }
 
 TensorBase read(istream& stream, FileType filetype, ModeFormat modetype, 
@@ -887,6 +1599,9 @@ void dispatchWrite(T& file, const TensorBase& tensor, FileType filetype) {
     case FileType::rb:
       writeRB(file, tensor);
       break;
+    case FileType::tbin:
+      writeBinary(file, tensor);
+      break;
   }
 }
 
@@ -907,6 +1622,9 @@ void write(string filename, const TensorBase& tensor) {
   else if (extension == "rb") {
     dispatchWrite(filename, tensor, FileType::rb);
   }
+  else if (extension == "tbin") {
+    dispatchWrite(filename, tensor, FileType::tbin);
+  }
   else {
     taco_uerror << "File extension not recognized: " << filename << std::endl;
   }
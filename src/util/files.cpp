@@ -5,6 +5,19 @@
 #include <iostream>
 #include <fstream>
 #include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
 
 using namespace std;
 
@@ -24,4 +37,166 @@ void openStream(std::fstream& stream, std::string path, fstream::openmode mode)
   taco_uassert(stream.is_open()) << "Error opening file: " << path;
 }
 
+MappedFile::MappedFile(std::string path, bool copyOnWrite)
+    : data(nullptr), size(0) {
+  int fd = open(sanitizePath(path).c_str(), O_RDONLY);
+  taco_uassert(fd != -1) << "Error opening file: " << path;
+  struct stat status;
+  if (fstat(fd, &status) == -1) {
+    close(fd);
+    taco_uerror << "Error reading file: " << path;
+  }
+  size = status.st_size;
+  if (size > 0) {
+    int protection = copyOnWrite ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    void* mapping = mmap(nullptr, size, protection, MAP_PRIVATE, fd, 0);
+    close(fd);
+    taco_uassert(mapping != MAP_FAILED) << "Error mapping file: " << path;
+    data = static_cast<char*>(mapping);
+  }
+  else {
+    close(fd);
+  }
+}
+
+MappedFile::~MappedFile() {
+  if (data != nullptr) {
+    munmap(data, size);
+  }
+}
+
+const char* MappedFile::getData() const {
+  return data;
+}
+
+char* MappedFile::getData() {
+  return data;
+}
+
+size_t MappedFile::getSize() const {
+  return size;
+}
+
+bool isGzipPath(std::string path) {
+  const std::string extension = ".gz";
+  return path.size() > extension.size() &&
+         path.compare(path.size() - extension.size(), extension.size(),
+                      extension) == 0;
+}
+
+bool isGzipSupported() {
+#ifdef USE_ZLIB
+  return true;
+#else
+  return false;
+#endif
+}
+
+#ifdef USE_ZLIB
+/// The number of decompressed bytes handed to the reader at a time
+static const size_t GZIP_BLOCK_SIZE = 1 << 20;
+
+/// The number of decompressed blocks the decompressing thread may get ahead
+/// of the reader
+static const size_t GZIP_MAX_BLOCKS = 4;
+
+/// A stream buffer whose blocks are decompressed on a separate thread and
+/// queued for the reader.
+struct GzipInputStream::Buffer : public std::streambuf {
+  gzFile file;
+  std::string path;
+  std::thread decompressor;
+
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::deque<std::vector<char>> blocks;
+  bool done = false;
+  bool stopping = false;
+  std::string error;
+
+  /// The block that the reader is reading
+  std::vector<char> current;
+
+  Buffer(std::string path) : path(path) {
+    file = gzopen(sanitizePath(path).c_str(), "rb");
+    taco_uassert(file != nullptr) << "Error opening file: " << path;
+    gzbuffer(file, 1 << 17);
+    decompressor = std::thread([this]() { decompress(); });
+  }
+
+  ~Buffer() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    changed.notify_all();
+    decompressor.join();
+    gzclose(file);
+  }
+
+  void decompress() {
+    while (true) {
+      std::vector<char> block(GZIP_BLOCK_SIZE);
+      int size = gzread(file, block.data(), (unsigned)block.size());
+
+      std::unique_lock<std::mutex> lock(mutex);
+      if (size <= 0) {
+        // Files that end early read as if they ended normally, and report it
+        // as an error
+        int code;
+        const char* message = gzerror(file, &code);
+        if (code != Z_OK) {
+          error = message;
+        }
+        done = true;
+        changed.notify_all();
+        return;
+      }
+      block.resize(size);
+      changed.wait(lock, [this]() {
+        return stopping || blocks.size() < GZIP_MAX_BLOCKS;
+      });
+      if (stopping) {
+        return;
+      }
+      blocks.push_back(std::move(block));
+      changed.notify_all();
+    }
+  }
+
+  int_type underflow() {
+    if (gptr() < egptr()) {
+      return traits_type::to_int_type(*gptr());
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this]() { return !blocks.empty() || done; });
+    if (blocks.empty()) {
+      taco_uassert(error.empty()) << "Error decompressing file " << path
+                                  << ": " << error;
+      return traits_type::eof();
+    }
+    current = std::move(blocks.front());
+    blocks.pop_front();
+    changed.notify_all();
+    setg(current.data(), current.data(), current.data() + current.size());
+    return traits_type::to_int_type(*gptr());
+  }
+};
+#else
+struct GzipInputStream::Buffer : public std::streambuf {
+  Buffer(std::string path) {
+    taco_uerror << "Reading gzip files requires taco to be built with zlib: "
+                << path;
+  }
+};
+#endif
+
+GzipInputStream::GzipInputStream(std::string path)
+    : std::istream(nullptr), buffer(new Buffer(path)) {
+  rdbuf(buffer.get());
+}
+
+GzipInputStream::~GzipInputStream() {
+}
+
 }}
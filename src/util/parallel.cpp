@@ -0,0 +1,33 @@
+#include "taco/util/parallel.h"
+
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+namespace taco {
+namespace util {
+
+size_t getNumThreads(size_t n, size_t grain) {
+  size_t numCores = max(thread::hardware_concurrency(), 1u);
+  return max(min(numCores, n / grain), (size_t)1);
+}
+
+void parallelBlocks(size_t n, size_t numThreads,
+                    const function<void(size_t,size_t,size_t)>& f) {
+  if (numThreads == 1) {
+    f(0, 0, n);
+    return;
+  }
+  vector<thread> threads;
+  for (size_t t = 0; t < numThreads; t++) {
+    threads.push_back(thread(f, t, n * t / numThreads,
+                             n * (t + 1) / numThreads));
+  }
+  for (auto& worker : threads) {
+    worker.join();
+  }
+}
+
+}}
@@ -0,0 +1,56 @@
+#include "taco/util/thread_pool.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace taco {
+namespace util {
+
+ThreadPool::ThreadPool(size_t numThreads) : stopping(false) {
+  numThreads = max(numThreads, (size_t)1);
+  for (size_t i = 0; i < numThreads; i++) {
+    workers.push_back(thread([this]() { work(); }));
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  available.notify_all();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+size_t ThreadPool::getNumThreads() const {
+  return workers.size();
+}
+
+void ThreadPool::enqueue(function<void()> task) {
+  {
+    lock_guard<std::mutex> lock(mutex);
+    tasks.push_back(task);
+  }
+  available.notify_one();
+}
+
+void ThreadPool::work() {
+  while (true) {
+    function<void()> task;
+    {
+      unique_lock<std::mutex> lock(mutex);
+      available.wait(lock, [this]() { return stopping || !tasks.empty(); });
+      if (tasks.empty()) {
+        return;
+      }
+      task = tasks.front();
+      tasks.pop_front();
+    }
+    task();
+  }
+}
+
+}}
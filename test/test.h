@@ -67,16 +67,10 @@ void ASSERT_COMPONENTS_EQUALS(vector<vector<vector<int>>> expectedIndices,
   auto storage = actual.getStorage();
 
   auto index = storage.getIndex();
-  for (int i=0; i < storage.getFormat().getOrder(); ++i) {
+  for (int i=0; i < index.getFormat().getOrder(); ++i) {
     auto modeIndex = index.getModeIndex(i);
-    auto modeType = storage.getFormat().getModeFormats()[i];
-    if (modeType == ModeFormat::Dense) {
-      taco_iassert(expectedIndices[i].size() == 1);
-      ASSERT_EQ(1, modeIndex.numIndexArrays());
-      auto size = modeIndex.getIndexArray(0);
-      ASSERT_ARRAY_EQ(expectedIndices[i][0],
-                      {(int*)size.getData(), size.getSize()});
-    } else if (modeType == ModeFormat::Sparse) {
+    auto modeType = index.getFormat().getModeFormats()[i];
+    if (modeType == ModeFormat::Sparse) {
       taco_iassert(expectedIndices[i].size() == 2);
       ASSERT_EQ(2, modeIndex.numIndexArrays());
       auto pos = modeIndex.getIndexArray(0);
@@ -85,6 +79,14 @@ void ASSERT_COMPONENTS_EQUALS(vector<vector<vector<int>>> expectedIndices,
                       {(int*)pos.getData(), pos.getSize()});
       ASSERT_ARRAY_EQ(expectedIndices[i][1],
                       {(int*)idx.getData(), idx.getSize()});
+    } else {
+      ASSERT_EQ(expectedIndices[i].size(),
+                (size_t)modeIndex.numIndexArrays());
+      for (int j = 0; j < modeIndex.numIndexArrays(); j++) {
+        auto array = modeIndex.getIndexArray(j);
+        ASSERT_ARRAY_EQ(expectedIndices[i][j],
+                        {(int*)array.getData(), array.getSize()});
+      }
     }
   }
 
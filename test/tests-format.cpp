@@ -72,3 +72,578 @@ TEST(format, dense) {
   A.pack();
   ASSERT_COMPONENTS_EQUALS({{{3}}, {{3}}}, {0,2,0, 0,0,0, 3,0,4}, A);
 }
+
+TEST(format, coo) {
+  Tensor<double> A("A", {2,3,4}, COO(3));
+  A.insert({1,2,0}, 3.0);
+  A.insert({0,1,3}, 1.0);
+  A.insert({0,1,1}, 2.0);
+  A.insert({1,0,0}, 4.0);
+  A.pack();
+  ASSERT_COMPONENTS_EQUALS({{{0,4}, {0,0,1,1}}, {{1,1,0,2}}, {{1,3,0,0}}},
+                           {2,1,4,3}, A);
+
+  Tensor<double> expected("expected", {2,3,4}, Format({Sparse,Sparse,Sparse}));
+  expected.insert({0,1,1}, 2.0);
+  expected.insert({0,1,3}, 1.0);
+  expected.insert({1,0,0}, 4.0);
+  expected.insert({1,2,0}, 3.0);
+  expected.pack();
+  ASSERT_TRUE(equals(expected, A));
+}
+
+TEST(format, coo_compute) {
+  IndexVar i, j, k;
+  Tensor<double> B("B", {3,4}, COO(2));
+  B.insert({0,1}, 1.0);
+  B.insert({0,3}, 2.0);
+  B.insert({2,0}, 3.0);
+  B.insert({2,2}, 4.0);
+  B.pack();
+
+  Tensor<double> C("C", {3,4}, COO(2));
+  C.insert({0,3}, 5.0);
+  C.insert({1,2}, 6.0);
+  C.pack();
+
+  Tensor<double> c("c", {4}, Format({Dense}));
+  for (int k = 0; k < 4; k++) {
+    c.insert({k}, (double)(k + 1));
+  }
+  c.pack();
+
+  // Consume a COO matrix
+  Tensor<double> a("a", {3}, Format({Dense}));
+  a(i) = B(i,j) * c(j);
+  a.evaluate();
+
+  Tensor<double> expectedA("expectedA", {3}, Format({Dense}));
+  expectedA.insert({0}, 10.0);
+  expectedA.insert({2}, 15.0);
+  expectedA.pack();
+  ASSERT_TRUE(equals(expectedA, a));
+
+  // Merge two COO matrices into a CSR matrix and into a COO matrix
+  Tensor<double> expected("expected", {3,4}, CSR);
+  expected.insert({0,1}, 1.0);
+  expected.insert({0,3}, 7.0);
+  expected.insert({1,2}, 6.0);
+  expected.insert({2,0}, 3.0);
+  expected.insert({2,2}, 4.0);
+  expected.pack();
+
+  Tensor<double> D("D", {3,4}, CSR);
+  D(i,j) = B(i,j) + C(i,j);
+  D.evaluate();
+  ASSERT_TRUE(equals(expected, D));
+
+  Tensor<double> E("E", {3,4}, COO(2));
+  E(i,j) = B(i,j) + C(i,j);
+  E.evaluate();
+  ASSERT_TRUE(equals(expected, E));
+  ASSERT_COMPONENTS_EQUALS({{{0,5}, {0,0,1,2,2}}, {{1,3,2,0,2}}},
+                           {1,7,6,3,4}, E);
+}
+
+TEST(format, hashed) {
+  Tensor<double> A("A", {3,8}, Format({Dense,Hashed}));
+  A.insert({0,5}, 2.0);
+  A.insert({0,1}, 1.0);
+  A.insert({2,6}, 5.0);
+  A.insert({2,2}, 3.0);
+  A.insert({2,3}, 4.0);
+  A.pack();
+
+  // Tables are twice as wide as the largest row, and the 6 in the last row
+  // wraps around to the first bucket of its table
+  ASSERT_COMPONENTS_EQUALS({{{3}},
+                            {{6}, {-1,1,-1,-1,-1,5, -1,-1,-1,-1,-1,-1,
+                                   6,-1,2,3,-1,-1}}},
+                           {0,1,0,0,0,2, 0,0,0,0,0,0, 5,0,3,4,0,0}, A);
+
+  Tensor<double> expected("expected", {3,8}, CSR);
+  expected.insert({0,1}, 1.0);
+  expected.insert({0,5}, 2.0);
+  expected.insert({2,2}, 3.0);
+  expected.insert({2,3}, 4.0);
+  expected.insert({2,6}, 5.0);
+  expected.pack();
+  ASSERT_TRUE(equals(expected, A));
+}
+
+TEST(format, hashed_compute) {
+  IndexVar i, j;
+  Tensor<double> H("H", {3,8}, Format({Dense,Hashed}));
+  H.insert({0,1}, 1.0);
+  H.insert({0,5}, 2.0);
+  H.insert({2,2}, 3.0);
+  H.insert({2,3}, 4.0);
+  H.insert({2,6}, 5.0);
+  H.pack();
+
+  Tensor<double> B("B", {3,8}, CSR);
+  B.insert({0,0}, 1.0);
+  B.insert({0,5}, 2.0);
+  B.insert({1,4}, 3.0);
+  B.insert({2,6}, 4.0);
+  B.pack();
+
+  Tensor<double> c("c", {8}, Format({Dense}));
+  for (int j = 0; j < 8; j++) {
+    c.insert({j}, (double)(j + 1));
+  }
+  c.pack();
+
+  // Iterate over the buckets of a hashed level
+  Tensor<double> a("a", {3}, Format({Dense}));
+  a(i) = H(i,j) * c(j);
+  a.evaluate();
+
+  Tensor<double> expectedA("expectedA", {3}, Format({Dense}));
+  expectedA.insert({0}, 14.0);
+  expectedA.insert({2}, 60.0);
+  expectedA.pack();
+  ASSERT_TRUE(equals(expectedA, a));
+
+  // Locate into a hashed level while iterating over a compressed level, and
+  // insert into a hashed result
+  Tensor<double> expected("expected", {3,8}, CSR);
+  expected.insert({0,5}, 4.0);
+  expected.insert({2,6}, 20.0);
+  expected.pack();
+
+  Tensor<double> D("D", {3,8}, CSR);
+  D(i,j) = B(i,j) * H(i,j);
+  D.evaluate();
+  ASSERT_TRUE(equals(expected, D));
+
+  Tensor<double> E("E", {3,8}, Format({Dense,Hashed}));
+  E(i,j) = B(i,j) * H(i,j);
+  E.evaluate();
+  ASSERT_TRUE(equals(expected, E));
+}
+
+TEST(format, bcsr) {
+  Tensor<double> A("A", {4,6}, BCSR(2,3));
+  A.insert({0,0}, 1.0);
+  A.insert({0,2}, 2.0);
+  A.insert({1,1}, 3.0);
+  A.insert({3,5}, 5.0);
+  A.insert({2,4}, 4.0);
+  A.insert({3,3}, 6.0);
+  A.pack();
+
+  // The levels store the coordinates of the two nonzero 2x3 blocks, and the
+  // blocks are stored row-major with their zeros
+  ASSERT_COMPONENTS_EQUALS({{{2}}, {{0,1,2}, {0,1}}},
+                           {1,0,2, 0,3,0, 0,4,0, 6,0,5}, A);
+
+  Tensor<double> expected("expected", {4,6}, CSR);
+  expected.insert({0,0}, 1.0);
+  expected.insert({0,2}, 2.0);
+  expected.insert({1,1}, 3.0);
+  expected.insert({2,4}, 4.0);
+  expected.insert({3,3}, 6.0);
+  expected.insert({3,5}, 5.0);
+  expected.pack();
+  ASSERT_TRUE(equals(expected, A));
+
+  // Blocks tile the modes, also of storage mapped from files
+  ASSERT_DEATH(Tensor<double>("B", {5,6}, BCSR(2,3)),
+               "Mode 0 has dimension 5, which is not a multiple of its block "
+               "size 2");
+  ASSERT_DEATH(TensorStorage(Float64, {4,7}, BCSR(2,3)),
+               "Mode 1 has dimension 7, which is not a multiple of its block "
+               "size 3");
+}
+
+TEST(format, bcsr_compute) {
+  IndexVar i, j;
+  Tensor<double> A("A", {4,6}, BCSR(2,3));
+  Tensor<double> B("B", {4,6}, CSR);
+  for (auto& component : std::vector<std::pair<std::vector<int>,double>>{
+           {{0,0}, 1.0}, {{0,2}, 2.0}, {{1,1}, 3.0},
+           {{2,4}, 4.0}, {{3,3}, 6.0}, {{3,5}, 5.0}}) {
+    A.insert(component.first, component.second);
+    B.insert(component.first, component.second);
+  }
+  A.pack();
+  B.pack();
+
+  Tensor<double> x("x", {6}, Format({Dense}));
+  for (int j = 0; j < 6; j++) {
+    x.insert({j}, (double)(j + 1));
+  }
+  x.pack();
+
+  // The dense vectors are split into blocks to match the blocks of A
+  Tensor<double> expectedY("expectedY", {4}, Format({Dense}));
+  expectedY(i) = B(i,j) * x(j);
+  expectedY.evaluate();
+
+  Tensor<double> y("y", {4}, Format({Dense}));
+  y(i) = A(i,j) * x(j);
+  y.evaluate();
+  ASSERT_TRUE(equals(expectedY, y));
+
+  // Blocked results have the blocks of their operands
+  Tensor<double> expected("expected", {4,6}, CSR);
+  expected(i,j) = B(i,j) * 2.0;
+  expected.evaluate();
+
+  Tensor<double> C("C", {4,6}, BCSR(2,3));
+  C(i,j) = A(i,j) * 2.0;
+  C.evaluate();
+  ASSERT_TRUE(equals(expected, C));
+  ASSERT_COMPONENTS_EQUALS({{{2}}, {{0,1,2}, {0,1}}},
+                           {2,0,4, 0,6,0, 0,8,0, 12,0,10}, C);
+}
+
+TEST(format, sell) {
+  Tensor<double> A("A", {5,6}, SELL(2,4));
+  A.insert({0,1}, 1.0);
+  A.insert({1,0}, 2.0);
+  A.insert({1,2}, 3.0);
+  A.insert({1,5}, 4.0);
+  A.insert({3,3}, 5.0);
+  A.insert({3,4}, 6.0);
+  A.insert({4,5}, 7.0);
+  A.pack();
+
+  // The first four rows are sorted by length into rows 1,3,0,2, the last
+  // slice is padded with an empty row, and every slice stores its rows
+  // column-major in as many slots as its longest row
+  ASSERT_COMPONENTS_EQUALS({{{3}}, {{0,3,4,5}},
+                            {{2}, {1,3,0,2,4,-1}, {3,2,1,0,1,0}},
+                            {{0,3,2,4,5,0,1,0,5,0}}},
+                           {2,5,3,6,4,0,1,0,7,0}, A);
+
+  Tensor<double> expected("expected", {5,6}, CSR);
+  expected.insert({0,1}, 1.0);
+  expected.insert({1,0}, 2.0);
+  expected.insert({1,2}, 3.0);
+  expected.insert({1,5}, 4.0);
+  expected.insert({3,3}, 5.0);
+  expected.insert({3,4}, 6.0);
+  expected.insert({4,5}, 7.0);
+  expected.pack();
+  ASSERT_TRUE(equals(expected, A));
+}
+
+TEST(format, sell_compute) {
+  IndexVar i, j;
+  Tensor<double> B("B", {5,6}, CSR);
+  Tensor<double> A("A", {5,6}, SELL(2,4));
+  Tensor<double> E("E", {5,6}, ELL());
+  for (auto& component : std::vector<std::pair<std::vector<int>,double>>{
+           {{0,1}, 1.0}, {{1,0}, 2.0}, {{1,2}, 3.0}, {{1,5}, 4.0},
+           {{3,3}, 5.0}, {{3,4}, 6.0}, {{4,5}, 7.0}}) {
+    B.insert(component.first, component.second);
+    A.insert(component.first, component.second);
+    E.insert(component.first, component.second);
+  }
+  B.pack();
+  A.pack();
+  E.pack();
+
+  Tensor<double> x("x", {6}, Format({Dense}));
+  for (int j = 0; j < 6; j++) {
+    x.insert({j}, (double)(j + 1));
+  }
+  x.pack();
+
+  Tensor<double> expectedY("expectedY", {5}, Format({Dense}));
+  expectedY(i) = B(i,j) * x(j);
+  expectedY.evaluate();
+
+  // Results indexed by the rows of sorted slices are located through the
+  // rows the slices store, which skip the row that pads the last slice
+  Tensor<double> y("y", {5}, Format({Dense}));
+  y(i) = A(i,j) * x(j);
+  y.evaluate();
+  ASSERT_TRUE(equals(expectedY, y));
+  ASSERT_NE(std::string::npos, y.getSource().find("y2_rows["));
+
+  Tensor<double> z("z", {5}, Format({Dense}));
+  z(i) = E(i,j) * x(j);
+  z.evaluate();
+  ASSERT_TRUE(equals(expectedY, z));
+
+  // Operands indexed by the rows of sorted slices are located the same way
+  Tensor<double> w("w", {5}, Format({Dense}));
+  for (int i = 0; i < 5; i++) {
+    w.insert({i}, (double)(i + 1));
+  }
+  w.pack();
+
+  Tensor<double> expectedV("expectedV", {6}, Format({Dense}));
+  expectedV(j) = B(i,j) * w(i);
+  expectedV.evaluate();
+
+  Tensor<double> v("v", {6}, Format({Dense}));
+  v(j) = A(i,j) * w(i);
+  v.evaluate();
+  ASSERT_TRUE(equals(expectedV, v));
+  ASSERT_NE(std::string::npos, v.getSource().find("w2_rows["));
+
+  // Results with more modes than the rows store all the components of every
+  // row, also when they are assembled while they are computed
+  IndexVar k;
+  Tensor<double> X("X", {6,3}, Format({Dense,Dense}));
+  for (int j = 0; j < 6; j++) {
+    for (int k = 0; k < 3; k++) {
+      X.insert({j,k}, (double)(j * 3 + k + 1));
+    }
+  }
+  X.pack();
+
+  Tensor<double> expectedZ("expectedZ", {5,3}, Format({Dense,Dense}));
+  expectedZ(i,k) = B(i,j) * X(j,k);
+  expectedZ.evaluate();
+
+  Tensor<double> Z("Z", {5,3}, Format({Dense,Dense}));
+  Z(i,k) = A(i,j) * X(j,k);
+  Z.compile(true);
+  Z.compute();
+  ASSERT_TRUE(equals(expectedZ, Z));
+  ASSERT_EQ(15u, Z.getStorage().getValues().getSize());
+}
+
+TEST(format, dia) {
+  Tensor<double> A("A", {4,5}, DIA());
+  A.insert({0,0}, 1.0);
+  A.insert({1,1}, 2.0);
+  A.insert({2,2}, 3.0);
+  A.insert({3,3}, 4.0);
+  A.insert({0,1}, 5.0);
+  A.insert({2,3}, 6.0);
+  A.insert({3,4}, 7.0);
+  A.insert({2,0}, 8.0);
+  A.pack();
+
+  // The diagonals with offsets -2, 0 and 1 store a component per row, where
+  // the rows they do not cross store zeros
+  ASSERT_COMPONENTS_EQUALS({{{3}}, {{4}, {-2,0,1}}, {{-2,0,1}}},
+                           {0,0,8,0, 1,2,3,4, 5,0,6,7}, A);
+
+  Tensor<double> expected("expected", {4,5}, CSR);
+  expected.insert({0,0}, 1.0);
+  expected.insert({0,1}, 5.0);
+  expected.insert({1,1}, 2.0);
+  expected.insert({2,0}, 8.0);
+  expected.insert({2,2}, 3.0);
+  expected.insert({2,3}, 6.0);
+  expected.insert({3,3}, 4.0);
+  expected.insert({3,4}, 7.0);
+  expected.pack();
+  ASSERT_TRUE(equals(expected, A));
+}
+
+TEST(format, dia_compute) {
+  IndexVar i, j;
+  Tensor<double> B("B", {4,5}, CSR);
+  Tensor<double> A("A", {4,5}, DIA());
+  for (auto& component : std::vector<std::pair<std::vector<int>,double>>{
+           {{0,0}, 1.0}, {{0,1}, 5.0}, {{1,1}, 2.0}, {{2,0}, 8.0},
+           {{2,2}, 3.0}, {{2,3}, 6.0}, {{3,3}, 4.0}, {{3,4}, 7.0}}) {
+    B.insert(component.first, component.second);
+    A.insert(component.first, component.second);
+  }
+  B.pack();
+  A.pack();
+
+  Tensor<double> x("x", {5}, Format({Dense}));
+  for (int j = 0; j < 5; j++) {
+    x.insert({j}, (double)(j + 1));
+  }
+  x.pack();
+
+  // The columns of the components are computed from the offsets of their
+  // diagonals
+  Tensor<double> expected("expected", {4}, Format({Dense}));
+  expected(i) = B(i,j) * x(j);
+  expected.evaluate();
+
+  Tensor<double> y("y", {4}, Format({Dense}));
+  y(i) = A(i,j) * x(j);
+  y.evaluate();
+  ASSERT_TRUE(equals(expected, y));
+}
+
+TEST(format, bitmap) {
+  Tensor<double> A("A", {3,70}, Format({Dense,Bitmap}));
+  A.insert({0,5}, 2.0);
+  A.insert({0,1}, 1.0);
+  A.insert({2,66}, 4.0);
+  A.insert({2,2}, 3.0);
+  A.pack();
+
+  // Every row stores two words, and the positions of their first set bits
+  auto modeIndex = A.getStorage().getIndex().getModeIndex(1);
+  ASSERT_EQ(2, modeIndex.numIndexArrays());
+  auto pos = modeIndex.getIndexArray(0);
+  auto bits = modeIndex.getIndexArray(1);
+  ASSERT_ARRAY_EQ<int>({0,2,2,2,2,3,4}, {(int*)pos.getData(), pos.getSize()});
+  ASSERT_ARRAY_EQ<uint64_t>({(1ull<<1)|(1ull<<5),0ull, 0ull,0ull, 1ull<<2,1ull<<2},
+                  {(uint64_t*)bits.getData(), bits.getSize()});
+  ASSERT_ARRAY_EQ<double>({1.0,2.0,3.0,4.0},
+                  {(double*)A.getStorage().getValues().getData(),
+                   (size_t)A.getStorage().getIndex().getSize()});
+
+  Tensor<double> expected("expected", {3,70}, CSR);
+  expected.insert({0,1}, 1.0);
+  expected.insert({0,5}, 2.0);
+  expected.insert({2,2}, 3.0);
+  expected.insert({2,66}, 4.0);
+  expected.pack();
+  ASSERT_TRUE(equals(expected, A));
+}
+
+TEST(format, bitmap_compute) {
+  IndexVar i, j;
+  Tensor<double> a("a", {100}, Format({Bitmap}));
+  Tensor<double> b("b", {100}, Format({Bitmap}));
+  Tensor<double> c("c", {100}, Format({Sparse}));
+  Tensor<double> sa("sa", {100}, Format({Sparse}));
+  Tensor<double> sb("sb", {100}, Format({Sparse}));
+  for (int i = 0; i < 100; i += 3) {
+    a.insert({i}, (double)(i + 1));
+    sa.insert({i}, (double)(i + 1));
+  }
+  for (int i = 0; i < 100; i += 5) {
+    b.insert({i}, (double)(2 * i));
+    sb.insert({i}, (double)(2 * i));
+    c.insert({i}, (double)(2 * i));
+  }
+  a.pack();
+  b.pack();
+  c.pack();
+  sa.pack();
+  sb.pack();
+
+  // Intersections and unions of bitmap levels iterate over the set bits of
+  // the conjunctions and disjunctions of their words
+  Tensor<double> expected("expected", {100}, Format({Dense}));
+  expected(i) = sa(i) * sb(i);
+  expected.evaluate();
+  Tensor<double> x("x", {100}, Format({Dense}));
+  x(i) = a(i) * b(i);
+  x.evaluate();
+  ASSERT_TRUE(equals(expected, x));
+
+  expected(i) = sa(i) + sb(i);
+  expected.evaluate();
+  x(i) = a(i) + b(i);
+  x.evaluate();
+  ASSERT_TRUE(equals(expected, x));
+
+  expected(i) = sa(i) * sb(i) + sa(i);
+  expected.evaluate();
+  x(i) = a(i) * b(i) + a(i);
+  x.evaluate();
+  ASSERT_TRUE(equals(expected, x));
+
+  // Locate into a bitmap level while iterating over a compressed level
+  expected(i) = sa(i) * c(i);
+  expected.evaluate();
+  x(i) = a(i) * c(i);
+  x.evaluate();
+  ASSERT_TRUE(equals(expected, x));
+
+  Tensor<double> s("s");
+  s = a(i) * b(i);
+  s.evaluate();
+  Tensor<double> expectedS("expectedS");
+  expectedS = sa(i) * sb(i);
+  expectedS.evaluate();
+  ASSERT_TRUE(equals(expectedS, s));
+
+  // Iterate over the words of the rows of a matrix
+  Tensor<double> B("B", {3,127}, CSR);
+  Tensor<double> A("A", {3,127}, Format({Dense,Bitmap}));
+  for (auto& component : std::vector<std::pair<std::vector<int>,double>>{
+           {{0,1}, 1.0}, {{0,5}, 2.0}, {{2,2}, 3.0}, {{2,120}, 4.0}}) {
+    B.insert(component.first, component.second);
+    A.insert(component.first, component.second);
+  }
+  B.pack();
+  A.pack();
+
+  Tensor<double> v("v", {127}, Format({Dense}));
+  for (int j = 0; j < 127; j++) {
+    v.insert({j}, (double)(j + 1));
+  }
+  v.pack();
+
+  Tensor<double> expectedY("expectedY", {3}, Format({Dense}));
+  expectedY(i) = B(i,j) * v(j);
+  expectedY.evaluate();
+  Tensor<double> y("y", {3}, Format({Dense}));
+  y(i) = A(i,j) * v(j);
+  y.evaluate();
+  ASSERT_TRUE(equals(expectedY, y));
+
+  // Locate into the rows of a bitmap matrix
+  Tensor<double> expectedD("expectedD", {3,127}, CSR);
+  expectedD(i,j) = B(i,j) * B(i,j);
+  expectedD.evaluate();
+  Tensor<double> D("D", {3,127}, CSR);
+  D(i,j) = B(i,j) * A(i,j);
+  D.evaluate();
+  ASSERT_TRUE(equals(expectedD, D));
+}
+
+TEST(format, pattern) {
+  Format csrPattern = CSR;
+  csrPattern.setPattern();
+  ASSERT_NE(CSR, csrPattern);
+
+  Tensor<double> A("A", {3,4}, csrPattern);
+  A.insert({0,1}, 1.0);
+  A.insert({2,0}, 1.0);
+  A.insert({2,3}, 1.0);
+  A.pack();
+
+  // Pattern formats store the index but no values
+  ASSERT_ARRAY_EQ<int>({0,1,1,3}, {(int*)A.getStorage().getIndex()
+                                         .getModeIndex(1).getIndexArray(0)
+                                         .getData(), 4});
+  ASSERT_EQ(0u, A.getStorage().getValues().getSize());
+
+  Tensor<double> expected("expected", {3,4}, CSR);
+  expected.insert({0,1}, 1.0);
+  expected.insert({2,0}, 1.0);
+  expected.insert({2,3}, 1.0);
+  expected.pack();
+  ASSERT_TRUE(equals(expected, A));
+
+  // Kernels use one in place of the components of pattern operands
+  IndexVar i, j;
+  Tensor<double> x("x", {4}, Format({Dense}));
+  for (int j = 0; j < 4; j++) {
+    x.insert({j}, (double)(j + 1));
+  }
+  x.pack();
+
+  Tensor<double> expectedY("expectedY", {3}, Format({Dense}));
+  expectedY(i) = expected(i,j) * x(j);
+  expectedY.evaluate();
+  Tensor<double> y("y", {3}, Format({Dense}));
+  y(i) = A(i,j) * x(j);
+  y.evaluate();
+  ASSERT_TRUE(equals(expectedY, y));
+
+  Tensor<double> B("B", {3,4}, CSR);
+  B.insert({0,1}, 2.0);
+  B.insert({1,1}, 3.0);
+  B.insert({2,3}, 4.0);
+  B.pack();
+
+  Tensor<double> expectedC("expectedC", {3,4}, CSR);
+  expectedC(i,j) = expected(i,j) + B(i,j);
+  expectedC.evaluate();
+  Tensor<double> C("C", {3,4}, CSR);
+  C(i,j) = A(i,j) + B(i,j);
+  C.evaluate();
+  ASSERT_TRUE(equals(expectedC, C));
+}
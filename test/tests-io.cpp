@@ -1,6 +1,15 @@
 #include "test.h"
 
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <cstring>
+
 #include "taco/tensor.h"
+#include "taco/storage/file_io_bin.h"
+#include "taco/util/env.h"
+#include "taco/util/files.h"
+#include "storage/text_parser.h"
 
 using namespace taco;
 
@@ -127,3 +136,379 @@ TEST(io, mtxsymmetric) {
 
   ASSERT_TRUE(equals(expected, tensor));
 }
+
+TEST(io, mtxparallel) {
+  // Large enough to be parsed in several chunks.  The tensors are dense so
+  // that their values can be compared directly.
+  const int n = 1000;
+  std::string filename = util::getTmpdir() + "parallel.mtx";
+  std::ofstream file(filename);
+  file << "%%MatrixMarket matrix coordinate real symmetric" << std::endl;
+  file << "% comment" << std::endl;
+  file << n << " " << n << " " << n*200 << std::endl;
+  std::vector<double> expected(n*n, 0.0);
+  for (int i = 0; i < n; i++) {
+    for (int j = i; j < i + 200; j++) {
+      double value = (i + j) * 0.25;
+      file << (j % n) + 1 << " " << i + 1 << " " << value << std::endl;
+      expected[(j % n)*n + i] = value;
+      expected[i*n + (j % n)] = value;
+    }
+  }
+  file.close();
+
+  auto assertValues = [&](const TensorStorage& storage) {
+    ASSERT_EQ(expected.size(), storage.getValues().getSize());
+    ASSERT_EQ(0, memcmp(expected.data(), storage.getValues().getData(),
+                        expected.size() * sizeof(double)));
+  };
+  assertValues(read(filename, Dense).getStorage());
+  assertValues(readToStorage(filename, Format({Dense,Dense})));
+  std::ifstream stream(filename);
+  assertValues(read(stream, FileType::mtx, Dense).getStorage());
+}
+
+TEST(io, tnsparallel) {
+  // Large enough to be parsed in several chunks.  The tensors are dense so
+  // that their values can be compared directly.
+  const int dimensions[] = {60, 50, 40};
+  std::string filename = util::getTmpdir() + "parallel.tns";
+  std::ofstream file(filename);
+  file << "# comment" << std::endl;
+  std::vector<double> expected(dimensions[0]*dimensions[1]*dimensions[2]);
+  for (size_t i = 0; i < expected.size(); i++) {
+    // Write the components in reverse order, with a blank line in between
+    size_t component = expected.size() - 1 - i;
+    expected[component] = component * 0.5;
+    file << component / (dimensions[1]*dimensions[2]) + 1 << " "
+         << component / dimensions[2] % dimensions[1] + 1 << " "
+         << component % dimensions[2] + 1 << " "
+         << expected[component] << std::endl;
+    if (i == expected.size() / 2) {
+      file << std::endl;
+    }
+  }
+  file.close();
+
+  auto assertValues = [&](const TensorStorage& storage) {
+    ASSERT_EQ(std::vector<int>(dimensions, dimensions + 3),
+              storage.getDimensions());
+    ASSERT_EQ(expected.size(), storage.getValues().getSize());
+    ASSERT_EQ(0, memcmp(expected.data(), storage.getValues().getData(),
+                        expected.size() * sizeof(double)));
+  };
+  assertValues(read(filename, Dense).getStorage());
+  assertValues(readToStorage(filename, Format({Dense,Dense,Dense})));
+  std::ifstream stream(filename);
+  assertValues(read(stream, FileType::tns, Dense).getStorage());
+}
+
+TEST(io, gzip) {
+  // Large enough to be decompressed in several blocks
+  const int dimensions[] = {60, 50, 40};
+  std::string filename = util::getTmpdir() + "compressed.tns";
+  std::ofstream file(filename);
+  std::vector<double> expected(dimensions[0]*dimensions[1]*dimensions[2]);
+  for (size_t component = 0; component < expected.size(); component++) {
+    expected[component] = component * 0.5;
+    file << component / (dimensions[1]*dimensions[2]) + 1 << " "
+         << component / dimensions[2] % dimensions[1] + 1 << " "
+         << component % dimensions[2] + 1 << " "
+         << expected[component] << std::endl;
+  }
+  file.close();
+  ASSERT_FALSE(system(("gzip -f " + filename).c_str()));
+  filename += ".gz";
+  if (!util::isGzipSupported()) {
+    ASSERT_DEATH(read(filename, Dense), "requires taco to be built with zlib");
+    return;
+  }
+
+  auto assertValues = [&](const TensorStorage& storage) {
+    ASSERT_EQ(std::vector<int>(dimensions, dimensions + 3),
+              storage.getDimensions());
+    ASSERT_EQ(expected.size(), storage.getValues().getSize());
+    ASSERT_EQ(0, memcmp(expected.data(), storage.getValues().getData(),
+                        expected.size() * sizeof(double)));
+  };
+  TensorBase tensor = read(filename, Dense);
+  ASSERT_EQ("compressed", tensor.getName());
+  assertValues(tensor.getStorage());
+  assertValues(readToStorage(filename, Format({Dense,Dense,Dense})));
+  assertValues(read(filename, FileType::tns, Dense).getStorage());
+
+  std::string mtxFilename = util::getTmpdir() + "compressed.mtx";
+  std::ofstream mtxFile(mtxFilename);
+  mtxFile << "%%MatrixMarket matrix coordinate real general" << std::endl;
+  mtxFile << "2 3 2" << std::endl;
+  mtxFile << "1 3 2.5" << std::endl;
+  mtxFile << "2 1 -1" << std::endl;
+  mtxFile.close();
+  ASSERT_FALSE(system(("gzip -f " + mtxFilename).c_str()));
+  TensorStorage matrix = readToStorage(mtxFilename + ".gz", Dense);
+  ASSERT_EQ(std::vector<int>({2, 3}), matrix.getDimensions());
+  const double expectedMatrix[] = {0, 0, 2.5, -1, 0, 0};
+  ASSERT_EQ(0, memcmp(expectedMatrix, matrix.getValues().getData(),
+                      sizeof(expectedMatrix)));
+
+  // Truncated files are reported while they are read
+  std::string truncated = util::getTmpdir() + "truncated.tns.gz";
+  ASSERT_FALSE(system(("head -c 1000 " + filename + " > " + truncated).c_str()));
+  ASSERT_DEATH(read(truncated, Dense), "Error decompressing file");
+}
+
+TEST(io, lineblocks) {
+  // Blocks end at whole lines, lines that are longer than a block are carried
+  // over until they end, and the last line need not end with a newline
+  const std::string text = "1 2\n3 4 5 6 7 8\n\n9\n10 11";
+  std::istringstream stream(text);
+  std::string parsed;
+  parseLineBlocks(stream, [&](const char* begin, const char* end) {
+    ASSERT_LT(begin, end);
+    std::string block(begin, end);
+    ASSERT_TRUE(block.back() == '\n' || parsed.size() + block.size() ==
+                                        text.size());
+    parsed += block;
+  }, 5);
+  ASSERT_EQ(text, parsed);
+
+  // The entries of a stream are the same when they are parsed a block at a
+  // time as at once
+  EntryParser entries('#', "tns");
+  std::istringstream entryStream("# comment\n1 2 0.5\n3 1 -1\n\n2 2 4");
+  parseLineBlocks(entryStream, [&](const char* begin, const char* end) {
+    entries.parse(begin, end);
+  }, 4);
+  ASSERT_EQ(2u, entries.getOrder());
+  ASSERT_EQ(3u, entries.getSize());
+  ASSERT_EQ(std::vector<long long>({3, 2}), entries.getMaxCoordinates());
+  ParsedComponents components = entries.takeComponents({3, 2});
+  const int expectedRows[] = {0, 2, 1};
+  const double expectedValues[] = {0.5, -1, 4};
+  ASSERT_EQ(0, memcmp(expectedRows, components.coordinates[0].getData(),
+                      sizeof(expectedRows)));
+  ASSERT_EQ(0, memcmp(expectedValues, components.values.getData(),
+                      sizeof(expectedValues)));
+}
+
+TEST(io, rb) {
+  // Dense matrices compare their values directly
+  auto assertDenseEquals = [](const TensorStorage& expected,
+                              const TensorStorage& actual) {
+    ASSERT_EQ(expected.getDimensions(), actual.getDimensions());
+    ASSERT_EQ(expected.getValues().getSize(), actual.getValues().getSize());
+    ASSERT_EQ(0, memcmp(expected.getValues().getData(),
+                        actual.getValues().getData(),
+                        expected.getValues().getSize() * sizeof(double)));
+  };
+  auto assertCompressedEquals = [](const TensorStorage& expected,
+                                   const TensorStorage& actual) {
+    ASSERT_EQ(expected.getDimensions(), actual.getDimensions());
+    for (int i = 0; i < 2; i++) {
+      Array expectedArray =
+          expected.getIndex().getModeIndex(1).getIndexArray(i);
+      Array actualArray = actual.getIndex().getModeIndex(1).getIndexArray(i);
+      ASSERT_EQ(expectedArray.getSize(), actualArray.getSize());
+      ASSERT_EQ(0, memcmp(expectedArray.getData(), actualArray.getData(),
+                          expectedArray.getSize() * sizeof(int)));
+    }
+    ASSERT_EQ(expected.getValues().getSize(), actual.getValues().getSize());
+    ASSERT_EQ(0, memcmp(expected.getValues().getData(),
+                        actual.getValues().getData(),
+                        expected.getValues().getSize() * sizeof(double)));
+  };
+
+  std::string mtxFilename = testDirectory() + "/data/rua_32.mtx";
+  std::string rbFilename = testDirectory() + "/data/rua_32.rb";
+  assertCompressedEquals(readToStorage(mtxFilename, CSC),
+                         readToStorage(rbFilename, CSC));
+  assertCompressedEquals(readToStorage(mtxFilename, CSR),
+                         readToStorage(rbFilename, CSR));
+  assertCompressedEquals(readToStorage(mtxFilename, CSR),
+                         read(rbFilename, CSR).getStorage());
+  assertDenseEquals(readToStorage(mtxFilename, Dense),
+                    read(rbFilename, Dense).getStorage());
+  std::ifstream stream(rbFilename);
+  assertCompressedEquals(readToStorage(mtxFilename, CSC),
+                         readToStorage(stream, FileType::rb, CSC));
+
+  // Files that taco writes separate their fields by blanks
+  TensorBase matrix = read(rbFilename, CSC);
+  std::string filename = util::getTmpdir() + "written.rb";
+  write(filename, matrix);
+  assertCompressedEquals(matrix.getStorage(), readToStorage(filename, CSC));
+
+  // Fixed-width fields need not be separated, and values may have Fortran
+  // exponents
+  filename = util::getTmpdir() + "fixed.rb";
+  std::ofstream file(filename);
+  file << "Fixed-width matrix fixed" << std::endl;
+  file << "5 1 1 3 0" << std::endl;
+  file << "RUA 3 3 5 0" << std::endl;
+  file << "(4I1)           (5I1)           (2D10.3)" << std::endl;
+  file << "1346" << std::endl;
+  file << "13223" << std::endl;
+  file << " 1.000D+00-2.500D-01" << std::endl;
+  file << " 3.000D+00 4.000d+00" << std::endl;
+  file << " 5.000E+00" << std::endl;
+  file.close();
+  const double expected[] = {1, 0, 0, 0, 3, 4, -0.25, 0, 5};
+  TensorStorage dense = readToStorage(filename, Dense);
+  ASSERT_EQ(std::vector<int>({3, 3}), dense.getDimensions());
+  ASSERT_EQ(0, memcmp(expected, dense.getValues().getData(),
+                      sizeof(expected)));
+  TensorStorage csr = readToStorage(filename, CSR);
+  const int expectedPos[] = {0, 1, 3, 5};
+  const int expectedCrd[] = {0, 1, 2, 0, 2};
+  const double expectedVals[] = {1, 3, 4, -0.25, 5};
+  ASSERT_EQ(0, memcmp(expectedPos,
+                      csr.getIndex().getModeIndex(1).getIndexArray(0).getData(),
+                      sizeof(expectedPos)));
+  ASSERT_EQ(0, memcmp(expectedCrd,
+                      csr.getIndex().getModeIndex(1).getIndexArray(1).getData(),
+                      sizeof(expectedCrd)));
+  ASSERT_EQ(0, memcmp(expectedVals, csr.getValues().getData(),
+                      sizeof(expectedVals)));
+}
+
+TEST(io, mtxvalues) {
+  std::vector<std::string> values = {"1", "-2.5", "+.125", "1.5e3", "0.1",
+                                     "1e-300", "17.0000000000000000001",
+                                     "123456789012345678901234", "2.5E-3",
+                                     "-0", "4.9e-324"};
+  std::string filename = util::getTmpdir() + "values.mtx";
+  std::ofstream file(filename);
+  file << "%%MatrixMarket matrix coordinate real general" << std::endl;
+  file << values.size() << " 1 " << values.size() << std::endl;
+  for (size_t i = 0; i < values.size(); i++) {
+    file << i + 1 << "\t1  " << values[i] << "\r" << std::endl;
+  }
+  file.close();
+
+  TensorBase tensor = read(filename, Dense);
+  double* vals = (double*)tensor.getStorage().getValues().getData();
+  for (size_t i = 0; i < values.size(); i++) {
+    ASSERT_EQ(strtod(values[i].c_str(), nullptr), vals[i]);
+  }
+}
+
+TEST(io, mtxmalformed) {
+  auto readLines = [](const std::string& header, const std::string& entry) {
+    std::string filename = util::getTmpdir() + "malformed.mtx";
+    std::ofstream file(filename);
+    file << "%%MatrixMarket matrix coordinate real general" << std::endl;
+    file << header << std::endl;
+    file << entry << std::endl;
+    file.close();
+    return readToStorage(filename, Dense);
+  };
+  ASSERT_EQ(3.0, ((double*)readLines("2 2 1 ", "2 1 3 \r")
+                      .getValues().getData())[2]);
+  ASSERT_DEATH(readLines("2 2 1x", "1 1 1"), "Invalid MatrixMarket header");
+  ASSERT_DEATH(readLines("2 2 1", "1.5 1 1"), "Invalid coordinate");
+  ASSERT_DEATH(readLines("2 2 1", "1 1x 1"), "Invalid coordinate");
+  ASSERT_DEATH(readLines("2 2 1", "1 1 1 1"), "Invalid value");
+  ASSERT_DEATH(readLines("2 2 1", "1 1 1.5x"), "Invalid value");
+}
+
+TEST(io, tnsmalformed) {
+  auto readLines = [](const std::string& entry) {
+    std::string filename = util::getTmpdir() + "malformed.tns";
+    std::ofstream file(filename);
+    file << "1 1 1 1.0" << std::endl;
+    file << entry << std::endl;
+    file.close();
+    return readToStorage(filename, Format({Dense,Dense,Dense}));
+  };
+  ASSERT_EQ(std::vector<int>({2, 1, 3}),
+            readLines("2\t1 3 2.5 \r").getDimensions());
+  ASSERT_DEATH(readLines("1 2 1.5"), "Invalid coordinate in tns entry");
+  ASSERT_DEATH(readLines("1 1x 1 1.0"), "Invalid coordinate in tns entry");
+  ASSERT_DEATH(readLines("1 1 1 1.0 2"), "Invalid value in tns entry");
+  ASSERT_DEATH(readLines("1 1 1 1.0x"), "Invalid value in tns entry");
+}
+
+TEST(io, tbin) {
+  TensorBase csr(Float64, {4,6}, CSR);
+  csr.insert({0, 1}, 1.0);
+  csr.insert({2, 0}, 2.5);
+  csr.insert({2, 4}, -3.0);
+  csr.insert({3, 3}, 4.0);
+  csr.pack();
+
+  TensorBase bcsr(Float64, {4,6}, BCSR(2,2));
+  for (auto& component : iterate<double>(csr)) {
+    bcsr.insert({(int)component.first[0], (int)component.first[1]},
+                component.second);
+  }
+  bcsr.pack();
+
+  for (TensorBase tensor : {csr, bcsr}) {
+    std::string filename = util::getTmpdir() + "tensor.tbin";
+    write(filename, tensor);
+
+    // Read in the same format, with the arrays mapped from the file
+    TensorBase mapped = read(filename, tensor.getFormat());
+    ASSERT_EQ(tensor.getFormat(), mapped.getFormat());
+    ASSERT_TRUE(equals(tensor, mapped));
+    ASSERT_EQ(tensor.getFormat(),
+              readToStorageBinary(filename).getFormat());
+
+    // Read in another format, which repacks the components
+    TensorBase repacked = read(filename, Format({Dense,Dense}));
+    ASSERT_EQ(Format({Dense,Dense}), repacked.getFormat());
+    ASSERT_TRUE(equals(tensor, repacked));
+
+    write(filename + "2", FileType::tbin, tensor);
+    std::ifstream file(filename + "2");
+    ASSERT_TRUE(equals(tensor, read(file, FileType::tbin,
+                                    tensor.getFormat())));
+  }
+
+  // Compute with mapped arrays
+  write(util::getTmpdir() + "csr.tbin", csr);
+  Tensor<double> B = read(util::getTmpdir() + "csr.tbin", CSR);
+  Tensor<double> c({6}, Dense);
+  for (int j = 0; j < 6; j++) {
+    c.insert({j}, 1.0);
+  }
+  c.pack();
+  Tensor<double> a({4}, Dense);
+  IndexVar i, j;
+  a(i) = B(i,j) * c(j);
+  a.evaluate();
+  Tensor<double> expected({4}, Dense);
+  expected.insert({0}, 1.0);
+  expected.insert({2}, -0.5);
+  expected.insert({3}, 4.0);
+  expected.pack();
+  ASSERT_TRUE(equals(expected, a));
+}
+
+TEST(io, tbincorrupt) {
+  TensorBase csr(Float64, {4,6}, CSR);
+  csr.insert({2, 4}, -3.0);
+  csr.pack();
+  std::string filename = util::getTmpdir() + "corrupt.tbin";
+  write(filename, csr);
+
+  // Overwrite a header word, whose index is counted from the end of the
+  // header if it is negative
+  auto corrupt = [&](int word, uint64_t value) {
+    std::fstream file(filename, std::ios::in | std::ios::out |
+                                std::ios::binary);
+    uint64_t numWords;
+    file.seekg(24);
+    file.read((char*)&numWords, sizeof(numWords));
+    file.seekp(32 + 8 * (word < 0 ? numWords + word : word));
+    file.write((const char*)&value, sizeof(value));
+    file.close();
+    return readToStorageBinary(filename);
+  };
+
+  // The number of dimensions exceeds the header
+  ASSERT_DEATH(corrupt(1, 1ull << 62), "Corrupt taco binary tensor header");
+  // The size of the value array overflows when multiplied by its type size
+  write(filename, csr);
+  ASSERT_DEATH(corrupt(-2, 1ull << 61), "Truncated taco binary tensor");
+}
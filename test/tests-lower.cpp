@@ -20,6 +20,8 @@ using taco::Tensor;
 using taco::TensorVar;
 using taco::IndexVar;
 using taco::IndexStmt;
+using taco::ParallelStrategy;
+using taco::ReductionStrategy;
 using taco::IndexExpr;
 using taco::Format;
 using taco::type;
@@ -498,3 +500,119 @@ TEST_STMT(broadcast_scalar_vector_add,
                    {{3},  42.0}, {{4}, 45.0}}}})
   }
 )
+
+TEST_STMT(parallel_vector_neg,
+  forall(i,
+         a(i) = -b(i),
+         ParallelStrategy::Static
+         ),
+  Values(
+         Formats({{a,dense},  {b,dense}}),
+         Formats({{a,dense},  {b,sparse}})
+         ),
+  {
+    TestCase({{b, {{{0},  42.0}, {{3},  4.0}}}},
+             {{a, {{{0}, -42.0}, {{3}, -4.0}}}})
+  }
+)
+
+TEST_STMT(parallel_vector_mul,
+  forall(i,
+         a(i) = b(i) * c(i),
+         ParallelStrategy::Dynamic
+         ),
+  Values(
+         Formats({{a, dense}, {b, dense}, {c, dense}}),
+         Formats({{a, dense}, {b,sparse}, {c, dense}})
+         ),
+  {
+    TestCase({{b, {{{0},  1.0}, {{1},   2.0}, {{3},  3.0}}},
+              {c, {{{1}, 10.0}, {{2},  20.0}, {{4}, 30.0}}}},
+             {{a, {{{1}, 20.0}}}})
+  }
+)
+
+TEST_STMT(parallel_vector_dot,
+  forall(i,
+         alpha += b(i) * c(i),
+         ParallelStrategy::Static
+         ),
+  Values(
+         Formats({{b, dense}, {c, dense}}),
+         Formats({{b,sparse}, {c, dense}})
+         ),
+  {
+    TestCase({{b, {{{0},  1.0}, {{1},   2.0}, {{3},  3.0}}},
+              {c, {{{1}, 10.0}, {{3},  20.0}, {{4}, 30.0}}}},
+             {{alpha, {{{}, 80.0}}}})
+  }
+)
+
+TEST_STMT(parallel_vector_dot_deterministic,
+  forall(i,
+         alpha += b(i) * c(i),
+         ParallelStrategy::Dynamic, ReductionStrategy::Deterministic
+         ),
+  Values(
+         Formats({{b, dense}, {c, dense}}),
+         Formats({{b,sparse}, {c, dense}})
+         ),
+  {
+    TestCase({{b, {{{0},  1.0}, {{1},   2.0}, {{3},  3.0}}},
+              {c, {{{1}, 10.0}, {{3},  20.0}, {{4}, 30.0}}}},
+             {{alpha, {{{}, 80.0}}}})
+  }
+)
+
+TEST_STMT(parallel_matrix_vector_mul,
+  forall(i,
+         forall(j,
+                a(i) += B(i,j) * c(j),
+                ParallelStrategy::Static
+                )),
+  Values(
+         Formats({{a, dense}, {B, Format({dense, dense})},  {c, dense}}),
+         Formats({{a, dense}, {B, Format({dense, sparse})}, {c, dense}})
+         ),
+  {
+    TestCase({{B, {{{0,1},  1.0}, {{0,4},   2.0}, {{3,3},  3.0}}},
+              {c, {{{1}, 10.0}, {{3},  20.0}, {{4}, 30.0}}}},
+             {{a, {{{0}, 70.0}, {{3}, 60.0}}}})
+  }
+)
+
+TEST_STMT(parallel_transposed_matrix_vector_mul,
+  forall(j,
+         forall(i,
+                a(i) += B(j,i) * c(j)
+                ),
+         ParallelStrategy::Static
+         ),
+  Values(
+         Formats({{a, dense}, {B, Format({dense, dense})},  {c, dense}}),
+         Formats({{a, dense}, {B, Format({dense, sparse})}, {c, dense}})
+         ),
+  {
+    TestCase({{B, {{{1,0},  1.0}, {{3,3},  3.0}, {{4,0},   2.0}}},
+              {c, {{{1}, 10.0}, {{3},  20.0}, {{4}, 30.0}}}},
+             {{a, {{{0}, 70.0}, {{3}, 60.0}}}})
+  }
+)
+
+TEST_STMT(parallel_transposed_matrix_vector_mul_deterministic,
+  forall(j,
+         forall(i,
+                a(i) += B(j,i) * c(j)
+                ),
+         ParallelStrategy::Dynamic, ReductionStrategy::Deterministic
+         ),
+  Values(
+         Formats({{a, dense}, {B, Format({dense, dense})},  {c, dense}}),
+         Formats({{a, dense}, {B, Format({dense, sparse})}, {c, dense}})
+         ),
+  {
+    TestCase({{B, {{{1,0},  1.0}, {{3,3},  3.0}, {{4,0},   2.0}}},
+              {c, {{{1}, 10.0}, {{3},  20.0}, {{4}, 30.0}}}},
+             {{a, {{{0}, 70.0}, {{3}, 60.0}}}})
+  }
+)
@@ -3,7 +3,12 @@
 #include "test_tensors.h"
 
 #include <vector>
+#include <cstdlib>
+#include <dirent.h>
+#include <unistd.h>
+#include "taco/codegen/module.h"
 #include "taco/util/collections.h"
+#include "taco/util/env.h"
 
 using namespace taco;
 
@@ -65,6 +70,104 @@ TEST(tensor, duplicates) {
   }
 }
 
+TEST(tensor, duplicate_policies) {
+  Tensor<double> a({5,5}, Sparse);
+  a.setDuplicatePolicy(DuplicatePolicy::Sum);
+  a.insert({1,2}, 42.0);
+  a.insert({2,2}, 10.0);
+  a.insert({1,2}, 1.0);
+  a.insert({1,2}, 2.0);
+  a.pack();
+  map<vector<int>,double> sums = {{{1,2}, 45.0}, {{2,2}, 10.0}};
+  size_t numSums = 0;
+  for (auto val = a.beginTyped<int>(); val != a.endTyped<int>(); ++val) {
+    ASSERT_TRUE(util::contains(sums, val->first));
+    ASSERT_EQ(sums.at(val->first), val->second);
+    numSums++;
+  }
+  ASSERT_EQ(sums.size(), numSums);
+
+  Tensor<double> b({5,5}, Sparse);
+  b.setDuplicatePolicy(DuplicatePolicy::Last);
+  b.insert({1,2}, 42.0);
+  b.insert({2,2}, 10.0);
+  b.insert({1,2}, 1.0);
+  b.pack();
+  map<vector<int>,double> lasts = {{{1,2}, 1.0}, {{2,2}, 10.0}};
+  for (auto val = b.beginTyped<int>(); val != b.endTyped<int>(); ++val) {
+    ASSERT_TRUE(util::contains(lasts, val->first));
+    ASSERT_EQ(lasts.at(val->first), val->second);
+  }
+}
+
+TEST(tensor, bulk_insert) {
+  int* rows = (int*)malloc(3 * sizeof(int));
+  int* cols = (int*)malloc(3 * sizeof(int));
+  double* vals = (double*)malloc(3 * sizeof(double));
+  rows[0] = 3; cols[0] = 1; vals[0] = 2.0;
+  rows[1] = 0; cols[1] = 4; vals[1] = 3.0;
+  rows[2] = 1; cols[2] = 2; vals[2] = 4.0;
+
+  // Components inserted after the bulk inserted ones are merged with them as
+  // if inserted later
+  Tensor<double> a({5,5}, Format({Sparse,Sparse}));
+  a.setDuplicatePolicy(DuplicatePolicy::Last);
+  a.insert({1,2}, 1.0);
+  a.insert({makeArray(rows, 3, Array::Free), makeArray(cols, 3, Array::Free)},
+           makeArray(vals, 3, Array::Free));
+  a.insert({3,1}, 5.0);
+  a.pack();
+
+  Tensor<double> expected({5,5}, Format({Sparse,Sparse}));
+  expected.insert({0,4}, 3.0);
+  expected.insert({1,2}, 4.0);
+  expected.insert({3,1}, 5.0);
+  expected.pack();
+  ASSERT_TRUE(equals(expected, a));
+}
+
+TEST(tensor, insert_out_of_bounds) {
+  Tensor<double> a({5,5}, Format({Dense,Sparse}));
+  a.insert({1,5}, 1.0);
+  ASSERT_DEATH(a.pack(), "out of bounds");
+
+  int* rows = (int*)malloc(2 * sizeof(int));
+  int* cols = (int*)malloc(2 * sizeof(int));
+  double* vals = (double*)malloc(2 * sizeof(double));
+  rows[0] = 0; cols[0] = 1; vals[0] = 2.0;
+  rows[1] = -1; cols[1] = 2; vals[1] = 3.0;
+  Tensor<double> b({5,5}, Format({Sparse,Sparse}));
+  b.insert({makeArray(rows, 2, Array::Free), makeArray(cols, 2, Array::Free)},
+           makeArray(vals, 2, Array::Free));
+  ASSERT_DEATH(b.pack(), "out of bounds");
+}
+
+TEST(tensor, pack_unsorted) {
+  // Enough components, with large enough coordinates, that packing takes
+  // several radix sort passes
+  const int rows = 1000, cols = 100000;
+  Tensor<double> a({rows,cols}, Format({Dense,Sparse}));
+  a.setDuplicatePolicy(DuplicatePolicy::Sum);
+  map<vector<int>,double> expected;
+  srand(4357);
+  for (int k = 0; k < 50000; k++) {
+    int i = rand() % rows;
+    int j = (rand() % 2 == 0) ? rand() % 10 : rand() % cols;
+    a.insert({i,j}, 1.0);
+    expected[{i,j}] += 1.0;
+  }
+  a.pack();
+
+  auto component = expected.begin();
+  for (auto val = a.beginTyped<int>(); val != a.endTyped<int>(); ++val) {
+    ASSERT_TRUE(component != expected.end());
+    ASSERT_EQ(component->first, val->first);
+    ASSERT_EQ(component->second, val->second);
+    ++component;
+  }
+  ASSERT_TRUE(component == expected.end());
+}
+
 TEST(tensor, transpose) {
   TensorData<double> testData = TensorData<double>({5, 3, 2}, {
     {{0,0,0}, 0.0},
@@ -96,3 +199,369 @@ TEST(tensor, transpose) {
   ASSERT_TRUE(equals(tensor.transpose({2,0,1}, Format({Sparse, Sparse, Dense}, {2, 1, 0})), transposedTensor2));
   ASSERT_TRUE(equals(tensor.transpose({0,1,2}), tensor));
 }
+
+TEST(tensor, kernel_cache) {
+  // A fresh cache directory, so that libraries left by earlier runs of the
+  // test cannot be hit
+  std::string cachetemplate = util::getTmpdir() + "kernel_cache_XXXXXX";
+  std::vector<char> cachename(cachetemplate.begin(), cachetemplate.end());
+  cachename.push_back('\0');
+  ASSERT_NE(nullptr, mkdtemp(cachename.data()));
+  std::string cachedir = std::string(cachename.data()) + "/";
+  setenv("TACO_CACHE_DIR", cachedir.c_str(), 1);
+
+  for (int run = 0; run < 2; run++) {
+    clearCompileCache();
+    Tensor<double> a("a", {3}, Dense);
+    Tensor<double> B("B", {3,3}, CSR);
+    Tensor<double> c("c", {3}, Dense);
+    B.insert({0,1}, 2.0);
+    B.insert({2,2}, 3.0);
+    B.pack();
+    c.insert({1}, 4.0);
+    c.insert({2}, 5.0);
+    c.pack();
+
+    IndexVar i("i"), j("j");
+    a(i) = B(i,j) * c(j);
+    a.evaluate();
+
+    Tensor<double> expected("expected", {3}, Dense);
+    expected.insert({0}, 8.0);
+    expected.insert({2}, 15.0);
+    expected.pack();
+    ASSERT_TRUE(equals(expected, a));
+  }
+
+  // A module is loaded from the cache, rather than compiled, if and only if
+  // the path of its library is in the cache
+  std::vector<std::string> libraries;
+  for (int run = 0; run < 2; run++) {
+    ir::Module module;
+    module.addFunction(ir::Function::make("cached", {}, {}, ir::Block::make()));
+    libraries.push_back(module.compile());
+  }
+  unsetenv("TACO_CACHE_DIR");
+  ASSERT_NE(0, libraries[0].compare(0, cachedir.size(), cachedir));
+  ASSERT_EQ(0, libraries[1].compare(0, cachedir.size(), cachedir));
+
+  // Both tensor kernels are the same library, and so are both modules
+  int numLibraries = 0;
+  DIR* dir = opendir(cachedir.c_str());
+  ASSERT_NE(nullptr, dir);
+  while (struct dirent* entry = readdir(dir)) {
+    std::string name = entry->d_name;
+    if (name.size() > 3 && name.substr(name.size() - 3) == ".so") {
+      numLibraries++;
+    }
+    if (name != "." && name != "..") {
+      unlink((cachedir + name).c_str());
+    }
+  }
+  closedir(dir);
+  rmdir(cachedir.c_str());
+  ASSERT_EQ(2, numLibraries);
+}
+
+TEST(tensor, compile_cache) {
+  clearCompileCache();
+
+  for (int run = 0; run < 3; run++) {
+    Tensor<double> a({3}, Dense);
+    Tensor<double> B({3,3}, CSR);
+    Tensor<double> c({3}, Dense);
+    B.insert({0,1}, 2.0);
+    B.insert({2,2}, 3.0);
+    B.pack();
+    c.insert({1}, 4.0);
+    c.insert({2}, (double)run);
+    c.pack();
+
+    IndexVar i, j;
+    a(i) = B(i,j) * c(j);
+    a.evaluate();
+
+    Tensor<double> expected({3}, Dense);
+    expected.insert({0}, 8.0);
+    expected.insert({2}, 3.0 * run);
+    expected.pack();
+    ASSERT_TRUE(equals(expected, a));
+  }
+  ASSERT_EQ(1u, getCompileCacheStats().misses);
+  ASSERT_EQ(2u, getCompileCacheStats().hits);
+
+  // A different format of an operand requires a different kernel
+  Tensor<double> a({3}, Dense);
+  Tensor<double> B({3,3}, CSC);
+  Tensor<double> c({3}, Dense);
+  B.pack();
+  c.pack();
+  IndexVar i, j;
+  a(i) = B(i,j) * c(j);
+  a.compile();
+  ASSERT_EQ(2u, getCompileCacheStats().misses);
+  ASSERT_EQ(2u, getCompileCacheStats().size);
+
+  // So does a format that differs only in the properties of a mode
+  Tensor<double> d({3}, Dense);
+  Tensor<double> E({3,3}, Format({Dense,
+                          ModeFormat::Compressed({ModeFormat::NOT_UNIQUE})}));
+  Tensor<double> f({3}, Dense);
+  d(i) = E(i,j) * f(j);
+  d.compile();
+  ASSERT_EQ(3u, getCompileCacheStats().misses);
+  ASSERT_EQ(3u, getCompileCacheStats().size);
+
+  // So do literals that differ only past their sixth significant digit
+  Tensor<double> g({2}, Dense);
+  g.insert({0}, 1.0);
+  g.insert({1}, 1.0);
+  g.pack();
+  Tensor<double> h1({2}, Dense);
+  Tensor<double> h2({2}, Dense);
+  h1(i) = g(i) * 2.0;
+  h1.evaluate();
+  h2(i) = g(i) * 2.0000001;
+  h2.evaluate();
+  ASSERT_EQ(5u, getCompileCacheStats().misses);
+  const double* vals = (const double*)h2.getStorage().getValues().getData();
+  ASSERT_DOUBLE_EQ(2.0000001, vals[0]);
+  ASSERT_DOUBLE_EQ(2.0000001, vals[1]);
+}
+
+TEST(tensor, compile_async_cache_hits) {
+  clearCompileCache();
+
+  Tensor<double> B({3,3}, CSR);
+  B.insert({0,1}, 2.0);
+  B.insert({2,2}, 3.0);
+  B.pack();
+  Tensor<double> c({3}, Dense);
+  c.insert({1}, 4.0);
+  c.insert({2}, 5.0);
+  c.pack();
+
+  // Later tensors share the cached IR while the first kernel compiles
+  IndexVar i, j;
+  std::vector<Tensor<double>> results;
+  for (int k = 0; k < 16; k++) {
+    Tensor<double> a({3}, Dense);
+    a(i) = B(i,j) * c(j);
+    a.compileAsync();
+    results.push_back(a);
+  }
+
+  Tensor<double> expected({3}, Dense);
+  expected.insert({0}, 8.0);
+  expected.insert({2}, 15.0);
+  expected.pack();
+  for (auto& a : results) {
+    a.assemble();
+    a.compute();
+    ASSERT_TRUE(equals(expected, a));
+  }
+  ASSERT_EQ(15u, getCompileCacheStats().hits);
+}
+
+TEST(tensor, compile_async) {
+  clearCompileCache();
+
+  Tensor<double> B({3,3}, CSR);
+  B.insert({0,1}, 2.0);
+  B.insert({2,2}, 3.0);
+  B.pack();
+  Tensor<double> c({3}, Dense);
+  c.insert({1}, 4.0);
+  c.insert({2}, 5.0);
+  c.pack();
+
+  IndexVar i, j;
+  Tensor<double> a({3}, Dense);
+  a(i) = B(i,j) * c(j);
+  Tensor<double> d({3}, Sparse);
+  d(i) = B(i,j) * c(j);
+  Tensor<double> e({3}, Dense);
+  e(i) = c(i) + c(i);
+
+  std::shared_future<void> aCompiled = a.compileAsync();
+  d.compileAsync();
+  e.compileAsync();
+  aCompiled.wait();
+
+  a.assemble();
+  a.compute();
+  d.assemble();
+  d.compute();
+  e.assemble();
+  e.compute();
+
+  Tensor<double> expected({3}, Dense);
+  expected.insert({0}, 8.0);
+  expected.insert({2}, 15.0);
+  expected.pack();
+  ASSERT_TRUE(equals(expected, a));
+  ASSERT_TRUE(equals(expected, d));
+
+  Tensor<double> expectedSum({3}, Dense);
+  expectedSum.insert({1}, 8.0);
+  expectedSum.insert({2}, 10.0);
+  expectedSum.pack();
+  ASSERT_TRUE(equals(expectedSum, e));
+}
+
+TEST(tensor, compute_repeated) {
+  Tensor<double> B({3,3}, CSR);
+  B.insert({0,1}, 2.0);
+  B.insert({2,2}, 3.0);
+  B.pack();
+  Tensor<double> c({3}, Format({Dense}));
+  c.insert({1}, 4.0);
+  c.insert({2}, 5.0);
+  c.pack();
+
+  IndexVar i, j;
+  Tensor<double> a({3}, Format({Dense}));
+  a(i) = B(i,j) * c(j);
+  a.compile();
+  a.assemble();
+
+  // Later calls reuse the cached arguments and see updated operand values
+  double* cvals = (double*)c.getStorage().getValues().getData();
+  for (int run = 1; run <= 3; run++) {
+    cvals[2] = 5.0 * run;
+    a.compute();
+    double* avals = (double*)a.getStorage().getValues().getData();
+    ASSERT_DOUBLE_EQ(8.0, avals[0]);
+    ASSERT_DOUBLE_EQ(15.0 * run, avals[2]);
+  }
+}
+
+TEST(tensor, parallel_assemble) {
+  Tensor<double> B({4,5}, CSR);
+  B.insert({0,1}, 1.0);
+  B.insert({0,4}, 2.0);
+  B.insert({2,0}, 3.0);
+  B.insert({3,3}, 4.0);
+  B.pack();
+  Tensor<double> C({4,5}, CSR);
+  C.insert({0,1}, 10.0);
+  C.insert({2,2}, 20.0);
+  C.insert({3,0}, 30.0);
+  C.pack();
+
+  Tensor<double> expected({4,5}, CSR);
+  expected.insert({0,1}, 11.0);
+  expected.insert({0,4}, 2.0);
+  expected.insert({2,0}, 3.0);
+  expected.insert({2,2}, 20.0);
+  expected.insert({3,0}, 30.0);
+  expected.insert({3,3}, 4.0);
+  expected.pack();
+
+  for (bool assembleWhileCompute : {false, true}) {
+    IndexVar i, j;
+    Tensor<double> A({4,5}, CSR);
+    A.setParallelAssemble(true);
+    A(i,j) = B(i,j) + C(i,j);
+    A.compile(assembleWhileCompute);
+    A.assemble();
+    A.compute();
+    ASSERT_TRUE(equals(expected, A));
+  }
+}
+
+TEST(tensor, parallel_reduce) {
+  Tensor<double> B({5,4}, Format({Dense, Sparse}));
+  B.insert({1,0}, 1.0);
+  B.insert({3,3}, 3.0);
+  B.insert({4,0}, 2.0);
+  B.pack();
+  Tensor<double> c({5}, Sparse);
+  c.insert({1}, 10.0);
+  c.insert({3}, 20.0);
+  c.insert({4}, 30.0);
+  c.pack();
+  Tensor<double> d({5}, Format({Dense}));
+  for (int k = 0; k < 5; k++) {
+    d.insert({k}, (double)k);
+  }
+  d.pack();
+
+  for (auto strategy : {ReductionStrategy::Fast,
+                        ReductionStrategy::Deterministic}) {
+    IndexVar i, j;
+    Tensor<double> alpha;
+    alpha.setParallelReduce(true, strategy);
+    alpha = c(j) * d(j);
+    alpha.evaluate();
+    ASSERT_DOUBLE_EQ(190.0, alpha.begin()->second);
+
+    Tensor<double> a({4}, Format({Dense}));
+    a.setParallelReduce(true, strategy);
+    a(i) = B(j,i) * c(j);
+    a.evaluate();
+    double* avals = (double*)a.getStorage().getValues().getData();
+    ASSERT_DOUBLE_EQ(70.0, avals[0]);
+    ASSERT_DOUBLE_EQ(0.0, avals[1]);
+    ASSERT_DOUBLE_EQ(60.0, avals[3]);
+  }
+
+  // Results too large to copy into every chunk are not privatized
+  const int size = 40000;
+  Tensor<double> C({5,size}, Format({Dense, Sparse}));
+  C.insert({1,0}, 1.0);
+  C.insert({3,size-1}, 3.0);
+  C.insert({4,0}, 2.0);
+  C.pack();
+  for (auto strategy : {ReductionStrategy::Fast,
+                        ReductionStrategy::Deterministic}) {
+    IndexVar i, j;
+    Tensor<double> a({size}, Format({Dense}));
+    a.setParallelReduce(true, strategy);
+    a(i) = C(j,i) * c(j);
+    a.evaluate();
+    double* avals = (double*)a.getStorage().getValues().getData();
+    ASSERT_DOUBLE_EQ(70.0, avals[0]);
+    ASSERT_DOUBLE_EQ(0.0, avals[1]);
+    ASSERT_DOUBLE_EQ(60.0, avals[size-1]);
+  }
+}
+
+TEST(tensor, symbolic_assemble) {
+  Tensor<double> B({4,5}, Format({Sparse, Sparse}));
+  B.insert({0,1}, 1.0);
+  B.insert({0,4}, 2.0);
+  B.insert({3,3}, 4.0);
+  B.pack();
+  Tensor<double> C({4,5}, Format({Sparse, Sparse}));
+  C.insert({0,1}, 10.0);
+  C.insert({2,2}, 20.0);
+  C.pack();
+
+  Tensor<double> expected({4,5}, Format({Sparse, Sparse}));
+  expected.insert({0,1}, 11.0);
+  expected.insert({0,4}, 2.0);
+  expected.insert({2,2}, 20.0);
+  expected.insert({3,3}, 4.0);
+  expected.pack();
+
+  for (bool assembleWhileCompute : {false, true}) {
+    IndexVar i, j;
+    Tensor<double> A({4,5}, Format({Sparse, Sparse}));
+    A.setSymbolicAssemble(true);
+    A(i,j) = B(i,j) + C(i,j);
+    A.compile(assembleWhileCompute);
+    ASSERT_EQ(std::string::npos, A.getSource().find("1048576"));
+    A.assemble();
+    A.compute();
+    ASSERT_TRUE(equals(expected, A));
+  }
+
+  // Results that outgrow the initial allocation size are resized
+  IndexVar i, j;
+  Tensor<double> A({4,5}, Format({Sparse, Sparse}));
+  A.setAllocSize(1);
+  A(i,j) = B(i,j) + C(i,j);
+  A.evaluate();
+  ASSERT_TRUE(equals(expected, A));
+}
@@ -5,6 +5,8 @@
 
 #include "taco/tensor.h"
 #include "taco/storage/typed_vector.h"
+#include "taco/index_notation/kernel.h"
+#include "taco/taco_tensor_t.h"
 
 #define _USE_MATH_DEFINES
 
@@ -45,7 +47,7 @@ TYPED_TEST_P(VectorTensorTest, types) {
   ASSERT_EQ(t, a.getComponentType());
   ASSERT_EQ(1, a.getOrder());
   ASSERT_EQ(5, a.getDimension(0));
-  map<vector<int>,TypeParam> vals = {{{0}, 1.0}, {{2}, 2.0}};
+  map<vector<int>,TypeParam> vals = {{{0}, (TypeParam)1.0}, {{2}, (TypeParam)2.0}};
   for (auto& val : vals) {
     a.insert(val.first, val.second);
   }
@@ -282,6 +284,71 @@ TEST(tensor_types, complex_accumulate) {
   ASSERT_TRUE(equals(expected,a));
 }
 
+TEST(tensor_types, complex_split) {
+  typedef std::complex<double> Complex;
+  Format sparse({Sparse});
+  Format dense({Dense});
+  Format csr = CSR;
+  sparse.setSplitComplex();
+  dense.setSplitComplex();
+  csr.setSplitComplex();
+
+  TensorData<Complex> testData = TensorData<Complex>({8}, {
+    {{0}, Complex(10.5, 10.5)},
+    {{2}, Complex(1, 0)},
+    {{3}, Complex(0, 1)},
+  });
+  Tensor<Complex> b = testData.makeTensor("b", sparse);
+  b.pack();
+
+  // Split values store the real parts of all components before their
+  // imaginary parts
+  const double* vals = (const double*)b.getStorage().getValues().getData();
+  ASSERT_ARRAY_EQ<double>({10.5,1,0, 10.5,0,1}, {vals, 6});
+  Tensor<Complex> expectedB = testData.makeTensor("expectedB",
+                                                  Format({Sparse}));
+  expectedB.pack();
+  ASSERT_TRUE(equals(expectedB, b));
+
+  Tensor<Complex> a("a", {8}, dense);
+  a(i) = b(i) * b(i) + b(i);
+  a.evaluate();
+
+  Tensor<Complex> expected("expected", {8}, Format({Dense}));
+  expected.insert({0}, Complex(10.5, 231));
+  expected.insert({2}, Complex(2, 0));
+  expected.insert({3}, Complex(-1, 1));
+  expected.pack();
+  ASSERT_TRUE(equals(expected, a));
+
+  Tensor<Complex> s("s");
+  s = b(i) * b(i);
+  s.evaluate();
+  ASSERT_EQ(Complex(0, 220.5), s.begin()->second);
+
+  Tensor<Complex> A("A", {3,4}, csr);
+  A.insert({0,1}, Complex(1, 2));
+  A.insert({2,0}, Complex(3, -1));
+  A.insert({2,3}, Complex(0, 1));
+  A.pack();
+
+  Tensor<Complex> x("x", {4}, dense);
+  for (int k = 0; k < 4; k++) {
+    x.insert({k}, Complex(k + 1, -k));
+  }
+  x.pack();
+
+  Tensor<Complex> y("y", {3}, dense);
+  y(i) = A(i,j) * x(j);
+  y.evaluate();
+
+  Tensor<Complex> expectedY("expectedY", {3}, Format({Dense}));
+  expectedY.insert({0}, Complex(4, 3));
+  expectedY.insert({2}, Complex(6, 3));
+  expectedY.pack();
+  ASSERT_TRUE(equals(expectedY, y));
+}
+
 template <typename T>
 bool equalsExact(Tensor<T> a, Tensor<T> b) {
   auto at = iterate<T>(a);
@@ -422,3 +489,115 @@ TEST(tensor_types, coordinate_types) {
   }
 
 }
+
+TEST(tensor_types, int64_positions) {
+  Format csr64({Dense, Sparse});
+  csr64.setLevelArrayTypes({{Int32}, {Int64, Int32}});
+
+  Tensor<double> b("b", {3, 4}, csr64);
+  Tensor<double> c("c", {3, 4}, csr64);
+  b.insert({0, 1}, 1.0);
+  b.insert({2, 3}, 2.0);
+  c.insert({0, 1}, 3.0);
+  c.insert({1, 0}, 4.0);
+  b.pack();
+  c.pack();
+
+  Tensor<double> a("a", {3, 4}, csr64);
+  a(i,j) = b(i,j) + c(i,j);
+  a.evaluate();
+
+  Tensor<double> expected("expected", {3, 4}, CSR);
+  expected.insert({0, 1}, 4.0);
+  expected.insert({1, 0}, 4.0);
+  expected.insert({2, 3}, 2.0);
+  expected.pack();
+  ASSERT_TRUE(equals(expected, a));
+
+  Array pos = a.getStorage().getIndex().getModeIndex(1).getIndexArray(0);
+  ASSERT_EQ(Int64, pos.getType());
+  ASSERT_EQ(3u, pos.get(3).getAsIndex());
+}
+
+TEST(tensor_types, narrow_coordinates) {
+  Format csr16({Dense, Sparse});
+  csr16.setLevelArrayTypes({{Int32}, {Int32, UInt16}});
+
+  Tensor<double> b("b", {3, 300}, csr16);
+  b.insert({0, 1}, 1.0);
+  b.insert({0, 299}, 2.0);
+  b.insert({2, 256}, 3.0);
+  b.pack();
+
+  Tensor<double> c("c", {300}, Format({Dense}));
+  for (int k = 0; k < 300; k++) {
+    c.insert({k}, (double)k);
+  }
+  c.pack();
+
+  Tensor<double> a("a", {3}, Format({Dense}));
+  a(i) = b(i,j) * c(j);
+  a.evaluate();
+  ASSERT_NE(std::string::npos, a.getSource().find("uint16_t* restrict"));
+
+  Tensor<double> expected("expected", {3}, Format({Dense}));
+  expected.insert({0}, 599.0);
+  expected.insert({2}, 768.0);
+  expected.pack();
+  ASSERT_TRUE(equals(expected, a));
+
+  Tensor<double> d("d", {3, 300}, csr16);
+  d(i,j) = b(i,j) + b(i,j);
+  d.evaluate();
+
+  Array crd = d.getStorage().getIndex().getModeIndex(1).getIndexArray(1);
+  ASSERT_EQ(UInt16, crd.getType());
+  ASSERT_EQ(299u, crd.get(1).getAsIndex());
+  ASSERT_EQ(256u, crd.get(2).getAsIndex());
+}
+
+TEST(tensor_types, int64_dimensions) {
+  // Dimensions and coordinates above INT_MAX are beyond the int TensorBase
+  // API, so the kernel is called directly on hand-built taco_tensor_t's
+  const int64_t size = 3000000000ll;
+  Format sv64({Sparse});
+  sv64.setLevelArrayTypes({{Int64, Int64}});
+  TensorVar alpha("alpha", Float64, Format());
+  TensorVar b("b", Type(Float64, {Dimension((size_t)size)}), sv64);
+  TensorVar c("c", Type(Float64, {Dimension((size_t)size)}), sv64);
+  Kernel kernel = compile(forall(i, alpha += b(i) * c(i)));
+
+  int64_t dims[] = {size};
+  int32_t ordering[] = {0};
+  taco_mode_t modes[] = {taco_mode_sparse};
+
+  // b(1) = 2, b(2^32+1) = 5 and c(2^32+1) = 3, which truncate to overlap at 1
+  int64_t bPos[] = {0, 2};
+  int64_t bCrd[] = {1, (1ll << 32) + 1};
+  double bVals[] = {2.0, 5.0};
+  int64_t cPos[] = {0, 1};
+  int64_t cCrd[] = {(1ll << 32) + 1};
+  double cVals[] = {3.0};
+  double alphaVal = 0.0;
+
+  taco_tensor_t* alphaT = init_taco_tensor_t(0, 64, nullptr, nullptr, nullptr);
+  taco_tensor_t* bT = init_taco_tensor_t(1, 64, dims, ordering, modes);
+  taco_tensor_t* cT = init_taco_tensor_t(1, 64, dims, ordering, modes);
+  alphaT->vals = (uint8_t*)&alphaVal;
+  bT->indices[0][0] = (uint8_t*)bPos;
+  bT->indices[0][1] = (uint8_t*)bCrd;
+  bT->vals = (uint8_t*)bVals;
+  bT->vals_size = 2;
+  cT->indices[0][0] = (uint8_t*)cPos;
+  cT->indices[0][1] = (uint8_t*)cCrd;
+  cT->vals = (uint8_t*)cVals;
+  cT->vals_size = 1;
+
+  void* args[] = {alphaT, bT, cT};
+  ASSERT_TRUE(kernel.computePacked(args));
+  ASSERT_DOUBLE_EQ(15.0, alphaVal);
+
+  deinit_taco_tensor_t(alphaT);
+  deinit_taco_tensor_t(bT);
+  deinit_taco_tensor_t(cT);
+}
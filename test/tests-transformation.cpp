@@ -185,6 +185,78 @@ INSTANTIATE_TEST_CASE_P(precompute, apply,
   )
 );
 
+INSTANTIATE_TEST_CASE_P(parallelize, precondition,
+  Values(
+         PreconditionTest(Parallelize(j, ParallelStrategy::Static),
+                          forall(i,
+                                 A(i,i) = B(i,i)
+                                 )
+                          ),
+         PreconditionTest(Parallelize(j, ParallelStrategy::Static),
+                          forall(i,
+                                 forall(j,
+                                        a(i) = b(i)
+                                        ))
+                          ),
+         PreconditionTest(Parallelize(i, ParallelStrategy::Dynamic),
+                          forall(j,
+                                 where(forall(i,
+                                              A(i,j) = w(i)),
+                                       forall(i,
+                                              w(i) = B(i,j))))
+                          )
+         )
+);
+
+INSTANTIATE_TEST_CASE_P(parallelize, apply,
+  Values(
+         TransformationTest(Parallelize(i, ParallelStrategy::Static),
+                            forall(i,
+                                   forall(j,
+                                          a(i) += B(i,j) * c(j)
+                                          )),
+                            forall(i,
+                                   forall(j,
+                                          a(i) += B(i,j) * c(j)
+                                          ),
+                                   ParallelStrategy::Static)
+                            ),
+         TransformationTest(Parallelize(j, ParallelStrategy::Static,
+                                        ReductionStrategy::Deterministic),
+                            forall(i,
+                                   forall(j,
+                                          a(i) += B(i,j) * c(j)
+                                          )),
+                            forall(i,
+                                   forall(j,
+                                          a(i) += B(i,j) * c(j),
+                                          ParallelStrategy::Static,
+                                          ReductionStrategy::Deterministic))
+                            ),
+         TransformationTest(Parallelize(j, ParallelStrategy::Dynamic),
+                            forall(i,
+                                   forall(j,
+                                          A(i,j) = B(i,j)
+                                          )),
+                            forall(i,
+                                   forall(j,
+                                          A(i,j) = B(i,j),
+                                          ParallelStrategy::Dynamic))
+                            ),
+         TransformationTest(Reorder(i, j),
+                            forall(i,
+                                   forall(j,
+                                          A(i,j) = B(i,j)
+                                          ),
+                                   ParallelStrategy::Static),
+                            forall(j,
+                                   forall(i,
+                                          A(i,j) = B(i,j),
+                                          ParallelStrategy::Static))
+                            )
+         )
+);
+
 /*
 TEST(schedule, workspace_spmspm) {
   TensorBase A("A", Float(64), {3,3}, Format({Dense,Sparse}));
@@ -84,7 +84,7 @@ static void printFlag(string flag, string text) {
   cout << endl;
 }
 
-static const string fileFormats = "(.tns .ttx .mtx .rb)";
+static const string fileFormats = "(.tns .ttx .mtx .rb .tbin)";
 
 static void printUsageInfo() {
   cout << "Usage: taco <index expression> [options]" << endl;
@@ -104,9 +104,10 @@ static void printUsageInfo() {
   cout << endl;
   printFlag("f=<tensor>:<format>",
             "Specify the format of a tensor in the expression. Formats are "
-            "specified per dimension using d (dense) and s (sparse). "
-            "All formats default to dense. "
-            "Examples: A:ds, b:d and D:sss.");
+            "specified per dimension using d (dense), s (sparse), "
+            "q (singleton), h (hashed) and b (bitmap). Levels followed by a "
+            "singleton level store duplicate coordinates. All formats default to dense. "
+            "Examples: A:ds, b:d, D:sss, C:sq (COO) and H:dh.");
   cout << endl;
   printFlag("t=<tensor>:<data type>",
             "Specify the data type of a tensor (defaults to double)."
@@ -341,10 +342,23 @@ int main(int argc, char* argv[]) {
           case 's':
             modeTypes.push_back(ModeFormat::Sparse);
             break;
+          case 'q':
+            modeTypes.push_back(ModeFormat::Singleton);
+            break;
+          case 'h':
+            modeTypes.push_back(ModeFormat::Hashed);
+            break;
+          case 'b':
+            modeTypes.push_back(ModeFormat::Bitmap);
+            break;
           default:
             return reportError("Incorrect format descriptor", 3);
             break;
         }
+        if (i > 0 && formatString[i] == 'q') {
+          ModeFormat parent = modeTypes[i-1].getModeFormats()[0];
+          modeTypes[i-1] = parent({ModeFormat::NOT_UNIQUE});
+        }
         modeOrdering.push_back(i);
       }
       if (descriptor.size() > 2) {